@@ -0,0 +1,109 @@
+//===- Compiler.h -----------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// C interface to the in-process compiler driver, see
+// aie/Targets/AIECompilerDriver.h.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_C_COMPILER_H
+#define AIE_C_COMPILER_H
+
+#include "mlir-c/IR.h"
+#include "mlir-c/Support.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct AieCompilation {
+  void *ptr;
+};
+using AieCompilation = struct AieCompilation;
+
+/// Lowers a copy of the device `deviceName` of `moduleOp` to a routed design
+/// with buffer addresses. The name may be empty if the module has a single
+/// device. The result is null if that fails, in which case the errors have
+/// been emitted on the context of the module.
+MLIR_CAPI_EXPORTED AieCompilation aieCompilationCreate(
+    MlirOperation moduleOp, MlirStringRef deviceName, MlirStringRef allocScheme,
+    bool dynamicObjFifos, bool ctrlPktOverlay);
+MLIR_CAPI_EXPORTED void aieCompilationDestroy(AieCompilation compilation);
+
+static inline bool aieCompilationIsNull(AieCompilation compilation) {
+  return !compilation.ptr;
+}
+
+/// Calls `callback` with the name of every device of `moduleOp`.
+MLIR_CAPI_EXPORTED void aieCompilationGetDeviceNames(
+    MlirOperation moduleOp, MlirStringCallback callback, void *userData);
+
+/// The modules are owned by the compilation.
+MLIR_CAPI_EXPORTED MlirOperation
+aieCompilationGetModuleWithAddresses(AieCompilation compilation);
+MLIR_CAPI_EXPORTED MlirOperation
+aieCompilationGetPhysicalModule(AieCompilation compilation);
+
+/// The strings returned by the getters below are owned by the compilation.
+MLIR_CAPI_EXPORTED MlirStringRef
+aieCompilationGetDeviceName(AieCompilation compilation);
+MLIR_CAPI_EXPORTED MlirStringRef
+aieCompilationGetTargetArch(AieCompilation compilation);
+
+MLIR_CAPI_EXPORTED intptr_t
+aieCompilationGetNumCores(AieCompilation compilation);
+MLIR_CAPI_EXPORTED void aieCompilationGetCoreTile(AieCompilation compilation,
+                                                  intptr_t pos, int *col,
+                                                  int *row);
+/// Empty if the core does not have an elf_file attribute.
+MLIR_CAPI_EXPORTED MlirStringRef
+aieCompilationGetCoreElfFile(AieCompilation compilation, intptr_t pos);
+/// Empty until aieCompilationLowerCores succeeded.
+MLIR_CAPI_EXPORTED MlirStringRef
+aieCompilationGetCoreLLVMIR(AieCompilation compilation, intptr_t pos);
+MLIR_CAPI_EXPORTED MlirStringRef
+aieCompilationGetCoreLdScript(AieCompilation compilation, intptr_t pos);
+MLIR_CAPI_EXPORTED MlirStringRef
+aieCompilationGetCoreBCF(AieCompilation compilation, intptr_t pos);
+
+/// Lowers the cores to LLVM IR in parallel.
+MLIR_CAPI_EXPORTED MlirLogicalResult
+aieCompilationLowerCores(AieCompilation compilation);
+/// Lowers all cores to one LLVM IR module. The result is allocated with
+/// malloc and owned by the caller, and is null on failure.
+MLIR_CAPI_EXPORTED MlirStringRef
+aieCompilationLowerCoresUnified(AieCompilation compilation);
+
+/// Generates the NPU instruction stream into an array allocated with malloc
+/// and owned by the caller.
+MLIR_CAPI_EXPORTED MlirLogicalResult aieCompilationGenerateNPUInstructions(
+    AieCompilation compilation, uint32_t **words, size_t *numWords);
+
+/// Generates the CDO binaries, which are then owned by the compilation and
+/// replace those of earlier calls.
+MLIR_CAPI_EXPORTED MlirLogicalResult
+aieCompilationGenerateCDO(AieCompilation compilation, MlirStringRef elfDir);
+MLIR_CAPI_EXPORTED intptr_t
+aieCompilationGetNumCDOBinaries(AieCompilation compilation);
+MLIR_CAPI_EXPORTED void aieCompilationGetCDOBinary(AieCompilation compilation,
+                                                   intptr_t pos,
+                                                   MlirStringRef *name,
+                                                   MlirStringRef *data);
+
+/// Generates the transactions of the configuration as a module owned by the
+/// caller. The result is null on failure.
+MLIR_CAPI_EXPORTED MlirOperation aieCompilationGenerateTransactions(
+    AieCompilation compilation, MlirStringRef elfDir);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AIE_C_COMPILER_H
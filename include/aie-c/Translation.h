@@ -36,6 +36,11 @@ aieTranslateToCDODirect(MlirOperation moduleOp, MlirStringRef workDirPath,
                         bool aieSim, bool xaieDebug, bool enableCores);
 MLIR_CAPI_EXPORTED MlirOperation aieTranslateBinaryToTxn(MlirContext ctx,
                                                          MlirStringRef binary);
+MLIR_CAPI_EXPORTED MlirStringRef aieDecodeTrace(MlirOperation moduleOp,
+                                                MlirStringRef trace,
+                                                bool binaryInput,
+                                                bool binaryOutput,
+                                                int colShift);
 
 struct AieRtControl {
   void *ptr;
@@ -237,6 +237,9 @@ typedef struct DMAChannel {
   }
 } DMAChannel;
 
+// The number of packet rules a slave port of a stream switch can hold.
+constexpr int numPacketRuleSlots = 4;
+
 const AIETargetModel &getTargetModel(mlir::Operation *op);
 const AIETargetModel &getTargetModel(AIEDevice device);
 
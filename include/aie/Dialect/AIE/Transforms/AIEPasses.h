@@ -14,6 +14,7 @@
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/Pass/Pass.h"
 
 namespace xilinx::AIE {
@@ -30,17 +31,29 @@ std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 createAIECoreToStandardPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIEFindFlowsPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIELocalizeLocksPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIEOptimizeLocksPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIENormalizeAddressSpacesPass();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAIERouteFlowsPass();
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
 createAIEVectorOptPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEVectorizeStreamsPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIEPathfinderPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoStatefulTransformPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEObjectFifoSoftwarePipelinePass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEObjectFifoDepthSizingPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIEPlacePass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIESimulatePerformancePass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIEAnalyzeLocksPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoRegisterProcessPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIELowerCascadeFlowsPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIECascadeReductionPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEAssignBufferDescriptorIDsPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
@@ -14,7 +14,10 @@
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/IR/AIETargetModel.h"
 
+#include "llvm/Support/JSON.h"
+
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <list>
 #include <set>
@@ -28,6 +31,10 @@ namespace xilinx::AIE {
 #define MAX_CIRCUIT_STREAM_CAPACITY 1
 #define MAX_PACKET_STREAM_CAPACITY 32
 
+// Names the objectFifo link that the inputs of a join flow into, on the flows
+// that carry them.
+constexpr llvm::StringLiteral balanceGroupAttr = "aie.balance_group";
+
 enum class Connectivity { INVALID = 0, AVAILABLE = 1 };
 
 using SwitchboxConnect = struct SwitchboxConnect {
@@ -192,8 +199,19 @@ public:
                        bool isPriorityFlow) = 0;
   virtual void sortFlows(const int maxCol, const int maxRow) = 0;
   virtual bool addFixedConnection(SwitchboxOp switchboxOp) = 0;
+  // Asks to route all destinations of every flow, and all flows from the
+  // sources of every group in `groups`, through equal numbers of switchboxes
+  // where congestion allows. Routers are free to ignore this.
+  virtual void
+  balanceLatencies(std::vector<std::vector<PathEndPoint>> groups) {}
   virtual std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) = 0;
+  // The name of the router and the settings that select the routings it
+  // finds, which become part of the key of cached routings.
+  virtual std::string getSettings() const { return ""; }
+  // Whether the last routing found would be found again for the same flows,
+  // rather than depending on how long the search ran.
+  virtual bool isReproducible() const { return true; }
 };
 
 class Pathfinder : public Router {
@@ -205,11 +223,28 @@ public:
                bool isPacketFlow, bool isPriorityFlow) override;
   void sortFlows(const int maxCol, const int maxRow) override;
   bool addFixedConnection(SwitchboxOp switchboxOp) override;
+  void
+  balanceLatencies(std::vector<std::vector<PathEndPoint>> groups) override;
   std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) override;
+  std::string getSettings() const override { return "router=pathfinder"; }
   std::map<PathEndPoint, PathEndPoint> dijkstraShortestPaths(PathEndPoint src);
 
-private:
+protected:
+  // The ends of the channels that start at `src`, sorted.
+  const std::vector<PathEndPoint> &getChannels(PathEndPoint src);
+  double getDemand(PathEndPoint src, PathEndPoint dst);
+
+  // The number of switchboxes every flow should pass through to reach each of
+  // its destinations, if latencies are balanced.
+  std::map<PathEndPoint, int> getHopTargets();
+  // Reroutes the path in `preds` from the tree of `processed` ports of the
+  // flow from `src` to `dst`, so that it passes through as close to
+  // `targetHops` switchboxes as possible.
+  void balanceBranch(PathEndPoint src, PathEndPoint dst, int targetHops,
+                     const std::set<PathEndPoint> &processed,
+                     std::map<PathEndPoint, PathEndPoint> &preds);
+
   // Flows to be routed
   std::vector<Flow> flows;
   // Represent all routable paths as a graph
@@ -223,6 +258,80 @@ private:
   // The value is a vector of PathEndPoints representing the possible ends of
   // the path
   std::map<PathEndPoint, std::vector<PathEndPoint>> channels;
+  // Whether to balance the latencies of flows, and the groups of sources
+  // whose flows are balanced together
+  bool balanceLatency = false;
+  std::vector<std::vector<PathEndPoint>> latencyGroups;
+};
+
+// Routes all flows at once with a branch-and-bound search, which minimizes
+// the highest utilization of the channels between any two switchboxes and
+// then the total number of such channels used. The search considers the
+// `maxCandidates` shortest tile paths to every destination of a flow, and
+// assigns the channels along them as it goes. It returns the best routing
+// found within `timeBudget`, and falls back to Pathfinder if it found none.
+class ExactRouter : public Pathfinder {
+public:
+  ExactRouter(std::chrono::milliseconds timeBudget = std::chrono::seconds(1),
+              int maxCandidates = 4)
+      : timeBudget(timeBudget), maxCandidates(maxCandidates) {}
+  std::optional<std::map<PathEndPoint, SwitchSettings>>
+  findPaths(int maxIterations) override;
+  std::string getSettings() const override;
+  bool isReproducible() const override { return !timedOut; }
+
+private:
+  struct Search;
+
+  std::chrono::milliseconds timeBudget;
+  int maxCandidates;
+  // Whether the last search ran out of its time budget.
+  bool timedOut = false;
+};
+
+// RoutingCache persists routings in a directory, keyed by the device and the
+// flows and fixed connections they route. Columns are numbered relative to
+// the leftmost column of the flows, so that a design which is a copy of a
+// cached one shifted by whole columns reuses its routing, as long as the
+// columns the routing passes through are of the same kind.
+class RoutingCache {
+public:
+  RoutingCache(llvm::StringRef directory, DeviceOp device, int maxCol,
+               int maxRow);
+
+  void addFlow(TileID srcCoords, Port srcPort, TileID dstCoords, Port dstPort,
+               bool isPacketFlow, bool isPriorityFlow);
+  void addFixedConnection(SwitchboxOp switchboxOp);
+  // Routing options that change the routing found.
+  void addOption(llvm::StringRef option);
+
+  // The cached routing of the flows added so far, translated to their
+  // columns, if there is one.
+  std::optional<std::map<PathEndPoint, SwitchSettings>> lookup();
+  mlir::LogicalResult
+  store(const std::map<PathEndPoint, SwitchSettings> &flowSolutions);
+
+private:
+  struct Entry {
+    std::string kind;
+    TileID srcCoords;
+    Port srcPort;
+    TileID dstCoords;
+    Port dstPort;
+  };
+
+  // The kinds of the tiles of a column, from the bottom up.
+  std::string getColumnKind(int col) const;
+  int getColumnOffset() const;
+  std::string getKey() const;
+  std::string getPath(llvm::StringRef key) const;
+
+  std::string directory;
+  std::string deviceName;
+  const AIETargetModel &targetModel;
+  int maxCol, maxRow;
+  std::vector<Entry> entries;
+  std::vector<std::string> options;
 };
 
 // DynamicTileAnalysis integrates the Pathfinder class into the MLIR
@@ -242,6 +351,11 @@ public:
   llvm::DenseMap<int, PLIOOp> coordToPLIO;
 
   const int maxIterations = 1000; // how long until declared unroutable
+  // Where routings are cached across compilations, if not empty.
+  std::string routingCacheDir;
+  // Whether to balance the latencies of the branches of fanouts, and of the
+  // flows that join in the same objectFifo link.
+  bool balanceLatency = false;
 
   DynamicTileAnalysis() : pathfinder(std::make_shared<Pathfinder>()) {}
   DynamicTileAnalysis(std::shared_ptr<Router> p) : pathfinder(std::move(p)) {}
@@ -258,9 +372,33 @@ public:
   ShimMuxOp getShimMux(mlir::OpBuilder &builder, int col);
 };
 
+// Summarizes the quality of the routing `flowSolutions` of the flows of
+// `device` as JSON: the hops and latency in switchboxes of every flow, the
+// circuit and packet channels used on every link between switchboxes, the
+// most contended switchboxes, the unused channels, and a heat map of the
+// utilization of every switchbox.
+llvm::json::Value
+getRoutingMetrics(DeviceOp device,
+                  const std::map<PathEndPoint, SwitchSettings> &flowSolutions);
+
 // Get enum int value from WireBundle.
 int getWireBundleAsInt(WireBundle bundle);
 
+// A packet rule matches the packet IDs `id` with `(id & mask) == value`.
+struct PacketIDCube {
+  int mask;
+  int value;
+  bool matches(int id) const { return (id & mask) == value; }
+};
+
+// Covers the packet IDs `ids` with as few packet rules as possible, none of
+// which matches an ID of `excluded`. IDs that occur in neither set are free
+// to be matched. The smallest rule enclosing all of `ids` is preferred, so
+// that designs without conflicts keep a single rule per group of flows.
+llvm::SmallVector<PacketIDCube> coverPacketIDs(llvm::ArrayRef<int> ids,
+                                               llvm::ArrayRef<int> excluded,
+                                               int idBits = 5);
+
 } // namespace xilinx::AIE
 
 namespace llvm {
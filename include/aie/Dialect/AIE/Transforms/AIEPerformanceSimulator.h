@@ -0,0 +1,141 @@
+//===- AIEPerformanceSimulator.h --------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Discrete-event performance model of a lowered device. The cores run the
+// lock operations and kernel calls in their bodies, the DMA channels run the
+// BD chains of the aie.mem, aie.memtile_dma and aie.shim_dma operations, and
+// data moves between DMA channels over the streams routed by the switchboxes.
+// Shim DMA channels without BDs are driven by the host, which is always ready
+// to send or receive.
+//
+// The same model, without time, is the transition system of the lock analysis,
+// which looks for reachable states in which no unit can make progress.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_PERFORMANCE_SIMULATOR_H
+#define AIE_PERFORMANCE_SIMULATOR_H
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xilinx::AIE {
+
+struct PerformanceSimulatorOptions {
+  /// Cycles to simulate if the design does not stop earlier.
+  uint64_t maxCycles = 1000000;
+  /// Cycles of a kernel call without an aie.kernel_cycles attribute.
+  uint64_t defaultKernelCycles = 0;
+  /// Clock frequency of the array, used to convert cycles into frames per
+  /// second.
+  double clockMHz = 1000;
+  /// Bytes the host receives per frame. If zero, a frame is one buffer
+  /// descriptor's worth of data arriving at every host output.
+  uint64_t frameBytes = 0;
+};
+
+/// A core or a DMA channel of the simulated device.
+struct SimulatedUnit {
+  enum class Kind { Core, MM2S, S2MM };
+  Kind kind;
+  TileID tile;
+  int channel = 0;
+  /// Cycles spent computing (cores) or moving data (DMA channels).
+  uint64_t busyCycles = 0;
+  /// Cycles spent waiting to acquire a lock.
+  uint64_t lockStallCycles = 0;
+  /// Cycles a DMA channel spent waiting for the other end of its stream.
+  uint64_t streamStallCycles = 0;
+  /// Cycles after the unit ran out of work.
+  uint64_t idleCycles = 0;
+
+  std::string getName() const;
+};
+
+struct PerformanceReport {
+  /// Cycles simulated.
+  uint64_t cycles = 0;
+  /// Every core program and BD chain ran to completion.
+  bool finished = false;
+  /// No unit could make progress before the end of the simulation.
+  bool stalled = false;
+  /// The units that waited when the simulation stalled, with what they waited
+  /// on.
+  std::vector<std::string> blocked;
+  std::vector<SimulatedUnit> units;
+  /// Bytes received by the host and the cycle the first of them arrived.
+  uint64_t hostOutputBytes = 0;
+  std::optional<uint64_t> firstOutputCycle;
+  /// Cycle from which the steady-state rates are measured.
+  uint64_t steadyStateStart = 0;
+  /// Steady-state bytes received by the host per cycle.
+  double hostBytesPerCycle = 0;
+  double framesPerSecond = 0;
+
+  void print(llvm::raw_ostream &os) const;
+};
+
+/// Simulates `device` and returns the statistics of its units. Fails with an
+/// error on the device if the device contains constructs the simulator cannot
+/// follow, such as core loops without a constant trip count.
+mlir::FailureOr<PerformanceReport>
+simulatePerformance(DeviceOp device,
+                    const PerformanceSimulatorOptions &options = {});
+
+struct LockAnalysisOptions {
+  /// Passes around every core loop and BD chain to prove deadlock free.
+  unsigned iterations = 4;
+  /// States to explore before giving up.
+  uint64_t maxStates = 1000000;
+  /// The timed model the initiation intervals are measured on.
+  PerformanceSimulatorOptions simulator;
+};
+
+/// Locks that hand buffers back and forth: for every lock of the cycle, a unit
+/// that acquires it releases another lock of the cycle, which is acquired by a
+/// unit that releases the first.
+struct LockCycle {
+  std::vector<std::string> locks;
+  /// The units that acquire the locks.
+  std::vector<std::string> units;
+  /// Steady-state cycles between successive acquires of the locks of the
+  /// cycle, if they were acquired at least twice.
+  std::optional<double> initiationInterval;
+};
+
+struct LockAnalysisReport {
+  enum class Result { DeadlockFree, Deadlock, Inconclusive };
+  Result result = Result::DeadlockFree;
+  unsigned iterations = 0;
+  /// Distinct states of the transition system explored.
+  uint64_t states = 0;
+  /// The units that wait in the deadlock found, with what they wait on.
+  std::vector<std::string> blocked;
+  std::vector<LockCycle> cycles;
+
+  void print(llvm::raw_ostream &os) const;
+};
+
+/// Explores the interleavings of the lock operations of the cores and the BD
+/// chains of the DMA channels of `device` for `options.iterations` passes
+/// around each of them, and measures the initiation interval of every lock
+/// cycle on the timed model of simulatePerformance. Fails like
+/// simulatePerformance.
+mlir::FailureOr<LockAnalysisReport>
+analyzeLocks(DeviceOp device, const LockAnalysisOptions &options = {});
+
+} // namespace xilinx::AIE
+
+#endif // AIE_PERFORMANCE_SIMULATOR_H
@@ -41,8 +41,9 @@ struct CanonicalizeVectorForAIEVecOptions
     : public mlir::PassPipelineOptions<CanonicalizeVectorForAIEVecOptions> {
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". This "
+                     "will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
@@ -57,8 +58,9 @@ struct LowerVectorToAIEVecOptions
     : public mlir::PassPipelineOptions<LowerVectorToAIEVecOptions> {
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". This "
+                     "will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
@@ -73,8 +75,9 @@ struct OptimizeAIEVecOptions
     : public mlir::PassPipelineOptions<OptimizeAIEVecOptions> {
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". This "
+                     "will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
@@ -109,8 +112,9 @@ struct ConvertVectorToAIEVecOptions
       llvm::cl::init(2)};
   PassOptions::Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". This "
+                     "will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
   PassOptions::Option<std::string> targetBackend{
       *this, "target-backend",
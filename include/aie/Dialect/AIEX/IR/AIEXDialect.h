@@ -41,6 +41,20 @@ verifyStridesWraps(mlir::Operation *forOp, mlir::MemRefType referencedBufType,
                    llvm::SmallVector<int64_t, 4> hardwareStrides,
                    bool skipTransformationChecks = false);
 
+// Blockwrite payloads of at least this many words are stored as dense resource
+// blobs, which parse, print and serialize without visiting every element.
+constexpr size_t blockWriteResourceWords = 1024;
+
+// The initial value of a global holding a blockwrite payload.
+mlir::ElementsAttr getBlockWriteData(mlir::RankedTensorType type,
+                                     llvm::ArrayRef<uint32_t> words);
+
+// The 32-bit words of a blockwrite payload. Dense resource blobs and non-splat
+// dense arrays are read in place, splats are expanded into `storage`.
+std::optional<llvm::ArrayRef<uint32_t>>
+getBlockWriteWords(mlir::Attribute data,
+                   llvm::SmallVectorImpl<uint32_t> &storage);
+
 } // namespace AIEX
 } // namespace xilinx
 
@@ -0,0 +1,119 @@
+//===- AIECompilerDriver.h --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Runs the MLIR stages of aiecc in-process on one MLIRContext: lowering to a
+// design with addresses, routing, per-core lowering to LLVM IR with linker
+// scripts, NPU instruction generation and CDO/transaction generation. The
+// modules stay in memory between the stages and the per-core work runs on the
+// thread pool of the context. Compiling the LLVM IR of the cores into ELFs is
+// left to the caller.
+//
+// A compilation compiles one aie.device. Modules with several devices are
+// compiled one device at a time, as aiecc does.
+//
+// The passes are looked up by name, so they must be registered before a
+// compilation is created, as aie-opt and the Python bindings do.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_COMPILER_DRIVER_H
+#define AIE_COMPILER_DRIVER_H
+
+#include "aie/Targets/AIETargets.h"
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OwningOpRef.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xilinx::AIE {
+
+struct CompilerDriverOptions {
+  /// The aie.device to compile, named like DeviceOp::getArtifactName. May be
+  /// empty if the module has a single device.
+  std::string deviceName;
+  /// Allocation scheme of aie-assign-buffer-addresses.
+  std::string allocScheme = "bank-aware";
+  bool dynamicObjFifos = false;
+  /// Route control packets from the shims to every tile.
+  bool ctrlPktOverlay = false;
+};
+
+struct CompiledCore {
+  int col;
+  int row;
+  /// The elf_file attribute of the core, if it has one.
+  std::optional<std::string> elfFile;
+  /// Empty until the cores are lowered, and in unified compilations.
+  std::string llvmIR;
+  std::string ldScript;
+  std::string bcf;
+};
+
+class AIECompilation {
+public:
+  /// Lowers a copy of the selected device of `module` to a design with
+  /// buffer addresses, the input of all later stages. The other devices are
+  /// left out of the copy. `module` itself is not modified.
+  static mlir::FailureOr<AIECompilation>
+  create(mlir::ModuleOp module, const CompilerDriverOptions &options = {});
+
+  /// The names of the devices of `module`, to select them in the options.
+  static std::vector<std::string> getDeviceNames(mlir::ModuleOp module);
+
+  /// The name of the compiled device.
+  llvm::StringRef getDeviceName() const { return deviceName; }
+
+  /// The design with buffer addresses and its routed counterpart.
+  mlir::ModuleOp getModuleWithAddresses() { return withAddresses.get(); }
+  mlir::ModuleOp getPhysicalModule() { return physical.get(); }
+
+  /// The architecture of the device, e.g. "AIE2".
+  llvm::StringRef getTargetArch() const { return targetArch; }
+
+  std::vector<CompiledCore> &getCores() { return cores; }
+
+  /// Lowers every core to LLVM IR and generates its linker script and BCF.
+  /// The cores are lowered in parallel.
+  mlir::LogicalResult lowerCores();
+
+  /// Lowers all cores to a single LLVM IR module, the input of aiecc's
+  /// unified compilation, and generates the linker scripts and BCFs.
+  mlir::FailureOr<std::string> lowerCoresUnified();
+
+  /// The NPU instruction stream of the runtime sequence.
+  mlir::FailureOr<std::vector<uint32_t>> generateNPUInstructions();
+
+  /// The CDO binaries of the physical design. The core ELFs are read from
+  /// `elfDir`.
+  mlir::FailureOr<std::vector<CDOBinary>> generateCDO(llvm::StringRef elfDir);
+
+  /// The configuration of the physical design as a module of transactions.
+  /// The core ELFs are read from `elfDir`.
+  mlir::FailureOr<mlir::OwningOpRef<mlir::ModuleOp>>
+  generateTransactions(llvm::StringRef elfDir);
+
+private:
+  AIECompilation() = default;
+
+  mlir::LogicalResult emitLinkerScripts();
+
+  mlir::OwningOpRef<mlir::ModuleOp> withAddresses;
+  mlir::OwningOpRef<mlir::ModuleOp> physical;
+  std::string deviceName;
+  std::string targetArch;
+  std::vector<CompiledCore> cores;
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_COMPILER_DRIVER_H
@@ -15,11 +15,14 @@
 
 #include "llvm/Support/raw_ostream.h"
 
+#include <string>
 #include <vector>
 
 namespace xilinx {
 namespace AIE {
 
+class DeviceOp;
+
 mlir::LogicalResult AIETranslateToXAIEV2(mlir::ModuleOp module,
                                          llvm::raw_ostream &output);
 mlir::LogicalResult AIETranslateToHSA(mlir::ModuleOp module,
@@ -34,36 +37,70 @@ mlir::LogicalResult AIETranslateShimSolution(mlir::ModuleOp module,
                                              llvm::raw_ostream &);
 mlir::LogicalResult AIETranslateGraphXPE(mlir::ModuleOp module,
                                          llvm::raw_ostream &);
+// The translations below operate on one aie.device of the module: the one
+// called `deviceName`, or the only one if `deviceName` is empty.
 mlir::LogicalResult AIETranslateToNPU(mlir::ModuleOp module,
                                       llvm::raw_ostream &output,
-                                      llvm::StringRef sequenceName = "");
+                                      llvm::StringRef sequenceName = "",
+                                      llvm::StringRef deviceName = "");
 mlir::LogicalResult AIETranslateToNPU(mlir::ModuleOp, std::vector<uint32_t> &,
-                                      llvm::StringRef sequenceName = "");
+                                      llvm::StringRef sequenceName = "",
+                                      llvm::StringRef deviceName = "");
 mlir::LogicalResult
 AIETranslateControlPacketsToUI32Vec(mlir::ModuleOp module,
                                     llvm::raw_ostream &output,
-                                    llvm::StringRef sequenceName = "");
+                                    llvm::StringRef sequenceName = "",
+                                    llvm::StringRef deviceName = "");
 mlir::LogicalResult
 AIETranslateControlPacketsToUI32Vec(mlir::ModuleOp, std::vector<uint32_t> &,
-                                    llvm::StringRef sequenceName = "");
+                                    llvm::StringRef sequenceName = "",
+                                    llvm::StringRef deviceName = "");
 mlir::LogicalResult AIETranslateToLdScript(mlir::ModuleOp module,
                                            llvm::raw_ostream &output,
-                                           int tileCol, int tileRow);
+                                           int tileCol, int tileRow,
+                                           llvm::StringRef deviceName = "");
 mlir::LogicalResult AIETranslateToBCF(mlir::ModuleOp module,
                                       llvm::raw_ostream &output, int tileCol,
-                                      int tileRow);
+                                      int tileRow,
+                                      llvm::StringRef deviceName = "");
 mlir::LogicalResult
 AIELLVMLink(llvm::raw_ostream &output, std::vector<std::string> Files,
             bool DisableDITypeMap = false, bool NoVerify = false,
             bool Internalize = false, bool OnlyNeeded = false,
             bool PreserveAssemblyUseListOrder = false, bool Verbose = false);
 
+/// Generates the CDO binaries of every aie.device of `m` into `workDirPath`.
+/// If the module holds several devices, they are translated in parallel and
+/// the binaries of each go to, and its core ELFs are read from, the
+/// subdirectory named after DeviceOp::getArtifactName.
 mlir::LogicalResult
 AIETranslateToCDODirect(mlir::ModuleOp m, llvm::StringRef workDirPath,
                         bool bigEndian = false, bool emitUnified = false,
                         bool cdoDebug = false, bool aieSim = false,
                         bool xaieDebug = false, bool enableCores = true);
 
+/// A CDO binary generated in memory, together with the file name
+/// AIETranslateToCDODirect would write it to (e.g. "aie_cdo_init.bin").
+struct CDOBinary {
+  std::string name;
+  std::vector<uint8_t> data;
+};
+
+/// Generates the CDO binaries of `device` into `binaries` without touching the
+/// filesystem, except to read the core ELF files from `workDirPath`. All state
+/// is owned by the call, so devices of different modules, or different devices
+/// of one module, can be translated concurrently from several threads.
+mlir::LogicalResult
+AIETranslateToCDOBuffers(DeviceOp device, llvm::StringRef workDirPath,
+                         std::vector<CDOBinary> &binaries,
+                         bool bigEndian = false, bool emitUnified = false,
+                         bool cdoDebug = false, bool aieSim = false,
+                         bool enableCores = true);
+
+/// Writes each of `binaries` to a file of the same name in `dirPath`.
+mlir::LogicalResult writeCDOBinaries(llvm::ArrayRef<CDOBinary> binaries,
+                                     llvm::StringRef dirPath);
+
 #ifdef AIE_ENABLE_AIRBIN
 mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
                                          const std::string &outputFilename,
@@ -72,7 +109,8 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
 #endif
 
 mlir::LogicalResult AIETranslateToTargetArch(mlir::ModuleOp module,
-                                             llvm::raw_ostream &output);
+                                             llvm::raw_ostream &output,
+                                             llvm::StringRef deviceName = "");
 
 } // namespace AIE
 
@@ -0,0 +1,148 @@
+//===- AIETraceDecoder.h ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Streaming decoder for the packet-switched trace streams written by the core,
+// memory, MemTile and shim trace units. This is the native counterpart of
+// programming_examples/utils/parse_trace.py: it produces the same Chrome/
+// Perfetto trace events, but decodes the trace words as they are read and
+// keeps only a fixed amount of state per trace unit.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_TARGETS_AIETRACEDECODER_H
+#define AIE_TARGETS_AIETRACEDECODER_H
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Support/LogicalResult.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <array>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace xilinx::AIE {
+
+/// The packet type a trace unit puts in the header of its trace packets.
+enum class TracePacketType : uint8_t {
+  Core = 0,
+  Mem = 1,
+  Shim = 2,
+  MemTile = 3
+};
+
+constexpr unsigned kNumTraceEventSlots = 8;
+
+/// Returns the name of event `code` of a trace unit of the given type, or
+/// "Unknown".
+llvm::StringRef getTraceEventName(TracePacketType type, uint8_t code);
+
+/// A trace unit and the events it was configured to trace.
+struct TraceUnit {
+  TracePacketType type;
+  int col;
+  int row;
+  std::array<uint8_t, kNumTraceEventSlots> events = {};
+  /// Process id of the unit in the decoded trace.
+  unsigned pid = 0;
+};
+
+/// The trace units configured by a design, in the order they are configured.
+class TraceConfig {
+public:
+  /// Collects the trace event selections written by the aiex.npu.write32 ops
+  /// of `module`, as parse_mlir_trace_events does. `colShift` is added to the
+  /// column of every unit.
+  static TraceConfig fromModule(mlir::ModuleOp module, int colShift = 0);
+
+  /// Sets the four events selected by one trace event register of a unit.
+  /// `firstSlot` is 0 for the first register and 4 for the second.
+  void setEvents(TracePacketType type, int col, int row, unsigned firstSlot,
+                 uint32_t value);
+
+  const TraceUnit *lookup(TracePacketType type, int col, int row) const;
+  llvm::ArrayRef<TraceUnit> units() const { return unitList; }
+
+private:
+  std::vector<TraceUnit> unitList;
+  std::map<std::tuple<TracePacketType, int, int>, unsigned> index;
+};
+
+/// Receives the output of a TraceDecoder.
+class TraceSink {
+public:
+  virtual ~TraceSink();
+  /// Called once per trace unit of the design before any event.
+  virtual void unit(const TraceUnit &unit) = 0;
+  /// An event of `unit` in slot `slot` starts (`begin`) or ends at cycle
+  /// `timestamp`.
+  virtual void event(const TraceUnit &unit, unsigned slot, uint64_t timestamp,
+                     bool begin) = 0;
+  /// Called after the last event.
+  virtual void finish() {}
+};
+
+/// Writes the trace as a Chrome trace event JSON array, readable by Perfetto
+/// and chrome://tracing. Events are written as they are decoded.
+std::unique_ptr<TraceSink> createChromeTraceSink(llvm::raw_ostream &os);
+
+/// Writes the trace in a compact binary format of little-endian records:
+///
+///   "AIETRACE" u32:version(1)
+///   unit:  u8:1 u16:pid u8:packet_type u8:col u8:row u8[8]:event_codes
+///   event: u8:2 (begin) or u8:3 (end) u16:pid u8:slot u64:timestamp
+std::unique_ptr<TraceSink> createBinaryTraceSink(llvm::raw_ostream &os);
+
+/// Decodes trace words. Words are split into 8-word packets whose first word
+/// is a header naming the trace unit; the other words are appended to the
+/// byte stream of that unit and decoded into events as soon as a complete
+/// trace command is available.
+class TraceDecoder {
+public:
+  TraceDecoder(const TraceConfig &config, TraceSink &sink);
+  ~TraceDecoder();
+
+  /// Decodes the next words of the trace.
+  void addWords(llvm::ArrayRef<uint32_t> words);
+
+  /// Flushes the sink. Returns the number of packets that were dropped
+  /// because their trace unit is not configured by the design.
+  uint64_t finish();
+
+private:
+  struct UnitState;
+  void addByte(UnitState &state, uint8_t byte);
+  void decodeCommand(UnitState &state);
+
+  const TraceConfig &config;
+  TraceSink &sink;
+  /// Decoding state of each trace unit, indexed by pid.
+  std::vector<UnitState> states;
+  /// The unit named by the last valid packet header, or null if that unit is
+  /// not configured.
+  UnitState *current = nullptr;
+  uint64_t wordIndex = 0;
+  uint64_t droppedPackets = 0;
+};
+
+/// Decodes a trace buffer, either the raw little-endian words (`binaryInput`)
+/// or a text dump with one hexadecimal word per line, into `sink`. Zero words
+/// of a raw buffer are skipped, as write_out_trace does when dumping one.
+mlir::LogicalResult decodeTrace(llvm::StringRef trace, bool binaryInput,
+                                const TraceConfig &config, TraceSink &sink,
+                                uint64_t *droppedPackets = nullptr);
+
+} // namespace xilinx::AIE
+
+#endif // AIE_TARGETS_AIETRACEDECODER_H
@@ -0,0 +1,176 @@
+//===- Compiler.cpp ---------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie-c/Compiler.h"
+
+#include "aie/Targets/AIECompilerDriver.h"
+
+#include "mlir/CAPI/IR.h"
+#include "mlir/CAPI/Support.h"
+#include "mlir/CAPI/Wrap.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace llvm;
+using namespace mlir;
+using namespace xilinx::AIE;
+
+namespace {
+struct Compilation {
+  AIECompilation driver;
+  std::vector<CDOBinary> cdoBinaries;
+};
+} // namespace
+
+DEFINE_C_API_PTR_METHODS(AieCompilation, Compilation)
+
+static MlirStringRef toStringRef(const std::string &s) {
+  return mlirStringRefCreate(s.data(), s.size());
+}
+
+AieCompilation aieCompilationCreate(MlirOperation moduleOp,
+                                    MlirStringRef deviceName,
+                                    MlirStringRef allocScheme,
+                                    bool dynamicObjFifos, bool ctrlPktOverlay) {
+  CompilerDriverOptions options;
+  options.deviceName = unwrap(deviceName).str();
+  options.allocScheme = unwrap(allocScheme).str();
+  options.dynamicObjFifos = dynamicObjFifos;
+  options.ctrlPktOverlay = ctrlPktOverlay;
+  auto driver =
+      AIECompilation::create(cast<ModuleOp>(unwrap(moduleOp)), options);
+  if (failed(driver))
+    return wrap(static_cast<Compilation *>(nullptr));
+  return wrap(new Compilation{std::move(*driver), {}});
+}
+
+void aieCompilationDestroy(AieCompilation compilation) {
+  delete unwrap(compilation);
+}
+
+void aieCompilationGetDeviceNames(MlirOperation moduleOp,
+                                  MlirStringCallback callback,
+                                  void *userData) {
+  for (const std::string &name :
+       AIECompilation::getDeviceNames(cast<ModuleOp>(unwrap(moduleOp))))
+    callback(toStringRef(name), userData);
+}
+
+MlirOperation aieCompilationGetModuleWithAddresses(AieCompilation compilation) {
+  return wrap(
+      unwrap(compilation)->driver.getModuleWithAddresses().getOperation());
+}
+
+MlirOperation aieCompilationGetPhysicalModule(AieCompilation compilation) {
+  return wrap(unwrap(compilation)->driver.getPhysicalModule().getOperation());
+}
+
+MlirStringRef aieCompilationGetDeviceName(AieCompilation compilation) {
+  return wrap(unwrap(compilation)->driver.getDeviceName());
+}
+
+MlirStringRef aieCompilationGetTargetArch(AieCompilation compilation) {
+  return wrap(unwrap(compilation)->driver.getTargetArch());
+}
+
+intptr_t aieCompilationGetNumCores(AieCompilation compilation) {
+  return unwrap(compilation)->driver.getCores().size();
+}
+
+void aieCompilationGetCoreTile(AieCompilation compilation, intptr_t pos,
+                               int *col, int *row) {
+  const CompiledCore &core = unwrap(compilation)->driver.getCores()[pos];
+  *col = core.col;
+  *row = core.row;
+}
+
+MlirStringRef aieCompilationGetCoreElfFile(AieCompilation compilation,
+                                           intptr_t pos) {
+  const CompiledCore &core = unwrap(compilation)->driver.getCores()[pos];
+  if (!core.elfFile)
+    return mlirStringRefCreate(nullptr, 0);
+  return toStringRef(*core.elfFile);
+}
+
+MlirStringRef aieCompilationGetCoreLLVMIR(AieCompilation compilation,
+                                          intptr_t pos) {
+  return toStringRef(unwrap(compilation)->driver.getCores()[pos].llvmIR);
+}
+
+MlirStringRef aieCompilationGetCoreLdScript(AieCompilation compilation,
+                                            intptr_t pos) {
+  return toStringRef(unwrap(compilation)->driver.getCores()[pos].ldScript);
+}
+
+MlirStringRef aieCompilationGetCoreBCF(AieCompilation compilation,
+                                       intptr_t pos) {
+  return toStringRef(unwrap(compilation)->driver.getCores()[pos].bcf);
+}
+
+MlirLogicalResult aieCompilationLowerCores(AieCompilation compilation) {
+  return wrap(unwrap(compilation)->driver.lowerCores());
+}
+
+MlirStringRef aieCompilationLowerCoresUnified(AieCompilation compilation) {
+  FailureOr<std::string> llvmIR =
+      unwrap(compilation)->driver.lowerCoresUnified();
+  if (failed(llvmIR))
+    return mlirStringRefCreate(nullptr, 0);
+  char *cStr = static_cast<char *>(malloc(llvmIR->size()));
+  llvmIR->copy(cStr, llvmIR->size());
+  return mlirStringRefCreate(cStr, llvmIR->size());
+}
+
+MlirLogicalResult
+aieCompilationGenerateNPUInstructions(AieCompilation compilation,
+                                      uint32_t **words, size_t *numWords) {
+  FailureOr<std::vector<uint32_t>> instructions =
+      unwrap(compilation)->driver.generateNPUInstructions();
+  if (failed(instructions))
+    return mlirLogicalResultFailure();
+  size_t size = instructions->size() * sizeof(uint32_t);
+  *words = static_cast<uint32_t *>(malloc(size));
+  std::memcpy(*words, instructions->data(), size);
+  *numWords = instructions->size();
+  return mlirLogicalResultSuccess();
+}
+
+MlirLogicalResult aieCompilationGenerateCDO(AieCompilation compilation,
+                                            MlirStringRef elfDir) {
+  FailureOr<std::vector<CDOBinary>> binaries =
+      unwrap(compilation)->driver.generateCDO(unwrap(elfDir));
+  if (failed(binaries))
+    return mlirLogicalResultFailure();
+  unwrap(compilation)->cdoBinaries = std::move(*binaries);
+  return mlirLogicalResultSuccess();
+}
+
+intptr_t aieCompilationGetNumCDOBinaries(AieCompilation compilation) {
+  return unwrap(compilation)->cdoBinaries.size();
+}
+
+void aieCompilationGetCDOBinary(AieCompilation compilation, intptr_t pos,
+                                MlirStringRef *name, MlirStringRef *data) {
+  const CDOBinary &binary = unwrap(compilation)->cdoBinaries[pos];
+  *name = toStringRef(binary.name);
+  *data =
+      mlirStringRefCreate(reinterpret_cast<const char *>(binary.data.data()),
+                          binary.data.size());
+}
+
+MlirOperation aieCompilationGenerateTransactions(AieCompilation compilation,
+                                                 MlirStringRef elfDir) {
+  auto transactions =
+      unwrap(compilation)->driver.generateTransactions(unwrap(elfDir));
+  if (failed(transactions))
+    return wrap(ModuleOp().getOperation());
+  return wrap(transactions->release().getOperation());
+}
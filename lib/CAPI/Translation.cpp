@@ -14,6 +14,7 @@
 #include "aie/Dialect/AIE/IR/AIETargetModel.h"
 #include "aie/Targets/AIERT.h"
 #include "aie/Targets/AIETargets.h"
+#include "aie/Targets/AIETraceDecoder.h"
 
 #include "mlir-c/IR.h"
 #include "mlir-c/Support.h"
@@ -92,6 +93,23 @@ MlirOperation aieTranslateBinaryToTxn(MlirContext ctx, MlirStringRef binary) {
   return wrap(mod->getOperation());
 }
 
+MlirStringRef aieDecodeTrace(MlirOperation moduleOp, MlirStringRef trace,
+                             bool binaryInput, bool binaryOutput,
+                             int colShift) {
+  std::string decoded;
+  llvm::raw_string_ostream os(decoded);
+  ModuleOp mod = llvm::cast<ModuleOp>(unwrap(moduleOp));
+  TraceConfig config = TraceConfig::fromModule(mod, colShift);
+  auto sink =
+      binaryOutput ? createBinaryTraceSink(os) : createChromeTraceSink(os);
+  if (failed(decodeTrace(llvm::StringRef(trace.data, trace.length),
+                         binaryInput, config, *sink)))
+    return mlirStringRefCreate(nullptr, 0);
+  char *cStr = static_cast<char *>(malloc(decoded.size()));
+  decoded.copy(cStr, decoded.size());
+  return mlirStringRefCreate(cStr, decoded.size());
+}
+
 MlirStringRef aieTranslateToNPU(MlirOperation moduleOp) {
   std::string npu;
   llvm::raw_string_ostream os(npu);
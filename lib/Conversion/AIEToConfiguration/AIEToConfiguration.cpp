@@ -13,6 +13,7 @@
 #include "aie/Conversion/AIEToConfiguration/AIEToConfiguration.h"
 #include "aie/Targets/AIERT.h"
 
+#include "llvm/ADT/MapVector.h"
 #include "llvm/Support/Debug.h"
 
 #include <vector>
@@ -260,21 +261,22 @@ emitControlPacketOps(OpBuilder &builder,
     } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
       if (!std::get<1>(p).getInitialValue())
         continue;
-      auto blockWriteData =
-          dyn_cast<DenseIntElementsAttr>(*std::get<1>(p).getInitialValue());
-      if (!blockWriteData) {
+      SmallVector<uint32_t> storage;
+      std::optional<ArrayRef<uint32_t>> blockWriteDataValues =
+          AIEX::getBlockWriteWords(*std::get<1>(p).getInitialValue(),
+                                   storage);
+      if (!blockWriteDataValues) {
         payload.emitError(
             "Global symbol initial value is not a dense int array");
         break;
       }
-      auto blockWriteDataValues = blockWriteData.getValues<int32_t>();
       // Split block write data into beats of 4 or less, in int32_t.
       int currAddr = op.cmd.RegOff;
-      for (size_t i = 0; i < blockWriteDataValues.size(); i += 4) {
-        auto last = std::min(blockWriteDataValues.size(), i + 4);
+      for (size_t i = 0; i < blockWriteDataValues->size(); i += 4) {
+        auto last = std::min(blockWriteDataValues->size(), i + 4);
         SmallVector<int32_t> splitData =
-            SmallVector<int32_t>(blockWriteDataValues.begin() + i,
-                                 blockWriteDataValues.begin() + last);
+            SmallVector<int32_t>(blockWriteDataValues->begin() + i,
+                                 blockWriteDataValues->begin() + last);
         builder.create<AIEX::NpuControlPacketOp>(
             loc, builder.getUI32IntegerAttr(currAddr), nullptr,
             /*opcode*/ builder.getI32IntegerAttr(0),
@@ -339,6 +341,97 @@ LogicalResult orConsecutiveWritesOnSameAddr(Block *body) {
   return success();
 }
 
+// The largest payload of a control packet, in words.
+constexpr size_t maxCtrlPktWords = 4;
+
+// Writes to the core control register start a core, so they must stay behind
+// every write that precedes them.
+constexpr uint32_t coreControlOffset = 0x32000;
+
+// Packs the control packets of `body` into as few packets as possible. The
+// packets are split into windows at the core control writes. Within a window,
+// the packets of each tile keep their order, but the packets of different
+// tiles are independent. Writes to consecutive addresses of a tile are packed
+// into packets of up to maxCtrlPktWords words. The packets of the tiles are
+// then interleaved, so that consecutive packets go to different tiles, and
+// usually to different shim channels of the control overlay.
+LogicalResult batchControlPackets(Block *body,
+                                  const AIETargetModel &targetModel) {
+  SmallVector<AIEX::NpuControlPacketOp> ctrlPktOps(
+      body->getOps<AIEX::NpuControlPacketOp>());
+  uint32_t tileOffsetMask =
+      (1u << std::min(targetModel.getRowShift(),
+                      targetModel.getColumnShift())) -
+      1;
+  auto isBarrier = [&](AIEX::NpuControlPacketOp op) {
+    return (op.getAddress() & tileOffsetMask) == coreControlOffset;
+  };
+  auto canAppend = [](AIEX::NpuControlPacketOp packet,
+                      AIEX::NpuControlPacketOp next) {
+    auto data = packet.getData();
+    auto nextData = next.getData();
+    if (!data || !nextData || packet.getOpcode() != 0 ||
+        next.getOpcode() != 0 || packet.getStreamId() != next.getStreamId())
+      return false;
+    return data->size() + nextData->size() <= maxCtrlPktWords &&
+           next.getAddress() ==
+               packet.getAddress() + data->size() * sizeof(uint32_t);
+  };
+
+  SmallVector<Operation *> erased;
+  auto batchWindow = [&](ArrayRef<AIEX::NpuControlPacketOp> window) {
+    if (window.empty())
+      return;
+    Operation *anchor = window.back()->getNextNode();
+
+    llvm::MapVector<TileID, SmallVector<AIEX::NpuControlPacketOp>> tiles;
+    for (AIEX::NpuControlPacketOp op : window) {
+      SmallVector<AIEX::NpuControlPacketOp> &packets =
+          tiles[{static_cast<int>(op.getColumnFromAddr()),
+                 static_cast<int>(op.getRowFromAddr())}];
+      if (packets.empty() || !canAppend(packets.back(), op)) {
+        packets.push_back(op);
+        continue;
+      }
+      AIEX::NpuControlPacketOp packet = packets.back();
+      SmallVector<int32_t> data(packet.getData()->begin(),
+                                packet.getData()->end());
+      data.append(op.getData()->begin(), op.getData()->end());
+      packet.setDataAttr(DenseI32ArrayAttr::get(packet->getContext(), data));
+      erased.push_back(op);
+    }
+
+    for (size_t i = 0;; i++) {
+      bool moved = false;
+      for (auto &[tile, packets] : tiles) {
+        if (i >= packets.size())
+          continue;
+        if (anchor)
+          packets[i]->moveBefore(anchor);
+        else
+          packets[i]->moveBefore(body, body->end());
+        moved = true;
+      }
+      if (!moved)
+        break;
+    }
+  };
+
+  size_t begin = 0;
+  for (size_t i = 0; i < ctrlPktOps.size(); i++) {
+    if (!isBarrier(ctrlPktOps[i]))
+      continue;
+    batchWindow(ArrayRef(ctrlPktOps).slice(begin, i - begin));
+    begin = i + 1;
+  }
+  batchWindow(ArrayRef(ctrlPktOps).drop_front(begin));
+
+  for (auto e : erased)
+    e->erase();
+
+  return success();
+}
+
 // an enum to represent the output type of the transaction binary
 enum OutputType {
   Transaction,
@@ -347,7 +440,8 @@ enum OutputType {
 
 static LogicalResult convertTransactionOpsToMLIR(
     OpBuilder builder, AIE::DeviceOp device, OutputType outputType,
-    std::vector<TransactionBinaryOperation> &operations) {
+    std::vector<TransactionBinaryOperation> &operations,
+    bool batchCtrlPkts = false) {
 
   auto loc = builder.getUnknownLoc();
 
@@ -360,7 +454,7 @@ static LogicalResult convertTransactionOpsToMLIR(
     }
     uint32_t size = op.cmd.Size / 4;
     const uint32_t *d = reinterpret_cast<const uint32_t *>(op.cmd.DataPtr);
-    std::vector<uint32_t> data32(d, d + size);
+    ArrayRef<uint32_t> data32(d, size);
 
     int id = 0;
     std::string name = "blockwrite_data";
@@ -368,10 +462,10 @@ static LogicalResult convertTransactionOpsToMLIR(
       name = "blockwrite_data_" + std::to_string(id++);
 
     MemRefType memrefType = MemRefType::get({size}, builder.getI32Type());
-    TensorType tensorType = RankedTensorType::get({size}, builder.getI32Type());
+    auto tensorType = RankedTensorType::get({size}, builder.getI32Type());
     auto global = builder.create<memref::GlobalOp>(
         loc, name, builder.getStringAttr("private"), memrefType,
-        DenseElementsAttr::get<uint32_t>(tensorType, data32), true, nullptr);
+        AIEX::getBlockWriteData(tensorType, data32), true, nullptr);
     global_data.push_back(global);
   }
 
@@ -395,6 +489,10 @@ static LogicalResult convertTransactionOpsToMLIR(
     // resolve mask writes; control packet doesn't natively support mask write.
     if (failed(orConsecutiveWritesOnSameAddr(&seq.getBody().front())))
       return failure();
+    if (batchCtrlPkts &&
+        failed(batchControlPackets(&seq.getBody().front(),
+                                   device.getTargetModel())))
+      return failure();
   } else {
     llvm_unreachable("bad output type");
   }
@@ -430,7 +528,8 @@ xilinx::AIE::convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
   std::vector<AIEDevice> devices{AIEDevice::npu1_1col, AIEDevice::npu1_2col,
                                  AIEDevice::npu1_3col, AIEDevice::npu1_4col,
                                  AIEDevice::npu1};
-  auto device = builder.create<DeviceOp>(loc, devices[columns - 1]);
+  auto device = builder.create<DeviceOp>(loc, devices[columns - 1],
+                                         /*sym_name=*/nullptr);
   device.getRegion().emplaceBlock();
   DeviceOp::ensureTerminator(device.getBodyRegion(), builder, loc);
   builder.setInsertionPointToStart(device.getBody());
@@ -445,7 +544,8 @@ xilinx::AIE::convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
 
 static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
                                                StringRef clElfDir,
-                                               OutputType outputType) {
+                                               OutputType outputType,
+                                               bool batchCtrlPkts = false) {
 
   const BaseNPUTargetModel &targetModel =
       (const BaseNPUTargetModel &)device.getTargetModel();
@@ -483,8 +583,8 @@ static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
   OpBuilder builder(device.getBodyRegion());
 
   // convert the parsed ops to MLIR
-  if (failed(
-          convertTransactionOpsToMLIR(builder, device, outputType, operations)))
+  if (failed(convertTransactionOpsToMLIR(builder, device, outputType,
+                                         operations, batchCtrlPkts)))
     return failure();
 
   return success();
@@ -511,7 +611,7 @@ struct ConvertAIEToControlPacketsPass
   }
   void runOnOperation() override {
     if (failed(convertAIEToConfiguration(getOperation(), clElfDir,
-                                         OutputType::ControlPacket)))
+                                         OutputType::ControlPacket, clBatch)))
       return signalPassFailure();
   }
 };
@@ -2289,6 +2289,11 @@ class ShuffleOpConversion
   LogicalResult
   matchAndRewrite(aievec::ShuffleOp shuffleOp, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
+    if (shuffleOp.getMode() > aievec::ShuffleMode::T8_4X8)
+      return rewriter.notifyMatchFailure(shuffleOp,
+                                         "shuffle mode is not available on "
+                                         "AIE2");
+
     auto loc = shuffleOp.getLoc();
     auto lhs = adaptor.getLhs();
     auto rhs = adaptor.getRhs();
@@ -2320,6 +2325,265 @@ class ShuffleOpConversion
   }
 };
 
+//===----------------------------------------------------------------------===//
+// AIE2P
+//===----------------------------------------------------------------------===//
+
+class MatMulAIE2POpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::MatMulAIE2POp> {
+  using ConvertOpToLLVMPattern<aievec::MatMulAIE2POp>::ConvertOpToLLVMPattern;
+
+  struct DecodedMatMulOp {
+    typedef enum { I32, BF16, FP8 } Kind;
+
+    Kind kind;
+    Value lhs;
+    Value rhs;
+    Value acc;
+    int conf;
+  };
+
+  // The AIE2P mac.conf intrinsics take the same control word layout as the
+  // AIE2 ones.
+  static DecodedMatMulOp decodeMatMulOp(OpAdaptor op) {
+    Value lhs = op.getLhs();
+    Value rhs = op.getRhs();
+    Value acc = op.getAcc();
+    auto lhsElTy = cast<VectorType>(lhs.getType()).getElementType();
+    if (lhsElTy.isBF16())
+      // <8x8xbf16> x <8x8xbf16> + <8x8xf32>
+      return {DecodedMatMulOp::Kind::BF16, lhs, rhs, acc,
+              aiev2_vmac_compute_control(
+                  /*sgn_x=*/0, /*sgn_y=*/0, /*amode=*/2, /*bmode=*/3,
+                  /*variant=*/0, /*zero_acc=*/0, /*shift16=*/0,
+                  /*sub_mul=*/0, /*sub_acc1=*/0, /*sub_acc2=*/0,
+                  /*sub_mask=*/0)};
+
+    if (isa<FloatType>(lhsElTy))
+      // <8x16xf8> x <16x8xf8> + <8x8xf32>, the variant selects the encoding.
+      return {DecodedMatMulOp::Kind::FP8, lhs, rhs, acc,
+              aiev2_vmac_compute_control(
+                  /*sgn_x=*/0, /*sgn_y=*/0, /*amode=*/2, /*bmode=*/0,
+                  /*variant=*/isa<Float8E5M2Type>(lhsElTy) ? 1 : 0,
+                  /*zero_acc=*/0, /*shift16=*/0,
+                  /*sub_mul=*/0, /*sub_acc1=*/0, /*sub_acc2=*/0,
+                  /*sub_mask=*/0)};
+
+    int signX = 0, signY = 0;
+    if (auto extSIOp = lhs.getDefiningOp<arith::ExtSIOp>()) {
+      lhs = extSIOp.getIn();
+      signX = 1;
+    } else if (auto extUIOp = lhs.getDefiningOp<arith::ExtUIOp>()) {
+      lhs = extUIOp.getIn();
+    } else if (!cast<IntegerType>(lhsElTy).isUnsigned()) {
+      // NOTE: We're choosing 'signed' by default
+      signX = 1;
+    }
+    auto rhsElTy = cast<VectorType>(rhs.getType()).getElementType();
+    if (auto extSIOp = rhs.getDefiningOp<arith::ExtSIOp>()) {
+      rhs = extSIOp.getIn();
+      signY = 1;
+    } else if (auto extUIOp = rhs.getDefiningOp<arith::ExtUIOp>()) {
+      rhs = extUIOp.getIn();
+    } else if (!cast<IntegerType>(rhsElTy).isUnsigned()) {
+      // NOTE: We're choosing 'signed' by default
+      signY = 1;
+    }
+
+    // <8x8xi8> x <8x8xi8> + <8x8xi32>
+    return {DecodedMatMulOp::Kind::I32, lhs, rhs, acc,
+            aiev2_vmac_compute_control(
+                /*sgn_x=*/signX, /*sgn_y=*/signY, /*amode=*/0, /*bmode=*/1,
+                /*variant=*/0, /*zero_acc=*/0, /*shift16=*/0,
+                /*sub_mul=*/0, /*sub_acc1=*/0, /*sub_acc2=*/0,
+                /*sub_mask=*/0)};
+  }
+
+  LogicalResult
+  matchAndRewrite(aievec::MatMulAIE2POp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto decodedMatMulOp = decodeMatMulOp(adaptor);
+
+    Location loc = op.getLoc();
+    // Flatten the inputs
+    auto lhsFlattenedVecTy =
+        getFlattenedVectorType(cast<VectorType>(decodedMatMulOp.lhs.getType()));
+    decodedMatMulOp.lhs = rewriter.create<vector::ShapeCastOp>(
+        loc, lhsFlattenedVecTy, decodedMatMulOp.lhs);
+    auto rhsFlattenedVecTy =
+        getFlattenedVectorType(cast<VectorType>(decodedMatMulOp.rhs.getType()));
+    decodedMatMulOp.rhs = rewriter.create<vector::ShapeCastOp>(
+        loc, rhsFlattenedVecTy, decodedMatMulOp.rhs);
+    auto accFlattenedVecTy =
+        getFlattenedVectorType(cast<VectorType>(decodedMatMulOp.acc.getType()));
+    decodedMatMulOp.acc = rewriter.create<vector::ShapeCastOp>(
+        loc, accFlattenedVecTy, decodedMatMulOp.acc);
+
+    Type i32ty = rewriter.getI32Type();
+    auto confCst = rewriter.create<LLVM::ConstantOp>(
+        loc, i32ty, rewriter.getI32IntegerAttr(decodedMatMulOp.conf));
+    SmallVector<Value> operands({decodedMatMulOp.lhs, decodedMatMulOp.rhs,
+                                 decodedMatMulOp.acc, confCst});
+    // AIE2P accumulators are 2048 bits wide.
+    VectorType v32xi64ty = VectorType::get({32}, rewriter.getI64Type());
+    Value matMulResVal;
+    switch (decodedMatMulOp.kind) {
+    case DecodedMatMulOp::Kind::BF16:
+      matMulResVal =
+          rewriter
+              .create<xllvm::MacConfBF16AIE2PIntrOp>(
+                  loc, v32xi64ty,
+                  forceCastOperandsToSignature(
+                      rewriter, loc, operands,
+                      {VectorType::get({64}, rewriter.getBF16Type()),
+                       VectorType::get({64}, rewriter.getBF16Type()),
+                       v32xi64ty, i32ty}))
+              .getResult();
+      break;
+    case DecodedMatMulOp::Kind::FP8:
+      matMulResVal =
+          rewriter
+              .create<xllvm::MacConfFP8AIE2PIntrOp>(
+                  loc, v32xi64ty,
+                  forceCastOperandsToSignature(
+                      rewriter, loc, operands,
+                      {VectorType::get({128}, rewriter.getI8Type()),
+                       VectorType::get({128}, rewriter.getI8Type()),
+                       v32xi64ty, i32ty}))
+              .getResult();
+      break;
+    case DecodedMatMulOp::Kind::I32:
+      matMulResVal =
+          rewriter
+              .create<xllvm::MacConfAcc32AIE2PIntrOp>(
+                  loc, v32xi64ty,
+                  forceCastOperandsToSignature(
+                      rewriter, loc, operands,
+                      {VectorType::get({64}, rewriter.getI8Type()),
+                       VectorType::get({16}, i32ty), v32xi64ty, i32ty}))
+              .getResult();
+      break;
+    }
+
+    auto castFromAcc =
+        bitcastValueToType(rewriter, loc, matMulResVal, accFlattenedVecTy);
+
+    rewriter.replaceOpWithNewOp<vector::ShapeCastOp>(op, op.getType(),
+                                                     castFromAcc);
+
+    return success();
+  }
+};
+
+class ShuffleOpAIE2PConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::ShuffleOp> {
+  using ConvertOpToLLVMPattern<aievec::ShuffleOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ShuffleOp shuffleOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto loc = shuffleOp.getLoc();
+    auto lhs = adaptor.getLhs();
+    auto rhs = adaptor.getRhs();
+    auto i32ty = rewriter.getI32Type();
+    auto v16xi32ty = VectorType::get({16}, i32ty);
+    if (!rhs)
+      rhs = rewriter.create<xllvm::UndefV16I32AIE2PIntrOp>(loc, v16xi32ty);
+
+    auto modeAttrVal =
+        rewriter
+            .create<LLVM::ConstantOp>(loc, i32ty,
+                                      static_cast<int32_t>(shuffleOp.getMode()))
+            .getResult();
+    auto vShuffleVal = rewriter
+                           .create<xllvm::VectorShuffleAIE2PIntrOp>(
+                               loc, v16xi32ty,
+                               forceCastOperandsToSignature(
+                                   rewriter, loc,
+                                   /*operands=*/{lhs, rhs, modeAttrVal},
+                                   /*signature=*/{v16xi32ty, v16xi32ty, i32ty}))
+                           .getResult();
+
+    vShuffleVal = forceCastValueToType(rewriter, loc, vShuffleVal,
+                                       shuffleOp.getResult().getType());
+
+    rewriter.replaceOp(shuffleOp, vShuffleVal);
+
+    return success();
+  }
+};
+
+// Only the bf16 <-> accfloat conversions of full 2048-bit accumulators are
+// supported on AIE2P for now.
+class UPSOpAIE2PConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::UPSOp> {
+  using ConvertOpToLLVMPattern<aievec::UPSOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::UPSOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto srcVecTy = cast<VectorType>(adaptor.getSource().getType());
+    auto resultVecTy = cast<VectorType>(op.getResult().getType());
+    if (!srcVecTy.getElementType().isBF16() ||
+        !resultVecTy.getElementType().isF32() ||
+        getVectorLaneSize(srcVecTy) != 64)
+      return rewriter.notifyMatchFailure(op, "unsupported AIE2P ups");
+
+    auto loc = op.getLoc();
+    Value upsVal =
+        rewriter
+            .create<xllvm::Vector64BF16ToV64AccFloatAIE2PIntrOp>(
+                loc, VectorType::get({32}, rewriter.getI64Type()),
+                forceCastOperandsToSignature(
+                    rewriter, loc, {adaptor.getSource()},
+                    {VectorType::get({64}, rewriter.getBF16Type())}))
+            .getResult();
+    rewriter.replaceOp(
+        op, forceCastValueToType(rewriter, loc, upsVal, resultVecTy));
+    return success();
+  }
+};
+
+class SRSOpAIE2PConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::SRSOp> {
+  using ConvertOpToLLVMPattern<aievec::SRSOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::SRSOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto srcVecTy = cast<VectorType>(adaptor.getSource().getType());
+    auto resultVecTy = cast<VectorType>(op.getResult().getType());
+    if (!srcVecTy.getElementType().isF32() ||
+        !resultVecTy.getElementType().isBF16() ||
+        getVectorLaneSize(srcVecTy) != 64)
+      return rewriter.notifyMatchFailure(op, "unsupported AIE2P srs");
+
+    auto loc = op.getLoc();
+    Value srsVal =
+        rewriter
+            .create<xllvm::Vector64AccFloatToV64BF16AIE2PIntrOp>(
+                loc, VectorType::get({64}, rewriter.getBF16Type()),
+                forceCastOperandsToSignature(
+                    rewriter, loc, {adaptor.getSource()},
+                    {VectorType::get({32}, rewriter.getI64Type())}))
+            .getResult();
+    rewriter.replaceOp(
+        op, forceCastValueToType(rewriter, loc, srsVal, resultVecTy));
+    return success();
+  }
+};
+
+void populateAIEVecToLLVMAIE2PConversionPatterns(
+    mlir::LLVMTypeConverter &converter, mlir::RewritePatternSet &patterns) {
+  // clang-format off
+  patterns.add<MatMulAIE2POpConversion,
+               UPSOpAIE2PConversion,
+               SRSOpAIE2PConversion,
+               FoldAIECastOps,
+               ShuffleOpAIE2PConversion>(converter);
+  // clang-format on
+}
+
 void populateAIEVecToLLVMConversionPatterns(
     mlir::LLVMTypeConverter &converter, mlir::RewritePatternSet &patterns,
     Aie2Fp32Emulation aie2Fp32EmulationOption) {
@@ -2361,8 +2625,16 @@ struct ConvertAIEVecToLLVMPass
     converter.addConversion(
         [&](VectorType type) -> std::optional<Type> { return type; });
 
-    populateAIEVecToLLVMConversionPatterns(converter, patterns,
-                                           aie2Fp32Emulation);
+    if (aieTarget == "aie2p") {
+      populateAIEVecToLLVMAIE2PConversionPatterns(converter, patterns);
+    } else if (aieTarget == "aie2") {
+      populateAIEVecToLLVMConversionPatterns(converter, patterns,
+                                             aie2Fp32Emulation);
+    } else {
+      getOperation()->emitError()
+          << "unknown AIE target '" << aieTarget << "'";
+      return signalPassFailure();
+    }
 
     LLVMConversionTarget target(getContext());
     target.addIllegalDialect<xilinx::aievec::AIEVecDialect,
@@ -1142,6 +1142,40 @@ const AIETargetModel &DeviceOp::getTargetModel() {
   return xilinx::AIE::getTargetModel(getDevice());
 }
 
+std::string DeviceOp::getArtifactName() {
+  if (std::optional<StringRef> name = getSymName())
+    return name->str();
+  auto module = (*this)->getParentOfType<ModuleOp>();
+  if (!module)
+    return "device0";
+  int index = 0;
+  for (DeviceOp device : module.getOps<DeviceOp>()) {
+    if (device == *this)
+      break;
+    index++;
+  }
+  std::string name = "device" + std::to_string(index);
+  while (isa_and_nonnull<DeviceOp>(SymbolTable::lookupSymbolIn(module, name)))
+    name += "_";
+  return name;
+}
+
+FailureOr<DeviceOp> DeviceOp::lookup(ModuleOp module, StringRef name) {
+  auto devices = module.getOps<DeviceOp>();
+  if (devices.empty())
+    return module.emitOpError("expected AIE.device operation at toplevel");
+  if (name.empty()) {
+    if (llvm::range_size(devices) > 1)
+      return module.emitOpError("contains several aie.device operations; "
+                                "select one by name");
+    return *devices.begin();
+  }
+  for (DeviceOp device : devices)
+    if (device.getArtifactName() == name)
+      return device;
+  return module.emitOpError("does not contain a device named ") << name;
+}
+
 //===----------------------------------------------------------------------===//
 // TileOp
 //===----------------------------------------------------------------------===//
@@ -1369,6 +1403,10 @@ int ShimDMAOp::rowIndex() { return getTileOp().rowIndex(); }
 LogicalResult PacketRulesOp::verify() {
   if (Region &body = getRules(); body.empty())
     return emitOpError("should have non-empty body");
+  if (llvm::range_size(getRules().front().getOps<PacketRuleOp>()) >
+      numPacketRuleSlots)
+    return emitOpError("cannot hold more than ")
+           << numPacketRuleSlots << " rules";
   return success();
 }
 
@@ -40,7 +40,8 @@ struct AIECanonicalizeDevicePass
     Location location = builder.getUnknownLoc();
     auto deviceOp = builder.create<DeviceOp>(
         location,
-        AIEDeviceAttr::get(builder.getContext(), AIEDevice::xcvc1902));
+        AIEDeviceAttr::get(builder.getContext(), AIEDevice::xcvc1902),
+        /*sym_name=*/nullptr);
 
     deviceOp.getRegion().takeBody(moduleOp.getBodyRegion());
     new (&moduleOp->getRegion(0)) Region(moduleOp);
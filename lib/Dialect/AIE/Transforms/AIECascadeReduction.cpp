@@ -0,0 +1,320 @@
+//===- AIECascadeReduction.cpp ----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/MapVector.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-cascade-reduction"
+
+namespace {
+
+constexpr StringLiteral cascadeReductionAttr = "aie.cascade_reduction";
+
+// The reduction loop of one core of a cascade group.
+struct ReductionLoop {
+  CoreOp core;
+  scf::ForOp loop;
+};
+
+bool isSupportedAccumulator(Type type) {
+  if (auto vectorType = dyn_cast<VectorType>(type))
+    return vectorType.getRank() == 1 &&
+           vectorType.getElementType().isIntOrFloat() &&
+           vectorType.getNumElements() *
+                       vectorType.getElementTypeBitWidth() % 32 ==
+               0;
+  return type.isIntOrFloat() && type.getIntOrFloatBitWidth() % 32 == 0;
+}
+
+// The accumulator is moved over the cascade as 32-bit words, padded to whole
+// cascade transfers.
+VectorType getWordsType(Type type) {
+  int64_t bits;
+  if (auto vectorType = dyn_cast<VectorType>(type))
+    bits = vectorType.getNumElements() * vectorType.getElementTypeBitWidth();
+  else
+    bits = type.getIntOrFloatBitWidth();
+  return VectorType::get({bits / 32}, IntegerType::get(type.getContext(), 32));
+}
+
+// The partial sums of the cores are added up at the end of the cascade, so
+// every iteration must add to the accumulator, and nothing else may read it.
+bool isSumReduction(scf::ForOp loop) {
+  Value acc = loop.getRegionIterArgs().front();
+  auto yield = cast<scf::YieldOp>(loop.getBody()->getTerminator());
+  Operation *update = yield.getOperand(0).getDefiningOp();
+  return isa_and_nonnull<arith::AddFOp, arith::AddIOp>(update) &&
+         update->getBlock() == loop.getBody() && acc.hasOneUse() &&
+         llvm::is_contained(update->getOperands(), acc);
+}
+
+Value combine(OpBuilder &builder, Location loc, Value lhs, Value rhs) {
+  if (isa<FloatType>(getElementTypeOrSelf(lhs.getType())))
+    return builder.create<arith::AddFOp>(loc, lhs, rhs);
+  return builder.create<arith::AddIOp>(loc, lhs, rhs);
+}
+
+struct AIECascadeReductionPass
+    : AIECascadeReductionBase<AIECascadeReductionPass> {
+  int64_t cascadeWords = 0;
+
+  void putCascade(OpBuilder &builder, Location loc, Value value) {
+    VectorType wordsType = getWordsType(value.getType());
+    if (!isa<VectorType>(value.getType()))
+      value = builder.create<vector::BroadcastOp>(
+          loc, VectorType::get({1}, value.getType()), value);
+    Value words = value;
+    if (value.getType() != wordsType)
+      words = builder.create<vector::BitCastOp>(loc, wordsType, value);
+
+    auto cascadeType = VectorType::get({cascadeWords}, builder.getI32Type());
+    int64_t numWords = wordsType.getNumElements();
+    for (int64_t word = 0; word < numWords; word += cascadeWords) {
+      int64_t size = std::min(cascadeWords, numWords - word);
+      Value chunk = words;
+      if (size != numWords)
+        chunk = builder.create<vector::ExtractStridedSliceOp>(
+            loc, words, ArrayRef<int64_t>{word}, ArrayRef<int64_t>{size},
+            ArrayRef<int64_t>{1});
+      if (size != cascadeWords)
+        chunk = builder.create<vector::InsertStridedSliceOp>(
+            loc, chunk,
+            builder.create<arith::ConstantOp>(
+                loc, cascadeType, builder.getZeroAttr(cascadeType)),
+            ArrayRef<int64_t>{0}, ArrayRef<int64_t>{1});
+      builder.create<PutCascadeOp>(loc, chunk);
+    }
+  }
+
+  Value getCascade(OpBuilder &builder, Location loc, Type type) {
+    VectorType wordsType = getWordsType(type);
+    Value words;
+
+    auto cascadeType = VectorType::get({cascadeWords}, builder.getI32Type());
+    int64_t numWords = wordsType.getNumElements();
+    for (int64_t word = 0; word < numWords; word += cascadeWords) {
+      int64_t size = std::min(cascadeWords, numWords - word);
+      Value chunk = builder.create<GetCascadeOp>(loc, cascadeType);
+      if (size != cascadeWords)
+        chunk = builder.create<vector::ExtractStridedSliceOp>(
+            loc, chunk, ArrayRef<int64_t>{0}, ArrayRef<int64_t>{size},
+            ArrayRef<int64_t>{1});
+      if (size == numWords) {
+        words = chunk;
+        continue;
+      }
+      if (!words)
+        words = builder.create<arith::ConstantOp>(
+            loc, wordsType, builder.getZeroAttr(wordsType));
+      words = builder.create<vector::InsertStridedSliceOp>(
+          loc, chunk, words, ArrayRef<int64_t>{word}, ArrayRef<int64_t>{1});
+    }
+
+    if (type == wordsType)
+      return words;
+    if (isa<VectorType>(type))
+      return builder.create<vector::BitCastOp>(loc, type, words);
+    Value value = builder.create<vector::BitCastOp>(
+        loc, VectorType::get({1}, type), words);
+    return builder.create<vector::ExtractOp>(loc, value, 0);
+  }
+
+  // Gives every loop of the group an equal, consecutive share of the
+  // iterations of the original loop. Only the first one starts from the
+  // initial value of the accumulator, the others start from zero, so that the
+  // sum at the end of the cascade is the result of the original loop.
+  LogicalResult partitionIterations(StringAttr group,
+                                    ArrayRef<ReductionLoop> loops) {
+    scf::ForOp first = loops.front().loop;
+    std::optional<int64_t> lb = getConstantIntValue(first.getLowerBound());
+    std::optional<int64_t> ub = getConstantIntValue(first.getUpperBound());
+    std::optional<int64_t> step = getConstantIntValue(first.getStep());
+    if (!lb || !ub || !step)
+      return first.emitOpError("cascade reduction to partition must have "
+                               "constant bounds and step");
+
+    // Each core only computes a share of the sum, which is complete in the
+    // last core alone.
+    for (ReductionLoop reduction : llvm::drop_end(loops))
+      if (!reduction.loop.getResult(0).use_empty())
+        return reduction.loop.emitOpError(
+                   "cascade reduction to partition must not use its result "
+                   "outside the last core of group '")
+               << group.getValue() << "'";
+    for (ReductionLoop reduction : loops)
+      if (getConstantIntValue(reduction.loop.getLowerBound()) != lb ||
+          getConstantIntValue(reduction.loop.getUpperBound()) != ub ||
+          getConstantIntValue(reduction.loop.getStep()) != step)
+        return reduction.loop.emitOpError(
+            "cascade reduction to partition must have the same bounds and "
+            "step in every core");
+
+    int64_t tripCount = std::max<int64_t>(0, (*ub - *lb + *step - 1) / *step);
+    int64_t numLoops = loops.size();
+    if (tripCount % numLoops != 0)
+      return first.emitOpError("trip count ")
+             << tripCount << " does not divide into " << numLoops
+             << " cascaded cores";
+
+    int64_t chunk = tripCount / numLoops * *step;
+    for (int64_t i = 0; i < numLoops; i++) {
+      scf::ForOp loop = loops[i].loop;
+      OpBuilder builder(loop);
+      Type type = loop.getLowerBound().getType();
+      loop.setLowerBound(builder.create<arith::ConstantOp>(
+          loop.getLoc(), builder.getIntegerAttr(type, *lb + i * chunk)));
+      loop.setUpperBound(builder.create<arith::ConstantOp>(
+          loop.getLoc(), builder.getIntegerAttr(type, *lb + (i + 1) * chunk)));
+      if (i > 0) {
+        Type accType = loop.getResult(0).getType();
+        loop.getInitArgsMutable()[0].set(builder.create<arith::ConstantOp>(
+            loop.getLoc(), accType, builder.getZeroAttr(accType)));
+      }
+    }
+    return success();
+  }
+
+  LogicalResult chainGroup(DeviceOp device, StringAttr group,
+                           SmallVector<ReductionLoop> &loops) {
+    if (loops.size() < 2)
+      return loops.front().loop.emitOpError("cascade reduction group '")
+             << group.getValue() << "' needs at least two cores";
+
+    // Cascades run from West to East along a row and from North to South
+    // along a column.
+    auto tileOf = [](ReductionLoop reduction) {
+      return reduction.core.getTileOp();
+    };
+    bool sameRow = llvm::all_of(loops, [&](const ReductionLoop &reduction) {
+      return tileOf(reduction).getRow() == tileOf(loops.front()).getRow();
+    });
+    llvm::sort(loops, [&](const ReductionLoop &a, const ReductionLoop &b) {
+      if (sameRow)
+        return tileOf(a).getCol() < tileOf(b).getCol();
+      return tileOf(a).getRow() > tileOf(b).getRow();
+    });
+
+    const auto &targetModel = device.getTargetModel();
+    Type accType = loops.front().loop.getResult(0).getType();
+    for (auto [src, dst] : llvm::zip(loops, llvm::drop_begin(loops))) {
+      TileOp srcTile = tileOf(src);
+      TileOp dstTile = tileOf(dst);
+      if (!targetModel.isEast(srcTile.getCol(), srcTile.getRow(),
+                              dstTile.getCol(), dstTile.getRow()) &&
+          !targetModel.isSouth(srcTile.getCol(), srcTile.getRow(),
+                               dstTile.getCol(), dstTile.getRow()))
+        return dst.loop.emitOpError("cascade reduction group '")
+               << group.getValue()
+               << "' must span adjacent cores of one row or column";
+      if (dst.loop.getResult(0).getType() != accType)
+        return dst.loop.emitOpError("cascade reduction group '")
+               << group.getValue() << "' must use one accumulator type";
+    }
+
+    for (CascadeFlowOp flow : device.getOps<CascadeFlowOp>())
+      for (const ReductionLoop &reduction : loops)
+        if (flow.getSourceTileOp() == tileOf(reduction) ||
+            flow.getDestTileOp() == tileOf(reduction))
+          return flow.emitOpError("tile already used by cascade reduction "
+                                  "group '")
+                 << group.getValue() << "'";
+
+    if (clPartitionK && failed(partitionIterations(group, loops)))
+      return failure();
+
+    // Every core finishes its own partial sum before it waits for the one of
+    // its predecessor, so the cores only serialize on the final additions.
+    for (auto [i, reduction] : llvm::enumerate(loops)) {
+      scf::ForOp loop = reduction.loop;
+      OpBuilder builder(loop->getContext());
+      builder.setInsertionPointAfter(loop);
+      Value partial = loop.getResult(0);
+      Value sum = partial;
+      if (i > 0) {
+        sum = combine(builder, loop.getLoc(), partial,
+                      getCascade(builder, loop.getLoc(), accType));
+        partial.replaceAllUsesExcept(sum, sum.getDefiningOp());
+      }
+      if (i + 1 < loops.size())
+        putCascade(builder, loop.getLoc(), sum);
+      loop->removeAttr(cascadeReductionAttr);
+    }
+
+    OpBuilder builder = OpBuilder::atBlockTerminator(device.getBody());
+    for (auto [src, dst] : llvm::zip(loops, llvm::drop_begin(loops)))
+      builder.create<CascadeFlowOp>(builder.getUnknownLoc(), tileOf(src),
+                                    tileOf(dst));
+    return success();
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    cascadeWords = device.getTargetModel().getAccumulatorCascadeSize() / 32;
+
+    llvm::MapVector<StringAttr, SmallVector<ReductionLoop>> groups;
+    WalkResult result = device.walk([&](scf::ForOp loop) {
+      auto group = loop->getAttrOfType<StringAttr>(cascadeReductionAttr);
+      if (!group)
+        return WalkResult::advance();
+      auto core = loop->getParentOfType<CoreOp>();
+      if (!core) {
+        loop.emitOpError("cascade reduction must be in an aie.core");
+        return WalkResult::interrupt();
+      }
+      if (loop.getNumResults() != 1 ||
+          !isSupportedAccumulator(loop.getResult(0).getType())) {
+        loop.emitOpError("cascade reduction must carry a single integer or "
+                         "float accumulator of a multiple of 32 bits");
+        return WalkResult::interrupt();
+      }
+      if (!isSumReduction(loop)) {
+        loop.emitOpError("cascade reduction must yield an arith.addf or "
+                         "arith.addi of its accumulator");
+        return WalkResult::interrupt();
+      }
+      SmallVector<ReductionLoop> &loops = groups[group];
+      if (llvm::any_of(loops, [&](const ReductionLoop &reduction) {
+            return reduction.core == core;
+          })) {
+        loop.emitOpError("core already has a loop in cascade reduction "
+                         "group '")
+            << group.getValue() << "'";
+        return WalkResult::interrupt();
+      }
+      loops.push_back({core, loop});
+      return WalkResult::advance();
+    });
+    if (result.wasInterrupted())
+      return signalPassFailure();
+
+    for (auto &[group, loops] : groups)
+      if (failed(chainGroup(device, group, loops)))
+        return signalPassFailure();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIECascadeReductionPass() {
+  return std::make_unique<AIECascadeReductionPass>();
+}
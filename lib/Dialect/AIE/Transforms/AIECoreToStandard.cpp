@@ -172,6 +172,18 @@ struct AIEDebugOpToStdLowering : OpConversionPattern<DebugOp> {
   }
 };
 
+// A vector of `numWords` 32-bit words, the unit vectors are streamed in.
+static VectorType getStreamWordsType(VectorType type) {
+  int64_t numWords = type.getNumElements() * type.getElementTypeBitWidth() / 32;
+  return VectorType::get({numWords}, IntegerType::get(type.getContext(), 32));
+}
+
+// AIE1 cores can access a stream 128 bits at a time, AIE2 cores only have
+// 32-bit stream accesses.
+static bool hasWideStreams(const AIETargetModel &targetModel) {
+  return targetModel.getTargetArch() == AIEArch::AIE1;
+}
+
 struct AIEPutStreamToStdLowering : OpConversionPattern<PutStreamOp> {
   using OpConversionPattern::OpConversionPattern;
   ModuleOp &module;
@@ -180,9 +192,8 @@ struct AIEPutStreamToStdLowering : OpConversionPattern<PutStreamOp> {
                             PatternBenefit benefit = 1)
       : OpConversionPattern(context, benefit), module(m) {}
 
-  LogicalResult
-  matchAndRewrite(PutStreamOp op, OpAdaptor adaptor,
-                  ConversionPatternRewriter &rewriter) const override {
+  LogicalResult createPut(PutStreamOp op, Value channel, Value value,
+                          ConversionPatternRewriter &rewriter) const {
     auto device = op->getParentOfType<DeviceOp>();
     const auto &targetModel = device.getTargetModel();
     std::string funcName;
@@ -191,9 +202,9 @@ struct AIEPutStreamToStdLowering : OpConversionPattern<PutStreamOp> {
     else
       funcName = "llvm.aie2.put.";
 
-    if (op.isWideStream())
+    if (value.getType().isInteger(128))
       funcName += "wms";
-    else if (op.isFloatStream())
+    else if (isa<FloatType>(value.getType()))
       funcName += "fms";
     else
       funcName += "ms";
@@ -204,15 +215,54 @@ struct AIEPutStreamToStdLowering : OpConversionPattern<PutStreamOp> {
              << funcName;
     SmallVector<Value, 2> args;
     if (targetModel.getTargetArch() == AIEArch::AIE1) {
-      args.push_back(op.getChannel());
-      args.push_back(op.getStreamValue());
+      args.push_back(channel);
+      args.push_back(value);
     } else {
-      args.push_back(op.getStreamValue());
+      args.push_back(value);
       args.push_back(rewriter.create<arith::ConstantOp>(
           op.getLoc(), IntegerType::get(rewriter.getContext(), 32),
           rewriter.getI32IntegerAttr(0))); // tlast
     }
     rewriter.create<func::CallOp>(rewriter.getUnknownLoc(), putMSFunc, args);
+    return success();
+  }
+
+  LogicalResult
+  matchAndRewrite(PutStreamOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!op.isVectorStream()) {
+      if (failed(createPut(op, op.getChannel(), op.getStreamValue(), rewriter)))
+        return failure();
+      rewriter.eraseOp(op);
+      return success();
+    }
+
+    // Send the vector as 128-bit chunks where the target supports them, and
+    // the remaining words one at a time.
+    Location loc = op.getLoc();
+    VectorType wordsType =
+        getStreamWordsType(cast<VectorType>(op.getStreamValue().getType()));
+    Value words = rewriter.create<vector::BitCastOp>(loc, wordsType,
+                                                     op.getStreamValue());
+    int64_t numWords = wordsType.getNumElements();
+    int64_t word = 0;
+    if (hasWideStreams(op->getParentOfType<DeviceOp>().getTargetModel())) {
+      auto wideType = VectorType::get({1}, rewriter.getIntegerType(128));
+      for (; word + 4 <= numWords; word += 4) {
+        Value chunk = rewriter.create<vector::ExtractStridedSliceOp>(
+            loc, words, ArrayRef<int64_t>{word}, ArrayRef<int64_t>{4},
+            ArrayRef<int64_t>{1});
+        Value wide = rewriter.create<vector::ExtractOp>(
+            loc, rewriter.create<vector::BitCastOp>(loc, wideType, chunk), 0);
+        if (failed(createPut(op, op.getChannel(), wide, rewriter)))
+          return failure();
+      }
+    }
+    for (; word < numWords; word++) {
+      Value value = rewriter.create<vector::ExtractOp>(loc, words, word);
+      if (failed(createPut(op, op.getChannel(), value, rewriter)))
+        return failure();
+    }
     rewriter.eraseOp(op);
     return success();
   }
@@ -226,9 +276,8 @@ struct AIEGetStreamToStdLowering : OpConversionPattern<GetStreamOp> {
                             PatternBenefit benefit = 1)
       : OpConversionPattern(context, benefit), module(m) {}
 
-  LogicalResult
-  matchAndRewrite(GetStreamOp op, OpAdaptor adaptor,
-                  ConversionPatternRewriter &rewriter) const override {
+  FailureOr<Value> createGet(GetStreamOp op, Value channel, Type type,
+                             ConversionPatternRewriter &rewriter) const {
     auto device = op->getParentOfType<DeviceOp>();
     const auto &targetModel = device.getTargetModel();
     std::string funcName;
@@ -237,9 +286,9 @@ struct AIEGetStreamToStdLowering : OpConversionPattern<GetStreamOp> {
     else
       funcName = "llvm.aie2.get.";
 
-    if (op.isWideStream())
+    if (type.isInteger(128))
       funcName += "wss";
-    else if (op.isFloatStream())
+    else if (isa<FloatType>(type))
       funcName += "fss";
     else
       funcName += "ss";
@@ -250,11 +299,57 @@ struct AIEGetStreamToStdLowering : OpConversionPattern<GetStreamOp> {
              << funcName;
     SmallVector<Value, 2> args;
     if (targetModel.getTargetArch() == AIEArch::AIE1)
-      args.push_back(op.getChannel());
+      args.push_back(channel);
     auto getSSCall = rewriter.create<func::CallOp>(rewriter.getUnknownLoc(),
                                                    getSSFunc, args);
-    rewriter.replaceOp(op, getSSCall.getResult(0));
     // Capture TLAST in AIEv2?
+    return getSSCall.getResult(0);
+  }
+
+  LogicalResult
+  matchAndRewrite(GetStreamOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!op.isVectorStream()) {
+      FailureOr<Value> value = createGet(
+          op, op.getChannel(), op.getStreamValue().getType(), rewriter);
+      if (failed(value))
+        return failure();
+      rewriter.replaceOp(op, *value);
+      return success();
+    }
+
+    // Receive the vector in the same chunks as AIEPutStreamToStdLowering
+    // sends it.
+    Location loc = op.getLoc();
+    auto vectorType = cast<VectorType>(op.getStreamValue().getType());
+    VectorType wordsType = getStreamWordsType(vectorType);
+    Value words = rewriter.create<arith::ConstantOp>(
+        loc, wordsType, rewriter.getZeroAttr(wordsType));
+    int64_t numWords = wordsType.getNumElements();
+    int64_t word = 0;
+    if (hasWideStreams(op->getParentOfType<DeviceOp>().getTargetModel())) {
+      Type wideType = rewriter.getIntegerType(128);
+      for (; word + 4 <= numWords; word += 4) {
+        FailureOr<Value> wide =
+            createGet(op, op.getChannel(), wideType, rewriter);
+        if (failed(wide))
+          return failure();
+        Value chunk = rewriter.create<vector::BroadcastOp>(
+            loc, VectorType::get({1}, wideType), *wide);
+        chunk = rewriter.create<vector::BitCastOp>(
+            loc, VectorType::get({4}, rewriter.getI32Type()), chunk);
+        words = rewriter.create<vector::InsertStridedSliceOp>(
+            loc, chunk, words, ArrayRef<int64_t>{word}, ArrayRef<int64_t>{1});
+      }
+    }
+    for (; word < numWords; word++) {
+      FailureOr<Value> value =
+          createGet(op, op.getChannel(), rewriter.getI32Type(), rewriter);
+      if (failed(value))
+        return failure();
+      words = rewriter.create<vector::InsertOp>(loc, *value, words, word);
+    }
+    rewriter.replaceOpWithNewOp<vector::BitCastOp>(op, vectorType, words);
     return success();
   }
 };
@@ -528,11 +623,14 @@ struct AIECoreToStandardPass : AIECoreToStandardBase<AIECoreToStandardPass> {
     ModuleOp m = getOperation();
     OpBuilder builder = OpBuilder::atBlockEnd(m.getBody());
 
-    if (m.getOps<DeviceOp>().empty()) {
-      m.emitOpError("expected AIE.device operation at toplevel");
+    FailureOr<DeviceOp> selected = DeviceOp::lookup(m, deviceName);
+    if (failed(selected))
       return signalPassFailure();
-    }
-    DeviceOp device = *m.getOps<DeviceOp>().begin();
+    DeviceOp device = *selected;
+    // The cores of the other devices end up in other ELFs.
+    for (DeviceOp other : llvm::make_early_inc_range(m.getOps<DeviceOp>()))
+      if (other != device)
+        other.erase();
     const auto &targetModel = device.getTargetModel();
 
     // Ensure that we don't have an incorrect target triple.  This may override
@@ -15,9 +15,13 @@
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ToolOutputFile.h"
 
 using namespace mlir;
 using namespace xilinx;
@@ -377,6 +381,9 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
   // A map from Tile and master selectValue to the ports targetted by that
   // master select.
   DenseMap<std::pair<Operation *, int>, SmallVector<Port, 4>> masterAMSels;
+  // The amsels in use on each tile, in the order they were allocated, so that
+  // a flow is only compared with the amsels of its own tile.
+  DenseMap<Operation *, SmallVector<int, 8>> tileAMSels;
 
   // Count of currently used logical arbiters for each tile.
   DenseMap<Operation *, int> amselValues;
@@ -393,10 +400,7 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
   };
   // Get a new unique amsel from masterAMSels on tile op. Prioritize on
   // incrementing arbiter id, before incrementing msel
-  auto getNewUniqueAmsel = [&](DenseMap<std::pair<Operation *, int>,
-                                        SmallVector<Port, 4>>
-                                   masterAMSels,
-                               Operation *tileOp, bool isCtrlPkt) {
+  auto getNewUniqueAmsel = [&](Operation *tileOp, bool isCtrlPkt) {
     if (isCtrlPkt) { // Higher AMsel first
       for (int i = numMsels - 1; i >= 0; i--)
         for (int a = numArbiters - 1; a >= 0; a--)
@@ -412,18 +416,15 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
     return -1;
   };
   // Get a new unique amsel from masterAMSels on tile op with given arbiter id
-  auto getNewUniqueAmselPerArbiterID =
-      [&](DenseMap<std::pair<Operation *, int>, SmallVector<Port, 4>>
-              masterAMSels,
-          Operation *tileOp, int arbiter) {
-        for (int i = 0; i < numMsels; i++)
-          if (!masterAMSels.count(
-                  {tileOp, getAmselFromArbiterIDAndMsel(arbiter, i)}))
-            return getAmselFromArbiterIDAndMsel(arbiter, i);
-        tileOp->emitOpError("tile op arbiter ")
-            << std::to_string(arbiter) << "has used up all its msels";
-        return -1;
-      };
+  auto getNewUniqueAmselPerArbiterID = [&](Operation *tileOp, int arbiter) {
+    for (int i = 0; i < numMsels; i++)
+      if (!masterAMSels.count(
+              {tileOp, getAmselFromArbiterIDAndMsel(arbiter, i)}))
+        return getAmselFromArbiterIDAndMsel(arbiter, i);
+    tileOp->emitOpError("tile op arbiter ")
+        << std::to_string(arbiter) << "has used up all its msels";
+    return -1;
+  };
 
   // Sorting the packet flows in order to get determinsitic amsel allocation;
   // allocate amsels for control packet flows before others to ensure
@@ -511,13 +512,11 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
     int foundPartialMatchArbiter =
         -1; // This switchbox's output channels match partially with an
             // existing amsel entry on this arbiter ID (-1 means null).
-    for (const auto &map : masterAMSels) {
-      if (map.first.first != tileOp)
-        continue;
-      amselValue = map.first.second;
+    for (int usedAmsel : tileAMSels[tileOp]) {
+      amselValue = usedAmsel;
 
       // check if same destinations
-      SmallVector<Port, 4> ports(masterAMSels[{tileOp, amselValue}]);
+      const SmallVector<Port, 4> &ports = masterAMSels[{tileOp, amselValue}];
 
       // check for complete/partial overlapping amsel -> port mapping with any
       // previous amsel assignments
@@ -556,8 +555,9 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
             return ctrlPktFlows[{{tileOp, port}, packetFlow.first.second}];
           });
 
-      amselValue = getNewUniqueAmsel(masterAMSels, tileOp, ctrlPktAMsel);
+      amselValue = getNewUniqueAmsel(tileOp, ctrlPktAMsel);
       // Update masterAMSels with new amsel
+      tileAMSels[tileOp].push_back(amselValue);
       for (auto dest : packetFlow.second) {
         Port port = dest.second;
         masterAMSels[{tileOp, amselValue}].push_back(port);
@@ -565,9 +565,10 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
     } else if (foundPartialMatchArbiter >= 0) {
       // This packet flow switchbox's output ports partially overlaps with
       // some existing amsel. Creating a new amsel with the same arbiter.
-      amselValue = getNewUniqueAmselPerArbiterID(masterAMSels, tileOp,
-                                                 foundPartialMatchArbiter);
+      amselValue =
+          getNewUniqueAmselPerArbiterID(tileOp, foundPartialMatchArbiter);
       // Update masterAMSels with new amsel
+      tileAMSels[tileOp].push_back(amselValue);
       for (auto dest : packetFlow.second) {
         Port port = dest.second;
         masterAMSels[{tileOp, amselValue}].push_back(port);
@@ -581,12 +582,16 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
   // Compute the master set IDs
   // A map from a switchbox output port to the number of that port.
   DenseMap<PhysPort, SmallVector<int, 4>> mastersets;
+  // The master ports of each tile that have a master set.
+  DenseMap<Operation *, SmallVector<Port, 4>> tileMasterPorts;
   for (const auto &[physPort, ports] : masterAMSels) {
     Operation *tileOp = physPort.first;
     assert(tileOp);
     int amselValue = physPort.second;
     for (auto port : ports) {
       PhysPort pp = {tileOp, port};
+      if (mastersets[pp].empty())
+        tileMasterPorts[tileOp].push_back(port);
       mastersets[pp].push_back(amselValue);
     }
   }
@@ -611,94 +616,90 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
   // Merging as many stream flows as possible
   // The flows must originate from the same source port and have different IDs
   // Two flows can be merged if they share the same destinations
+  // The groups are looked up by their slave port and set of destinations.
   SmallVector<SmallVector<std::pair<PhysPort, int>, 4>, 4> slaveGroups;
+  std::map<std::pair<Port, SmallVector<PhysPort, 4>>, size_t> slaveGroupIndex;
   SmallVector<std::pair<PhysPort, int>, 4> workList(slavePorts);
   while (!workList.empty()) {
-    auto slave1 = workList.pop_back_val();
-    Port slavePort1 = slave1.first.second;
-
-    bool foundgroup = false;
-    for (auto &group : slaveGroups) {
-      auto slave2 = group.front();
-      if (Port slavePort2 = slave2.first.second; slavePort1 != slavePort2)
-        continue;
+    auto slave = workList.pop_back_val();
+    SmallVector<PhysPort, 4> dests = packetFlows[slave];
+    llvm::sort(dests);
+    std::pair<Port, SmallVector<PhysPort, 4>> key(slave.first.second,
+                                                  std::move(dests));
+    auto [it, inserted] =
+        slaveGroupIndex.try_emplace(std::move(key), slaveGroups.size());
+    if (inserted)
+      slaveGroups.emplace_back();
+    slaveGroups[it->second].push_back(slave);
+  }
 
-      bool matched = true;
-      auto dests1 = packetFlows[slave1];
-      auto dests2 = packetFlows[slave2];
-      if (dests1.size() != dests2.size())
+  // Cover the IDs of every group with packet rules. A rule may match any ID
+  // that does not reach its slave port, but none of the other groups of the
+  // port, so a group may need several rules.
+  DenseMap<PhysPort, SmallVector<size_t, 4>> slaveGroupsOfPort;
+  for (const auto &[index, group] : llvm::enumerate(slaveGroups))
+    slaveGroupsOfPort[group.front().first].push_back(index);
+  SmallVector<SmallVector<PacketIDCube>, 4> slaveCovers;
+  for (const auto &[index, group] : llvm::enumerate(slaveGroups)) {
+    SmallVector<int> ids, excluded;
+    for (const auto &port : group)
+      ids.push_back(port.second);
+    for (size_t other : slaveGroupsOfPort[group.front().first]) {
+      if (other == index)
         continue;
-
-      for (auto dest1 : dests1) {
-        if (std::find(dests2.begin(), dests2.end(), dest1) == dests2.end()) {
-          matched = false;
-          break;
-        }
-      }
-
-      if (matched) {
-        group.push_back(slave1);
-        foundgroup = true;
-        break;
-      }
-    }
-
-    if (!foundgroup) {
-      SmallVector<std::pair<PhysPort, int>, 4> group({slave1});
-      slaveGroups.push_back(group);
+      for (const auto &port : slaveGroups[other])
+        excluded.push_back(port.second);
     }
+    slaveCovers.push_back(coverPacketIDs(ids, excluded));
   }
 
-  DenseMap<std::pair<PhysPort, int>, int> slaveMasks;
-  for (const auto &group : slaveGroups) {
-    // Iterate over all the ID values in a group
-    // If bit n-th (n <= 5) of an ID value differs from bit n-th of another ID
-    // value, the bit position should be "don't care", and we will set the
-    // mask bit of that position to 0
-    int mask[5] = {-1, -1, -1, -1, -1};
-    for (auto port : group) {
-      int ID = port.second;
-      for (int i = 0; i < 5; i++) {
-        if (mask[i] == -1)
-          mask[i] = ID >> i & 0x1;
-        else if (mask[i] != (ID >> i & 0x1))
-          mask[i] = 2; // found bit difference --> mark as "don't care"
-      }
-    }
-
-    int maskValue = 0;
-    for (int i = 4; i >= 0; i--) {
-      if (mask[i] == 2) // don't care
-        mask[i] = 0;
-      else
-        mask[i] = 1;
-      maskValue = (maskValue << 1) + mask[i];
-    }
-    for (auto port : group)
-      slaveMasks[port] = maskValue;
+  // A slave port holds at most numPacketRuleSlots rules, including those the
+  // design already placed on it.
+  DenseMap<PhysPort, int> usedRuleSlots;
+  for (auto switchbox : device.getOps<SwitchboxOp>())
+    for (auto rules : switchbox.getOps<PacketRulesOp>())
+      usedRuleSlots[{switchbox.getTileOp(), rules.sourcePort()}] +=
+          llvm::range_size(rules.getRules().front().getOps<PacketRuleOp>());
+  DenseMap<PhysPort, int> neededRuleSlots;
+  for (const auto &[group, cover] : llvm::zip(slaveGroups, slaveCovers))
+    neededRuleSlots[group.front().first] += cover.size();
+  bool outOfRuleSlots = false;
+  for (const auto &[slave, needed] : neededRuleSlots) {
+    int freeSlots = numPacketRuleSlots - usedRuleSlots.lookup(slave);
+    if (needed <= freeSlots)
+      continue;
+    slave.first->emitOpError("needs ")
+        << needed << " packet rules on slave port "
+        << stringifyWireBundle(slave.second.bundle) << " : "
+        << slave.second.channel << ", but only " << freeSlots << " of "
+        << numPacketRuleSlots << " rule slots are free";
+    outOfRuleSlots = true;
   }
+  if (outOfRuleSlots)
+    return signalPassFailure();
 
 #ifndef NDEBUG
   LLVM_DEBUG(llvm::dbgs() << "CHECK Slave Masks\n");
-  for (auto map : slaveMasks) {
-    auto port = map.first.first;
+  for (const auto &[group, cover] : llvm::zip(slaveGroups, slaveCovers)) {
+    auto port = group.front().first;
     auto tile = dyn_cast<TileOp>(port.first);
     WireBundle bundle = port.second.bundle;
     int channel = port.second.channel;
-    int ID = map.first.second;
-    int mask = map.second;
 
     LLVM_DEBUG(llvm::dbgs()
                << "Port " << tile << " " << stringifyWireBundle(bundle) << " "
                << channel << '\n');
-    LLVM_DEBUG(llvm::dbgs() << "Mask "
-                            << "0x" << llvm::Twine::utohexstr(mask) << '\n');
-    LLVM_DEBUG(llvm::dbgs() << "ID "
-                            << "0x" << llvm::Twine::utohexstr(ID) << '\n');
-    for (int i = 0; i < 31; i++) {
-      if ((i & mask) == (ID & mask))
-        LLVM_DEBUG(llvm::dbgs() << "matches flow ID "
-                                << "0x" << llvm::Twine::utohexstr(i) << '\n');
+    for (PacketIDCube cube : cover) {
+      LLVM_DEBUG(llvm::dbgs() << "Mask "
+                              << "0x" << llvm::Twine::utohexstr(cube.mask)
+                              << " ID "
+                              << "0x" << llvm::Twine::utohexstr(cube.value)
+                              << '\n');
+      for (int i = 0; i < 31; i++) {
+        if (cube.matches(i))
+          LLVM_DEBUG(llvm::dbgs() << "matches flow ID "
+                                  << "0x" << llvm::Twine::utohexstr(i) << '\n');
+      }
     }
   }
 #endif
@@ -718,14 +719,9 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
     builder.setInsertionPoint(b.getTerminator());
 
     std::vector<bool> amselOpNeededVector(numMsels * numArbiters);
-    for (const auto &map : mastersets) {
-      if (tileOp != map.first.first)
-        continue;
-
-      for (auto value : map.second) {
+    for (Port master : tileMasterPorts.lookup(tileOp))
+      for (auto value : mastersets[{tileOp, master}])
         amselOpNeededVector[value] = true;
-      }
-    }
     // Create all the amsel Ops
     DenseMap<int, AMSelOp> amselOps;
     for (int i = 0; i < numMsels; i++) {
@@ -742,12 +738,7 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
     }
     // Create all the master set Ops
     // First collect the master sets for this tile.
-    SmallVector<Port, 4> tileMasters;
-    for (const auto &map : mastersets) {
-      if (tileOp != map.first.first)
-        continue;
-      tileMasters.push_back(map.first.second);
-    }
+    SmallVector<Port, 4> tileMasters = tileMasterPorts.lookup(tileOp);
     // Sort them so we get a reasonable order
     std::sort(tileMasters.begin(), tileMasters.end());
     for (auto tileMaster : tileMasters) {
@@ -765,9 +756,11 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
           amsels, keepPktHeaderAttr[{tileOp, tileMaster}]);
     }
 
-    // Generate the packet rules
+    // Generate the packet rules, next to those the design already has.
     DenseMap<Port, PacketRulesOp> slaveRules;
-    for (auto group : slaveGroups) {
+    for (auto rules : swbox.getOps<PacketRulesOp>())
+      slaveRules[rules.sourcePort()] = rules;
+    for (const auto &[group, cover] : llvm::zip(slaveGroups, slaveCovers)) {
       builder.setInsertionPoint(b.getTerminator());
 
       auto port = group.front().first;
@@ -778,13 +771,12 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
       int channel = port.second.channel;
       auto slave = port.second;
 
-      int mask = slaveMasks[group.front()];
-      int ID = group.front().second & mask;
-
       // Verify that we actually map all the ID's correctly.
 #ifndef NDEBUG
       for (auto slave : group)
-        assert((slave.second & mask) == ID);
+        assert(llvm::any_of(cover, [&](PacketIDCube cube) {
+          return cube.matches(slave.second);
+        }));
 #endif
       Value amsel = amselOps[slaveAMSels[group.front()]];
 
@@ -801,10 +793,11 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
       Block &rules = packetrules.getRules().front();
 
       // Verify ID mapping against all other rules of the same slave.
+      int ID = group.front().second;
       for (auto rule : rules.getOps<PacketRuleOp>()) {
         auto verifyMask = rule.maskInt();
         auto verifyValue = rule.valueInt();
-        if ((group.front().second & verifyMask) == verifyValue) {
+        if ((ID & verifyMask) == verifyValue) {
           rule->emitOpError("can lead to false packet id match for id ")
               << ID << ", which is not supposed to pass through this port.";
           rule->emitRemark("Please consider changing all uses of packet id ")
@@ -813,7 +806,9 @@ void AIEPathfinderPass::runOnPacketFlow(DeviceOp device, OpBuilder &builder) {
       }
 
       builder.setInsertionPoint(rules.getTerminator());
-      builder.create<PacketRuleOp>(builder.getUnknownLoc(), mask, ID, amsel);
+      for (PacketIDCube cube : cover)
+        builder.create<PacketRuleOp>(builder.getUnknownLoc(), cube.mask,
+                                     cube.value, amsel);
     }
   }
 
@@ -926,8 +921,42 @@ void AIEPathfinderPass::runOnOperation() {
   LLVM_DEBUG(llvm::dbgs() << "---Begin AIEPathfinderPass---\n");
 
   DeviceOp d = getOperation();
+  if (clRouter == "exact") {
+    analyzer.pathfinder = std::make_shared<ExactRouter>(
+        std::chrono::milliseconds(clRouterTimeout));
+  } else if (clRouter != "pathfinder") {
+    d.emitError("unknown router '") << clRouter << "'";
+    return signalPassFailure();
+  }
+  if (!clCacheDir.empty())
+    analyzer.routingCacheDir = clCacheDir;
+  if (clBalanceLatency)
+    analyzer.balanceLatency = true;
   if (failed(analyzer.runAnalysis(d)))
     return signalPassFailure();
+  if (!clMetricsFile.empty()) {
+    // Every device of a module with several gets a file of its own, with the
+    // name of the device before the extension.
+    SmallString<128> metricsFile(clMetricsFile);
+    auto module = d->getParentOfType<ModuleOp>();
+    if (metricsFile != "-" && module &&
+        !llvm::hasSingleElement(module.getOps<DeviceOp>())) {
+      StringRef extension = llvm::sys::path::extension(clMetricsFile);
+      llvm::sys::path::replace_extension(metricsFile, d.getArtifactName());
+      metricsFile += extension;
+    }
+    std::string errorMessage;
+    std::unique_ptr<llvm::ToolOutputFile> output =
+        openOutputFile(metricsFile, &errorMessage);
+    if (!output) {
+      d.emitError(errorMessage);
+      return signalPassFailure();
+    }
+    output->os() << llvm::formatv(
+                        "{0:2}", getRoutingMetrics(d, analyzer.flowSolutions))
+                 << "\n";
+    output->keep();
+  }
   OpBuilder builder = OpBuilder::atBlockTerminator(d.getBody());
 
   if (clRouteCircuit)
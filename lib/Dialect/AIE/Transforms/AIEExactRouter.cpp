@@ -0,0 +1,378 @@
+//===- AIEExactRouter.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+
+#include <deque>
+#include <functional>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-exact-router"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Link = std::pair<TileID, TileID>;
+using Edge = std::pair<PathEndPoint, PathEndPoint>;
+// A port is either entered from a neighboring switchbox, as an input of its
+// switchbox, or from another port of the same switchbox, as an output.
+using PortUse = std::pair<PathEndPoint, bool /*isOutput*/>;
+
+// Routings compare by their highest link utilization first, and by the
+// number of channels between switchboxes they use second.
+struct Cost {
+  double maxUtilization = 0.0;
+  int hops = 0;
+
+  bool operator<(const Cost &rhs) const {
+    constexpr double epsilon = 1e-9;
+    if (maxUtilization < rhs.maxUtilization - epsilon)
+      return true;
+    if (maxUtilization > rhs.maxUtilization + epsilon)
+      return false;
+    return hops < rhs.hops;
+  }
+};
+
+int manhattanDistance(TileID a, TileID b) {
+  return std::abs(a.col - b.col) + std::abs(a.row - b.row);
+}
+
+} // namespace
+
+struct ExactRouter::Search {
+  // Every destination of every flow is routed along one of its candidate
+  // tile paths. The targets of a flow are consecutive.
+  struct Target {
+    size_t flow;
+    PathEndPoint dst;
+    std::vector<std::vector<TileID>> candidates;
+  };
+
+  // What routing one target added to the partial routing.
+  struct Trail {
+    std::vector<PortUse> claimed;
+    std::vector<Link> used;
+    std::vector<PortUse> reached;
+    size_t numEdges = 0;
+  };
+
+  ExactRouter &router;
+  Clock::time_point deadline;
+  bool timedOut = false;
+
+  std::vector<Target> targets;
+  // A lower bound on the channels between switchboxes the targets from an
+  // index on add to the routing.
+  std::vector<int> remainingHops;
+
+  // The switchboxes connected by at least one channel, and by how many.
+  std::map<TileID, std::vector<TileID>> successors;
+  std::map<TileID, std::vector<TileID>> predecessors;
+  std::map<Link, int> capacity;
+
+  // The partial routing: the flow or packet group that uses every port, how
+  // many channels of every link are used, and the ports every flow reaches.
+  std::map<PortUse, int> owner;
+  std::map<Link, int> usage;
+  std::vector<std::set<PortUse>> trees;
+  std::vector<std::vector<Edge>> edges;
+
+  std::optional<Cost> best;
+  std::vector<std::vector<Edge>> bestEdges;
+
+  Search(ExactRouter &router)
+      : router(router), deadline(Clock::now() + router.timeBudget) {}
+
+  // Packet flows of the same group may share ports, circuit flows may not.
+  int getOwner(size_t flow) {
+    int packetGroupId = router.flows[flow].packetGroupId;
+    return packetGroupId >= 0 ? packetGroupId
+                              : -static_cast<int>(flow) - 2;
+  }
+
+  void buildTileGraph() {
+    for (const auto &[link, sb] : router.graph) {
+      if (link.first == link.second || sb.srcPorts.empty())
+        continue;
+      successors[link.first].push_back(link.second);
+      predecessors[link.second].push_back(link.first);
+      capacity[link] = sb.srcPorts.size();
+    }
+    for (auto &[_, tiles] : successors)
+      llvm::sort(tiles);
+  }
+
+  std::map<TileID, int> getDistancesTo(TileID to) {
+    std::map<TileID, int> distances{{to, 0}};
+    std::deque<TileID> queue{to};
+    while (!queue.empty()) {
+      TileID tile = queue.front();
+      queue.pop_front();
+      int distance = distances[tile] + 1;
+      for (TileID prev : predecessors[tile])
+        if (distances.emplace(prev, distance).second)
+          queue.push_back(prev);
+    }
+    return distances;
+  }
+
+  // The shortest simple tile paths from `from` to `to`, and if there are
+  // fewer than `maxCandidates` of them, those with one detour.
+  std::vector<std::vector<TileID>> getCandidatePaths(TileID from, TileID to) {
+    std::vector<std::vector<TileID>> paths;
+    std::map<TileID, int> distances = getDistancesTo(to);
+    if (!distances.count(from))
+      return paths;
+
+    // Bound the work for paths with detours, most of which dead-end.
+    constexpr int maxExpansions = 10000;
+    int expansions = 0;
+    std::vector<TileID> path{from};
+    std::set<TileID> onPath{from};
+    std::function<void(int)> extend = [&](int length) {
+      TileID tile = path.back();
+      if (tile == to) {
+        if (length == 0)
+          paths.push_back(path);
+        return;
+      }
+      for (TileID next : successors[tile]) {
+        if (paths.size() >= static_cast<size_t>(router.maxCandidates) ||
+            ++expansions > maxExpansions)
+          return;
+        auto distance = distances.find(next);
+        if (distance == distances.end() || distance->second > length - 1 ||
+            onPath.count(next))
+          continue;
+        path.push_back(next);
+        onPath.insert(next);
+        extend(length - 1);
+        onPath.erase(next);
+        path.pop_back();
+      }
+    };
+    // All paths between two tiles of the array have the same parity.
+    extend(distances[from]);
+    extend(distances[from] + 2);
+    return paths;
+  }
+
+  bool claim(const PortUse &use, int key, Trail &trail) {
+    if (!owner.emplace(use, key).second)
+      return false;
+    trail.claimed.push_back(use);
+    return true;
+  }
+
+  // Extends the tree of the flow of `target` by the shortest chain of free
+  // ports along `path` that reaches its destination.
+  bool route(const Target &target, const std::vector<TileID> &path,
+             Trail &trail, Cost &cost) {
+    size_t flow = target.flow;
+    int key = getOwner(flow);
+    std::set<Link> links;
+    for (auto [from, to] : llvm::zip(path, llvm::drop_begin(path)))
+      links.insert({from, to});
+    std::set<TileID> tiles(path.begin(), path.end());
+    auto isFree = [&](const PortUse &use) {
+      auto it = owner.find(use);
+      return it == owner.end() || it->second == key;
+    };
+
+    std::set<PortUse> &tree = trees[flow];
+    if (tree.empty()) {
+      PortUse src{router.flows[flow].src, false};
+      if (!isFree(src))
+        return false;
+      claim(src, key, trail);
+      tree.insert(src);
+      trail.reached.push_back(src);
+    }
+    PortUse dst{target.dst, true};
+    if (tree.count(dst))
+      return true;
+
+    std::map<PortUse, PortUse> preds;
+    std::deque<PortUse> queue;
+    for (const PortUse &use : tree) {
+      if (tiles.count(use.first.coords)) {
+        preds.emplace(use, use);
+        queue.push_back(use);
+      }
+    }
+    bool found = false;
+    while (!queue.empty() && !found) {
+      auto [port, isOutput] = queue.front();
+      queue.pop_front();
+      for (const PathEndPoint &next : router.getChannels(port)) {
+        // Inputs connect to outputs of their switchbox, and outputs to the
+        // inputs of the next switchbox.
+        bool sameSwitchbox = next.coords == port.coords;
+        if (sameSwitchbox == isOutput ||
+            (!sameSwitchbox && !links.count({port.coords, next.coords})))
+          continue;
+        PortUse use{next, sameSwitchbox};
+        if (preds.count(use) || !isFree(use))
+          continue;
+        preds.emplace(use, PortUse{port, isOutput});
+        if (use == dst) {
+          found = true;
+          break;
+        }
+        queue.push_back(use);
+      }
+    }
+    if (!found)
+      return false;
+
+    for (PortUse use = dst; !tree.count(use); use = preds[use]) {
+      const PortUse &pred = preds[use];
+      if (claim(use, key, trail) && !use.second) {
+        Link link{pred.first.coords, use.first.coords};
+        int used = ++usage[link];
+        trail.used.push_back(link);
+        cost.hops++;
+        cost.maxUtilization =
+            std::max(cost.maxUtilization, double(used) / capacity[link]);
+      }
+      edges[flow].push_back({pred.first, use.first});
+      trail.numEdges++;
+      tree.insert(use);
+      trail.reached.push_back(use);
+    }
+    return true;
+  }
+
+  void undo(size_t flow, const Trail &trail) {
+    for (const PortUse &use : trail.claimed)
+      owner.erase(use);
+    for (const Link &link : trail.used)
+      usage[link]--;
+    for (const PortUse &use : trail.reached)
+      trees[flow].erase(use);
+    edges[flow].resize(edges[flow].size() - trail.numEdges);
+  }
+
+  void search(size_t index, const Cost &cost) {
+    if (Clock::now() >= deadline) {
+      timedOut = true;
+      return;
+    }
+    if (best && !(Cost{cost.maxUtilization, cost.hops + remainingHops[index]} <
+                  *best))
+      return;
+    if (index == targets.size()) {
+      best = cost;
+      bestEdges = edges;
+      return;
+    }
+    const Target &target = targets[index];
+    for (const std::vector<TileID> &path : target.candidates) {
+      Trail trail;
+      Cost next = cost;
+      if (route(target, path, trail, next))
+        search(index + 1, next);
+      undo(target.flow, trail);
+      if (timedOut)
+        return;
+    }
+  }
+
+  void run() {
+    buildTileGraph();
+    trees.resize(router.flows.size());
+    edges.resize(router.flows.size());
+
+    // Circuit flows use at least the channels to their farthest destination.
+    // Packet flows may share them with the rest of their group.
+    std::vector<int> flowHops(router.flows.size(), 0);
+    for (const auto &[flow, f] : llvm::enumerate(router.flows)) {
+      for (const PathEndPoint &dst : f.dsts) {
+        if (dst == f.src)
+          continue;
+        if (f.packetGroupId < 0)
+          flowHops[flow] = std::max(
+              flowHops[flow], manhattanDistance(f.src.coords, dst.coords));
+        targets.push_back(
+            {flow, dst, getCandidatePaths(f.src.coords, dst.coords)});
+        if (targets.back().candidates.empty()) {
+          LLVM_DEBUG(llvm::dbgs() << "\t\tExactRouter: no path from "
+                                  << f.src << " to " << dst << "\n");
+          return;
+        }
+      }
+    }
+    remainingHops.assign(targets.size() + 1, 0);
+    for (size_t index = targets.size(); index-- > 0;) {
+      size_t flow = targets[index].flow;
+      bool isFirst = index == 0 || targets[index - 1].flow != flow;
+      remainingHops[index] =
+          remainingHops[index + 1] + (isFirst ? flowHops[flow] : 0);
+    }
+    search(0, Cost{});
+  }
+};
+
+std::string ExactRouter::getSettings() const {
+  return llvm::formatv("router=exact timeout={0}ms candidates={1}",
+                       timeBudget.count(), maxCandidates)
+      .str();
+}
+
+std::optional<std::map<PathEndPoint, SwitchSettings>>
+ExactRouter::findPaths(const int maxIterations) {
+  LLVM_DEBUG(llvm::dbgs() << "\t---Begin ExactRouter::findPaths---\n");
+  Search search(*this);
+  search.run();
+  timedOut = search.timedOut;
+  if (!search.best) {
+    LLVM_DEBUG(llvm::dbgs()
+               << "\t\tExactRouter: no routing found"
+               << (search.timedOut ? " within the time budget" : "")
+               << ", falling back to Pathfinder.\n");
+    return Pathfinder::findPaths(maxIterations);
+  }
+  // The search only tries the candidate paths of each flow, so its best
+  // routing need not be optimal among all routings.
+  LLVM_DEBUG(llvm::dbgs() << "\t\tExactRouter: best routing"
+                          << (search.timedOut ? " found in time" : "")
+                          << " has a maximum link utilization of "
+                          << search.best->maxUtilization << " and uses "
+                          << search.best->hops << " channels.\n");
+
+  std::map<PathEndPoint, SwitchSettings> routingSolution;
+  for (const auto &[flow, flowEdges] : llvm::enumerate(search.bestEdges)) {
+    const Flow &f = flows[flow];
+    SwitchSettings switchSettings;
+    for (const PathEndPoint &dst : f.dsts) {
+      if (dst == f.src) {
+        // route to self
+        switchSettings[f.src.coords].srcs.push_back(f.src.port);
+        switchSettings[f.src.coords].dsts.push_back(f.src.port);
+      }
+    }
+    for (const auto &[pred, curr] : flowEdges) {
+      if (pred.coords == curr.coords) {
+        switchSettings[curr.coords].srcs.push_back(pred.port);
+        switchSettings[curr.coords].dsts.push_back(curr.port);
+      }
+    }
+    routingSolution[f.src] = switchSettings;
+  }
+  return routingSolution;
+}
@@ -0,0 +1,937 @@
+//===- AIEObjectFifoDepthSizing.cpp -----------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/Support/Format.h"
+
+#include <cmath>
+#include <limits>
+#include <map>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-objectFifo-depth-sizing"
+
+namespace {
+
+// Bytes a DMA moves over a stream per cycle.
+constexpr int64_t kStreamBytesPerCycle = 4;
+// Largest number of steps a core program is expanded to.
+constexpr size_t kMaxProgramSteps = 1 << 16;
+// Body iterations simulated before and while measuring the period of an
+// actor.
+constexpr unsigned kWarmupIterations = 8;
+constexpr unsigned kMeasuredIterations = 32;
+constexpr uint64_t kMaxSimulationEvents = 1 << 20;
+// Extra depth given to every channel to approximate unbounded buffers.
+constexpr int kUnboundedDepth = 64;
+
+// An objectFifo endpoint: the producer (0) or consumer i (i + 1).
+using Endpoint = std::pair<Operation *, unsigned>;
+
+// One set of objectFifo buffers. It is written by one actor (the producer
+// side) and read by another (the consumer side). Its depth is the depth of
+// the objectFifo endpoint it was created for.
+struct Channel {
+  ObjectFifoCreateOp fifo;
+  unsigned endpoint;
+  TileOp tile;
+  int64_t elemBytes;
+  int depth;
+  int minDepth = 1;
+  // Channels with initial values keep their depth and start full.
+  bool fixed = false;
+  bool hasProducer = false;
+  bool hasConsumer = false;
+};
+
+enum class StepKind { Acquire, Release, Compute };
+
+struct Step {
+  StepKind kind;
+  unsigned channel = 0;
+  bool produce = false;
+  // Objects for acquires and releases, cycles for computes.
+  int64_t count = 0;
+};
+
+// A core or a DMA, modelled as a program that runs its prologue once and
+// then repeats its body.
+struct Actor {
+  std::string name;
+  SmallVector<Step> prologue;
+  SmallVector<Step> body;
+};
+
+struct SimulationResult {
+  bool deadlock = false;
+  // Cycles per body iteration of each actor; infinite if it stopped.
+  SmallVector<double> period;
+  // Fraction of the simulated time each actor spent computing.
+  SmallVector<double> utilisation;
+  // Cycles producers spent waiting for free objects in each channel.
+  SmallVector<uint64_t> spaceStall;
+};
+
+// Self-timed execution of the actors: every actor runs as soon as the objects
+// it acquires are available.
+SimulationResult simulate(ArrayRef<Actor> actors, ArrayRef<Channel> channels,
+                          ArrayRef<int> depths) {
+  struct ChannelState {
+    int64_t free;
+    int64_t filled;
+    int64_t heldByProducer = 0;
+    int64_t heldByConsumer = 0;
+  };
+  struct ActorState {
+    bool inPrologue;
+    unsigned pc = 0;
+    bool busy = false;
+    uint64_t busyUntil = 0;
+    uint64_t busyCycles = 0;
+    unsigned iterations = 0;
+    uint64_t warmupEnd = 0;
+    uint64_t measureEnd = 0;
+    std::optional<uint64_t> blockedSince;
+    const Step *blockedOn = nullptr;
+  };
+
+  SmallVector<ChannelState> cs;
+  for (auto [channel, depth] : llvm::zip(channels, depths)) {
+    if (channel.fixed)
+      cs.push_back({0, depth});
+    else
+      cs.push_back({depth, 0});
+  }
+  SmallVector<ActorState> as;
+  for (const Actor &actor : actors)
+    as.push_back({!actor.prologue.empty()});
+
+  SimulationResult result;
+  result.spaceStall.assign(channels.size(), 0);
+  const unsigned done = kWarmupIterations + kMeasuredIterations;
+  uint64_t now = 0;
+
+  auto unblock = [&](ActorState &a) {
+    if (!a.blockedSince)
+      return;
+    if (a.blockedOn->produce)
+      result.spaceStall[a.blockedOn->channel] += now - *a.blockedSince;
+    a.blockedSince.reset();
+  };
+
+  for (uint64_t events = 0; events < kMaxSimulationEvents; events++) {
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      for (auto [actor, a] : llvm::zip(actors, as)) {
+        while (!a.busy) {
+          auto &steps = a.inPrologue ? actor.prologue : actor.body;
+          const Step &step = steps[a.pc];
+          if (step.kind == StepKind::Compute) {
+            a.busy = true;
+            a.busyUntil = now + step.count;
+            a.busyCycles += step.count;
+          } else {
+            ChannelState &c = cs[step.channel];
+            int64_t &held =
+                step.produce ? c.heldByProducer : c.heldByConsumer;
+            if (step.kind == StepKind::Acquire) {
+              int64_t &available = step.produce ? c.free : c.filled;
+              int64_t needed = step.count - held;
+              if (needed > available) {
+                if (!a.blockedSince) {
+                  a.blockedSince = now;
+                  a.blockedOn = &step;
+                }
+                break;
+              }
+              unblock(a);
+              if (needed > 0) {
+                available -= needed;
+                held += needed;
+              }
+            } else {
+              int64_t released = std::min(step.count, held);
+              held -= released;
+              (step.produce ? c.filled : c.free) += released;
+              progress = true;
+            }
+          }
+          if (++a.pc < steps.size())
+            continue;
+          a.pc = 0;
+          if (a.inPrologue) {
+            a.inPrologue = false;
+            continue;
+          }
+          if (++a.iterations == kWarmupIterations)
+            a.warmupEnd = a.busy ? a.busyUntil : now;
+          else if (a.iterations == done)
+            a.measureEnd = a.busy ? a.busyUntil : now;
+        }
+      }
+    }
+
+    if (llvm::all_of(as, [&](ActorState &a) { return a.iterations >= done; }))
+      break;
+
+    std::optional<uint64_t> next;
+    for (ActorState &a : as)
+      if (a.busy && (!next || a.busyUntil < *next))
+        next = a.busyUntil;
+    if (!next) {
+      result.deadlock = true;
+      break;
+    }
+    now = *next;
+    for (ActorState &a : as)
+      if (a.busy && a.busyUntil == now)
+        a.busy = false;
+  }
+
+  for (ActorState &a : as) {
+    unblock(a);
+    if (a.iterations >= done)
+      result.period.push_back(double(a.measureEnd - a.warmupEnd) /
+                              kMeasuredIterations);
+    else
+      result.period.push_back(std::numeric_limits<double>::infinity());
+    result.utilisation.push_back(
+        now ? std::min(1.0, double(a.busyCycles) / now) : 0.0);
+  }
+  if (llvm::any_of(result.period, [](double p) { return std::isinf(p); }))
+    result.deadlock = true;
+  return result;
+}
+
+// Sum of the periods of all actors relative to their periods with unbounded
+// buffers.
+double getCost(const SimulationResult &result, ArrayRef<double> ideal) {
+  if (result.deadlock)
+    return std::numeric_limits<double>::infinity();
+  double cost = 0;
+  for (auto [period, best] : llvm::zip(result.period, ideal))
+    cost += best > 0 ? period / best : period;
+  return cost;
+}
+
+bool reachesIdeal(const SimulationResult &result, ArrayRef<double> ideal) {
+  if (result.deadlock)
+    return false;
+  for (auto [period, best] : llvm::zip(result.period, ideal))
+    if (period > best * 1.001 + 1e-9)
+      return false;
+  return true;
+}
+
+// With unbounded channels, actors that do not wait on the slowest actor run
+// ahead of it for the length of a simulation. In the steady state, the actors
+// that are connected by channels iterate at rates fixed by the objects they
+// release per iteration, so their periods follow from the slowest of them.
+SmallVector<double> getSteadyPeriods(ArrayRef<Actor> actors,
+                                     unsigned numChannels,
+                                     ArrayRef<double> periods) {
+  // Actor and objects released per body iteration on each side of a channel.
+  SmallVector<std::pair<unsigned, int64_t>> producer(numChannels, {0, 0});
+  SmallVector<std::pair<unsigned, int64_t>> consumer(numChannels, {0, 0});
+  for (auto [idx, actor] : llvm::enumerate(actors))
+    for (const Step &step : actor.body)
+      if (step.kind == StepKind::Release) {
+        auto &side = step.produce ? producer[step.channel]
+                                  : consumer[step.channel];
+        side = {idx, side.second + step.count};
+      }
+
+  // Iterations of each actor per iteration of the first actor of its
+  // component.
+  SmallVector<double> rate(actors.size(), 0);
+  SmallVector<unsigned> component(actors.size(), 0);
+  for (unsigned root = 0; root < actors.size(); root++) {
+    if (rate[root] > 0)
+      continue;
+    rate[root] = 1;
+    component[root] = root;
+    SmallVector<unsigned> worklist = {root};
+    while (!worklist.empty()) {
+      unsigned a = worklist.pop_back_val();
+      for (unsigned c = 0; c < numChannels; c++) {
+        auto [p, produced] = producer[c];
+        auto [q, consumed] = consumer[c];
+        if (!produced || !consumed)
+          continue;
+        auto visit = [&](unsigned from, unsigned to, double ratio) {
+          if (from != a || rate[to] > 0)
+            return;
+          rate[to] = rate[from] * ratio;
+          component[to] = root;
+          worklist.push_back(to);
+        };
+        visit(p, q, double(produced) / consumed);
+        visit(q, p, double(consumed) / produced);
+      }
+    }
+  }
+
+  DenseMap<unsigned, double> graphPeriod;
+  for (unsigned a = 0; a < actors.size(); a++)
+    graphPeriod[component[a]] =
+        std::max(graphPeriod[component[a]], periods[a] * rate[a]);
+  SmallVector<double> steady;
+  for (unsigned a = 0; a < actors.size(); a++)
+    steady.push_back(graphPeriod[component[a]] / rate[a]);
+  return steady;
+}
+
+int64_t getElemBytes(ObjectFifoCreateOp fifo) {
+  auto elemType = cast<MemRefType>(
+      cast<AIEObjectFifoType>(fifo.getElemType()).getElementType());
+  return elemType.getNumElements() *
+         elemType.getElementType().getIntOrFloatBitWidth() / 8;
+}
+
+// Number of objects the stateful transform allocates for consumer `index` of
+// `fifo` when its depth is the single integer `depth`; see
+// findObjectFifoSize in AIEObjectFifoStatefulTransform.cpp.
+int getImpliedConsumerDepth(DeviceOp device, ObjectFifoCreateOp fifo,
+                            unsigned index, int depth) {
+  Value tile = fifo.getConsumerTiles()[index];
+  auto tileOp = tile.getDefiningOp<TileOp>();
+  if (tileOp.isMemTile() || tileOp.isShimTile())
+    return depth;
+  int maxAcquire = 0;
+  for (auto core : device.getOps<CoreOp>())
+    if (core.getTile() == tile)
+      core.walk([&](ObjectFifoAcquireOp acq) {
+        if (acq.getObjectFifo() == fifo)
+          maxAcquire = std::max(maxAcquire, acq.acqNumber());
+      });
+  if (maxAcquire == 0)
+    return depth;
+  if (maxAcquire == 1 && depth == 1)
+    return 1;
+  return maxAcquire + 1;
+}
+
+int getEndpointDepth(DeviceOp device, ObjectFifoCreateOp fifo,
+                     unsigned endpoint) {
+  if (isa<ArrayAttr>(fifo.getElemNumber()))
+    return fifo.size(endpoint);
+  if (endpoint == 0)
+    return fifo.size();
+  return getImpliedConsumerDepth(device, fifo, endpoint - 1, fifo.size());
+}
+
+bool isSharedMemory(const AIETargetModel &tm, TileOp a, TileOp b) {
+  if (a.isShimTile() || b.isShimTile() || a.isMemTile() != b.isMemTile())
+    return false;
+  return tm.isLegalMemAffinity(a.colIndex(), a.rowIndex(), b.colIndex(),
+                               b.rowIndex()) ||
+         tm.isLegalMemAffinity(b.colIndex(), b.rowIndex(), a.colIndex(),
+                               a.rowIndex());
+}
+
+std::string describeTile(TileOp tile) {
+  return "(" + std::to_string(tile.getCol()) + ", " +
+         std::to_string(tile.getRow()) + ")";
+}
+
+struct AIEObjectFifoDepthSizingPass
+    : AIEObjectFifoDepthSizingBase<AIEObjectFifoDepthSizingPass> {
+
+  DeviceOp device;
+  SmallVector<Channel> channels;
+  SmallVector<Actor> actors;
+  std::map<Endpoint, unsigned> endpointChannel;
+  // Objectfifos whose producer and consumer share the same buffers.
+  llvm::DenseSet<Operation *> sharedFifos;
+
+  int64_t getKernelCycles(func::CallOp call) {
+    if (auto cycles = call->getAttrOfType<IntegerAttr>("aie.kernel_cycles"))
+      return cycles.getInt();
+    if (auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+            call, call.getCalleeAttr()))
+      if (auto cycles =
+              callee->getAttrOfType<IntegerAttr>("aie.kernel_cycles"))
+        return cycles.getInt();
+    return clDefaultKernelCycles;
+  }
+
+  std::optional<unsigned> getPortChannel(ObjectFifoCreateOp fifo,
+                                         ObjectFifoPort port, Value tile) {
+    unsigned endpoint = 0;
+    if (port == ObjectFifoPort::Consume) {
+      auto consumers = fifo.getConsumerTiles();
+      auto it = llvm::find(consumers, tile);
+      if (it == consumers.end())
+        return std::nullopt;
+      endpoint = std::distance(consumers.begin(), it) + 1;
+    }
+    auto it = endpointChannel.find({fifo, endpoint});
+    if (it == endpointChannel.end())
+      return std::nullopt;
+    return it->second;
+  }
+
+  // Appends the steps of `ops` to `steps`, expanding loops with constant trip
+  // counts.
+  LogicalResult appendSteps(llvm::iterator_range<Block::iterator> ops,
+                            Value tile, SmallVector<Step> &steps) {
+    for (Operation &op : ops) {
+      if (auto acq = dyn_cast<ObjectFifoAcquireOp>(op)) {
+        auto channel = getPortChannel(acq.getObjectFifo(), acq.getPort(), tile);
+        if (!channel)
+          return acq.emitWarning("objectFifo access is not modelled");
+        steps.push_back({StepKind::Acquire, *channel,
+                         acq.getPort() == ObjectFifoPort::Produce,
+                         acq.acqNumber()});
+      } else if (auto rel = dyn_cast<ObjectFifoReleaseOp>(op)) {
+        auto channel = getPortChannel(rel.getObjectFifo(), rel.getPort(), tile);
+        if (!channel)
+          return rel.emitWarning("objectFifo access is not modelled");
+        steps.push_back({StepKind::Release, *channel,
+                         rel.getPort() == ObjectFifoPort::Produce,
+                         rel.relNumber()});
+      } else if (auto call = dyn_cast<func::CallOp>(op)) {
+        steps.push_back({StepKind::Compute, 0, false, getKernelCycles(call)});
+      } else if (auto loop = dyn_cast<scf::ForOp>(op)) {
+        std::optional<int64_t> tripCount = getTripCount(loop);
+        if (!tripCount)
+          return loop.emitWarning(
+              "loop with a dynamic trip count is not modelled");
+        // Loops analysed by aievec-cycle-estimate are costed as a whole.
+        auto cycles = loop->getAttrOfType<IntegerAttr>("aievec.cycles_per_iter");
+        if (cycles && !accessesObjectFifos(loop)) {
+          steps.push_back(
+              {StepKind::Compute, 0, false, *tripCount * cycles.getInt()});
+          continue;
+        }
+        SmallVector<Step> body;
+        if (failed(appendSteps(*loop.getBody(), tile, body)))
+          return failure();
+        if (body.size() * *tripCount + steps.size() > kMaxProgramSteps)
+          return loop.emitWarning("loop is too large to be modelled");
+        for (int64_t i = 0; i < *tripCount; i++)
+          steps.append(body);
+      } else if (op.getNumRegions()) {
+        if (accessesObjectFifos(&op))
+          return op.emitWarning("objectFifo accesses in '")
+                 << op.getName() << "' are not modelled";
+        int64_t cycles = 0;
+        op.walk([&](func::CallOp call) { cycles += getKernelCycles(call); });
+        steps.push_back({StepKind::Compute, 0, false, cycles});
+      }
+    }
+    return success();
+  }
+
+  static std::optional<int64_t> getTripCount(scf::ForOp loop) {
+    auto lb = getConstantIntValue(loop.getLowerBound());
+    auto ub = getConstantIntValue(loop.getUpperBound());
+    auto step = getConstantIntValue(loop.getStep());
+    if (!lb || !ub || !step)
+      return std::nullopt;
+    return constantTripCount(*lb, *ub, *step);
+  }
+
+  static bool accessesObjectFifos(Operation *op) {
+    return op
+        ->walk([](Operation *inner) {
+          if (isa<ObjectFifoAcquireOp, ObjectFifoReleaseOp>(inner))
+            return WalkResult::interrupt();
+          return WalkResult::advance();
+        })
+        .wasInterrupted();
+  }
+
+  // Merges adjacent computes and makes sure every iteration of a body takes
+  // time.
+  static void simplify(SmallVector<Step> &steps, bool isBody) {
+    SmallVector<Step> result;
+    for (const Step &step : steps) {
+      if (step.kind == StepKind::Compute) {
+        if (step.count <= 0)
+          continue;
+        if (!result.empty() && result.back().kind == StepKind::Compute) {
+          result.back().count += step.count;
+          continue;
+        }
+      }
+      result.push_back(step);
+    }
+    if (isBody && llvm::none_of(result, [](const Step &step) {
+          return step.kind == StepKind::Compute;
+        }))
+      result.push_back({StepKind::Compute, 0, false, 1});
+    steps = std::move(result);
+  }
+
+  // A core runs its body once, unless its body contains a loop that runs too
+  // long to be expanded: the operations before that loop are then the
+  // prologue and the body of the loop is repeated.
+  LogicalResult buildCore(CoreOp core) {
+    Actor actor;
+    actor.name = "core " + describeTile(core.getTileOp());
+    Block &block = core.getBody().front();
+    Value tile = core.getTile();
+
+    auto steadyLoop = llvm::find_if(block, [](Operation &op) {
+      auto loop = dyn_cast<scf::ForOp>(op);
+      return loop && getTripCount(loop).value_or(kMaxProgramSteps + 1) >
+                         kMaxProgramSteps;
+    });
+    if (steadyLoop != block.end()) {
+      if (failed(appendSteps({block.begin(), steadyLoop}, tile,
+                             actor.prologue)) ||
+          failed(appendSteps(*cast<scf::ForOp>(*steadyLoop).getBody(), tile,
+                             actor.body)))
+        return failure();
+    } else if (failed(appendSteps(block, tile, actor.body))) {
+      return failure();
+    }
+
+    simplify(actor.prologue, /*isBody=*/false);
+    simplify(actor.body, /*isBody=*/true);
+    if (llvm::any_of(actor.body,
+                     [](const Step &step) {
+                       return step.kind != StepKind::Compute;
+                     }) ||
+        llvm::any_of(actor.prologue, [](const Step &step) {
+          return step.kind != StepKind::Compute;
+        }))
+      actors.push_back(std::move(actor));
+    return success();
+  }
+
+  // A DMA moves one object from each of its inputs to each of its outputs at
+  // a time. The outputs of a distribute and the inputs of a join are moved
+  // by a single actor, as they share the objects of the link tile.
+  void buildDMA(ArrayRef<ObjectFifoCreateOp> fifos, int64_t repeatCount) {
+    SmallVector<unsigned> inputs, outputs;
+    int64_t bytes = 0;
+    std::string names;
+    for (ObjectFifoCreateOp fifo : fifos) {
+      if (auto it = endpointChannel.find({fifo, 0});
+          it != endpointChannel.end() && !llvm::is_contained(inputs, it->second))
+        inputs.push_back(it->second);
+      for (unsigned i = 1; i <= fifo.getConsumerTiles().size(); i++)
+        if (auto it = endpointChannel.find({fifo, i});
+            it != endpointChannel.end() &&
+            !llvm::is_contained(outputs, it->second))
+          outputs.push_back(it->second);
+      bytes = std::max(bytes, getElemBytes(fifo));
+      names += (names.empty() ? "@" : ", @") + fifo.name().str();
+    }
+    if (inputs.empty() && outputs.empty())
+      return;
+
+    Actor actor;
+    actor.name = "dma " + names;
+    int64_t cycles =
+        std::max<int64_t>(1, llvm::divideCeil(bytes, kStreamBytesPerCycle));
+    for (unsigned channel : inputs)
+      actor.body.push_back({StepKind::Acquire, channel, false, 1});
+    for (int64_t r = 0; r < repeatCount; r++) {
+      for (unsigned channel : outputs)
+        actor.body.push_back({StepKind::Acquire, channel, true, 1});
+      actor.body.push_back({StepKind::Compute, 0, false, cycles});
+      for (unsigned channel : outputs)
+        actor.body.push_back({StepKind::Release, channel, true, 1});
+    }
+    for (unsigned channel : inputs)
+      actor.body.push_back({StepKind::Release, channel, false, 1});
+    actors.push_back(std::move(actor));
+  }
+
+  // Creates a channel for every objectFifo endpoint that has buffers in a
+  // core tile or MemTile.
+  void buildChannels(ArrayRef<ObjectFifoCreateOp> fifos) {
+    const AIETargetModel &tm = device.getTargetModel();
+
+    // The link tile only holds the objects of one endpoint of a link, see
+    // createObjectFifoElements in AIEObjectFifoStatefulTransform.cpp.
+    std::map<Endpoint, Endpoint> linkAlias;
+    llvm::DenseSet<Operation *> linked;
+    for (auto link : device.getOps<ObjectFifoLinkOp>()) {
+      auto sharedTile = link.getOptionalSharedTile();
+      if (!sharedTile)
+        continue;
+      auto ins = link.getInputObjectFifos();
+      auto outs = link.getOutputObjectFifos();
+      auto linkEndpoint = [&](ObjectFifoCreateOp fifo) -> Endpoint {
+        auto consumers = fifo.getConsumerTiles();
+        auto index = std::distance(consumers.begin(),
+                                   llvm::find(consumers, *sharedTile));
+        return {fifo, static_cast<unsigned>(index) + 1};
+      };
+      auto numElements = [](ObjectFifoCreateOp fifo) {
+        return cast<MemRefType>(
+                   cast<AIEObjectFifoType>(fifo.getElemType()).getElementType())
+            .getNumElements();
+      };
+      Endpoint owner = {outs[0], 0};
+      if (link.isDistribute() ||
+          (!link.isJoin() && !outs[0].getInitValues() &&
+           numElements(ins[0]) >= numElements(outs[0])))
+        owner = linkEndpoint(ins[0]);
+      for (ObjectFifoCreateOp in : ins)
+        if (Endpoint e = linkEndpoint(in); e != owner)
+          linkAlias[e] = owner;
+      for (ObjectFifoCreateOp out : outs)
+        if (Endpoint e = {out, 0}; e != owner)
+          linkAlias[e] = owner;
+      for (ObjectFifoCreateOp fifo : ins)
+        linked.insert(fifo);
+      for (ObjectFifoCreateOp fifo : outs)
+        linked.insert(fifo);
+    }
+
+    for (ObjectFifoCreateOp fifo : fifos) {
+      auto consumers = fifo.getConsumerTiles();
+      TileOp producer = fifo.getProducerTileOp();
+      bool shared =
+          consumers.size() == 1 && !fifo.getVia_DMA() &&
+          !fifo.getRepeatCount() && fifo.getDimensionsToStream().empty() &&
+          llvm::all_of(fifo.getDimensionsFromStreamPerConsumer(),
+                       [](BDDimLayoutArrayAttr dims) { return dims.empty(); }) &&
+          !linked.contains(fifo) &&
+          isSharedMemory(tm, producer, consumers[0].getDefiningOp<TileOp>());
+      if (shared)
+        sharedFifos.insert(fifo);
+
+      for (unsigned e = 0; e <= consumers.size(); e++) {
+        TileOp tile =
+            e == 0 ? producer : consumers[e - 1].getDefiningOp<TileOp>();
+        if (tile.isShimTile() || linkAlias.count({fifo, e}))
+          continue;
+        if (shared && e > 0) {
+          endpointChannel[{fifo, e}] = endpointChannel[{fifo, 0}];
+          continue;
+        }
+        Channel channel;
+        channel.fifo = fifo;
+        channel.endpoint = e;
+        channel.tile = tile;
+        channel.elemBytes = getElemBytes(fifo);
+        channel.depth = getEndpointDepth(device, fifo, e);
+        channel.fixed = e == 0 && fifo.getInitValues().has_value();
+        endpointChannel[{fifo, e}] = channels.size();
+        channels.push_back(channel);
+      }
+    }
+
+    for (auto &[endpoint, owner] : linkAlias)
+      if (auto it = endpointChannel.find(owner); it != endpointChannel.end())
+        endpointChannel[endpoint] = it->second;
+  }
+
+  void buildDMAs(ArrayRef<ObjectFifoCreateOp> fifos) {
+    // Objectfifos moved by one actor, keyed by the objectFifo or the link
+    // that shares a DMA actor.
+    SmallVector<std::pair<Operation *, SmallVector<ObjectFifoCreateOp>>> groups;
+    DenseMap<Operation *, int64_t> repeatCounts;
+    auto addToGroup = [&](Operation *key, ObjectFifoCreateOp fifo) {
+      auto it = llvm::find_if(groups, [&](auto &g) { return g.first == key; });
+      if (it == groups.end()) {
+        groups.push_back({key, {}});
+        it = std::prev(groups.end());
+      }
+      it->second.push_back(fifo);
+      repeatCounts[key] =
+          std::max(repeatCounts.lookup(key),
+                   static_cast<int64_t>(fifo.getRepeatCount().value_or(1)));
+    };
+
+    DenseMap<Operation *, ObjectFifoLinkOp> outputOf, inputOf;
+    for (auto link : device.getOps<ObjectFifoLinkOp>()) {
+      for (ObjectFifoCreateOp fifo : link.getInputObjectFifos())
+        inputOf[fifo] = link;
+      for (ObjectFifoCreateOp fifo : link.getOutputObjectFifos())
+        outputOf[fifo] = link;
+    }
+
+    for (ObjectFifoCreateOp fifo : fifos) {
+      if (sharedFifos.contains(fifo))
+        continue;
+      Operation *key = fifo;
+      if (auto link = outputOf.lookup(fifo)) {
+        if (link.isDistribute())
+          key = link;
+        addToGroup(key, fifo);
+        // The link tile sends each object `repeat_count` times.
+        if (auto repeat = link.getRepeatCount())
+          repeatCounts[key] = std::max<int64_t>(repeatCounts[key], *repeat);
+        continue;
+      }
+      if (auto link = inputOf.lookup(fifo); link && link.isJoin())
+        key = link;
+      addToGroup(key, fifo);
+    }
+
+    for (auto &[key, group] : groups)
+      buildDMA(group, repeatCounts[key]);
+  }
+
+  // Memory of each tile that is not used by buffers, stacks or objectFifos
+  // at the depths in `depths`.
+  DenseMap<Operation *, int64_t> getFreeMemory(ArrayRef<int> depths) {
+    const AIETargetModel &tm = device.getTargetModel();
+    DenseMap<Operation *, int64_t> free;
+    for (auto tile : device.getOps<TileOp>())
+      free[tile] = tile.isMemTile() ? tm.getMemTileSize()
+                                    : tm.getLocalMemorySize();
+    for (auto buffer : device.getOps<BufferOp>())
+      free[buffer.getTile().getDefiningOp()] -= buffer.getAllocationSize();
+    for (auto core : device.getOps<CoreOp>())
+      free[core.getTile().getDefiningOp()] -= core.getStackSize();
+    for (auto [channel, depth] : llvm::zip(channels, depths))
+      free[channel.tile] -= depth * channel.elemBytes;
+    return free;
+  }
+
+  // Whether a consumer of `channel` waits for space in another channel. Its
+  // producers then stall on it because of a stall further downstream, such as
+  // a distribute that holds its input while it waits for its outputs.
+  bool hasStalledConsumer(unsigned channel, const SimulationResult &result) {
+    auto consumes = [&](const Step &step) {
+      return step.kind == StepKind::Acquire && !step.produce &&
+             step.channel == channel;
+    };
+    auto waitsForSpace = [&](const Step &step) {
+      return step.kind == StepKind::Acquire && step.produce &&
+             result.spaceStall[step.channel] > 0;
+    };
+    return llvm::any_of(actors, [&](const Actor &actor) {
+      return llvm::any_of(actor.body, consumes) &&
+             llvm::any_of(actor.body, waitsForSpace);
+    });
+  }
+
+  // Grows the channels from their minimum depth, one object at a time, until
+  // every actor runs at the rate it reaches with unbounded channels. Each step
+  // grows the channel whose producers stall on it and whose growth reduces
+  // the periods the most; growth is limited by `max-depth` and the memory of
+  // the tiles.
+  SmallVector<int> sizeChannels(ArrayRef<double> ideal,
+                                SimulationResult &result) {
+    SmallVector<int> depths;
+    for (const Channel &channel : channels)
+      depths.push_back(channel.fixed ? channel.depth : channel.minDepth);
+    result = simulate(actors, channels, depths);
+
+    while (!reachesIdeal(result, ideal)) {
+      DenseMap<Operation *, int64_t> free = getFreeMemory(depths);
+      double cost = getCost(result, ideal);
+      std::optional<unsigned> best, mostStalled;
+      bool mostStalledIsCause = false;
+      SimulationResult bestResult;
+      double bestCost = cost;
+      for (auto [idx, channel] : llvm::enumerate(channels)) {
+        if (channel.fixed ||
+            (!result.deadlock && result.spaceStall[idx] == 0) ||
+            depths[idx] >= std::max<int>(clMaxDepth, channel.minDepth) ||
+            free[channel.tile] < channel.elemBytes)
+          continue;
+        depths[idx]++;
+        SimulationResult candidate = simulate(actors, channels, depths);
+        depths[idx]--;
+        double candidateCost = getCost(candidate, ideal);
+        if (candidateCost < bestCost ||
+            (best && candidateCost == bestCost &&
+             channel.elemBytes < channels[*best].elemBytes)) {
+          best = idx;
+          bestCost = candidateCost;
+          bestResult = std::move(candidate);
+        }
+        bool isCause = !hasStalledConsumer(idx, result);
+        if (!mostStalled || isCause > mostStalledIsCause ||
+            (isCause == mostStalledIsCause &&
+             result.spaceStall[idx] > result.spaceStall[*mostStalled])) {
+          mostStalled = idx;
+          mostStalledIsCause = isCause;
+        }
+      }
+      if (!best) {
+        // No single object helps; grow the channel producers wait on most,
+        // as a throughput step may need more than one object. Channels whose
+        // consumers do not wait themselves come first, as the stalls of the
+        // others only pass on a stall downstream.
+        if (!mostStalled)
+          break;
+        best = mostStalled;
+        depths[*best]++;
+        result = simulate(actors, channels, depths);
+        continue;
+      }
+      depths[*best]++;
+      result = std::move(bestResult);
+    }
+    return depths;
+  }
+
+  void printReport(raw_ostream &os, ArrayRef<int> depths,
+                   const SimulationResult &result, ArrayRef<double> ideal) {
+    os << "objectFifo depth sizing for " << stringifyAIEDevice(device.getDevice())
+       << ":\n";
+    for (auto [channel, depth] : llvm::zip(channels, depths)) {
+      os << "  @" << channel.fifo.name() << " "
+         << (channel.endpoint == 0 ? "producer" : "consumer") << " buffers in "
+         << describeTile(channel.tile) << ": depth " << channel.depth << " -> "
+         << depth << " (" << channel.elemBytes << " bytes/object)\n";
+    }
+    std::optional<unsigned> bottleneck;
+    for (auto [idx, actor] : llvm::enumerate(actors)) {
+      os << "  " << actor.name << ": ";
+      if (std::isinf(result.period[idx]))
+        os << "stalled";
+      else
+        os << llvm::format("%.1f", result.period[idx]) << " cycles/iteration";
+      os << " (unbounded " << llvm::format("%.1f", ideal[idx]) << "), busy "
+         << llvm::format("%.1f", 100.0 * result.utilisation[idx]) << "%\n";
+      if (!bottleneck ||
+          result.utilisation[idx] > result.utilisation[*bottleneck])
+        bottleneck = idx;
+    }
+    if (result.deadlock)
+      os << "  deadlock: the objectFifos do not fit within the limits\n";
+    else if (!reachesIdeal(result, ideal))
+      os << "  throughput is limited by the objectFifo depths\n";
+    if (bottleneck)
+      os << "  bottleneck: " << actors[*bottleneck].name << "\n";
+  }
+
+  void runOnOperation() override {
+    // The same pass instance runs on every device of the module.
+    device = getOperation();
+    channels.clear();
+    actors.clear();
+    endpointChannel.clear();
+    sharedFifos.clear();
+    auto fifos = llvm::to_vector(device.getOps<ObjectFifoCreateOp>());
+    llvm::erase_if(fifos, [](ObjectFifoCreateOp fifo) { return !fifo.size(); });
+    if (fifos.empty())
+      return;
+
+    buildChannels(fifos);
+    for (auto core : device.getOps<CoreOp>())
+      if (failed(buildCore(core)))
+        return;
+    buildDMAs(fifos);
+
+    for (const Actor &actor : actors)
+      for (ArrayRef<Step> steps : {actor.prologue, actor.body})
+        for (const Step &step : steps) {
+          if (step.kind != StepKind::Acquire)
+            continue;
+          Channel &channel = channels[step.channel];
+          (step.produce ? channel.hasProducer : channel.hasConsumer) = true;
+          channel.minDepth = std::max<int>(channel.minDepth, step.count);
+        }
+    for (Channel &channel : channels)
+      if (!channel.hasProducer || !channel.hasConsumer) {
+        channel.fifo.emitWarning("the ")
+            << (channel.hasProducer ? "consumer" : "producer")
+            << " of the buffers in tile " << describeTile(channel.tile)
+            << " is not modelled; objectFifo depths are left unchanged";
+        return;
+      }
+
+    SmallVector<int> unbounded;
+    for (const Channel &channel : channels)
+      unbounded.push_back(channel.fixed ? channel.depth
+                                        : std::max(channel.depth,
+                                                   channel.minDepth) +
+                                              kUnboundedDepth);
+    SimulationResult ideal = simulate(actors, channels, unbounded);
+    if (ideal.deadlock) {
+      device.emitWarning("the objectFifos deadlock even when unbounded; "
+                         "objectFifo depths are left unchanged");
+      return;
+    }
+
+    SmallVector<double> idealPeriods =
+        getSteadyPeriods(actors, channels.size(), ideal.period);
+    SimulationResult result;
+    SmallVector<int> depths = sizeChannels(idealPeriods, result);
+    if (clPrint)
+      printReport(llvm::outs(), depths, result, idealPeriods);
+    if (clReportOnly || result.deadlock)
+      return;
+
+    Builder builder(device.getContext());
+    for (ObjectFifoCreateOp fifo : fifos) {
+      unsigned numEndpoints = fifo.getConsumerTiles().size() + 1;
+      SmallVector<int> newDepths;
+      SmallVector<bool> sized;
+      for (unsigned e = 0; e < numEndpoints; e++) {
+        newDepths.push_back(getEndpointDepth(device, fifo, e));
+        sized.push_back(false);
+        auto it = endpointChannel.find({fifo, e});
+        if (it == endpointChannel.end())
+          continue;
+        const Channel &channel = channels[it->second];
+        if (channel.fifo != fifo || channel.endpoint != e)
+          continue;
+        newDepths[e] = depths[it->second];
+        sized[e] = true;
+      }
+      if (sharedFifos.contains(fifo))
+        for (unsigned e = 1; e < numEndpoints; e++)
+          newDepths[e] = newDepths[0];
+      // A shim tile holds no objects, so its depth only matters for the depth
+      // it implies for the consumers.
+      if (!sized[0] && fifo.getProducerTileOp().isShimTile()) {
+        int consumerDepth = 0;
+        for (unsigned e = 1; e < numEndpoints; e++)
+          if (sized[e])
+            consumerDepth = std::max(consumerDepth, newDepths[e]);
+        if (consumerDepth)
+          newDepths[0] = consumerDepth;
+      }
+
+      // Keep the single depth form if the consumers get the depths chosen for
+      // them from it.
+      bool single = !isa<ArrayAttr>(fifo.getElemNumber());
+      for (unsigned e = 1; single && e < numEndpoints; e++)
+        if (sized[e] && !sharedFifos.contains(fifo) &&
+            getImpliedConsumerDepth(device, fifo, e - 1, newDepths[0]) !=
+                newDepths[e])
+          single = false;
+
+      Attribute depthAttr;
+      if (single) {
+        depthAttr = builder.getI32IntegerAttr(newDepths[0]);
+      } else {
+        SmallVector<Attribute> elems;
+        for (int depth : newDepths)
+          elems.push_back(builder.getI32IntegerAttr(depth));
+        depthAttr = builder.getArrayAttr(elems);
+      }
+      if (depthAttr != fifo.getElemNumber())
+        fifo.setElemNumberAttr(depthAttr);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEObjectFifoDepthSizingPass() {
+  return std::make_unique<AIEObjectFifoDepthSizingPass>();
+}
@@ -0,0 +1,233 @@
+//===- AIEObjectFifoSoftwarePipeline.cpp ------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Pass/Pass.h"
+
+#include <map>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-objectFifo-software-pipeline"
+
+namespace {
+
+using FifoPort = std::pair<StringRef, ObjectFifoPort>;
+
+// An acquire/release pair on one port of an objectFifo that is executed once
+// per iteration of the loop it sits in.
+struct PipelinedAccess {
+  ObjectFifoAcquireOp acquire;
+  ObjectFifoReleaseOp release;
+};
+
+ObjectFifoPort otherPort(ObjectFifoPort port) {
+  return port == ObjectFifoPort::Produce ? ObjectFifoPort::Consume
+                                         : ObjectFifoPort::Produce;
+}
+
+// Number of objects of `fifo` that the core on `tile` may hold through `port`.
+// For consumers without an explicit per-consumer depth the stateful transform
+// sizes the consumer buffers to the largest acquire plus one, so one object is
+// kept free to be filled by the DMA.
+std::optional<int> getDepth(ObjectFifoCreateOp fifo, ObjectFifoPort port,
+                            Value tile) {
+  if (port == ObjectFifoPort::Produce)
+    return fifo.size();
+  for (auto [idx, consumer] : llvm::enumerate(fifo.getConsumerTiles())) {
+    if (consumer != tile)
+      continue;
+    if (isa<ArrayAttr>(fifo.getElemNumber()))
+      return fifo.size(idx + 1);
+    return fifo.size() - 1;
+  }
+  return std::nullopt;
+}
+
+// Number of objects of the fifo port that are held on entry to `loop`, found
+// by replaying the acquires and releases of the core that precede it.
+int heldBefore(CoreOp core, scf::ForOp loop, FifoPort key) {
+  int held = 0;
+  core.walk<WalkOrder::PreOrder>([&](Operation *op) {
+    if (op == loop)
+      return WalkResult::interrupt();
+    if (auto acq = dyn_cast<ObjectFifoAcquireOp>(op)) {
+      if (acq.getObjFifoName() == key.first && acq.getPort() == key.second)
+        held = std::max(held, acq.acqNumber());
+    } else if (auto rel = dyn_cast<ObjectFifoReleaseOp>(op)) {
+      if (rel.getObjFifoName() == key.first && rel.getPort() == key.second)
+        held = std::max(0, held - rel.relNumber());
+    }
+    return WalkResult::advance();
+  });
+  return held;
+}
+
+struct AIEObjectFifoSoftwarePipelinePass
+    : AIEObjectFifoSoftwarePipelineBase<AIEObjectFifoSoftwarePipelinePass> {
+
+  // Largest number of objects acquired at once on each objectFifo port, over
+  // all cores of the device. Updated as loops are pipelined.
+  std::map<FifoPort, int> maxAcquire;
+
+  // Returns the acquire/release pairs of `loop` that can be pipelined. Only
+  // acquires and releases directly in the loop body are considered, and a
+  // port is only pipelined if it has exactly one acquire and one release of
+  // the same size in the loop, with the acquire first.
+  SmallVector<PipelinedAccess> findPipelinedAccesses(CoreOp core,
+                                                     scf::ForOp loop) {
+    std::map<FifoPort, SmallVector<ObjectFifoAcquireOp>> acquires;
+    std::map<FifoPort, SmallVector<ObjectFifoReleaseOp>> releases;
+    loop.getBody()->walk([&](Operation *op) {
+      if (auto acq = dyn_cast<ObjectFifoAcquireOp>(op))
+        acquires[{acq.getObjFifoName(), acq.getPort()}].push_back(acq);
+      else if (auto rel = dyn_cast<ObjectFifoReleaseOp>(op))
+        releases[{rel.getObjFifoName(), rel.getPort()}].push_back(rel);
+    });
+
+    SmallVector<PipelinedAccess> accesses;
+    for (auto &[key, acqs] : acquires) {
+      auto &rels = releases[key];
+      if (acqs.size() != 1 || rels.size() != 1)
+        continue;
+      ObjectFifoAcquireOp acq = acqs.front();
+      ObjectFifoReleaseOp rel = rels.front();
+      if (acq->getBlock() != loop.getBody() ||
+          rel->getBlock() != loop.getBody() ||
+          !acq->isBeforeInBlock(rel) || acq.acqNumber() != rel.relNumber())
+        continue;
+      if (heldBefore(core, loop, key) != 0)
+        continue;
+
+      // Holding the objects of two iterations must leave room for the
+      // largest acquire on the other end of the objectFifo, otherwise the
+      // two sides can deadlock when they share the same buffers.
+      int n = acq.acqNumber();
+      auto depth = getDepth(acq.getObjectFifo(), key.second, core.getTile());
+      int other = std::max(1, maxAcquire[{key.first, otherPort(key.second)}]);
+      if (!depth || 2 * n + other > *depth) {
+        LLVM_DEBUG(llvm::dbgs()
+                   << "not pipelining " << key.first << ": depth too small\n");
+        continue;
+      }
+      accesses.push_back({acq, rel});
+    }
+    return accesses;
+  }
+
+  // Rewrites
+  //
+  //   for i in [lb, ub) { acquire(N) ; compute(i) ; release(N) }
+  //
+  // into
+  //
+  //   acquire(N)
+  //   for i in [lb, ub - step) { acquire(2N) ; compute(i) ; release(N) }
+  //   acquire(N) ; compute(ub - step) ; release(N)
+  //
+  // Acquires are cumulative, so the acquire of 2N objects in the loop only
+  // locks the N objects of the next iteration, and the acquire in the
+  // epilogue does not lock anything.
+  void pipeline(scf::ForOp loop, int64_t tripCount,
+                ArrayRef<PipelinedAccess> accesses) {
+    Location loc = loop.getLoc();
+    OpBuilder builder(loop);
+
+    // Prologue: acquire the objects of the first iteration.
+    for (auto &access : accesses)
+      builder.clone(*access.acquire);
+
+    int64_t lb = *getConstantIntValue(*loop.getSingleLowerBound());
+    int64_t step = *getConstantIntValue(*loop.getSingleStep());
+    Type ivType = loop.getInductionVar().getType();
+    int64_t lastIv = lb + (tripCount - 1) * step;
+    Value last = builder.create<arith::ConstantOp>(
+        loc, ivType, builder.getIntegerAttr(ivType, lastIv));
+
+    // Epilogue: the last iteration, whose objects are acquired by the
+    // iteration before it.
+    SmallVector<OpOperand *> resultUses;
+    for (Value result : loop.getResults())
+      for (OpOperand &use : result.getUses())
+        resultUses.push_back(&use);
+
+    builder.setInsertionPointAfter(loop);
+    IRMapping mapping;
+    mapping.map(loop.getInductionVar(), last);
+    mapping.map(loop.getRegionIterArgs(), loop.getResults());
+    for (Operation &op : loop.getBody()->without_terminator())
+      builder.clone(op, mapping);
+    auto yield = cast<scf::YieldOp>(loop.getBody()->getTerminator());
+    for (OpOperand *use : resultUses) {
+      auto result = cast<OpResult>(use->get());
+      use->set(mapping.lookupOrDefault(
+          yield.getOperand(result.getResultNumber())));
+    }
+
+    // Steady state: run all but the last iteration and acquire the objects
+    // of the next iteration together with those of the current one.
+    loop.setUpperBound(last);
+    for (auto &access : accesses)
+      access.acquire.setSize(2 * access.acquire.acqNumber());
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+
+    device.walk([&](ObjectFifoAcquireOp acq) {
+      int &max = maxAcquire[{acq.getObjFifoName(), acq.getPort()}];
+      max = std::max(max, acq.acqNumber());
+    });
+
+    for (auto core : device.getOps<CoreOp>()) {
+      // Loops are visited innermost first, so a pipelined inner loop is also
+      // pipelined in the epilogue of its enclosing loop.
+      SmallVector<scf::ForOp> loops;
+      core.walk([&](scf::ForOp loop) { loops.push_back(loop); });
+
+      for (scf::ForOp loop : loops) {
+        auto lb = loop.getSingleLowerBound();
+        auto ub = loop.getSingleUpperBound();
+        auto step = loop.getSingleStep();
+        if (!lb || !ub || !step || !getConstantIntValue(*lb) ||
+            !getConstantIntValue(*step))
+          continue;
+        int64_t tripCount = constantTripCount(*lb, *ub, *step).value_or(0);
+        if (tripCount < 2)
+          continue;
+
+        auto accesses = findPipelinedAccesses(core, loop);
+        if (accesses.empty())
+          continue;
+        for (auto &access : accesses) {
+          int &max = maxAcquire[{access.acquire.getObjFifoName(),
+                                 access.acquire.getPort()}];
+          max = std::max(max, 2 * access.acquire.acqNumber());
+        }
+        pipeline(loop, tripCount, accesses);
+      }
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEObjectFifoSoftwarePipelinePass() {
+  return std::make_unique<AIEObjectFifoSoftwarePipelinePass>();
+}
@@ -12,6 +12,7 @@
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+#include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 
 #include "mlir/Analysis/TopologicalSortUtils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
@@ -22,6 +23,8 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "llvm/ADT/StringExtras.h"
+
 #include <numeric>
 #include <set>
 
@@ -33,6 +36,17 @@ using namespace xilinx::AIE;
 
 #define LOOP_VAR_DEPENDENCY (-2)
 
+// Estimates used by the loop cost model (see chooseLoopLowerings()). They are
+// rough averages for AIE core code rather than exact instruction encodings.
+static constexpr int64_t kBytesPerOp = 8;
+// A runtime indexed access loads the index of the next object and selects the
+// buffer with a switch that has one case per object.
+static constexpr int64_t kDynamicAccessCycles = 4;
+// Advancing the runtime index after a release: load, constant, add, compare,
+// subtract, select and store.
+static constexpr int64_t kDynamicReleaseOps = 7;
+static constexpr int64_t kDynamicReleaseCycles = 6;
+
 //===----------------------------------------------------------------------===//
 // Lock Analysis
 //===----------------------------------------------------------------------===//
@@ -147,6 +161,11 @@ struct AIEObjectFifoStatefulTransformPass
   std::vector<ObjectFifoCreateOp>
       splitBecauseLink; // objfifos which have been split because they are
   // part of a Link, not because they didn't have a shared memory module
+  std::set<Operation *>
+      rotatedLoops; // loops chosen by the loop cost model whose objFifo
+  // buffers rotate through loop-carried values
+
+  using FifoPort = std::pair<ObjectFifoCreateOp, ObjectFifoPort>;
 
   /// Function that returns true if two tiles in the AIE array share a memory
   /// module. share_direction is equal to:
@@ -932,10 +951,18 @@ struct AIEObjectFifoStatefulTransformPass
   }
 
   // Function that unrolls for-loops that contain objectFifo operations.
-  LogicalResult unrollForLoops(DeviceOp &device, OpBuilder &builder,
-                               std::set<TileOp> objectFifoTiles) {
+  // objectFifo ports in dynamicFifos are accessed with a runtime index and
+  // do not contribute to the unroll factor.
+  LogicalResult
+  unrollForLoops(DeviceOp &device, OpBuilder &builder,
+                 std::set<TileOp> objectFifoTiles,
+                 const std::map<TileOp, std::set<FifoPort>> &dynamicFifos = {}) {
     for (auto coreOp : device.getOps<CoreOp>()) {
       if (objectFifoTiles.count(coreOp.getTileOp()) > 0) {
+        std::set<FifoPort> coreDynamicFifos;
+        if (auto it = dynamicFifos.find(coreOp.getTileOp());
+            it != dynamicFifos.end())
+          coreDynamicFifos = it->second;
         std::vector<scf::ForOp> unrolledLoops;
         std::map<Operation *, bool> foundMap;
         std::map<Operation *, int64_t> remainderMap;
@@ -950,8 +977,10 @@ struct AIEObjectFifoStatefulTransformPass
           remainderMap[forLoop.getOperation()] = 0;
           for (auto acqOp : body->getOps<ObjectFifoAcquireOp>()) {
             if (acqOp.getOperation()->getParentOp() == forLoop) {
-              foundMap[forLoop.getOperation()] = true;
               ObjectFifoCreateOp op = acqOp.getObjectFifo();
+              if (coreDynamicFifos.count({op, acqOp.getPort()}) > 0)
+                continue;
+              foundMap[forLoop.getOperation()] = true;
               objFifoSizes.insert(op.size());
             }
           }
@@ -1052,11 +1081,20 @@ struct AIEObjectFifoStatefulTransformPass
                              BufferOp globalNextIndex, arith::ConstantOp index,
                              arith::ConstantOp size) {
     builder.setInsertionPointAfter(relOp);
+    updateGlobalNextIndex(builder, relOp.getSize(), globalNextIndex, index,
+                          size);
+  }
+
+  // Advances the runtime index of an objectfifo by `numRel` objects at the
+  // insertion point of the builder.
+  void updateGlobalNextIndex(OpBuilder &builder, int numRel,
+                             BufferOp globalNextIndex, arith::ConstantOp index,
+                             arith::ConstantOp size) {
     Value oldCounter = builder.create<memref::LoadOp>(
         builder.getUnknownLoc(), globalNextIndex,
         ValueRange(ArrayRef({index.getResult()})));
     Value val = builder.create<arith::ConstantOp>(
-        oldCounter.getLoc(), builder.getI32IntegerAttr(relOp.getSize()));
+        oldCounter.getLoc(), builder.getI32IntegerAttr(numRel));
     Value sum = builder.create<arith::AddIOp>(val.getLoc(), oldCounter, val);
     Value isGreaterEqual = builder.create<arith::CmpIOp>(
         sum.getLoc(), arith::CmpIPredicate::sge, sum, size);
@@ -1067,13 +1105,127 @@ struct AIEObjectFifoStatefulTransformPass
                                     ValueRange(ArrayRef({index.getResult()})));
   }
 
+  // Function that lowers the objectfifo accesses of a loop chosen by the loop
+  // cost model by rotating the buffers of each objectfifo through
+  // loop-carried values. The buffer order at loop entry is selected once from
+  // the runtime index, each iteration rotates it by the number of released
+  // objects, and the runtime index is advanced once after the loop. Releases
+  // in the loop are added to handledReleases as they no longer update the
+  // runtime index. Called by dynamicGlobalObjectFifos().
+  LogicalResult rotateObjectFifoBuffers(
+      OpBuilder &builder, scf::ForOp forLoop, BufferOp globalNextIndex,
+      std::map<FifoPort, arith::ConstantOp> &globalIndices,
+      std::map<FifoPort, arith::ConstantOp> &constantSizes,
+      std::set<Operation *> &handledReleases) {
+    struct RotatedFifo {
+      ObjectFifoAcquireOp acqOp;
+      FifoPort fifo;
+      int depth;
+      int numRel;
+      unsigned offset;
+    };
+    std::vector<RotatedFifo> rotated;
+    SmallVector<Value> initTables;
+    Block *body = forLoop.getBody();
+    builder.setInsertionPoint(forLoop);
+    for (auto acqOp : body->getOps<ObjectFifoAcquireOp>()) {
+      ObjectFifoCreateOp op = acqOp.getObjectFifo();
+      ObjectFifoPort port = acqOp.getPort();
+      int numRel = 0;
+      for (auto relOp : body->getOps<ObjectFifoReleaseOp>())
+        if (relOp.getObjectFifo() == op && relOp.getPort() == port) {
+          numRel = relOp.relNumber();
+          handledReleases.insert(relOp);
+        }
+      int depth = op.size();
+      rotated.push_back({acqOp, {op, port}, depth, numRel,
+                         static_cast<unsigned>(initTables.size())});
+
+      // Buffer order at loop entry: case i starts at buffer i.
+      auto counter = builder.create<memref::LoadOp>(
+          builder.getUnknownLoc(), globalNextIndex,
+          ValueRange(ArrayRef({globalIndices[{op, port}].getResult()})));
+      auto switchIndex = builder.create<arith::IndexCastOp>(
+          builder.getUnknownLoc(), builder.getIndexType(), counter);
+      SmallVector<int64_t, 4> caseValues;
+      for (int i = 0; i < depth; ++i)
+        caseValues.push_back(i);
+      SmallVector<Type> tableTypes(depth, buffersPerFifo[op][0].getType());
+      auto switchOp = builder.create<scf::IndexSwitchOp>(
+          switchIndex.getLoc(), tableTypes, switchIndex,
+          DenseI64ArrayAttr::get(builder.getContext(), caseValues), depth);
+      auto yieldTable = [&](Region &region, int first) {
+        OpBuilder::InsertionGuard guard(builder);
+        builder.createBlock(&region);
+        SmallVector<Value> table;
+        for (int j = 0; j < depth; ++j)
+          table.push_back(buffersPerFifo[op][(first + j) % depth].getResult());
+        builder.create<scf::YieldOp>(builder.getUnknownLoc(), table);
+      };
+      yieldTable(switchOp.getDefaultRegion(), 0);
+      for (int i = 0; i < depth; ++i)
+        yieldTable(switchOp.getCaseRegions()[i], i);
+      initTables.append(switchOp.getResults().begin(),
+                        switchOp.getResults().end());
+    }
+
+    IRRewriter rewriter(builder);
+    auto rotateTables = [&](OpBuilder &b, Location loc,
+                            ArrayRef<BlockArgument> tables) {
+      SmallVector<Value> next;
+      for (auto &r : rotated)
+        for (int j = 0; j < r.depth; ++j)
+          next.push_back(tables[r.offset + (j + r.numRel) % r.depth]);
+      return next;
+    };
+    FailureOr<LoopLikeOpInterface> replaced =
+        forLoop.replaceWithAdditionalYields(
+            rewriter, initTables, /*replaceInitOperandUsesInLoop=*/false,
+            rotateTables);
+    if (failed(replaced))
+      return forLoop.emitOpError("could not carry the objectFifo buffers "
+                                 "through the loop");
+    auto newLoop = cast<scf::ForOp>(replaced->getOperation());
+    auto tables = newLoop.getRegionIterArgs().take_back(initTables.size());
+    int64_t tripCount = getConstantTripCount(newLoop);
+
+    builder.setInsertionPointAfter(newLoop);
+    for (auto &r : rotated) {
+      std::vector<ObjectFifoSubviewAccessOp> accessOps;
+      for (auto u : r.acqOp->getUsers())
+        if (auto accessOp = dyn_cast<ObjectFifoSubviewAccessOp>(u))
+          accessOps.push_back(accessOp);
+      for (auto accessOp : accessOps) {
+        accessOp.getOutput().replaceAllUsesWith(
+            tables[r.offset + accessOp.getIndex()]);
+        accessOp.erase();
+      }
+      if (int advance = (r.numRel * tripCount) % r.depth; advance > 0)
+        updateGlobalNextIndex(builder, advance, globalNextIndex,
+                              globalIndices[r.fifo], constantSizes[r.fifo]);
+    }
+    return success();
+  }
+
   // Function that generates the IR for objectfifo accesses to be handled at
-  // runtime.
-  LogicalResult dynamicGlobalObjectFifos(DeviceOp &device, OpBuilder &builder,
-                                         std::set<TileOp> objectFifoTiles) {
+  // runtime. If selectedFifos is given, only the objectfifo ports it lists for
+  // a core are handled at runtime and the others are left to loop unrolling.
+  LogicalResult dynamicGlobalObjectFifos(
+      DeviceOp &device, OpBuilder &builder, std::set<TileOp> objectFifoTiles,
+      const std::map<TileOp, std::set<FifoPort>> *selectedFifos = nullptr) {
     for (auto coreOp : device.getOps<CoreOp>()) {
       if (objectFifoTiles.count(coreOp.getTileOp()) <= 0)
         continue;
+      const std::set<FifoPort> *selected = nullptr;
+      if (selectedFifos) {
+        auto it = selectedFifos->find(coreOp.getTileOp());
+        if (it == selectedFifos->end() || it->second.empty())
+          continue;
+        selected = &it->second;
+      }
+      auto isDynamic = [&](ObjectFifoCreateOp op, ObjectFifoPort port) {
+        return !selected || selected->count({op, port}) > 0;
+      };
       if (objectFifoTiles.count(coreOp.getTileOp()) > 0) {
         // For each core: count the number of objectFifos and create
         // a global buffer just before the core to track index of
@@ -1084,6 +1236,8 @@ struct AIEObjectFifoStatefulTransformPass
         coreOp.walk([&](ObjectFifoAcquireOp acqOp) {
           ObjectFifoCreateOp op = acqOp.getObjectFifo();
           ObjectFifoPort port = acqOp.getPort();
+          if (!isDynamic(op, port))
+            return;
           if (fifoSizes.find({op, port}) == fifoSizes.end())
             fifoSizes[{op, port}] = op.size();
         });
@@ -1122,6 +1276,21 @@ struct AIEObjectFifoStatefulTransformPass
               ValueRange(ArrayRef({indexOp.getResult()})));
         }
 
+        // Loops chosen for buffer rotation by the loop cost model.
+        std::set<Operation *> rotatedReleases;
+        SmallVector<scf::ForOp> loopsToRotate;
+        coreOp.walk([&](scf::ForOp forLoop) {
+          if (rotatedLoops.count(forLoop) > 0)
+            loopsToRotate.push_back(forLoop);
+        });
+        for (auto forLoop : loopsToRotate) {
+          rotatedLoops.erase(forLoop);
+          if (failed(rotateObjectFifoBuffers(builder, forLoop,
+                                             globalNextIndex, globalIndices,
+                                             constantSizes, rotatedReleases)))
+            return failure();
+        }
+
         // Walk the code:
         // - after each ObjectFifoReleaseOp:
         //    - globalNextIndex: add #rel modulo objfifo depth
@@ -1132,11 +1301,14 @@ struct AIEObjectFifoStatefulTransformPass
           if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op)) {
             ObjectFifoCreateOp createOp = relOp.getObjectFifo();
             ObjectFifoPort port = relOp.getPort();
-            updateGlobalNextIndex(builder, relOp, globalNextIndex,
-                                  globalIndices[{createOp, port}],
-                                  constantSizes[{createOp, port}]);
+            if (isDynamic(createOp, port) && rotatedReleases.count(op) == 0)
+              updateGlobalNextIndex(builder, relOp, globalNextIndex,
+                                    globalIndices[{createOp, port}],
+                                    constantSizes[{createOp, port}]);
           }
           if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op)) {
+            if (!isDynamic(acqOp.getObjectFifo(), acqOp.getPort()))
+              return WalkResult::advance();
             std::vector<ObjectFifoSubviewAccessOp> accessOps;
             for (auto u : acqOp->getUsers())
               if (auto accessOp = dyn_cast<ObjectFifoSubviewAccessOp>(u))
@@ -1203,6 +1375,320 @@ struct AIEObjectFifoStatefulTransformPass
     return success();
   }
 
+  // Estimated program memory footprint of an operation and the operations
+  // nested in it. Subview accesses and terminators do not generate code.
+  int64_t estimateCodeSize(Operation *op) {
+    int64_t numOps = 0;
+    op->walk([&](Operation *nested) {
+      if (!isa<ObjectFifoSubviewAccessOp>(nested) &&
+          !nested->hasTrait<OpTrait::IsTerminator>())
+        numOps++;
+    });
+    return numOps * kBytesPerOp;
+  }
+
+  int64_t getConstantTripCount(scf::ForOp forLoop) {
+    if (!forLoop.getSingleLowerBound() || !forLoop.getSingleUpperBound() ||
+        !forLoop.getSingleStep())
+      return 0;
+    return constantTripCount(*(forLoop.getSingleLowerBound()),
+                             *(forLoop.getSingleUpperBound()),
+                             *(forLoop.getSingleStep()))
+        .value_or(0);
+  }
+
+  // Accesses to one objectFifo port made directly in the body of a loop.
+  struct LoopFifoUse {
+    ObjectFifoAcquireOp acqOp;
+    int depth = 0;
+    int numAcquires = 0;
+    int numReleases = 0;
+    int numAccesses = 0;
+    int acqSize = 0;
+    int relSize = 0;
+    // True if the buffers of the port can rotate through loop-carried values:
+    // one acquire followed by one release of at most as many objects, and no
+    // accesses in nested regions.
+    bool rotatable = false;
+  };
+
+  // Cost of a loop lowering relative to the loop as written: the unroll
+  // factor, the program memory it adds and the cycles it adds over all
+  // iterations.
+  struct LoopLoweringCost {
+    int unrollFactor = 1;
+    int64_t codeBytes = 0;
+    int64_t cycles = 0;
+  };
+
+  // Function that collects the objectFifo ports acquired directly in the body
+  // of a loop, in program order.
+  std::vector<std::pair<FifoPort, LoopFifoUse>>
+  collectLoopFifoUses(scf::ForOp forLoop) {
+    std::vector<std::pair<FifoPort, LoopFifoUse>> uses;
+    auto findUse = [&](FifoPort fifo) -> LoopFifoUse * {
+      for (auto &use : uses)
+        if (use.first == fifo)
+          return &use.second;
+      return nullptr;
+    };
+    Block *body = forLoop.getBody();
+    for (auto acqOp : body->getOps<ObjectFifoAcquireOp>()) {
+      FifoPort fifo = {acqOp.getObjectFifo(), acqOp.getPort()};
+      LoopFifoUse *use = findUse(fifo);
+      if (!use) {
+        uses.push_back({fifo, LoopFifoUse()});
+        use = &uses.back().second;
+        use->acqOp = acqOp;
+        use->depth = fifo.first.size();
+      }
+      use->numAcquires++;
+      use->acqSize = acqOp.acqNumber();
+      for (auto *user : acqOp->getUsers())
+        if (isa<ObjectFifoSubviewAccessOp>(user))
+          use->numAccesses++;
+    }
+    std::set<FifoPort> releasedFirst;
+    for (auto relOp : body->getOps<ObjectFifoReleaseOp>()) {
+      FifoPort fifo = {relOp.getObjectFifo(), relOp.getPort()};
+      if (LoopFifoUse *use = findUse(fifo)) {
+        use->numReleases++;
+        use->relSize = relOp.relNumber();
+        if (relOp->isBeforeInBlock(use->acqOp))
+          releasedFirst.insert(fifo);
+      }
+    }
+    std::set<FifoPort> nested;
+    body->walk([&](Operation *op) {
+      if (op->getParentOp() == forLoop)
+        return;
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op))
+        nested.insert({acqOp.getObjectFifo(), acqOp.getPort()});
+      else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op))
+        nested.insert({relOp.getObjectFifo(), relOp.getPort()});
+    });
+    for (auto &[fifo, use] : uses)
+      use.rotatable = use.numAcquires == 1 && use.numReleases == 1 &&
+                      use.relSize <= use.acqSize &&
+                      releasedFirst.count(fifo) == 0 &&
+                      nested.count(fifo) == 0;
+    return uses;
+  }
+
+  // Cost of unrolling a loop by the least common multiple of the depths of
+  // its objectFifo ports that are not in dynamicFifos, with the ports in
+  // dynamicFifos accessed through a runtime index.
+  LoopLoweringCost
+  evaluateUnroll(const std::vector<std::pair<FifoPort, LoopFifoUse>> &uses,
+                 const std::set<FifoPort> &dynamicFifos, int64_t tripCount,
+                 int64_t bodyBytes) {
+    std::set<int> depths;
+    int64_t dynamicOps = 0;
+    int64_t dynamicCycles = 0;
+    for (auto &[fifo, use] : uses) {
+      if (dynamicFifos.count(fifo) == 0) {
+        depths.insert(use.depth);
+        continue;
+      }
+      dynamicOps += use.numAccesses * (2 + use.depth) +
+                    use.numReleases * kDynamicReleaseOps;
+      dynamicCycles += use.numAccesses * kDynamicAccessCycles +
+                       use.numReleases * kDynamicReleaseCycles;
+    }
+    LoopLoweringCost cost;
+    cost.unrollFactor = computeLCM(depths);
+    int64_t copies = cost.unrollFactor;
+    if (tripCount > 0) {
+      cost.unrollFactor = std::min<int64_t>(cost.unrollFactor, tripCount);
+      copies = cost.unrollFactor + tripCount % cost.unrollFactor;
+    }
+    cost.codeBytes =
+        copies * (bodyBytes + dynamicOps * kBytesPerOp) - bodyBytes;
+    cost.cycles = std::max<int64_t>(tripCount, 1) * dynamicCycles;
+    return cost;
+  }
+
+  // Cost of rotating the buffers of all objectFifo ports of a loop through
+  // loop-carried values: selecting the buffer order and advancing the runtime
+  // index once per port outside the loop, and moving the loop-carried buffers
+  // in every iteration.
+  LoopLoweringCost
+  evaluateRotation(const std::vector<std::pair<FifoPort, LoopFifoUse>> &uses,
+                   int64_t tripCount) {
+    LoopLoweringCost cost;
+    int64_t ops = 0;
+    for (auto &[fifo, use] : uses) {
+      ops += 2 + use.depth * use.depth + use.depth + kDynamicReleaseOps;
+      cost.cycles += kDynamicAccessCycles + kDynamicReleaseCycles +
+                     tripCount * use.depth;
+    }
+    cost.codeBytes = ops * kBytesPerOp;
+    return cost;
+  }
+
+  // Function that chooses how each loop of a core that contains objectFifo
+  // operations is lowered, based on the estimated program memory footprint
+  // of the core and the runtime overhead of each choice:
+  //  - unroll by the least common multiple of the objectFifo depths, which
+  //    has no runtime overhead,
+  //  - partially unroll by the depths of some of the objectFifos and access
+  //    the others through a modular runtime index, as done by
+  //    dynamicGlobalObjectFifos(),
+  //  - keep the loop rolled and rotate the buffers of its objectFifos through
+  //    loop-carried values, see rotateObjectFifoBuffers().
+  // Loops are visited innermost first. Each loop takes the cheapest choice at
+  // runtime that keeps the core within the program memory size, or the
+  // smallest one if none does. Returns the objectFifo ports of the core that
+  // need a runtime index, and records the loops to rotate in rotatedLoops.
+  // Each decision is reported as a remark on its loop.
+  std::set<FifoPort> chooseLoopLowerings(CoreOp coreOp) {
+    bool semaphoreLocks = getTargetModel(coreOp).hasProperty(
+        AIETargetModel::UsesSemaphoreLocks);
+    int64_t budget = clProgramMemorySize;
+    std::set<FifoPort> dynamicFifos;
+    std::set<Operation *> rotated;
+    std::map<Operation *, int64_t> extraBytes;
+    int64_t coreBytes = estimateCodeSize(coreOp) - kBytesPerOp;
+
+    std::vector<scf::ForOp> loops;
+    coreOp.walk([&](scf::ForOp forLoop) {
+      if (!forLoop.getBody()->getOps<ObjectFifoAcquireOp>().empty())
+        loops.push_back(forLoop);
+    });
+
+    auto getBodyBytes = [&](scf::ForOp forLoop) {
+      int64_t bodyBytes = 0;
+      for (auto &op : forLoop.getBody()->without_terminator())
+        bodyBytes += estimateCodeSize(&op);
+      forLoop.getBody()->walk([&](scf::ForOp inner) {
+        if (auto it = extraBytes.find(inner); it != extraBytes.end())
+          bodyBytes += it->second;
+      });
+      return bodyBytes;
+    };
+
+    for (auto forLoop : loops) {
+      auto uses = collectLoopFifoUses(forLoop);
+      int64_t tripCount = getConstantTripCount(forLoop);
+      int64_t bodyBytes = getBodyBytes(forLoop);
+
+      // Accessing objects through a runtime index relies on lock operations
+      // that do not depend on the index of the object, i.e. semaphore locks.
+      std::vector<FifoPort> candidates;
+      if (semaphoreLocks)
+        for (auto &[fifo, use] : uses)
+          if (dynamicFifos.count(fifo) == 0)
+            candidates.push_back(fifo);
+
+      struct Choice {
+        std::set<FifoPort> dynamicFifos;
+        bool rotate;
+        LoopLoweringCost cost;
+      };
+      std::vector<Choice> choices;
+      auto addUnrollChoice = [&](std::set<FifoPort> dynamic) {
+        LoopLoweringCost cost =
+            evaluateUnroll(uses, dynamic, tripCount, bodyBytes);
+        // Loops without a constant trip count cannot be unrolled.
+        if (tripCount == 0 && cost.unrollFactor > 1)
+          return;
+        choices.push_back({std::move(dynamic), false, cost});
+      };
+      if (candidates.size() <= 8) {
+        for (unsigned mask = 0; mask < (1u << candidates.size()); ++mask) {
+          std::set<FifoPort> dynamic = dynamicFifos;
+          for (unsigned i = 0; i < candidates.size(); ++i)
+            if (mask & (1u << i))
+              dynamic.insert(candidates[i]);
+          addUnrollChoice(dynamic);
+        }
+      } else {
+        addUnrollChoice(dynamicFifos);
+        std::set<FifoPort> dynamic = dynamicFifos;
+        dynamic.insert(candidates.begin(), candidates.end());
+        addUnrollChoice(dynamic);
+      }
+      if (semaphoreLocks && tripCount > 0 &&
+          llvm::all_of(uses, [](auto &use) { return use.second.rotatable; })) {
+        std::set<FifoPort> dynamic = dynamicFifos;
+        for (auto &[fifo, use] : uses)
+          dynamic.insert(fifo);
+        choices.push_back({dynamic, true, evaluateRotation(uses, tripCount)});
+      }
+      if (choices.empty())
+        choices.push_back({dynamicFifos, false,
+                           evaluateUnroll(uses, dynamicFifos, tripCount,
+                                          bodyBytes)});
+
+      auto fits = [&](const Choice &c) {
+        return coreBytes + c.cost.codeBytes <= budget;
+      };
+      const Choice *best = &choices.front();
+      for (const Choice &c : choices) {
+        if (fits(c) != fits(*best)) {
+          if (fits(c))
+            best = &c;
+          continue;
+        }
+        auto key = [&](const Choice &x) {
+          return fits(x) ? std::make_pair(x.cost.cycles, x.cost.codeBytes)
+                         : std::make_pair(x.cost.codeBytes, x.cost.cycles);
+        };
+        if (key(c) < key(*best))
+          best = &c;
+      }
+
+      dynamicFifos = best->dynamicFifos;
+      if (best->rotate)
+        rotated.insert(forLoop);
+      coreBytes += best->cost.codeBytes;
+      extraBytes[forLoop] = best->cost.codeBytes;
+    }
+
+    // Report the decisions. objectFifo ports that later loops chose to access
+    // through a runtime index reduce the unroll factor of earlier loops.
+    int64_t finalCoreBytes = estimateCodeSize(coreOp) - kBytesPerOp;
+    for (auto forLoop : loops) {
+      auto uses = collectLoopFifoUses(forLoop);
+      int64_t tripCount = getConstantTripCount(forLoop);
+      std::vector<std::string> names;
+      for (auto &[fifo, use] : uses)
+        if (dynamicFifos.count(fifo) > 0)
+          names.push_back(("@" + fifo.first.getName()).str());
+      llvm::sort(names);
+      std::string fifoList = llvm::join(names, ", ");
+
+      LoopLoweringCost cost;
+      auto remark = forLoop.emitRemark("objectFifo loop lowering: ");
+      if (rotated.count(forLoop) > 0) {
+        cost = evaluateRotation(uses, tripCount);
+        remark << "rotating buffer table for " << fifoList;
+      } else {
+        cost = evaluateUnroll(uses, dynamicFifos, tripCount,
+                              getBodyBytes(forLoop));
+        if (names.empty() && cost.unrollFactor > 1)
+          remark << "unroll by " << cost.unrollFactor;
+        else if (names.empty())
+          remark << "no unrolling";
+        else if (cost.unrollFactor > 1)
+          remark << "partial unroll by " << cost.unrollFactor
+                 << " with runtime index for " << fifoList;
+        else
+          remark << "runtime index for " << fifoList;
+      }
+      remark << " (estimated +" << cost.codeBytes
+             << " bytes of program memory, +" << cost.cycles << " cycles)";
+      finalCoreBytes += cost.codeBytes;
+    }
+    if (finalCoreBytes > budget)
+      coreOp.emitWarning() << "estimated program memory footprint of "
+                           << finalCoreBytes << " bytes exceeds "
+                           << budget << " bytes";
+
+    rotatedLoops.insert(rotated.begin(), rotated.end());
+    return dynamicFifos;
+  }
+
   /// Function used to create a UseLockOp based on input parameters.
   /// acc is an accumulator map that tracks the indices of the next locks to
   /// acquire (or release). Uses op to find index of acc for next lockID.
@@ -1587,10 +2073,20 @@ struct AIEObjectFifoStatefulTransformPass
 
         // create flow
         builder.setInsertionPointAfter(producer);
-        builder.create<FlowOp>(builder.getUnknownLoc(),
-                               producer.getProducerTile(), producerWireType,
-                               producerChan.channel, consumer.getProducerTile(),
-                               consumerWireType, consumerChan.channel);
+        auto flow = builder.create<FlowOp>(
+            builder.getUnknownLoc(), producer.getProducerTile(),
+            producerWireType, producerChan.channel, consumer.getProducerTile(),
+            consumerWireType, consumerChan.channel);
+
+        // tag the inputs of a join, so that routing can balance their
+        // latencies
+        if (std::optional<ObjectFifoLinkOp> linkOp =
+                getOptionalLinkOp(producer);
+            linkOp && linkOp->isJoin() &&
+            llvm::is_contained(linkOp->getInputObjectFifos(), producer))
+          flow->setAttr(balanceGroupAttr,
+                        builder.getStringAttr(
+                            linkOp->getOutputObjectFifos()[0].getName()));
       }
     }
 
@@ -1616,9 +2112,22 @@ struct AIEObjectFifoStatefulTransformPass
           }
         }
       }
+      // With the loop cost model, cores that did not choose a lowering
+      // through their dynamic_objfifo_lowering attribute may mix unrolling
+      // with runtime indexing per loop.
+      std::map<TileOp, std::set<FifoPort>> costModelFifos;
+      if (clLoopCostModel)
+        for (auto c : device.getOps<CoreOp>())
+          if (unrollTiles.count(c.getTileOp()) > 0 &&
+              !c.getDynamicObjfifoLowering().has_value())
+            costModelFifos[c.getTileOp()] = chooseLoopLowerings(c);
       if (failed(dynamicGlobalObjectFifos(device, builder, dynamicTiles)))
         signalPassFailure();
-      if (failed(unrollForLoops(device, builder, unrollTiles)))
+      if (failed(dynamicGlobalObjectFifos(device, builder, unrollTiles,
+                                          &costModelFifos)))
+        signalPassFailure();
+      if (failed(
+              unrollForLoops(device, builder, unrollTiles, costModelFifos)))
         signalPassFailure();
     }
 
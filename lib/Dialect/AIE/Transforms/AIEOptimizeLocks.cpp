@@ -0,0 +1,158 @@
+//===- AIEOptimizeLocks.cpp -------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-optimize-locks"
+
+namespace {
+
+// Only blocking acquire_ge and release operations of AIE2 semaphore locks are
+// rewritten. Their effect is to wait for and subtract, or to add, a value.
+bool isSemaphoreOp(UseLockOp op) {
+  return (op.acquireGE() || op.release()) && op.getTimeout() == 1 &&
+         op.getLock().getDefiningOp<LockOp>();
+}
+
+// Ops between two lock operations that neither touch memory nor contain
+// other ops cannot observe whether the lock operations were merged.
+bool isTransparent(Operation *op) {
+  return op->getNumRegions() == 0 && isMemoryEffectFree(op);
+}
+
+// AIE2 lock values are 6-bit, so no lock operation can wait for or add more.
+constexpr int maxLockValue = 63;
+
+struct AIEOptimizeLocksPass : AIEOptimizeLocksBase<AIEOptimizeLocksPass> {
+  // The locks that only `core` acquires. Any other agent may release them,
+  // but none can take a value that `core` released before it acquires it
+  // again. A lock that is used by anything but use_lock ops, by value or by
+  // its symbol name, is never private.
+  DenseSet<Operation *> privatelyAcquiredLocks(DeviceOp device, CoreOp core) {
+    DenseSet<Operation *> locks;
+    for (LockOp lock : device.getOps<LockOp>()) {
+      if (lock.hasName() &&
+          !SymbolTable::symbolKnownUseEmpty(lock.name(), device))
+        continue;
+      bool isPrivate = true;
+      bool acquiredByCore = false;
+      for (Operation *user : lock->getUsers()) {
+        auto useLock = dyn_cast<UseLockOp>(user);
+        if (!useLock) {
+          isPrivate = false;
+          break;
+        }
+        if (useLock.release())
+          continue;
+        if (useLock->getParentOfType<CoreOp>() != core) {
+          isPrivate = false;
+          break;
+        }
+        acquiredByCore = true;
+      }
+      if (isPrivate && acquiredByCore)
+        locks.insert(lock);
+    }
+    return locks;
+  }
+
+  void setValue(UseLockOp op, int value) {
+    op.setValueAttr(IntegerAttr::get(IntegerType::get(op.getContext(), 32),
+                                     value));
+  }
+
+  // Merges adjacent operations on the same lock in `block`. This is a
+  // peephole over neighbouring ops, not a dataflow analysis:
+  //  - acquire_ge(a); acquire_ge(b) waits for a + b as a single acquire_ge,
+  //    at the position of the first one. Holding `a` while waiting for `b`
+  //    never helps another agent make progress.
+  //  - release(a); release(b) becomes one release(a + b), at the position of
+  //    the second one.
+  //  - release(a); acquire_ge(b) on a lock only this core acquires cancels
+  //    out to release(a - b) or acquire_ge(b - a), or to nothing.
+  // Merges whose value exceeds maxLockValue are skipped.
+  void optimizeBlock(Block &block, const DenseSet<Operation *> &privateLocks) {
+    UseLockOp prev;
+    for (Operation &op : llvm::make_early_inc_range(block)) {
+      auto curr = dyn_cast<UseLockOp>(op);
+      if (!curr) {
+        if (!isTransparent(&op))
+          prev = nullptr;
+        for (Region &region : op.getRegions())
+          for (Block &nested : region)
+            optimizeBlock(nested, privateLocks);
+        continue;
+      }
+      if (!isSemaphoreOp(curr)) {
+        prev = nullptr;
+        continue;
+      }
+      if (!prev || prev.getLock() != curr.getLock() ||
+          prev.getAcqEn() != curr.getAcqEn()) {
+        prev = curr;
+        continue;
+      }
+
+      int prevValue = prev.getLockValue();
+      int currValue = curr.getLockValue();
+      bool fits = prevValue + currValue <= maxLockValue;
+      if (prev.acquireGE() && curr.acquireGE() && fits) {
+        setValue(prev, prevValue + currValue);
+        curr.erase();
+      } else if (prev.release() && curr.release() && fits) {
+        setValue(curr, prevValue + currValue);
+        prev.erase();
+        prev = curr;
+      } else if (prev.release() && curr.acquireGE() &&
+                 privateLocks.contains(prev.getLockOp())) {
+        if (prevValue > currValue) {
+          setValue(prev, prevValue - currValue);
+          curr.erase();
+        } else if (prevValue < currValue) {
+          setValue(curr, currValue - prevValue);
+          prev.erase();
+          prev = curr;
+        } else {
+          prev.erase();
+          curr.erase();
+          prev = nullptr;
+        }
+      } else {
+        prev = curr;
+      }
+    }
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    if (device.getTargetModel().getTargetArch() == AIEArch::AIE1)
+      return; // AIE1 locks are binary, not semaphores.
+
+    for (CoreOp core : device.getOps<CoreOp>()) {
+      DenseSet<Operation *> privateLocks = privatelyAcquiredLocks(device, core);
+      for (Block &block : core.getBody())
+        optimizeBlock(block, privateLocks);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIEOptimizeLocksPass() {
+  return std::make_unique<AIEOptimizeLocksPass>();
+}
@@ -15,6 +15,9 @@
 #include "llvm/Support/raw_os_ostream.h"
 
 #include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/bit.h"
+
+#include <queue>
 
 using namespace mlir;
 using namespace xilinx;
@@ -34,6 +37,13 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
 
   pathfinder->initialize(maxCol, maxRow, device.getTargetModel());
 
+  std::optional<RoutingCache> cache;
+  if (!routingCacheDir.empty()) {
+    cache.emplace(routingCacheDir, device, maxCol, maxRow);
+    if (std::string settings = pathfinder->getSettings(); !settings.empty())
+      cache->addOption(settings);
+  }
+
   // For each flow (circuit + packet) in the device, add it to pathfinder. Each
   // source can map to multiple different destinations (fanout). Control packet
   // flows to be routed (as prioritized routings). Then followed by normal
@@ -68,6 +78,9 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
                          // priority, to ensure routing consistency.
         pathfinder->addFlow(srcCoords, srcPort, dstCoords, dstPort,
                             /*isPktFlow*/ true, priorityFlow);
+        if (cache)
+          cache->addFlow(srcCoords, srcPort, dstCoords, dstPort,
+                         /*isPktFlow*/ true, priorityFlow);
       }
     }
   }
@@ -76,7 +89,9 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
   pathfinder->sortFlows(device.getTargetModel().columns(),
                         device.getTargetModel().rows());
 
-  // Add circuit flows.
+  // Add circuit flows. Flows that join in the same objectFifo link are tagged
+  // with the link, so that their latencies can be balanced.
+  llvm::MapVector<StringRef, std::vector<PathEndPoint>> latencyGroups;
   for (FlowOp flowOp : device.getOps<FlowOp>()) {
     TileOp srcTile = cast<TileOp>(flowOp.getSource().getDefiningOp());
     TileOp dstTile = cast<TileOp>(flowOp.getDest().getDefiningOp());
@@ -92,6 +107,19 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
                << "\n");
     pathfinder->addFlow(srcCoords, srcPort, dstCoords, dstPort,
                         /*isPktFlow*/ false, /*isPriorityFlow*/ false);
+    if (cache)
+      cache->addFlow(srcCoords, srcPort, dstCoords, dstPort,
+                     /*isPktFlow*/ false, /*isPriorityFlow*/ false);
+    if (auto group = flowOp->getAttrOfType<StringAttr>(balanceGroupAttr))
+      latencyGroups[group.getValue()].push_back({srcCoords, srcPort});
+  }
+  if (balanceLatency) {
+    std::vector<std::vector<PathEndPoint>> groups;
+    for (auto &[_, srcs] : latencyGroups)
+      groups.push_back(srcs);
+    pathfinder->balanceLatencies(std::move(groups));
+    if (cache)
+      cache->addOption("balance-latency");
   }
 
   // add existing connections so Pathfinder knows which resources are
@@ -99,15 +127,27 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
   for (SwitchboxOp switchboxOp : device.getOps<SwitchboxOp>()) {
     if (!pathfinder->addFixedConnection(switchboxOp))
       return switchboxOp.emitOpError() << "Unable to add fixed connections";
+    if (cache)
+      cache->addFixedConnection(switchboxOp);
   }
 
   // all flows are now populated, call the congestion-aware pathfinder
-  // algorithm
+  // algorithm, unless an earlier compilation routed the same flows
   // check whether the pathfinder algorithm creates a legal routing
-  if (auto maybeFlowSolutions = pathfinder->findPaths(maxIterations))
-    flowSolutions = maybeFlowSolutions.value();
-  else
-    return device.emitError("Unable to find a legal routing");
+  std::optional<std::map<PathEndPoint, SwitchSettings>> maybeFlowSolutions;
+  if (cache)
+    maybeFlowSolutions = cache->lookup();
+  if (!maybeFlowSolutions) {
+    maybeFlowSolutions = pathfinder->findPaths(maxIterations);
+    if (!maybeFlowSolutions)
+      return device.emitError("Unable to find a legal routing");
+    // A routing that depends on how long the router ran is not stored, so
+    // that a later compilation may find a better one.
+    if (cache && pathfinder->isReproducible() &&
+        failed(cache->store(*maybeFlowSolutions)))
+      device.emitWarning("Unable to cache the routing in ") << routingCacheDir;
+  }
+  flowSolutions = maybeFlowSolutions.value();
 
   // initialize all flows as unprocessed to prep for rewrite
   for (const auto &[PathEndPoint, switchSetting] : flowSolutions) {
@@ -421,6 +461,44 @@ bool Pathfinder::addFixedConnection(SwitchboxOp switchboxOp) {
 
 static constexpr double INF = std::numeric_limits<double>::max();
 
+const std::vector<PathEndPoint> &Pathfinder::getChannels(PathEndPoint src) {
+  // get all channels src connects to
+  if (channels.count(src) == 0) {
+    auto &sb = graph[std::make_pair(src.coords, src.coords)];
+    for (size_t i = 0; i < sb.srcPorts.size(); i++) {
+      for (size_t j = 0; j < sb.dstPorts.size(); j++) {
+        if (sb.srcPorts[i] == src.port &&
+            sb.connectivity[i][j] == Connectivity::AVAILABLE) {
+          // connections within the same switchbox
+          channels[src].push_back(PathEndPoint{src.coords, sb.dstPorts[j]});
+        }
+      }
+    }
+    // connections to neighboring switchboxes
+    std::vector<std::pair<TileID, Port>> neighbors = {
+        {{src.coords.col, src.coords.row - 1},
+         {WireBundle::North, src.port.channel}},
+        {{src.coords.col - 1, src.coords.row},
+         {WireBundle::East, src.port.channel}},
+        {{src.coords.col, src.coords.row + 1},
+         {WireBundle::South, src.port.channel}},
+        {{src.coords.col + 1, src.coords.row},
+         {WireBundle::West, src.port.channel}}};
+
+    for (const auto &[neighborCoords, neighborPort] : neighbors) {
+      if (graph.count(std::make_pair(src.coords, neighborCoords)) > 0 &&
+          src.port.bundle == getConnectingBundle(neighborPort.bundle)) {
+        auto &sb = graph[std::make_pair(src.coords, neighborCoords)];
+        if (std::find(sb.dstPorts.begin(), sb.dstPorts.end(), neighborPort) !=
+            sb.dstPorts.end())
+          channels[src].push_back({neighborCoords, neighborPort});
+      }
+    }
+    std::sort(channels[src].begin(), channels[src].end());
+  }
+  return channels[src];
+}
+
 std::map<PathEndPoint, PathEndPoint>
 Pathfinder::dijkstraShortestPaths(PathEndPoint src) {
   // Use std::map instead of DenseMap because DenseMap doesn't let you
@@ -444,42 +522,7 @@ Pathfinder::dijkstraShortestPaths(PathEndPoint src) {
     src = Q.top();
     Q.pop();
 
-    // get all channels src connects to
-    if (channels.count(src) == 0) {
-      auto &sb = graph[std::make_pair(src.coords, src.coords)];
-      for (size_t i = 0; i < sb.srcPorts.size(); i++) {
-        for (size_t j = 0; j < sb.dstPorts.size(); j++) {
-          if (sb.srcPorts[i] == src.port &&
-              sb.connectivity[i][j] == Connectivity::AVAILABLE) {
-            // connections within the same switchbox
-            channels[src].push_back(PathEndPoint{src.coords, sb.dstPorts[j]});
-          }
-        }
-      }
-      // connections to neighboring switchboxes
-      std::vector<std::pair<TileID, Port>> neighbors = {
-          {{src.coords.col, src.coords.row - 1},
-           {WireBundle::North, src.port.channel}},
-          {{src.coords.col - 1, src.coords.row},
-           {WireBundle::East, src.port.channel}},
-          {{src.coords.col, src.coords.row + 1},
-           {WireBundle::South, src.port.channel}},
-          {{src.coords.col + 1, src.coords.row},
-           {WireBundle::West, src.port.channel}}};
-
-      for (const auto &[neighborCoords, neighborPort] : neighbors) {
-        if (graph.count(std::make_pair(src.coords, neighborCoords)) > 0 &&
-            src.port.bundle == getConnectingBundle(neighborPort.bundle)) {
-          auto &sb = graph[std::make_pair(src.coords, neighborCoords)];
-          if (std::find(sb.dstPorts.begin(), sb.dstPorts.end(), neighborPort) !=
-              sb.dstPorts.end())
-            channels[src].push_back({neighborCoords, neighborPort});
-        }
-      }
-      std::sort(channels[src].begin(), channels[src].end());
-    }
-
-    for (auto &dest : channels[src]) {
+    for (auto &dest : getChannels(src)) {
       if (distance.count(dest) == 0)
         distance[dest] = INF;
       auto &sb = graph[std::make_pair(src.coords, dest.coords)];
@@ -511,6 +554,139 @@ Pathfinder::dijkstraShortestPaths(PathEndPoint src) {
   return preds;
 }
 
+double Pathfinder::getDemand(PathEndPoint src, PathEndPoint dst) {
+  auto &sb = graph[std::make_pair(src.coords, dst.coords)];
+  size_t i = std::distance(
+      sb.srcPorts.begin(),
+      std::find(sb.srcPorts.begin(), sb.srcPorts.end(), src.port));
+  size_t j = std::distance(
+      sb.dstPorts.begin(),
+      std::find(sb.dstPorts.begin(), sb.dstPorts.end(), dst.port));
+  assert(i < sb.srcPorts.size());
+  assert(j < sb.dstPorts.size());
+  return sb.demand[i][j];
+}
+
+void Pathfinder::balanceLatencies(
+    std::vector<std::vector<PathEndPoint>> groups) {
+  balanceLatency = true;
+  latencyGroups = std::move(groups);
+}
+
+// Every destination of a flow should be as many switchboxes away as its
+// farthest one, and every flow of a group as the farthest destination of the
+// group. Distances are Manhattan distances, which paths cannot undercut.
+std::map<PathEndPoint, int> Pathfinder::getHopTargets() {
+  std::map<PathEndPoint, int> hopTargets;
+  for (const Flow &flow : flows) {
+    int &target = hopTargets[flow.src];
+    for (const PathEndPoint &dst : flow.dsts)
+      target =
+          std::max(target, std::abs(dst.coords.col - flow.src.coords.col) +
+                               std::abs(dst.coords.row - flow.src.coords.row));
+  }
+  for (const std::vector<PathEndPoint> &group : latencyGroups) {
+    int target = 0;
+    for (const PathEndPoint &src : group)
+      target = std::max(target, hopTargets[src]);
+    for (const PathEndPoint &src : group)
+      hopTargets[src] = target;
+  }
+  return hopTargets;
+}
+
+void Pathfinder::balanceBranch(PathEndPoint src, PathEndPoint dst,
+                               int targetHops,
+                               const std::set<PathEndPoint> &processed,
+                               std::map<PathEndPoint, PathEndPoint> &preds) {
+  if (!preds.count(dst) || processed.count(dst))
+    return;
+  auto getHops = [&](PathEndPoint node) {
+    int hops = 0;
+    for (; !(node == src); node = preds[node])
+      if (preds[node].coords != node.coords)
+        hops++;
+    return hops;
+  };
+  int currentHops = getHops(dst);
+  if (currentHops == targetHops)
+    return;
+
+  // Search the cheapest path for every number of hops up to one past the
+  // target, starting anywhere on the tree of the flow so far and never
+  // passing through it again.
+  using State = std::pair<PathEndPoint, int>;
+  std::map<State, double> distance;
+  std::map<State, State> statePreds;
+  std::priority_queue<std::pair<double, State>,
+                      std::vector<std::pair<double, State>>, std::greater<>>
+      queue;
+  auto getMinHops = [&](TileID coords) {
+    return std::abs(dst.coords.col - coords.col) +
+           std::abs(dst.coords.row - coords.row);
+  };
+  for (const PathEndPoint &node : processed) {
+    State state = {node, getHops(node)};
+    if (state.second + getMinHops(node.coords) > targetHops + 1)
+      continue;
+    distance[state] = 0.0;
+    queue.push({0.0, state});
+  }
+  while (!queue.empty()) {
+    auto [cost, state] = queue.top();
+    queue.pop();
+    if (cost > distance[state])
+      continue;
+    auto [node, hops] = state;
+    for (const PathEndPoint &next : getChannels(node)) {
+      int nextHops = hops + (next.coords != node.coords);
+      if (processed.count(next) ||
+          nextHops + getMinHops(next.coords) > targetHops + 1)
+        continue;
+      State nextState = {next, nextHops};
+      double nextCost = cost + getDemand(node, next);
+      auto it = distance.find(nextState);
+      if (it != distance.end() && it->second <= nextCost)
+        continue;
+      distance[nextState] = nextCost;
+      statePreds[nextState] = state;
+      queue.push({nextCost, nextState});
+    }
+  }
+
+  // Prefer the number of hops closest to the target, then fewer hops.
+  std::optional<State> best;
+  for (int hops = 0; hops <= targetHops + 1; hops++) {
+    if (!distance.count({dst, hops}))
+      continue;
+    if (!best ||
+        std::abs(hops - targetHops) < std::abs(best->second - targetHops))
+      best = State{dst, hops};
+  }
+  if (!best ||
+      std::abs(best->second - targetHops) >= std::abs(currentHops - targetHops))
+    return;
+
+  // Trace the path back to the tree. Detours must not pass through a port
+  // twice.
+  std::vector<PathEndPoint> path;
+  std::set<PathEndPoint> visited;
+  for (State state = *best;;) {
+    if (!visited.insert(state.first).second)
+      return;
+    path.push_back(state.first);
+    auto pred = statePreds.find(state);
+    if (pred == statePreds.end())
+      break;
+    state = pred->second;
+  }
+  for (size_t k = 0; k + 1 < path.size(); k++)
+    preds[path[k]] = path[k + 1];
+  LLVM_DEBUG(llvm::dbgs() << "\t\tBalanced the path to " << dst << " from "
+                          << currentHops << " to " << best->second
+                          << " hops (target " << targetHops << ")\n");
+}
+
 // Perform congestion-aware routing for all flows which have been added.
 // Use Dijkstra's shortest path to find routes, and use "demand" as the
 // weights. If the routing finds too much congestion, update the demand
@@ -541,6 +717,10 @@ Pathfinder::findPaths(const int maxIterations) {
     groupedFlows[f.packetGroupId].push_back(f);
   }
 
+  std::map<PathEndPoint, int> hopTargets;
+  if (balanceLatency)
+    hopTargets = getHopTargets();
+
   int iterationCount = -1;
   int illegalEdges = 0;
 #ifndef NDEBUG
@@ -600,6 +780,8 @@ Pathfinder::findPaths(const int maxIterations) {
             // route to self
             switchSettings[src.coords].srcs.push_back(src.port);
             switchSettings[src.coords].dsts.push_back(src.port);
+          } else if (balanceLatency) {
+            balanceBranch(src, endPoint, hopTargets[src], processed, preds);
           }
           auto curr = endPoint;
           // trace backwards until a vertex already processed is reached
@@ -713,3 +895,60 @@ Pathfinder::findPaths(const int maxIterations) {
 int AIE::getWireBundleAsInt(WireBundle bundle) {
   return static_cast<typename std::underlying_type<WireBundle>::type>(bundle);
 }
+
+SmallVector<PacketIDCube> AIE::coverPacketIDs(ArrayRef<int> ids,
+                                              ArrayRef<int> excluded,
+                                              int idBits) {
+  int fullMask = (1 << idBits) - 1;
+  if (ids.empty())
+    return {};
+
+  // IDs in both sets cannot be told apart; leave them to the caller.
+  SmallVector<int> offSet;
+  for (int id : excluded)
+    if (!llvm::is_contained(ids, id))
+      offSet.push_back(id);
+  auto isLegal = [&](PacketIDCube cube) {
+    return llvm::none_of(offSet, [&](int id) { return cube.matches(id); });
+  };
+
+  // The smallest rule enclosing all IDs: its mask keeps the bits on which
+  // the IDs agree.
+  int differing = 0;
+  for (int id : ids)
+    differing |= id ^ ids.front();
+  PacketIDCube enclosing{fullMask & ~differing, ids.front() & ~differing};
+  if (isLegal(enclosing))
+    return {enclosing};
+
+  // Otherwise, greedily cover the IDs with the legal rule matching most of
+  // the uncovered ones. There are only 3^idBits rules, so enumerate them all;
+  // ties go to the narrowest rule so that fewer unused IDs are captured.
+  SmallVector<PacketIDCube> legal;
+  for (int mask = fullMask; mask >= 0; mask--)
+    for (int value = 0; value <= fullMask; value++)
+      if ((value & ~mask) == 0 && isLegal({mask, value}))
+        legal.push_back({mask, value});
+
+  auto fixedBits = [](PacketIDCube cube) {
+    return llvm::popcount(static_cast<unsigned>(cube.mask));
+  };
+  SmallVector<int> uncovered(ids.begin(), ids.end());
+  SmallVector<PacketIDCube> cover;
+  while (!uncovered.empty()) {
+    PacketIDCube best = {fullMask, uncovered.front()};
+    int bestCount = 0;
+    for (PacketIDCube cube : legal) {
+      int count = llvm::count_if(uncovered,
+                                 [&](int id) { return cube.matches(id); });
+      if (count > bestCount ||
+          (count == bestCount && fixedBits(cube) > fixedBits(best))) {
+        best = cube;
+        bestCount = count;
+      }
+    }
+    cover.push_back(best);
+    llvm::erase_if(uncovered, [&](int id) { return best.matches(id); });
+  }
+  return cover;
+}
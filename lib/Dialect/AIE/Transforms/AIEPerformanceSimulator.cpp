@@ -0,0 +1,1453 @@
+//===- AIEPerformanceSimulator.cpp ------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/Transforms/AIEPerformanceSimulator.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Format.h"
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <set>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-simulate-performance"
+
+namespace {
+
+// Bytes a stream moves per cycle.
+constexpr uint64_t kStreamBytesPerCycle = 4;
+// Cycles for the first word of a transfer to cross one switchbox.
+constexpr uint64_t kSwitchboxLatency = 1;
+
+struct LockAccess {
+  unsigned lock;
+  LockAction action;
+  int value;
+};
+
+// One instruction of a core program. Loops are kept as loops, so that cores
+// with long running loops do not need to be unrolled.
+struct Instruction {
+  enum class Kind { Lock, Compute, LoopBegin, LoopEnd };
+  Kind kind;
+  LockAccess access = {0, LockAction::Release, 0};
+  // Cycles of a compute, trip count of a loop.
+  int64_t count = 0;
+  // The other end of a loop.
+  unsigned jump = 0;
+  // Whether the body of a loop uses locks.
+  bool usesLocks = false;
+};
+
+struct BufferDescriptor {
+  SmallVector<LockAccess> acquires;
+  SmallVector<LockAccess> releases;
+  int64_t bytes = 0;
+  std::optional<unsigned> next;
+};
+
+struct StreamEndpoint {
+  // A DMA channel with BDs, the host, a core stream port, or a DMA channel
+  // without BDs, which never transfers.
+  enum class Kind { Unit, Host, Core, Unconfigured };
+  Kind kind;
+  unsigned unit = 0;
+};
+
+// A routed stream from one source to one or more destinations. A stream moves
+// data when its source and all its destinations are ready.
+struct Stream {
+  StreamEndpoint source;
+  SmallVector<StreamEndpoint> dests;
+  unsigned hops = 0;
+  bool moving = false;
+  uint64_t until = 0;
+  int64_t chunk = 0;
+  bool toHost = false;
+  // Source BDs delivered to the host, in total and in the steady state.
+  uint64_t hostTransfers = 0;
+  uint64_t steadyHostTransfers = 0;
+};
+
+struct LockState {
+  LockOp op;
+  int value = 0;
+  // Locks of devices without semaphore locks are held between an acquire and
+  // a release.
+  bool held = false;
+};
+
+bool canAcquire(const LockState &lock, const LockAccess &access,
+                bool semaphoreLocks) {
+  if (access.action == LockAction::AcquireGreaterEqual)
+    return lock.value >= access.value;
+  if (semaphoreLocks)
+    return lock.value == access.value;
+  return !lock.held && lock.value == access.value;
+}
+
+void acquireLock(LockState &lock, const LockAccess &access,
+                 bool semaphoreLocks) {
+  if (access.action == LockAction::AcquireGreaterEqual)
+    lock.value -= access.value;
+  else if (!semaphoreLocks)
+    lock.held = true;
+}
+
+void releaseLock(LockState &lock, const LockAccess &access,
+                 bool semaphoreLocks) {
+  if (semaphoreLocks) {
+    lock.value += access.value;
+  } else {
+    lock.value = access.value;
+    lock.held = false;
+  }
+}
+
+// When a lock was acquired, over the whole run and in the steady state.
+struct LockActivity {
+  struct Window {
+    uint64_t acquires = 0;
+    uint64_t first = 0;
+    uint64_t last = 0;
+
+    void record(uint64_t now) {
+      if (!acquires++)
+        first = now;
+      last = now;
+    }
+    std::optional<double> getInterval() const {
+      if (acquires < 2)
+        return std::nullopt;
+      return double(last - first) / (acquires - 1);
+    }
+  };
+  Window total;
+  Window steady;
+};
+
+struct Unit {
+  SimulatedUnit stats;
+  SmallVector<Instruction> program;
+  SmallVector<BufferDescriptor> bds;
+  unsigned pc = 0;
+  SmallVector<int64_t> loopCounts;
+  bool busy = false;
+  uint64_t busyUntil = 0;
+  // When the current loop iteration or BD started. One that would take no
+  // time takes a cycle instead, so that simulated time advances.
+  uint64_t stepStart = 0;
+  // BD chain state of a DMA channel.
+  enum class Phase { Acquire, Transfer, Release };
+  Phase phase = Phase::Acquire;
+  unsigned acquired = 0;
+  int64_t remaining = 0;
+  bool bdStart = false;
+  int64_t repeats = 0;
+  std::optional<unsigned> stream;
+  std::optional<unsigned> waitingOn;
+  bool done = false;
+
+  bool isCore() const { return stats.kind == SimulatedUnit::Kind::Core; }
+};
+
+// The state of a unit in the transition system of the lock analysis, in which
+// computing and moving data take no time.
+struct UnitState {
+  unsigned pc = 0;
+  SmallVector<int64_t> loopCounts;
+  Unit::Phase phase = Unit::Phase::Acquire;
+  unsigned acquired = 0;
+  int64_t remaining = 0;
+  int64_t repeats = 0;
+  bool done = false;
+  // Passes around a loop of a core or around the BD chain of a DMA channel.
+  unsigned iterations = 0;
+};
+
+struct SystemState {
+  SmallVector<UnitState> units;
+  SmallVector<LockState> locks;
+
+  std::vector<int64_t> encode() const {
+    std::vector<int64_t> key;
+    for (const UnitState &unit : units) {
+      key.push_back(unit.pc);
+      key.push_back(static_cast<int64_t>(unit.phase));
+      key.push_back(unit.acquired);
+      key.push_back(unit.remaining);
+      key.push_back(unit.repeats);
+      key.push_back(unit.done);
+      key.push_back(unit.iterations);
+      key.push_back(unit.loopCounts.size());
+      key.insert(key.end(), unit.loopCounts.begin(), unit.loopCounts.end());
+    }
+    for (const LockState &lock : locks) {
+      key.push_back(lock.value);
+      key.push_back(lock.held);
+    }
+    return key;
+  }
+};
+
+class Simulator {
+public:
+  Simulator(DeviceOp device, const PerformanceSimulatorOptions &options)
+      : device(device), options(options),
+        semaphoreLocks(device.getTargetModel().hasProperty(
+            AIETargetModel::UsesSemaphoreLocks)) {}
+
+  LogicalResult build() {
+    for (auto lock : device.getOps<LockOp>()) {
+      lockIndex[lock] = locks.size();
+      locks.push_back({lock, lock.getInit().value_or(0)});
+      lockActivity.emplace_back();
+    }
+    for (auto core : device.getOps<CoreOp>()) {
+      Unit unit;
+      unit.stats.kind = SimulatedUnit::Kind::Core;
+      unit.stats.tile = {core.colIndex(), core.rowIndex()};
+      if (failed(appendProgram(core.getBody().front(), unit.program)))
+        return failure();
+      units.push_back(std::move(unit));
+    }
+    for (auto mem : device.getOps<MemOp>())
+      if (failed(addDMAChannels(mem, mem.getTileOp())))
+        return failure();
+    for (auto mem : device.getOps<MemTileDMAOp>())
+      if (failed(addDMAChannels(mem, mem.getTileOp())))
+        return failure();
+    for (auto mem : device.getOps<ShimDMAOp>())
+      if (failed(addDMAChannels(mem, mem.getTileOp())))
+        return failure();
+    buildStreams();
+    return success();
+  }
+
+  PerformanceReport run();
+
+  LockAnalysisReport analyzeLocks(const LockAnalysisOptions &analysisOptions);
+
+private:
+  int64_t getKernelCycles(func::CallOp call) {
+    if (auto cycles = call->getAttrOfType<IntegerAttr>("aie.kernel_cycles"))
+      return cycles.getInt();
+    if (auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+            call, call.getCalleeAttr()))
+      if (auto cycles =
+              callee->getAttrOfType<IntegerAttr>("aie.kernel_cycles"))
+        return cycles.getInt();
+    return options.defaultKernelCycles;
+  }
+
+  LockAccess getAccess(UseLockOp useLock) {
+    return {lockIndex.lookup(useLock.getLock().getDefiningOp()),
+            useLock.getAction(), useLock.getLockValue()};
+  }
+
+  static bool usesLocks(Operation *op) {
+    return op
+        ->walk([](UseLockOp) { return WalkResult::interrupt(); })
+        .wasInterrupted();
+  }
+
+  LogicalResult appendProgram(Block &block,
+                              SmallVector<Instruction> &program) {
+    for (Operation &op : block) {
+      if (auto useLock = dyn_cast<UseLockOp>(op)) {
+        program.push_back({Instruction::Kind::Lock, getAccess(useLock)});
+      } else if (auto call = dyn_cast<func::CallOp>(op)) {
+        Instruction compute = {Instruction::Kind::Compute};
+        compute.count = getKernelCycles(call);
+        program.push_back(compute);
+      } else if (auto loop = dyn_cast<scf::ForOp>(op)) {
+        auto lb = getConstantIntValue(loop.getLowerBound());
+        auto ub = getConstantIntValue(loop.getUpperBound());
+        auto step = getConstantIntValue(loop.getStep());
+        std::optional<int64_t> tripCount;
+        if (lb && ub && step)
+          tripCount = constantTripCount(*lb, *ub, *step);
+        if (!tripCount)
+          return loop.emitError("loop without a constant trip count cannot "
+                                "be simulated");
+        // Loops analysed by aievec-cycle-estimate are costed as a whole.
+        auto cycles =
+            loop->getAttrOfType<IntegerAttr>("aievec.cycles_per_iter");
+        if (cycles && !usesLocks(loop)) {
+          Instruction compute = {Instruction::Kind::Compute};
+          compute.count = *tripCount * cycles.getInt();
+          program.push_back(compute);
+          continue;
+        }
+        unsigned begin = program.size();
+        Instruction loopBegin = {Instruction::Kind::LoopBegin};
+        loopBegin.count = *tripCount;
+        loopBegin.usesLocks = usesLocks(loop);
+        program.push_back(loopBegin);
+        if (failed(appendProgram(*loop.getBody(), program)))
+          return failure();
+        Instruction loopEnd = {Instruction::Kind::LoopEnd};
+        loopEnd.jump = begin;
+        program[begin].jump = program.size();
+        program.push_back(loopEnd);
+      } else if (op.getNumRegions()) {
+        if (usesLocks(&op))
+          return op.emitError("locks used in '")
+                 << op.getName() << "' cannot be simulated";
+        Instruction compute = {Instruction::Kind::Compute};
+        op.walk(
+            [&](func::CallOp call) { compute.count += getKernelCycles(call); });
+        program.push_back(compute);
+      }
+    }
+    return success();
+  }
+
+  LogicalResult addDMAChannels(Operation *memOp, TileOp tile) {
+    Region &body = memOp->getRegion(0);
+    if (!body.getOps<DMAOp>().empty())
+      return memOp->emitError("aie.dma operations cannot be simulated");
+    for (Block &block : body)
+      for (auto start : block.getOps<DMAStartOp>()) {
+        Unit unit;
+        unit.stats.kind = start.getChannelDir() == DMAChannelDir::MM2S
+                              ? SimulatedUnit::Kind::MM2S
+                              : SimulatedUnit::Kind::S2MM;
+        unit.stats.tile = {tile.colIndex(), tile.rowIndex()};
+        unit.stats.channel = start.getChannelIndex();
+        unit.repeats = start.getRepeatCount();
+
+        DenseMap<Block *, unsigned> bdIndex;
+        SmallVector<Block *> nextBlocks;
+        Block *bdBlock = start.getDest();
+        while (bdBlock && !bdIndex.count(bdBlock) &&
+               !bdBlock->getOps<DMABDOp>().empty()) {
+          BufferDescriptor bd;
+          for (Operation &op : *bdBlock) {
+            if (auto useLock = dyn_cast<UseLockOp>(op))
+              (useLock.release() ? bd.releases : bd.acquires)
+                  .push_back(getAccess(useLock));
+            else if (auto dmaBd = dyn_cast<DMABDOp>(op))
+              bd.bytes += dmaBd.getLenInBytes();
+          }
+          bdIndex[bdBlock] = unit.bds.size();
+          unit.bds.push_back(std::move(bd));
+          auto nextBd = dyn_cast<NextBDOp>(bdBlock->getTerminator());
+          bdBlock = nextBd ? nextBd.getDest() : nullptr;
+          nextBlocks.push_back(bdBlock);
+        }
+        for (auto [bd, next] : llvm::zip(unit.bds, nextBlocks))
+          if (auto it = bdIndex.find(next); it != bdIndex.end())
+            bd.next = it->second;
+        if (unit.bds.empty())
+          continue;
+
+        dmaUnits[{unit.stats.tile, start.getChannelDir(),
+                  unit.stats.channel}] = units.size();
+        units.push_back(std::move(unit));
+      }
+    return success();
+  }
+
+  StreamEndpoint getDMAEndpoint(TileID tile, DMAChannelDir dir, int channel) {
+    if (auto it = dmaUnits.find({tile, dir, channel}); it != dmaUnits.end())
+      return {StreamEndpoint::Kind::Unit, it->second};
+    if (device.getTargetModel().isShimNOCorPLTile(tile.col, tile.row))
+      return {StreamEndpoint::Kind::Host};
+    return {StreamEndpoint::Kind::Unconfigured};
+  }
+
+  using RouteKey = std::pair<TileID, Port>;
+
+  // Follows the connections of a switchbox (or shim mux) from input port
+  // `in` to the destinations of the stream.
+  void follow(TileID tile, Port in, bool inShimMux, unsigned hops,
+              Stream &stream, std::set<std::tuple<TileID, Port, bool>> &seen) {
+    if (!seen.insert({tile, in, inShimMux}).second)
+      return;
+    auto &routes = inShimMux ? shimMuxRoutes : switchboxRoutes;
+    auto it = routes.find({tile, in});
+    if (it == routes.end())
+      return;
+    for (Port out : it->second) {
+      int ch = out.channel;
+      switch (out.bundle) {
+      case WireBundle::North:
+        if (inShimMux)
+          follow(tile, {WireBundle::South, ch}, false, hops + 1, stream, seen);
+        else
+          follow({tile.col, tile.row + 1}, {WireBundle::South, ch}, false,
+                 hops + 1, stream, seen);
+        break;
+      case WireBundle::South:
+        if (shimMuxTiles.count(tile))
+          follow(tile, {WireBundle::North, ch}, true, hops, stream, seen);
+        else if (tile.row == 0)
+          stream.dests.push_back({StreamEndpoint::Kind::Host});
+        else
+          follow({tile.col, tile.row - 1}, {WireBundle::North, ch}, false,
+                 hops + 1, stream, seen);
+        break;
+      case WireBundle::East:
+        follow({tile.col + 1, tile.row}, {WireBundle::West, ch}, false,
+               hops + 1, stream, seen);
+        break;
+      case WireBundle::West:
+        follow({tile.col - 1, tile.row}, {WireBundle::East, ch}, false,
+               hops + 1, stream, seen);
+        break;
+      case WireBundle::DMA:
+        stream.dests.push_back(getDMAEndpoint(tile, DMAChannelDir::S2MM, ch));
+        break;
+      case WireBundle::Core:
+        stream.dests.push_back({StreamEndpoint::Kind::Core});
+        break;
+      case WireBundle::Trace:
+      case WireBundle::Ctrl:
+        break;
+      default:
+        stream.dests.push_back({StreamEndpoint::Kind::Host});
+        break;
+      }
+      stream.hops = std::max(stream.hops, hops);
+    }
+  }
+
+  void addStream(Stream stream) {
+    auto isUnit = [](const StreamEndpoint &e) {
+      return e.kind == StreamEndpoint::Kind::Unit;
+    };
+    // Streams between the host and cores never wait on the simulated units.
+    if (!isUnit(stream.source) && llvm::none_of(stream.dests, isUnit))
+      return;
+    stream.toHost = llvm::any_of(stream.dests, [](const StreamEndpoint &e) {
+      return e.kind == StreamEndpoint::Kind::Host;
+    });
+    if (isUnit(stream.source))
+      units[stream.source.unit].stream = streams.size();
+    for (const StreamEndpoint &dest : stream.dests)
+      if (isUnit(dest))
+        units[dest.unit].stream = streams.size();
+    streams.push_back(std::move(stream));
+  }
+
+  void buildStreams() {
+    for (auto switchbox : device.getOps<SwitchboxOp>()) {
+      TileID tile = {switchbox.colIndex(), switchbox.rowIndex()};
+      for (auto connect : switchbox.getConnections().getOps<ConnectOp>())
+        switchboxRoutes[{tile, connect.sourcePort()}].push_back(
+            connect.destPort());
+    }
+    for (auto shimMux : device.getOps<ShimMuxOp>()) {
+      TileID tile = {shimMux.colIndex(), shimMux.rowIndex()};
+      shimMuxTiles.insert(tile);
+      for (auto connect : shimMux.getConnections().getOps<ConnectOp>())
+        shimMuxRoutes[{tile, connect.sourcePort()}].push_back(
+            connect.destPort());
+    }
+    if (!device.getOps<PacketFlowOp>().empty() ||
+        device.walk([](MasterSetOp) { return WalkResult::interrupt(); })
+            .wasInterrupted())
+      device.emitWarning("packet-switched streams are not simulated");
+
+    // Designs that are not routed yet are simulated from their flows.
+    if (switchboxRoutes.empty()) {
+      std::map<RouteKey, Stream> flowStreams;
+      for (auto flow : device.getOps<FlowOp>()) {
+        auto src = cast<TileOp>(flow.getSource().getDefiningOp());
+        auto dst = cast<TileOp>(flow.getDest().getDefiningOp());
+        TileID srcID = {src.colIndex(), src.rowIndex()};
+        TileID dstID = {dst.colIndex(), dst.rowIndex()};
+        Stream &stream =
+            flowStreams[{srcID, {flow.getSourceBundle(), flow.sourceIndex()}}];
+        stream.source = getEndpoint(srcID, flow.getSourceBundle(),
+                                    flow.sourceIndex(), DMAChannelDir::MM2S);
+        stream.dests.push_back(getEndpoint(dstID, flow.getDestBundle(),
+                                           flow.destIndex(),
+                                           DMAChannelDir::S2MM));
+        stream.hops = std::max<unsigned>(
+            stream.hops, std::abs(srcID.col - dstID.col) +
+                             std::abs(srcID.row - dstID.row) + 1);
+      }
+      for (auto &[key, stream] : flowStreams)
+        addStream(std::move(stream));
+      return;
+    }
+
+    for (auto &[key, outs] : switchboxRoutes) {
+      auto [tile, in] = key;
+      Stream stream;
+      switch (in.bundle) {
+      case WireBundle::DMA:
+      case WireBundle::Core:
+        stream.source =
+            getEndpoint(tile, in.bundle, in.channel, DMAChannelDir::MM2S);
+        break;
+      case WireBundle::South:
+        if (tile.row != 0 || shimMuxTiles.count(tile))
+          continue;
+        stream.source = {StreamEndpoint::Kind::Host};
+        break;
+      case WireBundle::PLIO:
+      case WireBundle::NOC:
+      case WireBundle::FIFO:
+        stream.source = {StreamEndpoint::Kind::Host};
+        break;
+      default:
+        continue;
+      }
+      std::set<std::tuple<TileID, Port, bool>> seen;
+      follow(tile, in, false, 1, stream, seen);
+      addStream(std::move(stream));
+    }
+    for (auto &[key, outs] : shimMuxRoutes) {
+      auto [tile, in] = key;
+      Stream stream;
+      if (in.bundle == WireBundle::DMA)
+        stream.source = getDMAEndpoint(tile, DMAChannelDir::MM2S, in.channel);
+      else if (in.bundle == WireBundle::NOC || in.bundle == WireBundle::PLIO)
+        stream.source = {StreamEndpoint::Kind::Host};
+      else
+        continue;
+      std::set<std::tuple<TileID, Port, bool>> seen;
+      follow(tile, in, true, 0, stream, seen);
+      addStream(std::move(stream));
+    }
+  }
+
+  StreamEndpoint getEndpoint(TileID tile, WireBundle bundle, int channel,
+                             DMAChannelDir dir) {
+    if (bundle == WireBundle::DMA)
+      return getDMAEndpoint(tile, dir, channel);
+    if (bundle == WireBundle::Core)
+      return {StreamEndpoint::Kind::Core};
+    return {StreamEndpoint::Kind::Host};
+  }
+
+  bool tryAcquire(const LockAccess &access) {
+    LockState &lock = locks[access.lock];
+    if (!canAcquire(lock, access, semaphoreLocks))
+      return false;
+    acquireLock(lock, access, semaphoreLocks);
+    lockActivity[access.lock].total.record(now);
+    if (now > steadyStart)
+      lockActivity[access.lock].steady.record(now);
+    return true;
+  }
+
+  void release(const LockAccess &access) {
+    releaseLock(locks[access.lock], access, semaphoreLocks);
+  }
+
+  // Runs a core until it computes, waits on a lock or ends. Returns true if
+  // its state changed.
+  bool stepCore(Unit &unit) {
+    bool changed = false;
+    while (!unit.busy && !unit.done) {
+      if (unit.pc >= unit.program.size()) {
+        unit.done = true;
+        return true;
+      }
+      const Instruction &inst = unit.program[unit.pc];
+      switch (inst.kind) {
+      case Instruction::Kind::Lock:
+        if (inst.access.action == LockAction::Release) {
+          release(inst.access);
+        } else if (!tryAcquire(inst.access)) {
+          unit.waitingOn = inst.access.lock;
+          return changed;
+        }
+        unit.waitingOn.reset();
+        unit.pc++;
+        break;
+      case Instruction::Kind::Compute:
+        unit.pc++;
+        if (inst.count > 0) {
+          unit.busy = true;
+          unit.busyUntil = now + inst.count;
+        }
+        break;
+      case Instruction::Kind::LoopBegin:
+        if (inst.count <= 0) {
+          unit.pc = inst.jump + 1;
+        } else {
+          unit.loopCounts.push_back(inst.count);
+          unit.pc++;
+        }
+        break;
+      case Instruction::Kind::LoopEnd:
+        if (unit.loopCounts.back() > 1 && now == unit.stepStart) {
+          unit.busy = true;
+          unit.busyUntil = now + 1;
+          break;
+        }
+        if (--unit.loopCounts.back() > 0) {
+          unit.pc = inst.jump + 1;
+          unit.stepStart = now;
+        } else {
+          unit.loopCounts.pop_back();
+          unit.pc++;
+        }
+        break;
+      }
+      changed = true;
+    }
+    return changed;
+  }
+
+  // Runs a DMA channel until it waits on a lock or a transfer, or ends.
+  // Returns true if its state changed.
+  bool stepDMA(Unit &unit) {
+    bool changed = false;
+    while (!unit.busy && !unit.done) {
+      const BufferDescriptor &bd = unit.bds[unit.pc];
+      switch (unit.phase) {
+      case Unit::Phase::Acquire:
+        if (unit.acquired < bd.acquires.size()) {
+          if (!tryAcquire(bd.acquires[unit.acquired])) {
+            unit.waitingOn = bd.acquires[unit.acquired].lock;
+            return changed;
+          }
+          unit.acquired++;
+          break;
+        }
+        unit.waitingOn.reset();
+        unit.phase = Unit::Phase::Transfer;
+        unit.remaining = bd.bytes;
+        unit.bdStart = true;
+        break;
+      case Unit::Phase::Transfer:
+        if (unit.remaining > 0)
+          return changed;
+        unit.phase = Unit::Phase::Release;
+        break;
+      case Unit::Phase::Release:
+        if (now == unit.stepStart) {
+          unit.busy = true;
+          unit.busyUntil = now + 1;
+          break;
+        }
+        for (const LockAccess &access : bd.releases)
+          release(access);
+        unit.phase = Unit::Phase::Acquire;
+        unit.acquired = 0;
+        unit.stepStart = now;
+        if (bd.next) {
+          unit.pc = *bd.next;
+        } else if (unit.repeats > 0) {
+          unit.repeats--;
+          unit.pc = 0;
+        } else {
+          unit.done = true;
+        }
+        break;
+      }
+      changed = true;
+    }
+    return changed;
+  }
+
+  bool isReady(const StreamEndpoint &endpoint) {
+    switch (endpoint.kind) {
+    case StreamEndpoint::Kind::Unit: {
+      Unit &unit = units[endpoint.unit];
+      return !unit.done && unit.phase == Unit::Phase::Transfer &&
+             unit.remaining > 0;
+    }
+    case StreamEndpoint::Kind::Unconfigured:
+      return false;
+    default:
+      return true;
+    }
+  }
+
+  SmallVector<Unit *> getUnits(Stream &stream) {
+    SmallVector<Unit *> result;
+    if (stream.source.kind == StreamEndpoint::Kind::Unit)
+      result.push_back(&units[stream.source.unit]);
+    for (const StreamEndpoint &dest : stream.dests)
+      if (dest.kind == StreamEndpoint::Kind::Unit)
+        result.push_back(&units[dest.unit]);
+    return result;
+  }
+
+  bool tryStart(Stream &stream) {
+    if (stream.moving || !isReady(stream.source) ||
+        !llvm::all_of(stream.dests,
+                      [&](const StreamEndpoint &e) { return isReady(e); }))
+      return false;
+    int64_t chunk = std::numeric_limits<int64_t>::max();
+    bool bdStart = false;
+    for (Unit *unit : getUnits(stream)) {
+      chunk = std::min(chunk, unit->remaining);
+      bdStart |= unit->bdStart;
+      unit->bdStart = false;
+    }
+    stream.moving = true;
+    stream.chunk = chunk;
+    stream.until = now + llvm::divideCeil(chunk, kStreamBytesPerCycle) +
+                   (bdStart ? stream.hops * kSwitchboxLatency : 0);
+    return true;
+  }
+
+  void complete(Stream &stream, PerformanceReport &report) {
+    stream.moving = false;
+    for (Unit *unit : getUnits(stream))
+      unit->remaining -= stream.chunk;
+    if (!stream.toHost)
+      return;
+    report.hostOutputBytes += stream.chunk;
+    if (now > steadyStart)
+      steadyHostBytes += stream.chunk;
+    if (!report.firstOutputCycle)
+      report.firstOutputCycle = now;
+    if (stream.source.kind == StreamEndpoint::Kind::Unit &&
+        units[stream.source.unit].remaining == 0) {
+      stream.hostTransfers++;
+      if (now > steadyStart)
+        stream.steadyHostTransfers++;
+    }
+  }
+
+  void account(uint64_t cycles) {
+    for (Unit &unit : units) {
+      SimulatedUnit &stats = unit.stats;
+      if (unit.done)
+        stats.idleCycles += cycles;
+      else if (unit.waitingOn)
+        stats.lockStallCycles += cycles;
+      else if (unit.isCore())
+        stats.busyCycles += unit.busy ? cycles : 0;
+      else if (unit.busy ||
+               (unit.stream && streams[*unit.stream].moving))
+        stats.busyCycles += cycles;
+      else
+        stats.streamStallCycles += cycles;
+    }
+  }
+
+  // The next step of a unit of the lock analysis.
+  enum class Step { None, Local, Acquire, Transfer };
+
+  // The next step of unit `index` in `state`, and the lock access of an
+  // acquire.
+  Step getNextStep(const SystemState &state, unsigned index,
+                   const LockAccess *&access) const {
+    const Unit &unit = units[index];
+    const UnitState &unitState = state.units[index];
+    if (unitState.done)
+      return Step::None;
+    if (unit.isCore()) {
+      if (unitState.pc >= unit.program.size())
+        return Step::Local;
+      const Instruction &inst = unit.program[unitState.pc];
+      if (inst.kind != Instruction::Kind::Lock ||
+          inst.access.action == LockAction::Release)
+        return Step::Local;
+      access = &inst.access;
+      return Step::Acquire;
+    }
+    const BufferDescriptor &bd = unit.bds[unitState.pc];
+    switch (unitState.phase) {
+    case Unit::Phase::Acquire:
+      if (unitState.acquired < bd.acquires.size()) {
+        access = &bd.acquires[unitState.acquired];
+        return Step::Acquire;
+      }
+      return Step::Local;
+    case Unit::Phase::Transfer:
+      return unitState.remaining > 0 ? Step::Transfer : Step::Local;
+    case Unit::Phase::Release:
+      return Step::Local;
+    }
+    llvm_unreachable("unknown DMA phase");
+  }
+
+  // Takes a step of unit `index` that does not wait: a release, a compute,
+  // loop control, or the start or end of a BD.
+  void applyLocal(SystemState &state, unsigned index) {
+    const Unit &unit = units[index];
+    UnitState &unitState = state.units[index];
+    if (unit.isCore()) {
+      if (unitState.pc >= unit.program.size()) {
+        unitState.done = true;
+        return;
+      }
+      const Instruction &inst = unit.program[unitState.pc];
+      switch (inst.kind) {
+      case Instruction::Kind::Lock:
+        releaseLock(state.locks[inst.access.lock], inst.access,
+                    semaphoreLocks);
+        unitState.pc++;
+        break;
+      case Instruction::Kind::Compute:
+        unitState.pc++;
+        break;
+      case Instruction::Kind::LoopBegin:
+        // Loops without lock operations do not change the locks.
+        if (inst.count <= 0 || !inst.usesLocks) {
+          unitState.pc = inst.jump + 1;
+        } else {
+          unitState.loopCounts.push_back(inst.count);
+          unitState.pc++;
+        }
+        break;
+      case Instruction::Kind::LoopEnd:
+        if (--unitState.loopCounts.back() > 0) {
+          unitState.pc = inst.jump + 1;
+          unitState.iterations++;
+        } else {
+          unitState.loopCounts.pop_back();
+          unitState.pc++;
+        }
+        break;
+      }
+      return;
+    }
+
+    const BufferDescriptor &bd = unit.bds[unitState.pc];
+    switch (unitState.phase) {
+    case Unit::Phase::Acquire:
+      unitState.phase = Unit::Phase::Transfer;
+      unitState.remaining = bd.bytes;
+      break;
+    case Unit::Phase::Transfer:
+      unitState.phase = Unit::Phase::Release;
+      break;
+    case Unit::Phase::Release:
+      for (const LockAccess &access : bd.releases)
+        releaseLock(state.locks[access.lock], access, semaphoreLocks);
+      unitState.phase = Unit::Phase::Acquire;
+      unitState.acquired = 0;
+      if (bd.next) {
+        if (*bd.next <= unitState.pc)
+          unitState.iterations++;
+        unitState.pc = *bd.next;
+      } else if (unitState.repeats > 0) {
+        unitState.repeats--;
+        unitState.iterations++;
+        unitState.pc = 0;
+      } else {
+        unitState.done = true;
+      }
+      break;
+    }
+  }
+
+  void applyAcquire(SystemState &state, unsigned index,
+                    const LockAccess &access) {
+    acquireLock(state.locks[access.lock], access, semaphoreLocks);
+    UnitState &unitState = state.units[index];
+    if (units[index].isCore())
+      unitState.pc++;
+    else
+      unitState.acquired++;
+  }
+
+  bool isReady(const SystemState &state,
+               const StreamEndpoint &endpoint) const {
+    switch (endpoint.kind) {
+    case StreamEndpoint::Kind::Unit: {
+      const UnitState &unitState = state.units[endpoint.unit];
+      return !unitState.done && unitState.phase == Unit::Phase::Transfer &&
+             unitState.remaining > 0;
+    }
+    case StreamEndpoint::Kind::Unconfigured:
+      return false;
+    default:
+      return true;
+    }
+  }
+
+  bool isReady(const SystemState &state, const Stream &stream) const {
+    return isReady(state, stream.source) &&
+           llvm::all_of(stream.dests, [&](const StreamEndpoint &e) {
+             return isReady(state, e);
+           });
+  }
+
+  // Moves the data of `stream` if all its ends are ready.
+  bool tryTransfer(SystemState &state, const Stream &stream) {
+    if (!isReady(state, stream))
+      return false;
+    SmallVector<unsigned> ends;
+    if (stream.source.kind == StreamEndpoint::Kind::Unit)
+      ends.push_back(stream.source.unit);
+    for (const StreamEndpoint &dest : stream.dests)
+      if (dest.kind == StreamEndpoint::Kind::Unit)
+        ends.push_back(dest.unit);
+    int64_t chunk = std::numeric_limits<int64_t>::max();
+    for (unsigned end : ends)
+      chunk = std::min(chunk, state.units[end].remaining);
+    for (unsigned end : ends)
+      state.units[end].remaining -= chunk;
+    return true;
+  }
+
+  // Whether unit `index` could take a step in `state` if it had passes left.
+  bool canProgress(const SystemState &state, unsigned index) const {
+    const LockAccess *access = nullptr;
+    switch (getNextStep(state, index, access)) {
+    case Step::None:
+      return false;
+    case Step::Local:
+      return true;
+    case Step::Acquire:
+      return canAcquire(state.locks[access->lock], *access, semaphoreLocks);
+    case Step::Transfer:
+      return units[index].stream &&
+             isReady(state, streams[*units[index].stream]);
+    }
+    llvm_unreachable("unknown step");
+  }
+
+  // Acquires that no other unit can disable. Other units only release the
+  // lock, which keeps an acquire of a semaphore lock enabled.
+  bool isIndependent(const LockAccess &access) const {
+    return semaphoreLocks &&
+           access.action == LockAction::AcquireGreaterEqual &&
+           numAcquirers[access.lock] == 1;
+  }
+
+  // Takes the steps that do not depend on the order of the units, until
+  // every unit waits, ends or has no passes left.
+  void saturate(SystemState &state, unsigned iterations) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (unsigned index = 0; index < units.size(); index++) {
+        while (state.units[index].iterations < iterations) {
+          const LockAccess *access = nullptr;
+          Step step = getNextStep(state, index, access);
+          if (step == Step::Local)
+            applyLocal(state, index);
+          else if (step == Step::Acquire && isIndependent(*access) &&
+                   canAcquire(state.locks[access->lock], *access,
+                              semaphoreLocks))
+            applyAcquire(state, index, *access);
+          else
+            break;
+          changed = true;
+        }
+      }
+      for (const Stream &stream : streams)
+        changed |= tryTransfer(state, stream);
+    }
+  }
+
+  std::string describeLock(unsigned index) {
+    LockOp lock = locks[index].op;
+    if (lock.hasName())
+      return lock.name().str();
+    TileOp tile = lock.getTileOp();
+    std::string id =
+        lock.getLockID() ? std::to_string(*lock.getLockID()) : "?";
+    return "lock " + id + " of tile (" + std::to_string(tile.colIndex()) +
+           ", " + std::to_string(tile.rowIndex()) + ")";
+  }
+
+  DeviceOp device;
+  const PerformanceSimulatorOptions &options;
+  bool semaphoreLocks;
+  SmallVector<LockState> locks;
+  DenseMap<Operation *, unsigned> lockIndex;
+  SmallVector<LockActivity> lockActivity;
+  // Units that acquire every lock.
+  SmallVector<unsigned> numAcquirers;
+  SmallVector<Unit> units;
+  std::map<std::tuple<TileID, DMAChannelDir, int>, unsigned> dmaUnits;
+  std::map<RouteKey, SmallVector<Port>> switchboxRoutes;
+  std::map<RouteKey, SmallVector<Port>> shimMuxRoutes;
+  std::set<TileID> shimMuxTiles;
+  SmallVector<Stream> streams;
+  uint64_t now = 0;
+  uint64_t steadyStart = 0;
+  uint64_t steadyHostBytes = 0;
+};
+
+PerformanceReport Simulator::run() {
+  PerformanceReport report;
+  steadyStart = options.maxCycles / 2;
+
+  while (true) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (Unit &unit : units)
+        changed |= unit.isCore() ? stepCore(unit) : stepDMA(unit);
+      for (Stream &stream : streams)
+        changed |= tryStart(stream);
+    }
+
+    std::optional<uint64_t> next;
+    for (Unit &unit : units)
+      if (unit.busy && (!next || unit.busyUntil < *next))
+        next = unit.busyUntil;
+    for (Stream &stream : streams)
+      if (stream.moving && (!next || stream.until < *next))
+        next = stream.until;
+    if (!next) {
+      report.finished =
+          llvm::all_of(units, [](const Unit &unit) { return unit.done; });
+      report.stalled = !report.finished;
+      break;
+    }
+    uint64_t until = std::min(*next, options.maxCycles);
+    account(until - now);
+    now = until;
+    if (now >= options.maxCycles)
+      break;
+    for (Unit &unit : units)
+      if (unit.busy && unit.busyUntil == now)
+        unit.busy = false;
+    for (Stream &stream : streams)
+      if (stream.moving && stream.until == now)
+        complete(stream, report);
+  }
+
+  report.cycles = now;
+  for (Unit &unit : units) {
+    report.units.push_back(unit.stats);
+    if (!report.stalled || unit.done)
+      continue;
+    std::string waitsOn =
+        unit.waitingOn ? describeLock(*unit.waitingOn) : "its stream";
+    report.blocked.push_back(unit.stats.getName() + " waits on " + waitsOn);
+  }
+
+  // Designs that stop early are measured over the whole run.
+  bool steady = !report.finished && !report.stalled;
+  report.steadyStateStart = steady ? steadyStart : 0;
+  uint64_t window = now - report.steadyStateStart;
+  if (!window)
+    return report;
+  uint64_t bytes = steady ? steadyHostBytes : report.hostOutputBytes;
+  report.hostBytesPerCycle = double(bytes) / window;
+  double framesPerCycle = 0;
+  if (options.frameBytes) {
+    framesPerCycle = report.hostBytesPerCycle / options.frameBytes;
+  } else {
+    std::optional<uint64_t> transfers;
+    for (Stream &stream : streams)
+      if (stream.toHost && stream.source.kind == StreamEndpoint::Kind::Unit) {
+        uint64_t count =
+            steady ? stream.steadyHostTransfers : stream.hostTransfers;
+        transfers = std::min(transfers.value_or(count), count);
+      }
+    framesPerCycle = double(transfers.value_or(0)) / window;
+  }
+  report.framesPerSecond = framesPerCycle * options.clockMHz * 1e6;
+  return report;
+}
+
+LockAnalysisReport
+Simulator::analyzeLocks(const LockAnalysisOptions &analysisOptions) {
+  LockAnalysisReport report;
+  unsigned iterations = analysisOptions.iterations;
+  report.iterations = iterations;
+
+  // The locks every unit acquires and releases.
+  SmallVector<std::set<unsigned>> acquiredBy(units.size());
+  SmallVector<std::set<unsigned>> releasedBy(units.size());
+  for (auto [index, unit] : llvm::enumerate(units)) {
+    auto add = [&, index = index](const LockAccess &access) {
+      (access.action == LockAction::Release ? releasedBy : acquiredBy)[index]
+          .insert(access.lock);
+    };
+    for (const Instruction &inst : unit.program)
+      if (inst.kind == Instruction::Kind::Lock)
+        add(inst.access);
+    for (const BufferDescriptor &bd : unit.bds) {
+      llvm::for_each(bd.acquires, add);
+      llvm::for_each(bd.releases, add);
+    }
+  }
+  numAcquirers.assign(locks.size(), 0);
+  for (const std::set<unsigned> &acquired : acquiredBy)
+    for (unsigned lock : acquired)
+      numAcquirers[lock]++;
+
+  // Depth-first search over the orders in which units acquire contended
+  // locks.
+  SystemState initial;
+  for (const Unit &unit : units) {
+    UnitState unitState;
+    unitState.repeats = unit.repeats;
+    initial.units.push_back(std::move(unitState));
+  }
+  initial.locks = locks;
+  std::vector<SystemState> stack = {std::move(initial)};
+  std::set<std::vector<int64_t>> visited;
+  while (!stack.empty()) {
+    SystemState state = std::move(stack.back());
+    stack.pop_back();
+    saturate(state, iterations);
+    if (!visited.insert(state.encode()).second)
+      continue;
+    if (visited.size() > analysisOptions.maxStates) {
+      report.result = LockAnalysisReport::Result::Inconclusive;
+      break;
+    }
+
+    bool enabled = false;
+    for (unsigned index = 0; index < units.size(); index++) {
+      const LockAccess *access = nullptr;
+      if (state.units[index].iterations >= iterations ||
+          getNextStep(state, index, access) != Step::Acquire ||
+          !canAcquire(state.locks[access->lock], *access, semaphoreLocks))
+        continue;
+      SystemState next = state;
+      applyAcquire(next, index, *access);
+      stack.push_back(std::move(next));
+      enabled = true;
+    }
+    if (enabled)
+      continue;
+
+    // A DMA channel at the start of a BD is idle, not blocked, when only
+    // units that have ended release the lock it waits on.
+    SmallVector<bool> idle(units.size(), false);
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (unsigned index = 0; index < units.size(); index++) {
+        const UnitState &unitState = state.units[index];
+        const LockAccess *access = nullptr;
+        if (idle[index] || units[index].isCore() || unitState.done ||
+            unitState.acquired > 0 ||
+            getNextStep(state, index, access) != Step::Acquire)
+          continue;
+        unsigned lock = access->lock;
+        if (llvm::all_of(llvm::seq<unsigned>(0, units.size()),
+                         [&](unsigned other) {
+                           return !releasedBy[other].count(lock) ||
+                                  state.units[other].done || idle[other];
+                         }))
+          idle[index] = changed = true;
+      }
+    }
+
+    // The units that release the lock unit `index` waits on, or are the
+    // other ends of the stream it waits on.
+    auto getDependencies = [&](unsigned index) {
+      SmallVector<unsigned> dependencies;
+      const LockAccess *access = nullptr;
+      Step step = getNextStep(state, index, access);
+      if (step == Step::Acquire) {
+        for (unsigned other = 0; other < units.size(); other++)
+          if (other != index && releasedBy[other].count(access->lock))
+            dependencies.push_back(other);
+      } else if (step == Step::Transfer && units[index].stream) {
+        const Stream &stream = streams[*units[index].stream];
+        auto add = [&](const StreamEndpoint &endpoint) {
+          if (endpoint.kind == StreamEndpoint::Kind::Unit &&
+              endpoint.unit != index)
+            dependencies.push_back(endpoint.unit);
+        };
+        add(stream.source);
+        llvm::for_each(stream.dests, add);
+      }
+      return dependencies;
+    };
+
+    SmallVector<unsigned> worklist;
+    for (unsigned index = 0; index < units.size(); index++)
+      if (!state.units[index].done && !idle[index] &&
+          state.units[index].iterations < iterations)
+        worklist.push_back(index);
+    if (worklist.empty())
+      continue;
+
+    // A unit that ran out of passes excuses the waiting units only if it
+    // could go on to release a lock or feed a stream they depend on,
+    // directly or through other units that ran out of passes.
+    std::set<unsigned> seen(worklist.begin(), worklist.end());
+    bool truncated = false;
+    while (!worklist.empty() && !truncated) {
+      for (unsigned other : getDependencies(worklist.pop_back_val())) {
+        const UnitState &otherState = state.units[other];
+        if (otherState.done || otherState.iterations < iterations)
+          continue;
+        if (canProgress(state, other)) {
+          truncated = true;
+          break;
+        }
+        if (seen.insert(other).second)
+          worklist.push_back(other);
+      }
+    }
+    if (truncated)
+      continue;
+
+    report.result = LockAnalysisReport::Result::Deadlock;
+    for (unsigned index = 0; index < units.size(); index++) {
+      const UnitState &unitState = state.units[index];
+      if (unitState.done || idle[index] || unitState.iterations >= iterations)
+        continue;
+      const LockAccess *access = nullptr;
+      std::string waitsOn = "its stream";
+      if (getNextStep(state, index, access) == Step::Acquire)
+        waitsOn = describeLock(access->lock) + " (value " +
+                  std::to_string(state.locks[access->lock].value) + ")";
+      report.blocked.push_back(units[index].stats.getName() + " waits on " +
+                               waitsOn);
+    }
+    break;
+  }
+  report.states = visited.size();
+
+  // Lock cycles are the classes of locks that units hand to each other: a
+  // unit acquires one and releases the other, and a unit acquires the other
+  // and releases the first.
+  SmallVector<unsigned> leader(locks.size());
+  std::iota(leader.begin(), leader.end(), 0);
+  std::function<unsigned(unsigned)> find = [&](unsigned lock) {
+    return leader[lock] == lock ? lock : leader[lock] = find(leader[lock]);
+  };
+  SmallVector<bool> paired(locks.size(), false);
+  for (auto [acquired, released] : llvm::zip(acquiredBy, releasedBy))
+    for (unsigned a : acquired)
+      for (unsigned b : released) {
+        bool handsBack = llvm::any_of(
+            llvm::seq<unsigned>(0, units.size()), [&](unsigned other) {
+              return acquiredBy[other].count(b) && releasedBy[other].count(a);
+            });
+        if (!handsBack)
+          continue;
+        paired[a] = paired[b] = true;
+        leader[find(a)] = find(b);
+      }
+  std::map<unsigned, SmallVector<unsigned>> classes;
+  for (unsigned lock = 0; lock < locks.size(); lock++)
+    if (paired[lock])
+      classes[find(lock)].push_back(lock);
+
+  // Initiation intervals are measured like the rates of
+  // aie-simulate-performance: over the whole run for designs that stop, and
+  // over the second half of the run otherwise.
+  std::optional<bool> steady;
+  if (report.result != LockAnalysisReport::Result::Deadlock) {
+    PerformanceReport timed = run();
+    steady = !timed.finished && !timed.stalled;
+  }
+  SmallVector<SmallVector<unsigned>> sortedClasses;
+  for (auto &[_, members] : classes)
+    sortedClasses.push_back(members);
+  llvm::sort(sortedClasses, [](const auto &lhs, const auto &rhs) {
+    return lhs.front() < rhs.front();
+  });
+  for (const SmallVector<unsigned> &members : sortedClasses) {
+    LockCycle cycle;
+    std::set<unsigned> cycleUnits;
+    for (unsigned lock : members) {
+      cycle.locks.push_back(describeLock(lock));
+      for (unsigned index = 0; index < units.size(); index++)
+        if (acquiredBy[index].count(lock))
+          cycleUnits.insert(index);
+      if (!steady)
+        continue;
+      const LockActivity &activity = lockActivity[lock];
+      std::optional<double> interval =
+          (*steady ? activity.steady : activity.total).getInterval();
+      if (interval)
+        cycle.initiationInterval =
+            std::max(cycle.initiationInterval.value_or(0.0), *interval);
+    }
+    for (unsigned index : cycleUnits)
+      cycle.units.push_back(units[index].stats.getName());
+    report.cycles.push_back(std::move(cycle));
+  }
+  return report;
+}
+
+struct AIESimulatePerformancePass
+    : AIESimulatePerformanceBase<AIESimulatePerformancePass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    PerformanceSimulatorOptions options;
+    options.maxCycles = clMaxCycles;
+    options.defaultKernelCycles = clDefaultKernelCycles;
+    options.clockMHz = clClockMHz;
+    options.frameBytes = clFrameBytes;
+    FailureOr<PerformanceReport> report = simulatePerformance(device, options);
+    if (failed(report))
+      return signalPassFailure();
+    llvm::outs() << "performance of " << stringifyAIEDevice(device.getDevice())
+                 << ":\n";
+    report->print(llvm::outs());
+  }
+};
+
+struct AIEAnalyzeLocksPass : AIEAnalyzeLocksBase<AIEAnalyzeLocksPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    LockAnalysisOptions options;
+    options.iterations = clIterations;
+    options.maxStates = clMaxStates;
+    options.simulator.maxCycles = clMaxCycles;
+    options.simulator.defaultKernelCycles = clDefaultKernelCycles;
+    FailureOr<LockAnalysisReport> report = analyzeLocks(device, options);
+    if (failed(report))
+      return signalPassFailure();
+    llvm::outs() << "lock analysis of "
+                 << stringifyAIEDevice(device.getDevice()) << ":\n";
+    report->print(llvm::outs());
+
+    switch (report->result) {
+    case LockAnalysisReport::Result::DeadlockFree:
+      return;
+    case LockAnalysisReport::Result::Inconclusive:
+      device.emitWarning("lock analysis gave up after ")
+          << report->states << " states";
+      return;
+    case LockAnalysisReport::Result::Deadlock: {
+      InFlightDiagnostic diag = device.emitError("deadlock within ");
+      diag << report->iterations << " iterations";
+      for (const std::string &unit : report->blocked)
+        diag.attachNote() << unit;
+      return signalPassFailure();
+    }
+    }
+  }
+};
+
+} // namespace
+
+std::string SimulatedUnit::getName() const {
+  std::string at =
+      "(" + std::to_string(tile.col) + ", " + std::to_string(tile.row) + ")";
+  switch (kind) {
+  case Kind::Core:
+    return "core " + at;
+  case Kind::MM2S:
+    return "MM2S " + std::to_string(channel) + " " + at;
+  case Kind::S2MM:
+    return "S2MM " + std::to_string(channel) + " " + at;
+  }
+  llvm_unreachable("unknown unit kind");
+}
+
+void PerformanceReport::print(raw_ostream &os) const {
+  if (finished)
+    os << "  all cores and DMA channels finished after " << cycles
+       << " cycles\n";
+  else if (stalled)
+    os << "  no core or DMA channel can make progress after cycle " << cycles
+       << "\n";
+  else
+    os << "  simulated " << cycles << " cycles, steady state from cycle "
+       << steadyStateStart << "\n";
+  for (const std::string &unit : blocked)
+    os << "  blocked: " << unit << "\n";
+
+  auto percent = [&](uint64_t part) {
+    return llvm::format("%.1f%%", cycles ? 100.0 * part / cycles : 0.0);
+  };
+  std::map<TileID, SmallVector<const SimulatedUnit *>> tiles;
+  for (const SimulatedUnit &unit : units)
+    tiles[unit.tile].push_back(&unit);
+  for (auto &[tile, tileUnits] : tiles) {
+    os << "  tile (" << tile.col << ", " << tile.row << "):";
+    uint64_t dmaBusy = 0;
+    unsigned numDMAs = 0;
+    for (const SimulatedUnit *unit : tileUnits) {
+      if (unit->kind == SimulatedUnit::Kind::Core) {
+        os << " core busy " << percent(unit->busyCycles) << ",";
+      } else {
+        dmaBusy += unit->busyCycles;
+        numDMAs++;
+      }
+    }
+    os << " DMA occupancy " << percent(numDMAs ? dmaBusy / numDMAs : 0)
+       << "\n";
+    for (const SimulatedUnit *unit : tileUnits) {
+      os << "    " << unit->getName() << ": busy " << percent(unit->busyCycles)
+         << ", lock stall " << percent(unit->lockStallCycles);
+      if (unit->kind != SimulatedUnit::Kind::Core)
+        os << ", stream stall " << percent(unit->streamStallCycles);
+      os << ", idle " << percent(unit->idleCycles) << "\n";
+    }
+  }
+
+  os << "  host output: " << hostOutputBytes << " bytes";
+  if (firstOutputCycle)
+    os << ", first at cycle " << *firstOutputCycle;
+  os << ", " << llvm::format("%.2f", hostBytesPerCycle) << " bytes/cycle\n";
+  os << "  frames per second: " << llvm::format("%.1f", framesPerSecond)
+     << "\n";
+}
+
+void LockAnalysisReport::print(raw_ostream &os) const {
+  switch (result) {
+  case Result::DeadlockFree:
+    os << "  deadlock free for " << iterations
+       << " iterations of every core loop and BD chain, " << states
+       << " states explored\n";
+    break;
+  case Result::Deadlock:
+    os << "  deadlock within " << iterations << " iterations, " << states
+       << " states explored\n";
+    break;
+  case Result::Inconclusive:
+    os << "  inconclusive: " << states << " states explored without covering "
+       << iterations << " iterations\n";
+    break;
+  }
+  for (const std::string &unit : blocked)
+    os << "  blocked: " << unit << "\n";
+  for (const LockCycle &cycle : cycles) {
+    os << "  lock cycle " << llvm::join(cycle.locks, ", ") << " ("
+       << llvm::join(cycle.units, ", ") << "): ";
+    if (cycle.initiationInterval)
+      os << "initiation interval "
+         << llvm::format("%.1f", *cycle.initiationInterval) << " cycles\n";
+    else
+      os << "initiation interval not measured\n";
+  }
+}
+
+FailureOr<PerformanceReport>
+AIE::simulatePerformance(DeviceOp device,
+                         const PerformanceSimulatorOptions &options) {
+  Simulator simulator(device, options);
+  if (failed(simulator.build()))
+    return failure();
+  return simulator.run();
+}
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIESimulatePerformancePass() {
+  return std::make_unique<AIESimulatePerformancePass>();
+}
+
+FailureOr<LockAnalysisReport>
+AIE::analyzeLocks(DeviceOp device, const LockAnalysisOptions &options) {
+  Simulator simulator(device, options.simulator);
+  if (failed(simulator.build()))
+    return failure();
+  return simulator.analyzeLocks(options);
+}
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIEAnalyzeLocksPass() {
+  return std::make_unique<AIEAnalyzeLocksPass>();
+}
@@ -0,0 +1,602 @@
+//===- AIEPlace.cpp ---------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+
+#include <map>
+#include <set>
+
+#define DEBUG_TYPE "aie-place"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+// Any resource violation costs more than any amount of wirelength or
+// congestion, so the search never trades feasibility for a shorter route.
+constexpr int64_t kViolationPenalty = 1 << 24;
+// DMA channels per direction on a shim tile, as in DMAChannelAnalysis.
+constexpr unsigned kShimDMAChannels = 2;
+
+enum class TileKind { Core, Mem, ShimNOC, ShimPL };
+
+TileKind getTileKind(const AIETargetModel &tm, int col, int row) {
+  if (tm.isMemTile(col, row))
+    return TileKind::Mem;
+  if (tm.isShimNOCTile(col, row))
+    return TileKind::ShimNOC;
+  if (tm.isShimPLTile(col, row))
+    return TileKind::ShimPL;
+  return TileKind::Core;
+}
+
+bool isShimKind(TileKind kind) {
+  return kind == TileKind::ShimNOC || kind == TileKind::ShimPL;
+}
+
+TileID unplaced() { return {-1, -1}; }
+
+bool isPlaced(TileID pos) { return pos.col >= 0; }
+
+// Resources a tile needs regardless of where it is placed: explicit buffers,
+// locks, DMA channels named by flows and DMA programs, and the core stack.
+struct TileDemand {
+  int64_t memory = 0;
+  unsigned locks = 0;
+  std::set<int> mm2sChannels;
+  std::set<int> s2mmChannels;
+};
+
+// A producer -> consumers connection of an objectFifo. If the fifo has a
+// single consumer and does not need a DMA, placing both ends on tiles that
+// share memory removes the stream and the consumer side buffers and locks.
+struct FifoNet {
+  unsigned producer;
+  SmallVector<unsigned> consumers;
+  bool canShareMemory;
+  int64_t producerBytes;
+  SmallVector<int64_t> consumerBytes;
+  unsigned producerLocks;
+  SmallVector<unsigned> consumerLocks;
+};
+
+struct PlacementCost {
+  int64_t violations = 0;
+  int64_t wirelength = 0;
+  int64_t overflow = 0;
+  int64_t total = 0;
+
+  bool operator<(const PlacementCost &other) const {
+    return total < other.total;
+  }
+};
+
+struct AIEPlacePass : AIEPlaceBase<AIEPlacePass> {
+  const AIETargetModel *tm = nullptr;
+
+  // The tiles of the device, in program order, with their kind, placement
+  // and resource demand.
+  SmallVector<TileOp> tiles;
+  SmallVector<TileKind> kinds;
+  SmallVector<bool> movable;
+  SmallVector<TileDemand> demands;
+  DenseMap<Value, unsigned> tileIndex;
+
+  // Stream connections that do not depend on objectFifo lowering.
+  SmallVector<std::pair<unsigned, unsigned>> flows;
+  SmallVector<FifoNet> fifoNets;
+
+  // Directed switchbox link capacities, keyed by the source switchbox and the
+  // bundle the link leaves it through.
+  std::map<std::tuple<int, int, WireBundle>, unsigned> linkCapacity;
+
+  std::optional<unsigned> lookupTile(Value tile) {
+    auto it = tileIndex.find(tile);
+    if (it == tileIndex.end())
+      return std::nullopt;
+    return it->second;
+  }
+
+  unsigned getLinkCapacity(int col, int row, WireBundle bundle) {
+    auto key = std::make_tuple(col, row, bundle);
+    auto it = linkCapacity.find(key);
+    if (it != linkCapacity.end())
+      return it->second;
+    unsigned capacity = tm->getNumSourceSwitchboxConnections(col, row, bundle);
+    linkCapacity[key] = capacity;
+    return capacity;
+  }
+
+  bool sharesMemory(TileID a, TileID b) {
+    if (getTileKind(*tm, a.col, a.row) != TileKind::Core ||
+        getTileKind(*tm, b.col, b.row) != TileKind::Core)
+      return false;
+    return tm->isLegalMemAffinity(a.col, a.row, b.col, b.row) ||
+           tm->isLegalMemAffinity(b.col, b.row, a.col, a.row);
+  }
+
+  // Adds the links of the XY route from `a` to `b` to `demand`. The router
+  // may find a different path, but XY routes give a cheap estimate of how
+  // many flows compete for each link.
+  static void addRoute(TileID a, TileID b,
+                       std::map<std::tuple<int, int, WireBundle>, unsigned>
+                           &demand) {
+    int col = a.col, row = a.row;
+    while (col != b.col) {
+      WireBundle bundle = col < b.col ? WireBundle::East : WireBundle::West;
+      demand[{col, row, bundle}]++;
+      col += col < b.col ? 1 : -1;
+    }
+    while (row != b.row) {
+      WireBundle bundle = row < b.row ? WireBundle::North : WireBundle::South;
+      demand[{col, row, bundle}]++;
+      row += row < b.row ? 1 : -1;
+    }
+  }
+
+  // Evaluates a (possibly partial) placement. Connections with an unplaced
+  // end and unplaced tiles are ignored.
+  PlacementCost evaluate(ArrayRef<TileID> pos,
+                         SmallVectorImpl<std::string> *diagnostics = nullptr) {
+    PlacementCost cost;
+    unsigned n = tiles.size();
+    SmallVector<int64_t> memory(n);
+    SmallVector<unsigned> locks(n), mm2s(n), s2mm(n);
+    for (unsigned i = 0; i < n; i++) {
+      memory[i] = demands[i].memory;
+      locks[i] = demands[i].locks;
+      mm2s[i] = demands[i].mm2sChannels.size();
+      s2mm[i] = demands[i].s2mmChannels.size();
+    }
+
+    std::map<std::tuple<int, int, WireBundle>, unsigned> demand;
+    auto addStream = [&](unsigned src, unsigned dst) {
+      cost.wirelength += std::abs(pos[src].col - pos[dst].col) +
+                         std::abs(pos[src].row - pos[dst].row);
+      addRoute(pos[src], pos[dst], demand);
+    };
+
+    for (auto [src, dst] : flows)
+      if (isPlaced(pos[src]) && isPlaced(pos[dst]))
+        addStream(src, dst);
+
+    for (FifoNet &net : fifoNets) {
+      if (!isPlaced(pos[net.producer]))
+        continue;
+      memory[net.producer] += net.producerBytes;
+      locks[net.producer] += net.producerLocks;
+      if (net.canShareMemory && isPlaced(pos[net.consumers.front()]) &&
+          sharesMemory(pos[net.producer], pos[net.consumers.front()]))
+        continue;
+      mm2s[net.producer]++;
+      for (auto [idx, consumer] : llvm::enumerate(net.consumers)) {
+        if (!isPlaced(pos[consumer]))
+          continue;
+        memory[consumer] += net.consumerBytes[idx];
+        locks[consumer] += net.consumerLocks[idx];
+        s2mm[consumer]++;
+        addStream(net.producer, consumer);
+      }
+    }
+
+    for (auto &[link, count] : demand) {
+      auto [col, row, bundle] = link;
+      unsigned capacity = getLinkCapacity(col, row, bundle);
+      if (count > capacity)
+        cost.overflow += count - capacity;
+    }
+
+    auto check = [&](unsigned i, int64_t used, int64_t available,
+                     StringRef resource) {
+      if (used <= available)
+        return;
+      cost.violations++;
+      if (diagnostics)
+        diagnostics->push_back(("tile (" + Twine(pos[i].col) + ", " +
+                                Twine(pos[i].row) + ") requires " +
+                                Twine(used) + " " + resource + ", but only " +
+                                Twine(available) + " are available")
+                                   .str());
+    };
+    for (unsigned i = 0; i < n; i++) {
+      if (!isPlaced(pos[i]))
+        continue;
+      int col = pos[i].col, row = pos[i].row;
+      check(i, locks[i], tm->getNumLocks(col, row), "locks");
+      if (isShimKind(kinds[i])) {
+        check(i, mm2s[i], kShimDMAChannels, "MM2S DMA channels");
+        check(i, s2mm[i], kShimDMAChannels, "S2MM DMA channels");
+        continue;
+      }
+      check(i, mm2s[i],
+            tm->getNumDestSwitchboxConnections(col, row, WireBundle::DMA),
+            "MM2S DMA channels");
+      check(i, s2mm[i],
+            tm->getNumSourceSwitchboxConnections(col, row, WireBundle::DMA),
+            "S2MM DMA channels");
+      int64_t capacity = kinds[i] == TileKind::Mem ? tm->getMemTileSize()
+                                                   : tm->getLocalMemorySize();
+      check(i, memory[i], capacity, "bytes of memory");
+    }
+
+    cost.total = cost.violations * kViolationPenalty + cost.wirelength +
+                 clCongestionWeight * cost.overflow;
+    return cost;
+  }
+
+  void collectTiles(DeviceOp device) {
+    for (TileOp tile : device.getOps<TileOp>()) {
+      tileIndex[tile.getResult()] = tiles.size();
+      tiles.push_back(tile);
+      TileKind kind = getTileKind(*tm, tile.getCol(), tile.getRow());
+      kinds.push_back(kind);
+      movable.push_back(!isShimKind(kind) || clPlaceShims);
+      demands.emplace_back();
+    }
+
+    auto pin = [&](Value tile) {
+      if (auto idx = lookupTile(tile))
+        movable[*idx] = false;
+    };
+
+    // Cascade connections are only legal between neighbours.
+    device.walk([&](CascadeFlowOp op) {
+      pin(op.getSourceTile());
+      pin(op.getDestTile());
+    });
+    device.walk([&](ConfigureCascadeOp op) { pin(op.getTile()); });
+
+    // Buffers and locks accessed from the core or DMA of another tile tie the
+    // two tiles together.
+    auto pinSharedAccesses = [&](Operation *op, Value tile) {
+      for (Operation *user : op->getUsers()) {
+        Operation *parent = user;
+        while (parent && !isa<CoreOp, MemOp, MemTileDMAOp, ShimDMAOp>(parent))
+          parent = parent->getParentOp();
+        if (!parent)
+          continue;
+        Value userTile = parent->getOperand(0);
+        if (userTile == tile)
+          continue;
+        pin(tile);
+        pin(userTile);
+      }
+    };
+    device.walk([&](BufferOp op) { pinSharedAccesses(op, op.getTile()); });
+    device.walk([&](LockOp op) { pinSharedAccesses(op, op.getTile()); });
+  }
+
+  void collectDemands(DeviceOp device) {
+    for (BufferOp buffer : device.getOps<BufferOp>())
+      if (auto idx = lookupTile(buffer.getTile()))
+        demands[*idx].memory += buffer.getAllocationSize();
+    for (LockOp lock : device.getOps<LockOp>())
+      if (auto idx = lookupTile(lock.getTile()))
+        demands[*idx].locks++;
+    for (CoreOp core : device.getOps<CoreOp>())
+      if (auto idx = lookupTile(core.getTile()))
+        demands[*idx].memory += core.getStackSize();
+
+    auto addChannel = [&](Value tile, WireBundle bundle, int channel,
+                          bool isSource) {
+      if (bundle != WireBundle::DMA)
+        return;
+      if (auto idx = lookupTile(tile))
+        (isSource ? demands[*idx].mm2sChannels : demands[*idx].s2mmChannels)
+            .insert(channel);
+    };
+    auto addDMAStarts = [&](Operation *op, Value tile) {
+      op->walk([&](DMAStartOp start) {
+        addChannel(tile, WireBundle::DMA, start.getChannelIndex(),
+                   start.getChannelDir() == DMAChannelDir::MM2S);
+      });
+    };
+    for (MemOp op : device.getOps<MemOp>())
+      addDMAStarts(op, op.getTile());
+    for (MemTileDMAOp op : device.getOps<MemTileDMAOp>())
+      addDMAStarts(op, op.getTile());
+    for (ShimDMAOp op : device.getOps<ShimDMAOp>())
+      addDMAStarts(op, op.getTile());
+
+    for (FlowOp flow : device.getOps<FlowOp>()) {
+      addChannel(flow.getSource(), flow.getSourceBundle(),
+                 flow.getSourceChannel(), /*isSource=*/true);
+      addChannel(flow.getDest(), flow.getDestBundle(), flow.getDestChannel(),
+                 /*isSource=*/false);
+      auto src = lookupTile(flow.getSource());
+      auto dst = lookupTile(flow.getDest());
+      if (src && dst)
+        flows.push_back({*src, *dst});
+    }
+    for (PacketFlowOp flow : device.getOps<PacketFlowOp>()) {
+      SmallVector<PacketSourceOp> sources;
+      SmallVector<PacketDestOp> dests;
+      flow.walk([&](PacketSourceOp op) { sources.push_back(op); });
+      flow.walk([&](PacketDestOp op) { dests.push_back(op); });
+      for (PacketSourceOp source : sources) {
+        addChannel(source.getTile(), source.getBundle(), source.getChannel(),
+                   /*isSource=*/true);
+        for (PacketDestOp dest : dests) {
+          auto src = lookupTile(source.getTile());
+          auto dst = lookupTile(dest.getTile());
+          if (src && dst)
+            flows.push_back({*src, *dst});
+        }
+      }
+      for (PacketDestOp dest : dests)
+        addChannel(dest.getTile(), dest.getBundle(), dest.getChannel(),
+                   /*isSource=*/false);
+    }
+  }
+
+  void collectObjectFifos(DeviceOp device) {
+    // Fifos used by a link always go through a DMA. The buffers on the link
+    // tile are allocated once: by the input fifo for a distribute or a
+    // one-to-one link, and by the output fifo for a join.
+    DenseSet<Operation *> linked;
+    DenseSet<std::pair<Operation *, bool>> notAllocated;
+    for (ObjectFifoLinkOp link : device.getOps<ObjectFifoLinkOp>()) {
+      for (ObjectFifoCreateOp fifo : link.getInputObjectFifos()) {
+        linked.insert(fifo);
+        if (link.isJoin())
+          notAllocated.insert({fifo, /*producer=*/false});
+      }
+      for (ObjectFifoCreateOp fifo : link.getOutputObjectFifos()) {
+        linked.insert(fifo);
+        if (!link.isJoin())
+          notAllocated.insert({fifo, /*producer=*/true});
+      }
+    }
+
+    bool semaphoreLocks = tm->hasProperty(AIETargetModel::UsesSemaphoreLocks);
+    for (ObjectFifoCreateOp fifo : device.getOps<ObjectFifoCreateOp>()) {
+      auto producer = lookupTile(fifo.getProducerTile());
+      if (!producer)
+        continue;
+      auto elemType = llvm::cast<MemRefType>(
+          llvm::cast<AIEObjectFifoType>(fifo.getElemType()).getElementType());
+      int64_t elemBytes =
+          elemType.getNumElements() * elemType.getElementTypeBitWidth() / 8;
+      auto endBytes = [&](unsigned tile, int depth, bool isProducer) {
+        // Shim tiles use external buffers.
+        if (isShimKind(kinds[tile]) ||
+            notAllocated.contains({fifo.getOperation(), isProducer}))
+          return int64_t(0);
+        return depth * elemBytes;
+      };
+      auto endLocks = [&](int depth) -> unsigned {
+        if (fifo.getDisableSynchronization())
+          return 0;
+        return semaphoreLocks ? 2 : depth;
+      };
+
+      FifoNet net;
+      net.producer = *producer;
+      net.canShareMemory =
+          fifo.getConsumerTiles().size() == 1 && !fifo.getVia_DMA() &&
+          !fifo.getRepeatCount() && fifo.getDimensionsToStream().empty() &&
+          !linked.contains(fifo);
+      net.producerBytes = endBytes(*producer, fifo.size(), true);
+      net.producerLocks = endLocks(fifo.size());
+      for (auto [idx, consumerTile] :
+           llvm::enumerate(fifo.getConsumerTiles())) {
+        auto consumer = lookupTile(consumerTile);
+        if (!consumer)
+          continue;
+        // Without an explicit per-consumer depth, the consumer is sized like
+        // the producer.
+        int depth = isa<ArrayAttr>(fifo.getElemNumber()) ? fifo.size(idx + 1)
+                                                         : fifo.size();
+        net.consumers.push_back(*consumer);
+        net.consumerBytes.push_back(endBytes(*consumer, depth, false));
+        net.consumerLocks.push_back(endLocks(depth));
+      }
+      if (net.consumers.empty())
+        continue;
+      fifoNets.push_back(net);
+    }
+  }
+
+  // Builds a placement by adding one tile at a time, always the movable tile
+  // with the most connections to tiles already placed, at the free position
+  // that is cheapest given the tiles placed so far.
+  SmallVector<TileID> constructPlacement(
+      const std::map<TileKind, SmallVector<TileID>> &positions) {
+    unsigned n = tiles.size();
+    SmallVector<TileID> pos(n, unplaced());
+    std::set<TileID> occupied;
+    for (unsigned i = 0; i < n; i++) {
+      if (movable[i])
+        continue;
+      pos[i] = {tiles[i].getCol(), tiles[i].getRow()};
+      occupied.insert(pos[i]);
+    }
+
+    SmallVector<SmallVector<unsigned>> neighbours(n);
+    for (auto [src, dst] : flows) {
+      neighbours[src].push_back(dst);
+      neighbours[dst].push_back(src);
+    }
+    for (FifoNet &net : fifoNets)
+      for (unsigned consumer : net.consumers) {
+        neighbours[net.producer].push_back(consumer);
+        neighbours[consumer].push_back(net.producer);
+      }
+
+    while (true) {
+      std::optional<unsigned> next;
+      int bestConnections = -1;
+      for (unsigned i = 0; i < n; i++) {
+        if (isPlaced(pos[i]))
+          continue;
+        int connections = llvm::count_if(
+            neighbours[i], [&](unsigned j) { return isPlaced(pos[j]); });
+        if (connections > bestConnections) {
+          bestConnections = connections;
+          next = i;
+        }
+      }
+      if (!next)
+        break;
+
+      // Tiles with no placed neighbour keep their position if it is free.
+      TileID original = {tiles[*next].getCol(), tiles[*next].getRow()};
+      std::optional<TileID> best;
+      PlacementCost bestCost;
+      if (bestConnections == 0 && !occupied.count(original)) {
+        best = original;
+      } else {
+        for (TileID candidate : positions.at(kinds[*next])) {
+          if (occupied.count(candidate))
+            continue;
+          pos[*next] = candidate;
+          PlacementCost cost = evaluate(pos);
+          if (!best || cost < bestCost) {
+            best = candidate;
+            bestCost = cost;
+          }
+        }
+      }
+      if (!best)
+        return {};
+      pos[*next] = *best;
+      occupied.insert(*best);
+    }
+    return pos;
+  }
+
+  // Improves `pos` by moving single tiles to free positions or swapping two
+  // tiles of the same kind, until no move reduces the cost.
+  PlacementCost refinePlacement(
+      SmallVectorImpl<TileID> &pos,
+      const std::map<TileKind, SmallVector<TileID>> &positions) {
+    std::map<TileID, unsigned> occupant;
+    for (auto [idx, p] : llvm::enumerate(pos))
+      occupant[p] = idx;
+
+    PlacementCost best = evaluate(pos);
+    for (unsigned iter = 0; iter < clMaxIterations; iter++) {
+      bool improved = false;
+      for (unsigned i = 0; i < tiles.size(); i++) {
+        if (!movable[i])
+          continue;
+        for (TileID candidate : positions.at(kinds[i])) {
+          TileID current = pos[i];
+          if (candidate == current)
+            continue;
+          auto it = occupant.find(candidate);
+          std::optional<unsigned> other;
+          if (it != occupant.end()) {
+            if (!movable[it->second])
+              continue;
+            other = it->second;
+          }
+          pos[i] = candidate;
+          if (other)
+            pos[*other] = current;
+          PlacementCost cost = evaluate(pos);
+          if (!(cost < best)) {
+            pos[i] = current;
+            if (other)
+              pos[*other] = candidate;
+            continue;
+          }
+          best = cost;
+          improved = true;
+          occupant.erase(current);
+          occupant[candidate] = i;
+          if (other)
+            occupant[current] = *other;
+        }
+      }
+      if (!improved)
+        break;
+    }
+    return best;
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    tm = &device.getTargetModel();
+
+    // Switchboxes and wires are only legal for the placement they were
+    // generated for.
+    if (!device.getOps<SwitchboxOp>().empty() ||
+        !device.getOps<ShimMuxOp>().empty()) {
+      device.emitWarning("aie-place: device is already routed, the placement "
+                         "is left unchanged");
+      return;
+    }
+
+    collectTiles(device);
+    collectDemands(device);
+    collectObjectFifos(device);
+
+    std::map<TileKind, SmallVector<TileID>> positions;
+    for (int col = 0; col < tm->columns(); col++)
+      for (int row = 0; row < tm->rows(); row++)
+        positions[getTileKind(*tm, col, row)].push_back({col, row});
+    // A tile whose kind does not exist in the device has no positions.
+    for (TileKind kind : kinds)
+      positions.try_emplace(kind);
+
+    SmallVector<TileID> initial;
+    for (TileOp tile : tiles)
+      initial.push_back({tile.getCol(), tile.getRow()});
+    PlacementCost initialCost = evaluate(initial);
+
+    SmallVector<TileID> placement = constructPlacement(positions);
+    if (placement.empty())
+      placement = initial;
+    PlacementCost cost = refinePlacement(placement, positions);
+    if (!(cost < initialCost)) {
+      placement = initial;
+      cost = refinePlacement(placement, positions);
+    }
+
+    LLVM_DEBUG(llvm::dbgs()
+               << "aie-place: wirelength " << initialCost.wirelength << " -> "
+               << cost.wirelength << ", congestion overflow "
+               << initialCost.overflow << " -> " << cost.overflow
+               << ", violations " << initialCost.violations << " -> "
+               << cost.violations << "\n");
+
+    if (cost.violations) {
+      SmallVector<std::string> diagnostics;
+      evaluate(placement, &diagnostics);
+      auto diag = device.emitError("aie-place: no placement satisfies the "
+                                   "resource limits of the device");
+      for (auto &msg : diagnostics)
+        diag.attachNote() << msg;
+      return signalPassFailure();
+    }
+
+    for (auto [tile, p] : llvm::zip(tiles, placement)) {
+      if (tile.getCol() == p.col && tile.getRow() == p.row)
+        continue;
+      tile.setCol(p.col);
+      tile.setRow(p.row);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIEPlacePass() {
+  return std::make_unique<AIEPlacePass>();
+}
@@ -0,0 +1,268 @@
+//===- AIERoutingCache.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-routing-cache"
+
+// Cache files describe every flow by its source and the connections it makes
+// in every switchbox, with columns relative to the leftmost column of the
+// flows:
+//   {"key": ..., "columns": {"0": "NCCCC", ...},
+//    "flows": [{"src": [col, row, bundle, channel],
+//               "connections": [[col, row, bundle, channel,
+//                                bundle, channel], ...]}, ...]}
+static std::optional<Port> readPort(const llvm::json::Array &array,
+                                    size_t pos) {
+  if (array.size() < pos + 2)
+    return std::nullopt;
+  std::optional<llvm::StringRef> bundle = array[pos].getAsString();
+  std::optional<int64_t> channel = array[pos + 1].getAsInteger();
+  if (!bundle || !channel)
+    return std::nullopt;
+  std::optional<WireBundle> wireBundle = symbolizeWireBundle(*bundle);
+  if (!wireBundle)
+    return std::nullopt;
+  return Port{*wireBundle, static_cast<int>(*channel)};
+}
+
+static std::optional<TileID> readTile(const llvm::json::Array &array,
+                                      int columnOffset, int maxRow) {
+  if (array.size() < 2)
+    return std::nullopt;
+  std::optional<int64_t> col = array[0].getAsInteger();
+  std::optional<int64_t> row = array[1].getAsInteger();
+  if (!col || !row || *row < 0 || *row > maxRow)
+    return std::nullopt;
+  return TileID{static_cast<int>(*col) + columnOffset, static_cast<int>(*row)};
+}
+
+RoutingCache::RoutingCache(llvm::StringRef directory, DeviceOp device,
+                           int maxCol, int maxRow)
+    : directory(directory),
+      deviceName(stringifyAIEDevice(device.getDevice())),
+      targetModel(device.getTargetModel()), maxCol(maxCol), maxRow(maxRow) {}
+
+void RoutingCache::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
+                           Port dstPort, bool isPacketFlow,
+                           bool isPriorityFlow) {
+  std::string kind = !isPacketFlow    ? "flow"
+                     : isPriorityFlow ? "priority_packetflow"
+                                      : "packetflow";
+  entries.push_back({kind, srcCoords, srcPort, dstCoords, dstPort});
+}
+
+void RoutingCache::addFixedConnection(SwitchboxOp switchboxOp) {
+  TileID coords = {switchboxOp.colIndex(), switchboxOp.rowIndex()};
+  for (ConnectOp connectOp : switchboxOp.getOps<ConnectOp>())
+    entries.push_back({"connect", coords, connectOp.sourcePort(), coords,
+                       connectOp.destPort()});
+}
+
+void RoutingCache::addOption(llvm::StringRef option) {
+  options.push_back(option.str());
+}
+
+std::string RoutingCache::getColumnKind(int col) const {
+  std::string kind;
+  for (int row = 0; row <= maxRow; row++) {
+    if (targetModel.isShimNOCTile(col, row))
+      kind += 'N';
+    else if (targetModel.isShimPLTile(col, row))
+      kind += 'P';
+    else if (targetModel.isMemTile(col, row))
+      kind += 'M';
+    else if (targetModel.isCoreTile(col, row))
+      kind += 'C';
+    else
+      kind += '-';
+  }
+  return kind;
+}
+
+int RoutingCache::getColumnOffset() const {
+  int offset = maxCol;
+  for (const Entry &entry : entries)
+    offset = std::min({offset, entry.srcCoords.col, entry.dstCoords.col});
+  return offset;
+}
+
+// The device, the routing options, the kinds of the columns the flows span,
+// and the flows and fixed connections in a canonical order.
+std::string RoutingCache::getKey() const {
+  int offset = getColumnOffset();
+  int lastCol = offset;
+  std::vector<std::string> lines;
+  for (const Entry &entry : entries) {
+    lastCol = std::max({lastCol, entry.srcCoords.col, entry.dstCoords.col});
+    lines.push_back(llvm::formatv(
+        "{0} ({1}, {2}) {3} : {4} -> ({5}, {6}) {7} : {8}", entry.kind,
+        entry.srcCoords.col - offset, entry.srcCoords.row,
+        stringifyWireBundle(entry.srcPort.bundle), entry.srcPort.channel,
+        entry.dstCoords.col - offset, entry.dstCoords.row,
+        stringifyWireBundle(entry.dstPort.bundle), entry.dstPort.channel)
+                        .str());
+  }
+  llvm::sort(lines);
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << "device " << deviceName << "\n";
+  for (const std::string &option : options)
+    os << "option " << option << "\n";
+  for (int col = offset; col <= lastCol; col++)
+    os << "column " << col - offset << " " << getColumnKind(col) << "\n";
+  for (const std::string &line : lines)
+    os << line << "\n";
+  return os.str();
+}
+
+std::string RoutingCache::getPath(llvm::StringRef key) const {
+  llvm::SmallString<128> path(directory);
+  llvm::sys::path::append(
+      path,
+      llvm::utohexstr(llvm::xxh3_64bits(llvm::arrayRefFromStringRef(key))) +
+          ".json");
+  return std::string(path);
+}
+
+std::optional<std::map<PathEndPoint, SwitchSettings>> RoutingCache::lookup() {
+  if (entries.empty())
+    return std::nullopt;
+  std::string key = getKey();
+  std::string path = getPath(key);
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+      llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    LLVM_DEBUG(llvm::dbgs() << "routing cache miss: " << path << "\n");
+    return std::nullopt;
+  }
+  llvm::Expected<llvm::json::Value> value =
+      llvm::json::parse((*buffer)->getBuffer());
+  if (!value) {
+    llvm::consumeError(value.takeError());
+    return std::nullopt;
+  }
+  // Distinct keys may hash the same.
+  llvm::json::Object *object = value->getAsObject();
+  if (!object || object->getString("key") != llvm::StringRef(key))
+    return std::nullopt;
+
+  // The routing only carries over to columns of the same kind as the ones it
+  // was found for.
+  int offset = getColumnOffset();
+  llvm::json::Object *columns = object->getObject("columns");
+  llvm::json::Array *flows = object->getArray("flows");
+  if (!columns || !flows)
+    return std::nullopt;
+  for (const auto &column : *columns) {
+    int col;
+    if (llvm::StringRef(column.first).getAsInteger(10, col))
+      return std::nullopt;
+    col += offset;
+    std::optional<llvm::StringRef> kind = column.second.getAsString();
+    if (col < 0 || col > maxCol || !kind || *kind != getColumnKind(col)) {
+      LLVM_DEBUG(llvm::dbgs() << "routing cache entry " << path
+                              << " does not fit column " << col << "\n");
+      return std::nullopt;
+    }
+  }
+
+  std::map<PathEndPoint, SwitchSettings> flowSolutions;
+  for (const llvm::json::Value &flow : *flows) {
+    const llvm::json::Object *flowObject = flow.getAsObject();
+    if (!flowObject)
+      return std::nullopt;
+    const llvm::json::Array *src = flowObject->getArray("src");
+    const llvm::json::Array *connections = flowObject->getArray("connections");
+    if (!src || !connections)
+      return std::nullopt;
+    std::optional<TileID> srcCoords = readTile(*src, offset, maxRow);
+    std::optional<Port> srcPort = readPort(*src, 2);
+    if (!srcCoords || !srcPort)
+      return std::nullopt;
+
+    SwitchSettings switchSettings;
+    for (const llvm::json::Value &connection : *connections) {
+      const llvm::json::Array *array = connection.getAsArray();
+      if (!array)
+        return std::nullopt;
+      std::optional<TileID> coords = readTile(*array, offset, maxRow);
+      std::optional<Port> connectSrc = readPort(*array, 2);
+      std::optional<Port> connectDst = readPort(*array, 4);
+      if (!coords || !connectSrc || !connectDst)
+        return std::nullopt;
+      switchSettings[*coords].srcs.push_back(*connectSrc);
+      switchSettings[*coords].dsts.push_back(*connectDst);
+    }
+    flowSolutions[PathEndPoint{*srcCoords, *srcPort}] = switchSettings;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "routing cache hit: " << path << "\n");
+  return flowSolutions;
+}
+
+LogicalResult RoutingCache::store(
+    const std::map<PathEndPoint, SwitchSettings> &flowSolutions) {
+  if (entries.empty())
+    return success();
+  int offset = getColumnOffset();
+  llvm::json::Object columns;
+  llvm::json::Array flows;
+  for (const auto &[src, switchSettings] : flowSolutions) {
+    columns[std::to_string(src.coords.col - offset)] =
+        getColumnKind(src.coords.col);
+    llvm::json::Array connections;
+    for (const auto &[coords, setting] : switchSettings) {
+      columns[std::to_string(coords.col - offset)] = getColumnKind(coords.col);
+      for (const auto &[connectSrc, connectDst] :
+           llvm::zip(setting.srcs, setting.dsts))
+        connections.push_back(llvm::json::Array{
+            coords.col - offset, coords.row,
+            stringifyWireBundle(connectSrc.bundle), connectSrc.channel,
+            stringifyWireBundle(connectDst.bundle), connectDst.channel});
+    }
+    flows.push_back(llvm::json::Object{
+        {"src", llvm::json::Array{src.coords.col - offset, src.coords.row,
+                                  stringifyWireBundle(src.port.bundle),
+                                  src.port.channel}},
+        {"connections", std::move(connections)}});
+  }
+
+  if (llvm::sys::fs::create_directories(directory))
+    return failure();
+  std::string key = getKey();
+  llvm::json::Value value = llvm::json::Object{{"key", key},
+                                               {"columns", std::move(columns)},
+                                               {"flows", std::move(flows)}};
+  // Write to a temporary file first, so that concurrent compilations never
+  // read a partial entry.
+  if (llvm::Error error =
+          llvm::writeToOutput(getPath(key), [&](llvm::raw_ostream &os) {
+            os << llvm::formatv("{0:2}", value) << "\n";
+            return llvm::Error::success();
+          })) {
+    llvm::consumeError(std::move(error));
+    return failure();
+  }
+  return success();
+}
@@ -0,0 +1,241 @@
+//===- AIERoutingMetrics.cpp ------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
+
+#include <functional>
+#include <limits>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+// The channels of the links between switchboxes that flows use, and how many
+// packet flows share each packet channel.
+struct LinkUsage {
+  std::set<int> circuitChannels;
+  std::set<int> packetChannels;
+  int packetFlows = 0;
+};
+
+constexpr size_t numContendedSwitchboxes = 10;
+
+bool isNeighborBundle(WireBundle bundle) {
+  return bundle == WireBundle::North || bundle == WireBundle::South ||
+         bundle == WireBundle::East || bundle == WireBundle::West;
+}
+
+TileID getNeighbor(TileID coords, WireBundle bundle) {
+  switch (bundle) {
+  case WireBundle::North:
+    return {coords.col, coords.row + 1};
+  case WireBundle::South:
+    return {coords.col, coords.row - 1};
+  case WireBundle::East:
+    return {coords.col + 1, coords.row};
+  default:
+    return {coords.col - 1, coords.row};
+  }
+}
+
+std::string toString(Port port) {
+  return (stringifyWireBundle(port.bundle) + ":" + std::to_string(port.channel))
+      .str();
+}
+
+llvm::json::Object toJSON(TileID coords) {
+  return llvm::json::Object{{"col", coords.col}, {"row", coords.row}};
+}
+
+// The fewest and the most switchboxes a flow passes through to any of its
+// destinations.
+std::pair<int, int> getLatency(const PathEndPoint &src,
+                               const SwitchSettings &settings) {
+  int minLatency = std::numeric_limits<int>::max(), latency = 0;
+  std::set<PathEndPoint> visited;
+  std::function<void(PathEndPoint, int)> visit = [&](PathEndPoint in,
+                                                     int depth) {
+    if (!visited.insert(in).second)
+      return;
+    auto setting = settings.find(in.coords);
+    if (setting == settings.end())
+      return;
+    for (auto [srcPort, dstPort] :
+         llvm::zip(setting->second.srcs, setting->second.dsts)) {
+      if (srcPort != in.port)
+        continue;
+      if (!isNeighborBundle(dstPort.bundle)) {
+        minLatency = std::min(minLatency, depth);
+        latency = std::max(latency, depth);
+        continue;
+      }
+      visit({getNeighbor(in.coords, dstPort.bundle),
+             {getConnectingBundle(dstPort.bundle), dstPort.channel}},
+            depth + 1);
+    }
+  };
+  visit(src, 1);
+  return {std::min(minLatency, latency), latency};
+}
+
+} // namespace
+
+llvm::json::Value AIE::getRoutingMetrics(
+    DeviceOp device,
+    const std::map<PathEndPoint, SwitchSettings> &flowSolutions) {
+  const AIETargetModel &targetModel = device.getTargetModel();
+
+  std::set<PathEndPoint> packetSources;
+  for (PacketFlowOp packetFlowOp : device.getOps<PacketFlowOp>()) {
+    for (PacketSourceOp source :
+         packetFlowOp.getPorts().getOps<PacketSourceOp>()) {
+      auto tile = cast<TileOp>(source.getTile().getDefiningOp());
+      packetSources.insert(
+          {{tile.colIndex(), tile.rowIndex()}, source.port()});
+    }
+  }
+
+  std::map<std::pair<TileID, WireBundle>, LinkUsage> links;
+  std::map<TileID, std::set<Port>> usedPorts;
+  llvm::json::Array flows;
+  int totalHops = 0, maxLatency = 0;
+  for (const auto &[src, settings] : flowSolutions) {
+    bool isPacketFlow = packetSources.count(src);
+    int hops = 0, destinations = 0;
+    for (const auto &[coords, setting] : settings) {
+      for (Port dstPort : setting.dsts) {
+        usedPorts[coords].insert(dstPort);
+        if (!isNeighborBundle(dstPort.bundle)) {
+          destinations++;
+          continue;
+        }
+        hops++;
+        LinkUsage &link = links[{coords, dstPort.bundle}];
+        if (isPacketFlow) {
+          link.packetChannels.insert(dstPort.channel);
+          link.packetFlows++;
+        } else {
+          link.circuitChannels.insert(dstPort.channel);
+        }
+      }
+    }
+    auto [minLatency, latency] = getLatency(src, settings);
+    totalHops += hops;
+    maxLatency = std::max(maxLatency, latency);
+    flows.push_back(llvm::json::Object{
+        {"source", toJSON(src.coords)},
+        {"port", toString(src.port)},
+        {"packet", isPacketFlow},
+        {"destinations", destinations},
+        {"hops", hops},
+        {"latency", latency},
+        {"min_latency", minLatency}});
+  }
+
+  // Capacities count the channels out of every switchbox.
+  const std::vector<WireBundle> neighborBundles = {
+      WireBundle::North, WireBundle::South, WireBundle::East,
+      WireBundle::West};
+  llvm::json::Array linkMetrics;
+  double maxLinkUtilization = 0.0;
+  int usedChannels = 0, unusedChannels = 0;
+  struct Switchbox {
+    TileID coords;
+    int used;
+    int capacity;
+  };
+  std::vector<Switchbox> switchboxes;
+  llvm::json::Array heatMap;
+  for (int row = 0; row < targetModel.rows(); row++) {
+    llvm::json::Array heatMapRow;
+    for (int col = 0; col < targetModel.columns(); col++) {
+      TileID coords = {col, row};
+      int switchboxCapacity = 0;
+      for (WireBundle bundle : neighborBundles) {
+        int capacity =
+            targetModel.getNumDestSwitchboxConnections(col, row, bundle);
+        if (capacity == 0)
+          continue;
+        TileID neighbor = getNeighbor(coords, bundle);
+        if (!targetModel.isValidTile(neighbor))
+          continue;
+        switchboxCapacity += capacity;
+        auto link = links.find({coords, bundle});
+        int used = 0;
+        if (link != links.end()) {
+          used = link->second.circuitChannels.size() +
+                 link->second.packetChannels.size();
+          double utilization = double(used) / capacity;
+          maxLinkUtilization = std::max(maxLinkUtilization, utilization);
+          linkMetrics.push_back(llvm::json::Object{
+              {"source", toJSON(coords)},
+              {"direction", stringifyWireBundle(bundle)},
+              {"capacity", capacity},
+              {"circuit_channels", int(link->second.circuitChannels.size())},
+              {"packet_channels", int(link->second.packetChannels.size())},
+              {"packet_flows", link->second.packetFlows},
+              {"utilization", utilization}});
+        }
+        usedChannels += used;
+        unusedChannels += capacity - used;
+      }
+      int used = usedPorts.count(coords) ? int(usedPorts[coords].size()) : 0;
+      for (WireBundle bundle : {WireBundle::Core, WireBundle::DMA,
+                                WireBundle::FIFO, WireBundle::Trace,
+                                WireBundle::Ctrl})
+        switchboxCapacity +=
+            targetModel.getNumDestSwitchboxConnections(col, row, bundle);
+      double utilization =
+          switchboxCapacity ? std::min(1.0, double(used) / switchboxCapacity)
+                            : 0.0;
+      heatMapRow.push_back(utilization);
+      if (used)
+        switchboxes.push_back({coords, used, switchboxCapacity});
+    }
+    heatMap.push_back(std::move(heatMapRow));
+  }
+
+  auto utilization = [](const Switchbox &switchbox) {
+    return switchbox.capacity ? double(switchbox.used) / switchbox.capacity
+                              : 1.0;
+  };
+  llvm::stable_sort(switchboxes,
+                    [&](const Switchbox &lhs, const Switchbox &rhs) {
+                      return utilization(lhs) > utilization(rhs);
+                    });
+  if (switchboxes.size() > numContendedSwitchboxes)
+    switchboxes.resize(numContendedSwitchboxes);
+  llvm::json::Array contended;
+  for (const Switchbox &switchbox : switchboxes)
+    contended.push_back(llvm::json::Object{
+        {"switchbox", toJSON(switchbox.coords)},
+        {"used_ports", switchbox.used},
+        {"capacity", switchbox.capacity},
+        {"utilization", utilization(switchbox)}});
+
+  return llvm::json::Object{
+      {"device", stringifyAIEDevice(device.getDevice())},
+      {"name", device.getArtifactName()},
+      {"summary", llvm::json::Object{{"flows", int(flowSolutions.size())},
+                                     {"total_hops", totalHops},
+                                     {"max_latency", maxLatency},
+                                     {"max_link_utilization",
+                                      maxLinkUtilization},
+                                     {"used_channels", usedChannels},
+                                     {"unused_channels", unusedChannels}}},
+      {"flows", std::move(flows)},
+      {"links", std::move(linkMetrics)},
+      {"contended_switchboxes", std::move(contended)},
+      {"heat_map", llvm::json::Object{{"columns", targetModel.columns()},
+                                      {"rows", targetModel.rows()},
+                                      {"utilization", std::move(heatMap)}}}};
+}
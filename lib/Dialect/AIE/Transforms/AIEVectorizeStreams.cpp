@@ -0,0 +1,149 @@
+//===- AIEVectorizeStreams.cpp ----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Pass/Pass.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+#define DEBUG_TYPE "aie-vectorize-streams"
+
+namespace {
+
+// A loop that moves one element of a buffer per iteration between the buffer
+// and a stream, in either direction:
+//   %v = aie.get_stream(%c)         or   %v = memref.load %m[.., %iv]
+//   memref.store %v, %m[.., %iv]         aie.put_stream(%c, %v)
+struct StreamLoop {
+  scf::ForOp loop;
+  Operation *streamOp;
+  Operation *memoryOp;
+};
+
+// Whether consecutive iterations of `loop` access consecutive elements of the
+// buffer.
+bool isContiguousAccess(scf::ForOp loop, Value memref, ValueRange indices) {
+  auto type = cast<MemRefType>(memref.getType());
+  if (!type.getLayout().isIdentity() || !loop.isDefinedOutsideOfLoop(memref) ||
+      indices.empty() || indices.back() != loop.getInductionVar())
+    return false;
+  return llvm::all_of(indices.drop_back(), [&](Value index) {
+    return loop.isDefinedOutsideOfLoop(index);
+  });
+}
+
+std::optional<StreamLoop> matchStreamLoop(scf::ForOp loop) {
+  Block *body = loop.getBody();
+  if (loop.getNumRegionIterArgs() != 0 ||
+      !llvm::hasNItems(body->without_terminator(), 2))
+    return std::nullopt;
+  Operation *first = &body->front();
+  Operation *second = first->getNextNode();
+
+  if (auto get = dyn_cast<GetStreamOp>(first)) {
+    auto store = dyn_cast<memref::StoreOp>(second);
+    if (!store || store.getValue() != get.getStreamValue() ||
+        !get->hasOneUse() || get.isWideStream() || get.isVectorStream() ||
+        !loop.isDefinedOutsideOfLoop(get.getChannel()) ||
+        !isContiguousAccess(loop, store.getMemRef(), store.getIndices()))
+      return std::nullopt;
+    return StreamLoop{loop, get, store};
+  }
+
+  if (auto load = dyn_cast<memref::LoadOp>(first)) {
+    auto put = dyn_cast<PutStreamOp>(second);
+    if (!put || put.getStreamValue() != load.getResult() ||
+        !load->hasOneUse() || put.isWideStream() || put.isVectorStream() ||
+        !loop.isDefinedOutsideOfLoop(put.getChannel()) ||
+        !isContiguousAccess(loop, load.getMemRef(), load.getIndices()))
+      return std::nullopt;
+    return StreamLoop{loop, put, load};
+  }
+  return std::nullopt;
+}
+
+struct AIEVectorizeStreamsPass
+    : AIEVectorizeStreamsBase<AIEVectorizeStreamsPass> {
+  // Rewrites the loop to move `width` elements per iteration, which requires
+  // its trip count to be a multiple of `width`.
+  void vectorize(StreamLoop &match, int64_t width) {
+    scf::ForOp loop = match.loop;
+    std::optional<int64_t> lb = getConstantIntValue(loop.getLowerBound());
+    std::optional<int64_t> ub = getConstantIntValue(loop.getUpperBound());
+    std::optional<int64_t> step = getConstantIntValue(loop.getStep());
+    if (!lb || !ub || !step || *step != 1 || *ub <= *lb ||
+        (*ub - *lb) % width != 0) {
+      LLVM_DEBUG(llvm::dbgs() << "not vectorizing " << loop << "\n");
+      return;
+    }
+
+    OpBuilder builder(loop);
+    loop.setStep(builder.create<arith::ConstantIndexOp>(loop.getLoc(), width));
+
+    if (auto get = dyn_cast<GetStreamOp>(match.streamOp)) {
+      auto store = cast<memref::StoreOp>(match.memoryOp);
+      auto vectorType =
+          VectorType::get({width}, get.getStreamValue().getType());
+      builder.setInsertionPoint(store);
+      Value value = builder.create<GetStreamOp>(get.getLoc(), vectorType,
+                                                get.getChannel());
+      builder.create<vector::StoreOp>(store.getLoc(), value, store.getMemRef(),
+                                      store.getIndices());
+      store.erase();
+      get.erase();
+      return;
+    }
+
+    auto put = cast<PutStreamOp>(match.streamOp);
+    auto load = cast<memref::LoadOp>(match.memoryOp);
+    auto vectorType = VectorType::get({width}, load.getType());
+    builder.setInsertionPoint(put);
+    Value value = builder.create<vector::LoadOp>(
+        load.getLoc(), vectorType, load.getMemRef(), load.getIndices());
+    builder.create<PutStreamOp>(put.getLoc(), put.getChannel(), value);
+    put.erase();
+    load.erase();
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    if (clVectorBits % 32 != 0 || clVectorBits < 64) {
+      device.emitError("vector-bits must be a multiple of 32 of at least 64");
+      return signalPassFailure();
+    }
+    // Scalar streams only carry 32-bit values.
+    int64_t width = clVectorBits / 32;
+
+    SmallVector<StreamLoop> matches;
+    device.walk([&](scf::ForOp loop) {
+      if (!loop->getParentOfType<CoreOp>())
+        return;
+      if (std::optional<StreamLoop> match = matchStreamLoop(loop))
+        matches.push_back(*match);
+    });
+    for (StreamLoop &match : matches)
+      vectorize(match, width);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIEVectorizeStreamsPass() {
+  return std::make_unique<AIEVectorizeStreamsPass>();
+}
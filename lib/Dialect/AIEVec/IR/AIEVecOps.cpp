@@ -1240,6 +1240,8 @@ LogicalResult ShuffleOp::verify() {
     modeBitWidth = 16u;
     break;
   case ShuffleMode::T32_4X4: // 34
+  case ShuffleMode::T32_2X8: // 48
+  case ShuffleMode::T32_8X2: // 49
     requireRhs = false;
     LLVM_FALLTHROUGH;
   case ShuffleMode::T32_16X2_LO: //  4
@@ -1252,6 +1254,10 @@ LogicalResult ShuffleOp::verify() {
   case ShuffleMode::T32_4X8_HI:  // 33
     modeBitWidth = 32u;
     break;
+  case ShuffleMode::T64_2X4: // 50
+  case ShuffleMode::T64_4X2: // 51
+    requireRhs = false;
+    LLVM_FALLTHROUGH;
   case ShuffleMode::T64_8X2_LO: //  6
   case ShuffleMode::T64_8X2_HI: //  7
   case ShuffleMode::T64_2X8_LO: // 14
@@ -0,0 +1,571 @@
+//===- AIEVecCycleEstimate.cpp - Static cycle estimate for AIE kernels ----===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This is a static estimator of the cycles per iteration of the innermost
+// loops of vectorized AIE kernels. It works on AIEVec IR and on the XLLVM
+// intrinsics AIEVec is lowered to.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/Analysis/Passes.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+#include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
+
+#include <functional>
+
+#define DEBUG_TYPE "aievec-cycle-estimate"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+namespace xilinx::aievec {
+#define GEN_PASS_DEF_AIEVECCYCLEESTIMATE
+#include "aie/Dialect/AIEVec/Analysis/Passes.h.inc"
+} // namespace xilinx::aievec
+
+namespace {
+
+/// Resources of the core VLIW the estimate is computed against. One VLIW
+/// instruction can issue two loads, one store, one vector (MAC/ALU) operation,
+/// two moves and one scalar operation.
+struct CoreModel {
+  unsigned vectorSlots;
+  unsigned moveSlots;
+  unsigned scalarSlots;
+  unsigned loadPorts;
+  unsigned loadPortBits;
+  unsigned storePorts;
+  unsigned storePortBits;
+  unsigned numVectorRegs;
+  unsigned vectorRegBits;
+  unsigned numAccRegs;
+  unsigned accRegBits;
+
+  static CoreModel get(AIEArch arch) {
+    if (arch == AIEArch::AIE2P)
+      return {/*vectorSlots=*/1,     /*moveSlots=*/2,
+              /*scalarSlots=*/1,     /*loadPorts=*/2,
+              /*loadPortBits=*/512,  /*storePorts=*/1,
+              /*storePortBits=*/512, /*numVectorRegs=*/12,
+              /*vectorRegBits=*/512, /*numAccRegs=*/9,
+              /*accRegBits=*/2048};
+    return {/*vectorSlots=*/1,     /*moveSlots=*/2,
+            /*scalarSlots=*/1,     /*loadPorts=*/2,
+            /*loadPortBits=*/256,  /*storePorts=*/1,
+            /*storePortBits=*/256, /*numVectorRegs=*/12,
+            /*vectorRegBits=*/512, /*numAccRegs=*/9,
+            /*accRegBits=*/1024};
+  }
+
+  /// Nominal MACs per cycle of the vector unit for the given operand element
+  /// types, or 0 if the precision is not natively supported.
+  static unsigned peakMacsPerCycle(AIEArch arch, Type lhs, Type rhs) {
+    unsigned scale = arch == AIEArch::AIE2P ? 2 : 1;
+    if (lhs.isBF16() && rhs.isBF16())
+      return 128 * scale;
+    if (isa<Float8E4M3FNType, Float8E5M2Type>(lhs) &&
+        isa<Float8E4M3FNType, Float8E5M2Type>(rhs))
+      return arch == AIEArch::AIE2P ? 512 : 0;
+    if (!lhs.isInteger() || !rhs.isInteger())
+      return 0;
+    unsigned lw = lhs.getIntOrFloatBitWidth();
+    unsigned rw = rhs.getIntOrFloatBitWidth();
+    if (lw < rw)
+      std::swap(lw, rw);
+    if (lw == 8 && rw == 4)
+      return 512 * scale;
+    if (lw == 8 && rw == 8)
+      return 256 * scale;
+    if (lw == 16 && rw == 8)
+      return 128 * scale;
+    if (lw == 16 && rw == 16)
+      return 64 * scale;
+    if (lw == 32 && rw == 16)
+      return 32 * scale;
+    return 0;
+  }
+};
+
+enum class Slot { None, Vector, Move, Scalar, Load, Store };
+
+static uint64_t getBitWidth(Type type) {
+  if (auto vecTy = dyn_cast<VectorType>(type))
+    return vecTy.getNumElements() * vecTy.getElementTypeBitWidth();
+  if (type.isIntOrIndexOrFloat())
+    return type.isIndex() ? 32 : type.getIntOrFloatBitWidth();
+  return 0;
+}
+
+/// Classify XLLVM intrinsics by their mnemonic.
+static Slot classifyXLLVMOp(Operation *op) {
+  if (op->getNumOperands() == 0)
+    return Slot::None;
+  StringRef name = op->getName().getStringRef();
+  for (StringRef key : {"mac", "mul", "msc", "vmax", "vmin", "vsel", "add",
+                        "sub", "vband", "vbor", "vbxor", "vbneg", "vneg"})
+    if (name.contains(key))
+      return Slot::Vector;
+  return Slot::Move;
+}
+
+static bool isXLLVMMac(Operation *op) {
+  StringRef name = op->getName().getStringRef();
+  return name.starts_with("xllvm.") &&
+         (name.contains("mac") || name.contains("mul") || name.contains("msc"));
+}
+
+static Slot classify(Operation *op) {
+  if (op->getDialect() && op->getDialect()->getNamespace() == "xllvm")
+    return classifyXLLVMOp(op);
+  return llvm::TypeSwitch<Operation *, Slot>(op)
+      .Case<MatMulOp, MatMulAIE2POp, MulElemOp, FMAElemOp, MulConvOp,
+            FMAConvOp, AddElemOp, SubElemOp, MinOp, MaxOp, CmpOp, SelOp, NegOp,
+            BxorOp, BnegOp, BorOp, BandOp, vector::FMAOp,
+            vector::ContractionOp>([](auto) { return Slot::Vector; })
+      .Case<ShuffleOp, LegacyShuffleOp, ExtOp, ConcatOp, BroadcastOp,
+            BroadcastScalarOp, ShiftOp, PackOp, UnpackOp, SRSOp, UPSOp,
+            ExtElemOp, vector::BroadcastOp, vector::SplatOp,
+            vector::ExtractOp, vector::InsertOp, vector::TransposeOp>(
+          [](auto) { return Slot::Move; })
+      .Case<UPDOp, vector::TransferReadOp, vector::LoadOp, memref::LoadOp,
+            LLVM::LoadOp>([](auto) { return Slot::Load; })
+      .Case<vector::TransferWriteOp, vector::StoreOp, memref::StoreOp,
+            LLVM::StoreOp>([](auto) { return Slot::Store; })
+      .Case<CastOp, vector::ShapeCastOp, arith::ConstantOp, LLVM::ConstantOp,
+            LLVM::BitcastOp, LLVM::GEPOp, memref::SubViewOp,
+            memref::ReinterpretCastOp>([](auto) { return Slot::None; })
+      .Default([](Operation *op) {
+        if (op->hasTrait<OpTrait::IsTerminator>() || op->getNumResults() == 0)
+          return Slot::None;
+        if (op->getDialect() &&
+            op->getDialect()->getNamespace() == "arith") {
+          if (isa<VectorType>(op->getResult(0).getType()))
+            return Slot::Vector;
+          return Slot::Scalar;
+        }
+        if (op->getDialect() && op->getDialect()->getNamespace() == "llvm")
+          return Slot::Scalar;
+        return Slot::None;
+      });
+}
+
+/// Memory buffer a load or store accesses, or a null value if unknown.
+static Value getAccessedBuffer(Operation *op) {
+  Value base =
+      llvm::TypeSwitch<Operation *, Value>(op)
+          .Case<UPDOp>([](auto op) { return op.getSource(); })
+          .Case<vector::TransferReadOp, vector::TransferWriteOp>(
+              [](auto op) { return op.getSource(); })
+          .Case<vector::LoadOp, vector::StoreOp>(
+              [](auto op) { return op.getBase(); })
+          .Case<memref::LoadOp, memref::StoreOp>(
+              [](auto op) { return op.getMemRef(); })
+          .Case<LLVM::LoadOp>([](auto op) { return op.getAddr(); })
+          .Case<LLVM::StoreOp>([](auto op) { return op.getAddr(); })
+          .Default([](auto) { return Value(); });
+  while (base) {
+    Operation *def = base.getDefiningOp();
+    if (!def)
+      break;
+    if (auto gep = dyn_cast<LLVM::GEPOp>(def))
+      base = gep.getBase();
+    else if (auto subview = dyn_cast<memref::SubViewOp>(def))
+      base = subview.getSource();
+    else if (auto castOp = dyn_cast<memref::ReinterpretCastOp>(def))
+      base = castOp.getSource();
+    else
+      break;
+  }
+  return base;
+}
+
+static uint64_t getAccessBits(Operation *op) {
+  if (isa<LLVM::StoreOp, memref::StoreOp, vector::StoreOp,
+          vector::TransferWriteOp>(op))
+    return getBitWidth(op->getOperand(0).getType());
+  if (op->getNumResults() == 1)
+    return getBitWidth(op->getResult(0).getType());
+  return 0;
+}
+
+/// Number of multiply-accumulates performed by `op`, and the element types of
+/// its multiplicands.
+static std::optional<std::tuple<uint64_t, Type, Type>>
+getMacs(Operation *op, AIEArch arch) {
+  auto lanes = [](Value v) -> uint64_t {
+    if (auto vecTy = dyn_cast<VectorType>(v.getType()))
+      return vecTy.getNumElements();
+    return 1;
+  };
+  auto matmul = [](Value lhs, Value rhs) -> uint64_t {
+    auto lhsTy = cast<VectorType>(lhs.getType());
+    auto rhsTy = cast<VectorType>(rhs.getType());
+    return lhsTy.getDimSize(0) * lhsTy.getDimSize(1) * rhsTy.getDimSize(1);
+  };
+  using Result = std::optional<std::tuple<uint64_t, Type, Type>>;
+  return llvm::TypeSwitch<Operation *, Result>(op)
+      .Case<MatMulOp, MatMulAIE2POp>([&](auto op) -> Result {
+        return std::make_tuple(matmul(op.getLhs(), op.getRhs()),
+                               getElementTypeOrSelf(op.getLhs()),
+                               getElementTypeOrSelf(op.getRhs()));
+      })
+      .Case<MulElemOp, FMAElemOp>([&](auto op) -> Result {
+        return std::make_tuple(lanes(op.getResult()),
+                               getElementTypeOrSelf(op.getLhs()),
+                               getElementTypeOrSelf(op.getRhs()));
+      })
+      .Case<MulConvOp, FMAConvOp>([&](auto op) -> Result {
+        return std::make_tuple(
+            static_cast<uint64_t>(op.getM()) * op.getN(),
+            getElementTypeOrSelf(op.getLhs()),
+            getElementTypeOrSelf(op.getRhs()));
+      })
+      .Case<vector::FMAOp>([&](auto op) -> Result {
+        return std::make_tuple(lanes(op.getResult()),
+                               getElementTypeOrSelf(op.getLhs()),
+                               getElementTypeOrSelf(op.getRhs()));
+      })
+      .Case<arith::MulIOp, arith::MulFOp>([&](auto op) -> Result {
+        if (!isa<VectorType>(op.getType()))
+          return std::nullopt;
+        return std::make_tuple(lanes(op.getResult()),
+                               getElementTypeOrSelf(op.getLhs()),
+                               getElementTypeOrSelf(op.getRhs()));
+      })
+      .Default([&](Operation *op) -> Result {
+        // A MAC intrinsic is assumed to run at the peak rate of the
+        // precision of its multiplicands.
+        if (!isXLLVMMac(op) || op->getNumOperands() < 2)
+          return std::nullopt;
+        Type lhs = getElementTypeOrSelf(op->getOperand(0));
+        Type rhs = getElementTypeOrSelf(op->getOperand(1));
+        // Integer MACs take the rhs as a bag of i32 bits.
+        if (lhs.isInteger(8) && rhs.isInteger(32))
+          rhs = lhs;
+        uint64_t peak = CoreModel::peakMacsPerCycle(arch, lhs, rhs);
+        if (!peak)
+          return std::nullopt;
+        return std::make_tuple(peak, lhs, rhs);
+      });
+}
+
+/// Values held in accumulator registers rather than vector registers.
+/// `visited` holds the loop-carried values on the way to `v`, which may yield
+/// each other.
+static bool isAccumulator(Value v, SmallPtrSetImpl<Value> &visited) {
+  auto vecTy = dyn_cast<VectorType>(v.getType());
+  if (!vecTy)
+    return false;
+  if (auto arg = dyn_cast<BlockArgument>(v)) {
+    // Loop-carried values are in the register class of what is yielded.
+    auto loop = dyn_cast<LoopLikeOpInterface>(arg.getOwner()->getParentOp());
+    if (!loop || !visited.insert(v).second)
+      return false;
+    auto yielded = loop.getYieldedValues();
+    auto iterArgs = loop.getRegionIterArgs();
+    for (auto [iterArg, yield] : llvm::zip(iterArgs, yielded))
+      if (iterArg == arg)
+        return isAccumulator(yield, visited);
+    return false;
+  }
+  Operation *def = v.getDefiningOp();
+  if (auto castOp = dyn_cast<CastOp>(def))
+    return castOp.getIsResAcc();
+  if (isa<MatMulOp, MatMulAIE2POp, MulElemOp, FMAElemOp, MulConvOp, FMAConvOp,
+          UPSOp>(def))
+    return true;
+  // XLLVM intrinsics encode accumulators as vectors of i64.
+  return def->getDialect() && def->getDialect()->getNamespace() == "xllvm" &&
+         vecTy.getElementType().isInteger(64);
+}
+
+struct LoopEstimate {
+  unsigned vectorOps = 0;
+  unsigned moveOps = 0;
+  unsigned scalarOps = 0;
+  unsigned loadOps = 0;
+  unsigned storeOps = 0;
+  uint64_t loadBits = 0;
+  uint64_t storeBits = 0;
+  // Loads issued from the same buffer within one iteration; these cannot be
+  // dual-issued because they hit the same memory bank.
+  unsigned conflictingLoads = 0;
+  unsigned maxVectorRegs = 0;
+  unsigned maxAccRegs = 0;
+  unsigned spilledRegs = 0;
+  uint64_t macs = 0;
+  uint64_t peakMacs = 0;
+  uint64_t cycles = 0;
+  StringRef bound;
+  std::optional<int64_t> tripCount;
+};
+
+static uint64_t ceilDiv(uint64_t a, uint64_t b) { return (a + b - 1) / b; }
+
+/// Estimate the steady-state cycles of one iteration of `loop`, assuming the
+/// body is software pipelined so that the most contended resource sets the
+/// initiation interval.
+static LoopEstimate estimateLoop(LoopLikeOpInterface loop, AIEArch arch) {
+  CoreModel model = CoreModel::get(arch);
+  LoopEstimate est;
+  Block &body = loop->getRegion(0).front();
+
+  // Issue slot usage.
+  llvm::MapVector<Value, uint64_t> loadBitsPerBuffer;
+  llvm::MapVector<Value, unsigned> loadsPerBuffer;
+  llvm::MapVector<std::pair<Type, Type>, uint64_t> macsPerPrecision;
+  body.walk([&](Operation *op) {
+    switch (classify(op)) {
+    case Slot::Vector:
+      est.vectorOps++;
+      break;
+    case Slot::Move:
+      est.moveOps++;
+      break;
+    case Slot::Scalar:
+      est.scalarOps++;
+      break;
+    case Slot::Load: {
+      est.loadOps++;
+      uint64_t bits = getAccessBits(op);
+      est.loadBits += bits;
+      Value buffer = getAccessedBuffer(op);
+      loadBitsPerBuffer[buffer] += bits;
+      loadsPerBuffer[buffer]++;
+      break;
+    }
+    case Slot::Store:
+      est.storeOps++;
+      est.storeBits += getAccessBits(op);
+      break;
+    case Slot::None:
+      break;
+    }
+    if (auto macs = getMacs(op, arch)) {
+      auto [n, lhs, rhs] = *macs;
+      est.macs += n;
+      macsPerPrecision[{lhs, rhs}] += n;
+    }
+  });
+
+  // Register pressure: linear scan over the body, with uses inside nested
+  // regions attributed to their ancestor in the body. A value is counted as
+  // live before every op from the one after its definition up to its last
+  // use. Casts and shape casts do not need a register of their own.
+  auto isView = [](Operation *op) {
+    return isa<CastOp, vector::ShapeCastOp, LLVM::BitcastOp>(op);
+  };
+  DenseMap<Operation *, int64_t> position;
+  int64_t numOps = 0;
+  for (Operation &op : body)
+    position[&op] = numOps++;
+  std::function<int64_t(Value)> lastUse = [&](Value v) -> int64_t {
+    int64_t last = -1;
+    for (OpOperand &use : v.getUses()) {
+      Operation *user = body.findAncestorOpInBlock(*use.getOwner());
+      if (!user)
+        continue;
+      last = std::max(last, position[user]);
+      if (isView(user))
+        last = std::max(last, lastUse(user->getResult(0)));
+    }
+    return last;
+  };
+  // (def, last use, registers, isAcc) for every vector value.
+  SmallVector<std::tuple<int64_t, int64_t, unsigned, bool>> intervals;
+  auto addValue = [&](Value v, int64_t def) {
+    uint64_t bits = getBitWidth(v.getType());
+    if (!isa<VectorType>(v.getType()) || !bits)
+      return;
+    SmallPtrSet<Value, 4> visited;
+    bool acc = isAccumulator(v, visited);
+    unsigned regs =
+        ceilDiv(bits, acc ? model.accRegBits : model.vectorRegBits);
+    intervals.emplace_back(def, lastUse(v), regs, acc);
+  };
+  for (BlockArgument arg : body.getArguments())
+    addValue(arg, -1);
+  for (Operation &op : body)
+    if (!isView(&op))
+      for (Value res : op.getResults())
+        addValue(res, position[&op]);
+  for (int64_t i = 0; i < numOps; ++i) {
+    unsigned vec = 0, acc = 0;
+    for (auto [def, last, regs, isAcc] : intervals)
+      if (def < i && i <= last)
+        (isAcc ? acc : vec) += regs;
+    est.maxVectorRegs = std::max(est.maxVectorRegs, vec);
+    est.maxAccRegs = std::max(est.maxAccRegs, acc);
+  }
+
+  // Every register over the budget is spilled and reloaded once per
+  // iteration.
+  uint64_t spillBits = 0;
+  if (est.maxVectorRegs > model.numVectorRegs) {
+    unsigned n = est.maxVectorRegs - model.numVectorRegs;
+    est.spilledRegs += n;
+    spillBits += n * model.vectorRegBits;
+  }
+  if (est.maxAccRegs > model.numAccRegs) {
+    unsigned n = est.maxAccRegs - model.numAccRegs;
+    est.spilledRegs += n;
+    spillBits += n * model.accRegBits;
+  }
+
+  // Each buffer is assumed to live in its own bank, so loads from the same
+  // buffer serialize on one port while loads from different buffers can use
+  // both.
+  uint64_t loadCycles =
+      ceilDiv(est.loadBits + spillBits, model.loadPorts * model.loadPortBits);
+  for (auto [buffer, bits] : loadBitsPerBuffer) {
+    uint64_t sameBank = ceilDiv(bits, model.loadPortBits);
+    loadCycles = std::max(loadCycles, sameBank);
+    if (loadsPerBuffer[buffer] > 1)
+      est.conflictingLoads += loadsPerBuffer[buffer] - 1;
+  }
+  uint64_t storeCycles = ceilDiv(est.storeBits + spillBits,
+                                 model.storePorts * model.storePortBits);
+
+  SmallVector<std::pair<uint64_t, StringRef>> bounds = {
+      {ceilDiv(est.vectorOps, model.vectorSlots), "vector"},
+      {loadCycles, "load"},
+      {storeCycles, "store"},
+      {ceilDiv(est.moveOps, model.moveSlots), "move"},
+      {ceilDiv(est.scalarOps, model.scalarSlots), "scalar"}};
+  for (auto [cycles, name] : bounds) {
+    if (cycles > est.cycles) {
+      est.cycles = cycles;
+      est.bound = name;
+    }
+  }
+  // An empty body still takes one instruction per iteration.
+  if (!est.cycles) {
+    est.cycles = 1;
+    est.bound = "issue";
+  }
+
+  // The peak is taken from the precision that performs most of the MACs.
+  uint64_t dominant = 0;
+  for (auto [precision, n] : macsPerPrecision) {
+    if (n <= dominant)
+      continue;
+    dominant = n;
+    est.peakMacs =
+        CoreModel::peakMacsPerCycle(arch, precision.first, precision.second);
+  }
+
+  if (auto lb = loop.getSingleLowerBound())
+    if (auto ub = loop.getSingleUpperBound())
+      if (auto step = loop.getSingleStep())
+        est.tripCount = constantTripCount(*lb, *ub, *step);
+
+  return est;
+}
+
+static std::string describeScope(Operation *loop) {
+  for (Operation *p = loop->getParentOp(); p; p = p->getParentOp()) {
+    if (p->getName().getStringRef() == "aie.core")
+      return "aie.core";
+    if (auto sym = p->getAttrOfType<StringAttr>(
+            SymbolTable::getSymbolAttrName()))
+      return ("@" + sym.getValue()).str();
+  }
+  return "<top>";
+}
+
+static void printEstimate(raw_ostream &os, Operation *loop, unsigned index,
+                          const LoopEstimate &est, const CoreModel &model) {
+  os << "loop " << index << " in " << describeScope(loop);
+  if (auto loc = dyn_cast<FileLineColLoc>(loop->getLoc()))
+    os << " (line " << loc.getLine() << ")";
+  os << ":\n";
+  os << "  ops/iter: vector=" << est.vectorOps << " load=" << est.loadOps
+     << " store=" << est.storeOps << " move=" << est.moveOps
+     << " scalar=" << est.scalarOps << "\n";
+  os << "  cycles/iter: " << est.cycles << " (" << est.bound << " bound)\n";
+  if (est.tripCount)
+    os << "  trip count: " << *est.tripCount
+       << ", total cycles: " << *est.tripCount * est.cycles << "\n";
+  os << "  registers: vector=" << est.maxVectorRegs << "/"
+     << model.numVectorRegs << " acc=" << est.maxAccRegs << "/"
+     << model.numAccRegs << " spills=" << est.spilledRegs << "\n";
+  os << "  bank conflicts: " << est.conflictingLoads << "\n";
+  os << "  MACs/iter: " << est.macs;
+  if (est.peakMacs) {
+    double util = 100.0 * est.macs / (est.cycles * est.peakMacs);
+    os << ", peak " << est.peakMacs << "/cycle, utilisation "
+       << llvm::format("%.1f", util) << "%";
+  }
+  os << "\n";
+}
+
+struct AIEVecCycleEstimate
+    : public AIEVecCycleEstimateBase<AIEVecCycleEstimate> {
+  void runOnOperation() override {
+    if (!annotate)
+      markAllAnalysesPreserved();
+    AIEArch arch = AIEArch::AIE2;
+    if (aieTarget == "aie2p") {
+      arch = AIEArch::AIE2P;
+    } else if (aieTarget != "aie2" && aieTarget != "aieml") {
+      getOperation()->emitError() << "unknown AIE target '" << aieTarget << "'";
+      return signalPassFailure();
+    }
+    CoreModel model = CoreModel::get(arch);
+
+    unsigned index = 0;
+    getOperation()->walk([&](LoopLikeOpInterface loop) {
+      // Only innermost loops are estimated.
+      bool innermost = true;
+      loop->walk([&](LoopLikeOpInterface nested) {
+        if (nested != loop)
+          innermost = false;
+      });
+      if (!innermost || loop->getNumRegions() == 0 ||
+          loop->getRegion(0).empty())
+        return;
+
+      LoopEstimate est = estimateLoop(loop, arch);
+      LLVM_DEBUG(llvm::dbgs() << "estimated " << est.cycles
+                              << " cycles/iter for " << *loop << "\n");
+      if (printResult)
+        printEstimate(llvm::outs(), loop, index, est, model);
+      if (annotate) {
+        Builder b(loop->getContext());
+        loop->setAttr("aievec.cycles_per_iter",
+                      b.getI64IntegerAttr(est.cycles));
+        if (est.peakMacs)
+          loop->setAttr("aievec.mac_utilisation",
+                        b.getF64FloatAttr(static_cast<double>(est.macs) /
+                                          (est.cycles * est.peakMacs)));
+      }
+      index++;
+    });
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> xilinx::aievec::createAIEVecCycleEstimatePass() {
+  return std::make_unique<AIEVecCycleEstimate>();
+}
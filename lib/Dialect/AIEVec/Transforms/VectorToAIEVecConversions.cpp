@@ -2888,7 +2888,9 @@ struct ComputeSignedIntRightShiftOpPattern
   }
 };
 
-// Convert a `vector.contract` op to an `aievec.matmul` op for AIE2
+// Convert a `vector.contract` op to an `aievec.matmul` op for AIE2, or to an
+// `aievec.matmul_aie2p` op for AIE2P.
+template <typename MatMulOpTy>
 struct LowerVectorContractionOpToAIEVecMatMulPattern
     : OpConversionPattern<vector::ContractionOp> {
   using OpConversionPattern::OpConversionPattern;
@@ -2928,11 +2930,11 @@ struct LowerVectorContractionOpToAIEVecMatMulPattern
       acc = rewriter.create<aievec::CastOp>(contractOp.getLoc(), acc.getType(),
                                             acc, true);
 
-    auto matmulOp = rewriter.create<aievec::MatMulOp>(
-        contractOp.getLoc(), acc.getType(), lhs, rhs, acc);
+    auto matmulOp = rewriter.create<MatMulOpTy>(contractOp.getLoc(),
+                                                acc.getType(), lhs, rhs, acc);
     {
       // Replace diagnostics handler to silence errors when verifying the
-      // validity of the `aievec.matmul` ops being generated.
+      // validity of the matmul ops being generated.
       ScopedDiagnosticHandler diagHandler(
           contractOp.getContext(), [](Diagnostic &) { return success(); });
       if (failed(matmulOp.verifyInvariants())) {
@@ -2950,8 +2952,8 @@ struct LowerVectorContractionOpToAIEVecMatMulPattern
         if (wideRhsValue)
           rhs = reshapeLeadingUnitDims(rewriter, wideRhsValue);
 
-        matmulOp = rewriter.create<aievec::MatMulOp>(
-            contractOp.getLoc(), acc.getType(), lhs, rhs, acc);
+        matmulOp = rewriter.create<MatMulOpTy>(contractOp.getLoc(),
+                                               acc.getType(), lhs, rhs, acc);
         if (failed(matmulOp.verifyInvariants()))
           return failure();
       }
@@ -2972,10 +2974,16 @@ struct LowerVectorContractionOpToAIEVecMatMulPattern
   bool matMoveToAcc;
 };
 
-// Convert a `vector.transpose` op to an `aievec.shuffle` op for AIE2.
+// Convert a `vector.transpose` op to an `aievec.shuffle` op for AIE2. On AIE2P
+// the additional 32-bit and 64-bit transpose modes are also used.
 struct LowerVectorTransposeOpToAIEVecShuffleOpPattern
     : OpConversionPattern<vector::TransposeOp> {
   using OpConversionPattern::OpConversionPattern;
+
+  LowerVectorTransposeOpToAIEVecShuffleOpPattern(MLIRContext *context,
+                                                 bool aie2p = false)
+      : OpConversionPattern(context), aie2p(aie2p) {}
+
   LogicalResult
   matchAndRewrite(vector::TransposeOp transpOp, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -2987,7 +2995,8 @@ struct LowerVectorTransposeOpToAIEVecShuffleOpPattern
     if (vBitWidth != 512)
       return failure();
 
-    if (elemTyBitWidth != 8 && elemTyBitWidth != 16 && elemTyBitWidth != 32)
+    if (elemTyBitWidth != 8 && elemTyBitWidth != 16 && elemTyBitWidth != 32 &&
+        (!aie2p || elemTyBitWidth != 64))
       return failure();
 
     // Verify leading dimensions are all 1.
@@ -3035,8 +3044,36 @@ struct LowerVectorTransposeOpToAIEVecShuffleOpPattern
       default:
         return failure();
       }
-    } else if (resShape.back() != 4)
-      return failure();
+    } else if (elemTyBitWidth == 32) {
+      switch (resShape.back()) {
+      case 2:
+        if (!aie2p)
+          return failure();
+        shuffleMode = aievec::ShuffleMode::T32_2X8;
+        break;
+      case 4:
+        shuffleMode = aievec::ShuffleMode::T32_4X4;
+        break;
+      case 8:
+        if (!aie2p)
+          return failure();
+        shuffleMode = aievec::ShuffleMode::T32_8X2;
+        break;
+      default:
+        return failure();
+      }
+    } else {
+      switch (resShape.back()) {
+      case 2:
+        shuffleMode = aievec::ShuffleMode::T64_2X4;
+        break;
+      case 4:
+        shuffleMode = aievec::ShuffleMode::T64_4X2;
+        break;
+      default:
+        return failure();
+      }
+    }
 
     auto flatVecTy =
         VectorType::get({512 / elemTyBitWidth}, resTy.getElementType());
@@ -3049,6 +3086,8 @@ struct LowerVectorTransposeOpToAIEVecShuffleOpPattern
 
     return success();
   }
+
+  bool aie2p;
 };
 
 //===----------------------------------------------------------------------===//
@@ -3139,7 +3178,22 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
       LowerVectorExtractStridedSliceOpAIE2Pattern,
       LowerVectorTransposeOpToAIEVecShuffleOpPattern
       >(patterns.getContext());
-  patterns.add<LowerVectorContractionOpToAIEVecMatMulPattern
+  patterns.add<LowerVectorContractionOpToAIEVecMatMulPattern<aievec::MatMulOp>
+      >(patterns.getContext(), backend == TargetBackend::CPP);
+  // clang-format on
+}
+
+// AIE2P has its own matrix multiplication shapes and extra transpose modes.
+// The elementwise aievec ops of AIE2 have no AIE2P lowering in
+// convert-aievec-to-llvm yet, so the elementwise operations are left to the
+// LLVM vector lowering instead.
+static void populateAIEVecV2PConversionPatterns(RewritePatternSet &patterns,
+                                                TargetBackend backend) {
+  // clang-format off
+  patterns.add<LowerVectorTransposeOpToAIEVecShuffleOpPattern
+      >(patterns.getContext(), /*aie2p=*/true);
+  patterns.add<
+      LowerVectorContractionOpToAIEVecMatMulPattern<aievec::MatMulAIE2POp>
       >(patterns.getContext(), backend == TargetBackend::CPP);
   // clang-format on
 }
@@ -3775,6 +3829,14 @@ static void configureAIEVecV2Legalizations(ConversionTarget &target,
                       vector::FMAOp>();
 }
 
+static void configureAIEVecV2PLegalizations(ConversionTarget &target,
+                                            TargetBackend backend) {
+  target.addLegalDialect<xilinx::aievec::AIEVecDialect>();
+  target.addLegalOp<UnrealizedConversionCastOp>();
+  target.addLegalOp<vector::ShapeCastOp>();
+  target.addIllegalOp<vector::ContractionOp, vector::TransposeOp>();
+}
+
 //===----------------------------------------------------------------------===//
 // Lowering passes
 //===----------------------------------------------------------------------===//
@@ -3809,8 +3871,9 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
 
   Option<std::string> aieTarget{
       *this, "aie-target",
-      llvm::cl::desc("Select AIE version: \"aie\" or \"aie2\". This will "
-                     "determine the vector size and available operations."),
+      llvm::cl::desc("Select AIE version: \"aie\", \"aie2\" or \"aie2p\". This "
+                     "will determine the vector size and available "
+                     "operations."),
       llvm::cl::init("aie")};
 
   Option<std::string> targetBackend{
@@ -3830,6 +3893,8 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
       std::string target = aieTarget;
       if (target == "aieml" || target == "aie2")
         aieVersion = AIEArch::AIE2;
+      else if (target == "aie2p")
+        aieVersion = AIEArch::AIE2P;
       else if (target != "aie") {
         op->emitError() << "unknown AIE target '" << aieTarget << "'";
         return signalPassFailure();
@@ -3853,14 +3918,19 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
       }
     }
 
-    populateAIEVecCommonConversionPatterns(patterns, backend);
-    configureAIEVecCommonLegalizations(target, backend);
-    if (aieVersion == AIEArch::AIE) {
-      populateAIEVecV1ConversionPatterns(patterns, backend);
-      configureAIEVecV1Legalizations(target, backend);
+    if (aieVersion == AIEArch::AIE2P) {
+      populateAIEVecV2PConversionPatterns(patterns, backend);
+      configureAIEVecV2PLegalizations(target, backend);
     } else {
-      populateAIEVecV2ConversionPatterns(patterns, backend);
-      configureAIEVecV2Legalizations(target, backend);
+      populateAIEVecCommonConversionPatterns(patterns, backend);
+      configureAIEVecCommonLegalizations(target, backend);
+      if (aieVersion == AIEArch::AIE) {
+        populateAIEVecV1ConversionPatterns(patterns, backend);
+        configureAIEVecV1Legalizations(target, backend);
+      } else {
+        populateAIEVecV2ConversionPatterns(patterns, backend);
+        configureAIEVecV2Legalizations(target, backend);
+      }
     }
 
     if (failed(applyPartialConversion(op, target, std::move(patterns))))
@@ -11,6 +11,8 @@
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/Interfaces/FoldInterfaces.h"
 #include "mlir/Transforms/InliningUtils.h"
 
@@ -249,6 +251,40 @@ AIEX::verifyStridesWraps(mlir::Operation *forOp,
   return success();
 }
 
+ElementsAttr AIEX::getBlockWriteData(RankedTensorType type,
+                                     ArrayRef<uint32_t> words) {
+  if (words.size() < blockWriteResourceWords)
+    return DenseElementsAttr::get<uint32_t>(type, words);
+  return DenseResourceElementsAttr::get(
+      type, "blockwrite_data",
+      HeapAsmResourceBlob::allocateAndCopyInferAlign(words));
+}
+
+std::optional<ArrayRef<uint32_t>>
+AIEX::getBlockWriteWords(Attribute data, SmallVectorImpl<uint32_t> &storage) {
+  auto elements = dyn_cast<ElementsAttr>(data);
+  if (!elements || !elements.getElementType().isInteger(32))
+    return std::nullopt;
+  size_t size = elements.getNumElements();
+
+  if (auto resource = dyn_cast<DenseResourceElementsAttr>(data)) {
+    AsmResourceBlob *blob = resource.getRawHandle().getBlob();
+    if (!blob || blob->getData().size() != size * sizeof(uint32_t))
+      return std::nullopt;
+    return blob->getDataAs<uint32_t>();
+  }
+
+  auto dense = dyn_cast<DenseIntElementsAttr>(data);
+  if (!dense)
+    return std::nullopt;
+  if (dense.isSplat()) {
+    storage.assign(size, dense.getSplatValue<APInt>().getZExtValue());
+    return ArrayRef<uint32_t>(storage);
+  }
+  return ArrayRef<uint32_t>(
+      reinterpret_cast<const uint32_t *>(dense.getRawData().data()), size);
+}
+
 //===----------------------------------------------------------------------===//
 // UseTokenOp
 //===----------------------------------------------------------------------===//
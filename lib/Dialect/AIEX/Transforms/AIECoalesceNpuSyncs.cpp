@@ -0,0 +1,347 @@
+//===- AIECoalesceNpuSyncs.cpp ----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+#include <deque>
+#include <map>
+#include <tuple>
+
+#define DEBUG_TYPE "aie-coalesce-npu-syncs"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+namespace {
+
+// Shim DMA register offsets, see PushQueuetoWrite32Pattern and
+// WriteBdToBlockWritePattern in AIEDmaToNpu.cpp.
+constexpr uint32_t kShimBdBase = 0x1D000;
+constexpr uint32_t kShimBdStride = 0x20;
+constexpr uint32_t kShimDmaCtrlBase = 0x1D200;
+constexpr uint32_t kShimDmaCtrlEnd = 0x1D220;
+constexpr uint32_t kTaskCompleteTokenBit = 0x80000000;
+// Number of tasks that can be outstanding in a shim DMA channel task queue.
+constexpr unsigned kShimTaskQueueDepth = 4;
+// The buffer of a task whose buffer descriptor was not patched with a runtime
+// sequence argument.
+constexpr int kUnknownArg = -1;
+
+// A task queue is identified by <col, row, direction, channel>. Direction uses
+// the npu.sync encoding (0 is S2MM, 1 is MM2S).
+using QueueID = std::tuple<int, int, int, int>;
+
+// A register write in the runtime sequence, decoded into the tile it targets
+// and the offset inside that tile's address space.
+struct DecodedAddress {
+  int col;
+  int row;
+  uint32_t offset;
+};
+
+DecodedAddress decodeAddress(const AIE::AIETargetModel &tm, uint32_t address,
+                             std::optional<int32_t> col,
+                             std::optional<int32_t> row) {
+  if (col && row)
+    return {*col, *row, address & 0xFFFFF};
+  int c = (address >> tm.getColumnShift()) & 0x7f;
+  int r = (address >> tm.getRowShift()) & 0x1f;
+  return {c, r, address & 0xFFFFF};
+}
+
+std::optional<QueueID> getPushedQueue(const DecodedAddress &a) {
+  // Task queue registers: S2MM_0 0x1D204, S2MM_1 0x1D20C, MM2S_0 0x1D214,
+  // MM2S_1 0x1D21C.
+  switch (a.offset) {
+  case 0x1D204:
+    return QueueID{a.col, a.row, 0, 0};
+  case 0x1D20C:
+    return QueueID{a.col, a.row, 0, 1};
+  case 0x1D214:
+    return QueueID{a.col, a.row, 1, 0};
+  case 0x1D21C:
+    return QueueID{a.col, a.row, 1, 1};
+  default:
+    return std::nullopt;
+  }
+}
+
+std::optional<int> getShimBdId(const AIE::AIETargetModel &tm,
+                               const DecodedAddress &a) {
+  if (!tm.isShimNOCTile(a.col, a.row))
+    return std::nullopt;
+  if (a.offset < kShimBdBase ||
+      a.offset >= kShimBdBase + tm.getNumBDs(a.col, a.row) * kShimBdStride)
+    return std::nullopt;
+  return (a.offset - kShimBdBase) / kShimBdStride;
+}
+
+// Removes npu.sync ops whose completion is implied by a later npu.sync on the
+// same task queue. Tasks in one queue complete in order, so waiting for the
+// last one also waits for all earlier ones. The token of the task the removed
+// sync was waiting for is suppressed, so the later sync still matches the
+// token of its own task.
+//
+// A sync is only removed if every operation between it and the later sync is
+// known not to depend on the earlier tasks having completed: pushes to the
+// same task queue, pushes to other task queues of tasks whose buffer is
+// another runtime sequence argument, shim buffer descriptor writes that do not
+// touch descriptors still in flight, and syncs on other queues. Tasks on
+// other queues run in any order with the earlier tasks, so one that reads or
+// writes the same argument, at any offset, keeps the sync.
+struct RedundantSyncEliminator {
+  const AIE::AIETargetModel &tm;
+
+  struct Candidate {
+    NpuSyncOp sync;
+    // The queue push whose token `sync` consumes.
+    NpuWrite32Op push;
+    // Buffer descriptors used by tasks that are not known complete once
+    // `sync` is removed.
+    llvm::SmallSet<int, 8> bdsInFlight;
+    // Runtime sequence arguments of those tasks.
+    llvm::SmallSet<int, 4> argsInFlight;
+    // Number of tasks that may be pending in the queue.
+    unsigned tasksInFlight = 0;
+  };
+
+  std::map<QueueID, std::deque<NpuWrite32Op>> pendingTokens;
+  std::map<QueueID, llvm::SmallSet<int, 8>> bdsSinceSync;
+  std::map<QueueID, llvm::SmallSet<int, 4>> argsSinceSync;
+  // The runtime sequence argument each shim buffer descriptor was patched
+  // with, keyed by <col, row, bd>.
+  std::map<std::tuple<int, int, int>, int> bdArgs;
+  std::map<QueueID, unsigned> tasksSinceSync;
+  std::map<QueueID, Candidate> candidates;
+  SmallVector<NpuSyncOp> toErase;
+
+  RedundantSyncEliminator(const AIE::AIETargetModel &tm) : tm(tm) {}
+
+  void dropAll() { candidates.clear(); }
+
+  // A task pushed to `queue` uses runtime sequence argument `arg`. Candidates
+  // of other queues whose tasks may use the same buffer are dropped.
+  void touchArg(const QueueID &queue, int arg) {
+    for (auto it = candidates.begin(); it != candidates.end();) {
+      const auto &args = it->second.argsInFlight;
+      if (it->first != queue &&
+          (arg == kUnknownArg || args.contains(arg) ||
+           args.contains(kUnknownArg)))
+        it = candidates.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  // A buffer descriptor of tile (col, row) is rewritten or reused.
+  void touchBd(int col, int row, int bd) {
+    for (auto it = candidates.begin(); it != candidates.end();) {
+      if (std::get<0>(it->first) == col && std::get<1>(it->first) == row &&
+          it->second.bdsInFlight.contains(bd))
+        it = candidates.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  // Any write that is not a queue push or a shim BD/DMA control register write
+  // may depend on earlier tasks having completed.
+  void visitWrite(const DecodedAddress &a) {
+    if (auto bd = getShimBdId(tm, a)) {
+      bdArgs.erase({a.col, a.row, *bd});
+      return touchBd(a.col, a.row, *bd);
+    }
+    if (tm.isShimNOCTile(a.col, a.row) && a.offset >= kShimDmaCtrlBase &&
+        a.offset < kShimDmaCtrlEnd)
+      return;
+    dropAll();
+  }
+
+  void visitWrite32(NpuWrite32Op op) {
+    if (op.getBuffer())
+      return dropAll();
+    DecodedAddress a =
+        decodeAddress(tm, op.getAddress(), op.getColumn(), op.getRow());
+    auto queue = getPushedQueue(a);
+    if (!queue || !tm.isShimNOCTile(a.col, a.row))
+      return visitWrite(a);
+
+    int bd = op.getValue() & 0xF;
+    auto argIt = bdArgs.find({a.col, a.row, bd});
+    int arg = argIt == bdArgs.end() ? kUnknownArg : argIt->second;
+    touchBd(a.col, a.row, bd);
+    touchArg(*queue, arg);
+    bdsSinceSync[*queue].insert(bd);
+    argsSinceSync[*queue].insert(arg);
+    tasksSinceSync[*queue]++;
+    if (op.getValue() & kTaskCompleteTokenBit)
+      pendingTokens[*queue].push_back(op);
+
+    auto it = candidates.find(*queue);
+    if (it == candidates.end())
+      return;
+    it->second.bdsInFlight.insert(bd);
+    it->second.argsInFlight.insert(arg);
+    if (++it->second.tasksInFlight > kShimTaskQueueDepth)
+      candidates.erase(it);
+  }
+
+  void visitSync(NpuSyncOp op) {
+    if (op.getColumnNum() != 1 || op.getRowNum() != 1) {
+      // Syncs that were already grouped are left alone.
+      dropAll();
+      return;
+    }
+    QueueID queue{op.getColumn(), op.getRow(), op.getDirection(),
+                  op.getChannel()};
+    auto &tokens = pendingTokens[queue];
+    if (tokens.empty()) {
+      // The token comes from a task this analysis cannot see.
+      candidates.erase(queue);
+      bdsSinceSync[queue].clear();
+      argsSinceSync[queue].clear();
+      tasksSinceSync[queue] = 0;
+      return;
+    }
+    NpuWrite32Op push = tokens.front();
+    tokens.pop_front();
+
+    Candidate next;
+    next.sync = op;
+    next.push = push;
+    auto prev = candidates.find(queue);
+    if (prev != candidates.end()) {
+      // The previous sync on this queue is implied by this one.
+      Candidate &c = prev->second;
+      c.push.setValue(c.push.getValue() & ~kTaskCompleteTokenBit);
+      toErase.push_back(c.sync);
+      next.bdsInFlight = c.bdsInFlight;
+      next.argsInFlight = c.argsInFlight;
+      next.tasksInFlight = c.tasksInFlight;
+    } else {
+      for (int bd : bdsSinceSync[queue])
+        next.bdsInFlight.insert(bd);
+      for (int arg : argsSinceSync[queue])
+        next.argsInFlight.insert(arg);
+      next.tasksInFlight = tasksSinceSync[queue];
+    }
+    bdsSinceSync[queue].clear();
+    argsSinceSync[queue].clear();
+    tasksSinceSync[queue] = 0;
+    candidates[queue] = next;
+  }
+
+  void run(Block &block) {
+    for (Operation &o : block) {
+      llvm::TypeSwitch<Operation *>(&o)
+          .Case<NpuSyncOp>([&](auto op) { visitSync(op); })
+          .Case<NpuWrite32Op>([&](auto op) { visitWrite32(op); })
+          .Case<NpuMaskWrite32Op, NpuBlockWriteOp>([&](auto op) {
+            if (op.getBuffer())
+              return dropAll();
+            visitWrite(decodeAddress(tm, op.getAddress(), op.getColumn(),
+                                     op.getRow()));
+          })
+          .Case<NpuAddressPatchOp>([&](auto op) {
+            DecodedAddress a =
+                decodeAddress(tm, op.getAddr(), std::nullopt, std::nullopt);
+            visitWrite(a);
+            if (auto bd = getShimBdId(tm, a))
+              bdArgs[{a.col, a.row, *bd}] = op.getArgIdx();
+          })
+          .Case<memref::GetGlobalOp>([](auto) {})
+          .Default([&](auto) { dropAll(); });
+    }
+    for (NpuSyncOp op : toErase)
+      op.erase();
+  }
+};
+
+// Merges runs of adjacent npu.sync ops that wait on the same row, direction
+// and channel of neighbouring columns into a single npu.sync spanning those
+// columns with `column_num`.
+void coalesceAdjacentSyncs(Block &block) {
+  SmallVector<SmallVector<NpuSyncOp>> runs;
+  SmallVector<NpuSyncOp> current;
+  for (Operation &o : block) {
+    if (auto sync = dyn_cast<NpuSyncOp>(o)) {
+      current.push_back(sync);
+      continue;
+    }
+    if (current.size() > 1)
+      runs.push_back(current);
+    current.clear();
+  }
+  if (current.size() > 1)
+    runs.push_back(current);
+
+  for (auto &run : runs) {
+    // <row, row_num, direction, channel> -> syncs ordered by column
+    std::map<std::tuple<int, int, int, int>, std::map<int, NpuSyncOp>> groups;
+    for (NpuSyncOp sync : run) {
+      auto key = std::make_tuple(sync.getRow(), sync.getRowNum(),
+                                 sync.getDirection(), sync.getChannel());
+      // A second wait on the same columns expects a second token and cannot
+      // be merged.
+      if (sync.getColumnNum() != 1 || groups[key].count(sync.getColumn()))
+        continue;
+      groups[key][sync.getColumn()] = sync;
+    }
+
+    for (auto &[key, byCol] : groups) {
+      NpuSyncOp head = nullptr;
+      int nextCol = -1;
+      for (auto &[col, sync] : byCol) {
+        if (head && col == nextCol) {
+          head.setColumnNum(head.getColumnNum() + 1);
+          nextCol++;
+          sync.erase();
+          continue;
+        }
+        head = sync;
+        nextCol = col + 1;
+      }
+    }
+  }
+}
+
+struct AIECoalesceNpuSyncsPass
+    : AIECoalesceNpuSyncsBase<AIECoalesceNpuSyncsPass> {
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    const AIE::AIETargetModel &tm = device.getTargetModel();
+
+    for (auto seq : device.getOps<RuntimeSequenceOp>()) {
+      Block &entry = seq.getBody().front();
+      if (clEliminateRedundant) {
+        RedundantSyncEliminator eliminator(tm);
+        eliminator.run(entry);
+      }
+      coalesceAdjacentSyncs(entry);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIECoalesceNpuSyncsPass() {
+  return std::make_unique<AIECoalesceNpuSyncsPass>();
+}
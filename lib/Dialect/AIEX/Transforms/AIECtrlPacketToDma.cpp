@@ -25,6 +25,10 @@ using namespace xilinx;
 using namespace xilinx::AIE;
 using namespace xilinx::AIEX;
 
+// Writes to the core control register start a core, so they must not be sent
+// together with the writes that precede them.
+static constexpr uint32_t coreControlOffset = 0x32000;
+
 struct AIECtrlPacketInferTilesPass
     : AIECtrlPacketInferTilesBase<AIECtrlPacketInferTilesPass> {
   void runOnOperation() override {
@@ -83,7 +87,24 @@ struct AIECtrlPacketToDmaPass : AIECtrlPacketToDmaBase<AIECtrlPacketToDmaPass> {
       auto newBlockArg = newSeq.getBody().addArgument(ctrlPktMemrefType, loc);
       builder.setInsertionPointToStart(&newSeq.getBody().front());
 
+      // A control packet is sent by the shim channel of the control overlay
+      // that serves its tile.
+      struct Transfer {
+        int col;
+        int shimChan;
+        int64_t ddrOffset;
+        int64_t size;
+        AIE::PacketInfoAttr controllerIdPkt;
+        bool coreControl;
+      };
+      SmallVector<Transfer> transfers;
       int ddrOffset = 0;
+      auto rowToShimChanMap =
+          getRowToShimChanMap(targetModel, WireBundle::DMA);
+      uint32_t tileOffsetMask =
+          (1u << std::min(targetModel.getRowShift(),
+                          targetModel.getColumnShift())) -
+          1;
       Block &entry = f.getBody().front();
       for (auto &o : entry) {
         llvm::TypeSwitch<Operation *>(&o).Case<NpuControlPacketOp>(
@@ -108,40 +129,78 @@ struct AIECtrlPacketToDmaPass : AIECtrlPacketToDmaBase<AIECtrlPacketToDmaPass> {
                 ctrlPktSize = *length;
               ctrlPktSize++; // Ctrl info word
 
-              const std::vector<int64_t> staticOffsets = {0, 0, 0, ddrOffset};
+              bool coreControl =
+                  (op.getAddress() & tileOffsetMask) == coreControlOffset;
+              transfers.push_back({col,
+                                   rowToShimChanMap[destTileOp.rowIndex()],
+                                   ddrOffset, ctrlPktSize, controllerIdPkt,
+                                   coreControl});
               ddrOffset += ctrlPktSize;
-              const std::vector<int64_t> staticSizes = {1, 1, 1,
-                                                        (int64_t)ctrlPktSize};
-              const std::vector<int64_t> staticStrides = {0, 0, 0, 1};
-
-              // Shim dma alloc symbol name
-              std::string shimDmaAllocName = "ctrlpkt";
-              shimDmaAllocName += "_col" + std::to_string(col);
-              shimDmaAllocName += "_mm2s";
-              auto rowToShimChanMap =
-                  getRowToShimChanMap(targetModel, WireBundle::DMA);
-              int shimChan = rowToShimChanMap[destTileOp.rowIndex()];
-              shimDmaAllocName += "_chan" + std::to_string(shimChan);
-
-              StringRef metadata = builder.getStringAttr(shimDmaAllocName);
-              builder.create<NpuDmaMemcpyNdOp>(
-                  builder.getUnknownLoc(), 0, 0, newBlockArg,
-                  SmallVector<Value>{}, SmallVector<Value>{},
-                  SmallVector<Value>{}, ArrayRef(staticOffsets),
-                  ArrayRef(staticSizes), ArrayRef(staticStrides),
-                  controllerIdPkt, metadata, 0, true, 0, 0, 0, 0, 0, 0);
-
-              auto shimRow = builder.getI32IntegerAttr(0);
-              auto shimCol = builder.getI32IntegerAttr(col);
-              auto dir = builder.getI32IntegerAttr(1); // MM2S
-              auto chan = builder.getI32IntegerAttr(shimChan);
-              auto col_num = builder.getI32IntegerAttr(1);
-              auto row_num = builder.getI32IntegerAttr(1);
-              builder.create<AIEX::NpuSyncOp>(loc, shimCol, shimRow, dir, chan,
-                                              col_num, row_num);
             });
       }
 
+      auto createMemcpy = [&](const Transfer &transfer, int bdId) {
+        const std::vector<int64_t> staticOffsets = {0, 0, 0,
+                                                    transfer.ddrOffset};
+        const std::vector<int64_t> staticSizes = {1, 1, 1, transfer.size};
+        const std::vector<int64_t> staticStrides = {0, 0, 0, 1};
+
+        // Shim dma alloc symbol name
+        std::string shimDmaAllocName = "ctrlpkt";
+        shimDmaAllocName += "_col" + std::to_string(transfer.col);
+        shimDmaAllocName += "_mm2s";
+        shimDmaAllocName += "_chan" + std::to_string(transfer.shimChan);
+
+        StringRef metadata = builder.getStringAttr(shimDmaAllocName);
+        builder.create<NpuDmaMemcpyNdOp>(
+            builder.getUnknownLoc(), 0, 0, newBlockArg, SmallVector<Value>{},
+            SmallVector<Value>{}, SmallVector<Value>{}, ArrayRef(staticOffsets),
+            ArrayRef(staticSizes), ArrayRef(staticStrides),
+            transfer.controllerIdPkt, metadata, bdId, true, 0, 0, 0, 0, 0, 0);
+      };
+      auto createSync = [&](const Transfer &transfer) {
+        auto shimRow = builder.getI32IntegerAttr(0);
+        auto shimCol = builder.getI32IntegerAttr(transfer.col);
+        auto dir = builder.getI32IntegerAttr(1); // MM2S
+        auto chan = builder.getI32IntegerAttr(transfer.shimChan);
+        auto col_num = builder.getI32IntegerAttr(1);
+        auto row_num = builder.getI32IntegerAttr(1);
+        builder.create<AIEX::NpuSyncOp>(loc, shimCol, shimRow, dir, chan,
+                                        col_num, row_num);
+      };
+
+      if (!clParallelChannels) {
+        for (const Transfer &transfer : transfers) {
+          createMemcpy(transfer, 0);
+          createSync(transfer);
+        }
+      } else {
+        // Consecutive packets on different shim channels are sent together
+        // and waited for together. The channels of a column share its BDs,
+        // so every channel uses the BD numbered after it. A core control
+        // write is sent on its own, after every earlier packet has arrived,
+        // so that a core never starts before the writes that precede it.
+        SmallVector<Transfer> round;
+        auto flush = [&]() {
+          for (const Transfer &transfer : round)
+            createMemcpy(transfer, transfer.shimChan);
+          for (const Transfer &transfer : round)
+            createSync(transfer);
+          round.clear();
+        };
+        for (const Transfer &transfer : transfers) {
+          if (transfer.coreControl ||
+              llvm::any_of(round, [&](const Transfer &other) {
+                return other.coreControl ||
+                       (other.col == transfer.col &&
+                        other.shimChan == transfer.shimChan);
+              }))
+            flush();
+          round.push_back(transfer);
+        }
+        flush();
+      }
+
       erased.push_back(f);
     }
 
@@ -0,0 +1,294 @@
+//===- AIECompilerDriver.cpp ------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Targets/AIECompilerDriver.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Target/LLVMIR/Dialect/All.h"
+
+#include "mlir/IR/Threading.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Target/LLVMIR/Dialect/All.h"
+#include "mlir/Target/LLVMIR/Export.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FormatVariadic.h"
+
+#define DEBUG_TYPE "aie-compiler-driver"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+// The pipelines of aiecc, see python/compiler/aiecc/main.py.
+
+std::string inputWithAddressesPipeline(const CompilerDriverOptions &options) {
+  return llvm::formatv(
+      "builtin.module(lower-affine,aie-canonicalize-device,aie.device("
+      "aie-assign-lock-ids,aie-register-objectFifos,"
+      "aie-objectFifo-stateful-transform{{dynamic-objFifos={0}},"
+      "aie-assign-bd-ids,aie-lower-cascade-flows,aie-lower-broadcast-packet,"
+      "aie-lower-multicast,aie-assign-tile-controller-ids,"
+      "aie-generate-column-control-overlay{{route-shim-to-tile-ctrl={1}},"
+      "aie-assign-buffer-addresses{{alloc-scheme={2}}),convert-scf-to-cf)",
+      options.dynamicObjFifos, options.ctrlPktOverlay, options.allocScheme);
+}
+
+constexpr const char *lowerToLLVMPipeline =
+    "canonicalize,cse,convert-vector-to-llvm,expand-strided-metadata,"
+    "lower-affine,convert-math-to-llvm,convert-index-to-llvm,arith-expand,"
+    "convert-arith-to-llvm,finalize-memref-to-llvm,"
+    "convert-func-to-llvm{use-bare-ptr-memref-call-conv=1},"
+    "convert-cf-to-llvm,canonicalize,cse";
+
+std::string aieLowerToLLVMPipeline(std::optional<TileID> tile) {
+  std::string standardLowering = "aie-standard-lowering";
+  if (tile)
+    standardLowering +=
+        llvm::formatv("{{tilecol={0} tilerow={1}}", tile->col, tile->row);
+  return llvm::formatv("builtin.module(aie.device(aie-localize-locks,"
+                       "aie-normalize-address-spaces),{0},"
+                       "aiex-standard-lowering,{1})",
+                       standardLowering, lowerToLLVMPipeline);
+}
+
+constexpr const char *createPathfinderFlowsPipeline =
+    "builtin.module(aie.device(aie-create-pathfinder-flows))";
+
+constexpr const char *dmaToNPUPipeline =
+    "builtin.module(aie.device(aie-materialize-bd-chains,"
+    "aie-substitute-shim-dma-allocations,aie-assign-runtime-sequence-bd-ids,"
+    "aie-dma-tasks-to-npu,aie-dma-to-npu,aie-coalesce-npu-syncs))";
+
+FailureOr<OpPassManager> parsePipeline(ModuleOp module,
+                                       llvm::StringRef pipeline) {
+  std::string errors;
+  llvm::raw_string_ostream errorStream(errors);
+  FailureOr<OpPassManager> parsed = parsePassPipeline(pipeline, errorStream);
+  if (failed(parsed)) {
+    module.emitError("failed to parse pass pipeline '")
+        << pipeline << "': " << errors;
+    return failure();
+  }
+  return parsed;
+}
+
+LogicalResult runPipeline(ModuleOp module, const OpPassManager &pipeline) {
+  PassManager pm(module.getContext());
+  static_cast<OpPassManager &>(pm) = pipeline;
+  if (failed(pm.run(module))) {
+    std::string description;
+    llvm::raw_string_ostream os(description);
+    pipeline.printAsTextualPipeline(os);
+    return module.emitError("failed to run pass pipeline '")
+           << description << "'";
+  }
+  return success();
+}
+
+FailureOr<OwningOpRef<ModuleOp>>
+runPipelineOnClone(ModuleOp module, const OpPassManager &pipeline) {
+  OwningOpRef<ModuleOp> clone = module.clone();
+  if (failed(runPipeline(*clone, pipeline)))
+    return failure();
+  return clone;
+}
+
+FailureOr<OwningOpRef<ModuleOp>> runPipelineOnClone(ModuleOp module,
+                                                    llvm::StringRef pipeline) {
+  FailureOr<OpPassManager> parsed = parsePipeline(module, pipeline);
+  if (failed(parsed))
+    return failure();
+  return runPipelineOnClone(module, *parsed);
+}
+
+FailureOr<std::string> translateToLLVMIR(ModuleOp module) {
+  llvm::LLVMContext llvmContext;
+  std::unique_ptr<llvm::Module> llvmModule =
+      translateModuleToLLVMIR(module, llvmContext);
+  if (!llvmModule)
+    return module.emitError("failed to translate to LLVM IR");
+  std::string llvmIR;
+  llvm::raw_string_ostream os(llvmIR);
+  llvmModule->print(os, nullptr);
+  return llvmIR;
+}
+
+DeviceOp getDevice(ModuleOp module) {
+  auto devices = module.getOps<DeviceOp>();
+  if (devices.empty()) {
+    module.emitError("module does not contain an aie.device");
+    return nullptr;
+  }
+  return *devices.begin();
+}
+
+} // namespace
+
+std::vector<std::string> AIECompilation::getDeviceNames(ModuleOp module) {
+  std::vector<std::string> names;
+  for (DeviceOp device : module.getOps<DeviceOp>())
+    names.push_back(device.getArtifactName());
+  return names;
+}
+
+FailureOr<AIECompilation>
+AIECompilation::create(ModuleOp module, const CompilerDriverOptions &options) {
+  MLIRContext *ctx = module.getContext();
+  FailureOr<DeviceOp> selected = DeviceOp::lookup(module, options.deviceName);
+  if (failed(selected))
+    return failure();
+
+  // The LLVM IR translation of the cores needs the translation interfaces of
+  // every dialect that can reach it. Register them up front, since the
+  // registry of the context must not change while the cores are lowered in
+  // parallel.
+  DialectRegistry registry;
+  registerAllToLLVMIRTranslations(registry);
+  xilinx::registerAllAIEToLLVMIRTranslations(registry);
+  ctx->appendDialectRegistry(registry);
+
+  // Like aiecc's split_devices, every device is compiled on a module of its
+  // own, so that the later stages need not select it again.
+  AIECompilation compilation;
+  compilation.deviceName = selected->getArtifactName();
+  OwningOpRef<ModuleOp> input = module.clone();
+  for (auto [device, original] :
+       llvm::zip(llvm::to_vector(input->getOps<DeviceOp>()),
+                 module.getOps<DeviceOp>()))
+    if (original != *selected)
+      device.erase();
+  FailureOr<OpPassManager> pipeline =
+      parsePipeline(module, inputWithAddressesPipeline(options));
+  if (failed(pipeline) || failed(runPipeline(*input, *pipeline)))
+    return failure();
+  compilation.withAddresses = std::move(input);
+
+  auto physical = runPipelineOnClone(*compilation.withAddresses,
+                                     createPathfinderFlowsPipeline);
+  if (failed(physical))
+    return failure();
+  compilation.physical = std::move(*physical);
+
+  std::string targetArch;
+  llvm::raw_string_ostream archStream(targetArch);
+  if (failed(AIETranslateToTargetArch(*compilation.withAddresses, archStream)))
+    return failure();
+  compilation.targetArch = llvm::StringRef(targetArch).trim().str();
+
+  DeviceOp device = getDevice(*compilation.withAddresses);
+  if (!device)
+    return failure();
+  for (CoreOp core : device.getOps<CoreOp>()) {
+    CompiledCore &compiled = compilation.cores.emplace_back();
+    compiled.col = core.colIndex();
+    compiled.row = core.rowIndex();
+    if (std::optional<llvm::StringRef> elfFile = core.getElfFile())
+      compiled.elfFile = elfFile->str();
+  }
+  return compilation;
+}
+
+LogicalResult AIECompilation::emitLinkerScripts() {
+  ModuleOp module = *withAddresses;
+  for (CompiledCore &core : cores) {
+    core.ldScript.clear();
+    core.bcf.clear();
+    llvm::raw_string_ostream ldScript(core.ldScript);
+    llvm::raw_string_ostream bcf(core.bcf);
+    if (failed(AIETranslateToLdScript(module, ldScript, core.col, core.row)) ||
+        failed(AIETranslateToBCF(module, bcf, core.col, core.row)))
+      return failure();
+  }
+  return success();
+}
+
+LogicalResult AIECompilation::lowerCores() {
+  if (failed(emitLinkerScripts()))
+    return failure();
+  ModuleOp module = *withAddresses;
+  MLIRContext *ctx = module.getContext();
+
+  // Running a pass manager loads the dialects its passes depend on, which the
+  // context does not allow on several threads at once. Parse the pipelines
+  // and load those dialects before the parallel section.
+  SmallVector<OpPassManager> pipelines;
+  DialectRegistry dependentDialects;
+  for (CompiledCore &core : cores) {
+    FailureOr<OpPassManager> parsed = parsePipeline(
+        module, aieLowerToLLVMPipeline(TileID{core.col, core.row}));
+    if (failed(parsed))
+      return failure();
+    parsed->getDependentDialects(dependentDialects);
+    pipelines.push_back(std::move(*parsed));
+  }
+  ctx->appendDialectRegistry(dependentDialects);
+  for (llvm::StringRef name : dependentDialects.getDialectNames())
+    ctx->getOrLoadDialect(name);
+
+  // Every core lowers its own clone of the design, so the cores only share
+  // the uniqued attributes and types of the context.
+  return failableParallelForEachN(
+      ctx, 0, cores.size(), [&](size_t index) -> LogicalResult {
+        CompiledCore &core = cores[index];
+        auto lowered = runPipelineOnClone(module, pipelines[index]);
+        if (failed(lowered))
+          return failure();
+        FailureOr<std::string> llvmIR = translateToLLVMIR(**lowered);
+        if (failed(llvmIR))
+          return failure();
+        core.llvmIR = std::move(*llvmIR);
+        return success();
+      });
+}
+
+FailureOr<std::string> AIECompilation::lowerCoresUnified() {
+  if (failed(emitLinkerScripts()))
+    return failure();
+  auto lowered =
+      runPipelineOnClone(*withAddresses, aieLowerToLLVMPipeline(std::nullopt));
+  if (failed(lowered))
+    return failure();
+  return translateToLLVMIR(**lowered);
+}
+
+FailureOr<std::vector<uint32_t>> AIECompilation::generateNPUInstructions() {
+  auto lowered = runPipelineOnClone(*withAddresses, dmaToNPUPipeline);
+  if (failed(lowered))
+    return failure();
+  std::vector<uint32_t> instructions;
+  if (failed(AIETranslateToNPU(**lowered, instructions)))
+    return failure();
+  return instructions;
+}
+
+FailureOr<std::vector<CDOBinary>>
+AIECompilation::generateCDO(llvm::StringRef elfDir) {
+  DeviceOp device = getDevice(*physical);
+  if (!device)
+    return failure();
+  std::vector<CDOBinary> binaries;
+  if (failed(AIETranslateToCDOBuffers(device, elfDir, binaries)))
+    return failure();
+  return binaries;
+}
+
+FailureOr<OwningOpRef<ModuleOp>>
+AIECompilation::generateTransactions(llvm::StringRef elfDir) {
+  return runPipelineOnClone(
+      *physical, llvm::formatv("builtin.module(aie.device(convert-aie-to-"
+                               "transaction{{elf-dir={0}}))",
+                               elfDir)
+                     .str());
+}
@@ -7,9 +7,6 @@
 
 #include "aie/Targets/AIERT.h"
 #include "aie/Targets/AIETargets.h"
-extern "C" {
-#include "cdo-driver/cdo_driver.h"
-}
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/IR/AIEEnums.h"
@@ -18,17 +15,21 @@ extern "C" {
 #include "mlir/IR/Block.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
 
-#include <algorithm>
 #include <cassert>
-#include <filesystem>
 #include <functional>
 #include <string>
 #include <vector>
@@ -40,6 +41,7 @@ extern "C" {
 extern "C" {
 #include "xaiengine/xaie_elfloader.h"
 #include "xaiengine/xaie_interrupt.h"
+#include "xaiengine/xaie_txn.h"
 #include "xaiengine/xaiegbl.h"
 }
 
@@ -49,75 +51,239 @@ using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
 
-static void initializeCDOGenerator(byte_ordering endianness, bool cdoDebug) {
-  // Enables AXI-MM prints for configs being added in CDO
-  if (cdoDebug)
-    EnAXIdebug();
-  setEndianness(endianness);
+namespace {
+
+// CDO header, see bootgen's cdo-driver.
+constexpr uint32_t kCDOHeaderNumWords = 4;
+constexpr uint32_t kCDOHeaderIdent = 0x004f4443; // "CDO"
+constexpr uint32_t kCDOHeaderVersion = 0x00000200;
+constexpr unsigned kCDOHeaderSize = kCDOHeaderNumWords + 1;
+
+// PLM command ids (module 1) of the CDO commands that are emitted.
+constexpr uint32_t kCDOCmdDmaWrite = 0x105;
+constexpr uint32_t kCDOCmdMaskPoll64 = 0x106;
+constexpr uint32_t kCDOCmdMaskWrite64 = 0x107;
+constexpr uint32_t kCDOCmdWrite64 = 0x108;
+constexpr uint32_t kCDOCmdNop = 0x111;
+// Commands with this many payload words or more carry their length in an
+// extra word.
+constexpr uint32_t kCDOLongCommandLength = 255;
+// DMA write payloads must start on a 128-bit boundary.
+constexpr unsigned kCDODmaPayloadAlignWords = 4;
+constexpr uint32_t kCDOMaskPollTimeoutMs = 1;
+
+// Builds one CDO binary in memory. This replaces bootgen's CDO driver, whose
+// stream, endianness and header are process-wide, so that several binaries
+// can be built at the same time. The debug output matches the driver's.
+class CDOStream {
+public:
+  CDOStream(llvm::endianness endianness, bool debug)
+      : endianness(endianness), debug(debug) {}
+
+  void noOp(unsigned numWords) {
+    assert(numWords > 0 && "a NOP is at least one word");
+    if (debug)
+      llvm::outs() << "(NOP Command): Payload Length: " << numWords - 1
+                   << " \n";
+    command(kCDOCmdNop, SmallVector<uint32_t>(numWords - 1, 0));
+  }
+
+  void write(uint64_t addr, uint32_t value) {
+    if (debug)
+      llvm::outs() << llvm::format("(Write64): Address:  0x%016lX Data:  "
+                                   "0x%08X  \n",
+                                   addr, value);
+    command(kCDOCmdWrite64, {hi(addr), lo(addr), value});
+  }
+
+  void maskWrite(uint64_t addr, uint32_t mask, uint32_t value) {
+    if (debug)
+      llvm::outs() << llvm::format("(MaskWrite64): Address: 0x%016lX  Mask: "
+                                   "0x%08X  Data: 0x%08X \n",
+                                   addr, mask, value);
+    command(kCDOCmdMaskWrite64, {hi(addr), lo(addr), mask, value});
+  }
+
+  void maskPoll(uint64_t addr, uint32_t mask, uint32_t value) {
+    if (debug)
+      llvm::outs() << llvm::format("(MaskPoll64): Address: 0x%016lX  Mask: "
+                                   "0x%08X  Expected Value: 0x%08X \n",
+                                   addr, mask, value);
+    command(kCDOCmdMaskPoll64,
+            {hi(addr), lo(addr), mask, value, kCDOMaskPollTimeoutMs});
+  }
+
+  void blockWrite(uint64_t addr, ArrayRef<uint32_t> data) {
+    if (debug) {
+      llvm::outs() << llvm::format("(BlockWrite-DMAWriteCmd): Start Address: "
+                                   "0x%016lX  Size: %u\n",
+                                   addr, static_cast<unsigned>(data.size()));
+      for (auto [i, word] : llvm::enumerate(data))
+        llvm::outs() << llvm::format("    Address: 0x%016lX  Data@ %p is: "
+                                     "0x%08X \n",
+                                     addr + 4 * i, &word, word);
+    }
+    SmallVector<uint32_t> args{hi(addr), lo(addr)};
+    args.append(data.begin(), data.end());
+    unsigned preamble = args.size() >= kCDOLongCommandLength ? 4 : 3;
+    unsigned misalignment =
+        (kCDOHeaderSize + words.size() + preamble) % kCDODmaPayloadAlignWords;
+    if (misalignment)
+      noOp(kCDODmaPayloadAlignWords - misalignment);
+    command(kCDOCmdDmaWrite, args);
+  }
+
+  // Returns the binary: the header, whose length and checksum cover the
+  // commands added so far, followed by the commands.
+  std::vector<uint8_t> finish() const {
+    uint32_t length = words.size();
+    uint32_t checksum = ~(kCDOHeaderNumWords + kCDOHeaderIdent +
+                          kCDOHeaderVersion + length);
+    std::vector<uint8_t> data;
+    data.reserve(4 * (kCDOHeaderSize + words.size()));
+    auto append = [&](uint32_t word) {
+      uint8_t bytes[4];
+      llvm::support::endian::write32(bytes, word, endianness);
+      data.insert(data.end(), bytes, bytes + 4);
+    };
+    for (uint32_t word : {kCDOHeaderNumWords, kCDOHeaderIdent,
+                          kCDOHeaderVersion, length, checksum})
+      append(word);
+    for (uint32_t word : words)
+      append(word);
+    return data;
+  }
+
+private:
+  static uint32_t hi(uint64_t addr) { return addr >> 32; }
+  static uint32_t lo(uint64_t addr) { return addr & 0xFFFFFFFF; }
+
+  void command(uint32_t id, ArrayRef<uint32_t> args) {
+    if (args.size() < kCDOLongCommandLength) {
+      words.push_back(args.size() << 16 | id);
+    } else {
+      words.push_back(kCDOLongCommandLength << 16 | id);
+      words.push_back(args.size());
+    }
+    words.append(args.begin(), args.end());
+  }
+
+  llvm::endianness endianness;
+  bool debug;
+  SmallVector<uint32_t> words;
 };
 
-static LogicalResult
-generateCDOBinary(const StringRef outputPath,
-                  const std::function<LogicalResult()> &cb) {
+// Appends the register operations recorded in `txn` to `stream`.
+LogicalResult appendTransaction(CDOStream &stream, XAie_TxnInst *txn) {
+  for (uint32_t i = 0; i < txn->NumCmds; i++) {
+    const XAie_TxnCmd &cmd = txn->CmdBuf[i];
+    switch (cmd.Opcode) {
+    case XAie_TxnOpcode::XAIE_IO_WRITE:
+      stream.write(cmd.RegOff, cmd.Value);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_MASKWRITE:
+      stream.maskWrite(cmd.RegOff, cmd.Mask, cmd.Value);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_MASKPOLL:
+      stream.maskPoll(cmd.RegOff, cmd.Mask, cmd.Value);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_BLOCKWRITE:
+      stream.blockWrite(
+          cmd.RegOff,
+          ArrayRef(reinterpret_cast<const uint32_t *>(cmd.DataPtr), cmd.Size));
+      break;
+    case XAie_TxnOpcode::XAIE_IO_BLOCKSET:
+      stream.blockWrite(cmd.RegOff, SmallVector<uint32_t>(cmd.Size, cmd.Value));
+      break;
+    default:
+      llvm::errs() << "unsupported transaction opcode "
+                   << AIETXNOPCODETOSTR.at(cmd.Opcode) << " in CDO\n";
+      return failure();
+    }
+  }
+  return success();
+}
 
-  // TODO(newling): Get bootgen team to remove print statement in this function.
-  startCDOFileStream(outputPath.str().c_str());
-  FileHeader();
+struct CDOOptions {
+  llvm::endianness endianness;
+  bool cdoDebug;
+  bool aieSim;
+  bool xaieDebug;
+};
+
+// Generates one CDO binary named `name` from the configuration added by `cb`.
+// The configuration is recorded as an aie-rt transaction of a control object
+// owned by this call and then encoded, so nothing is shared between calls.
+LogicalResult
+generateCDOBinary(const BaseNPUTargetModel &targetModel, StringRef name,
+                  const CDOOptions &options,
+                  const std::function<LogicalResult(AIERTControl &)> &cb,
+                  std::vector<CDOBinary> &binaries) {
+  LLVM_DEBUG(llvm::dbgs() << "Generating " << name << "\n");
+  AIERTControl ctl(targetModel);
+  if (failed(ctl.setIOBackend(options.aieSim, options.xaieDebug)))
+    return failure();
+  ctl.startTransaction();
+  if (failed(cb(ctl)))
+    return failure();
+
+  CDOStream stream(options.endianness, options.cdoDebug);
   // Never generate a completely empty CDO file.  If the file only contains a
-  // header, then bootgen flags it as invalid.
-  insertNoOpCommand(4);
-  if (failed(cb()))
+  // header, then bootgen flags it as invalid. The driver's
+  // insertNoOpCommand(4) counted bytes: it wrote this one-word NOP.
+  stream.noOp(1);
+  XAie_TxnInst *txn = XAie_ExportTransactionInstance(&ctl.devInst);
+  LogicalResult result = appendTransaction(stream, txn);
+  XAie_FreeTransactionInstance(txn);
+  if (failed(result))
     return failure();
-  configureHeader();
-  endCurrentCDOFileStream();
+
+  // The simulator and debug backends see the same register operations as the
+  // CDO.
+  if (options.aieSim || options.xaieDebug)
+    TRY_XAIE_API_LOGICAL_RESULT(XAie_SubmitTransaction, &ctl.devInst, nullptr);
+
+  binaries.push_back({name.str(), stream.finish()});
   return success();
 }
 
-static LogicalResult generateCDOBinariesSeparately(AIERTControl &ctl,
-                                                   const StringRef workDirPath,
-                                                   DeviceOp &targetOp,
-                                                   bool aieSim,
-                                                   bool enableCores) {
-  auto ps = std::filesystem::path::preferred_separator;
-
-  LLVM_DEBUG(llvm::dbgs() << "Generating aie_cdo_elfs.bin");
+LogicalResult generateCDOBinariesSeparately(
+    const BaseNPUTargetModel &targetModel, StringRef workDirPath,
+    DeviceOp targetOp, const CDOOptions &options, bool enableCores,
+    std::vector<CDOBinary> &binaries) {
   if (failed(generateCDOBinary(
-          (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo_elfs.bin")
-              .str(),
-          [&ctl, &targetOp, &workDirPath, &aieSim] {
-            return ctl.addAieElfs(targetOp, workDirPath, aieSim);
-          })))
+          targetModel, "aie_cdo_elfs.bin", options,
+          [&](AIERTControl &ctl) {
+            return ctl.addAieElfs(targetOp, workDirPath, options.aieSim);
+          },
+          binaries)))
     return failure();
 
-  LLVM_DEBUG(llvm::dbgs() << "Generating aie_cdo_init.bin");
   if (failed(generateCDOBinary(
-          (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo_init.bin")
-              .str(),
-          [&ctl, &targetOp] { return ctl.addInitConfig(targetOp); })))
+          targetModel, "aie_cdo_init.bin", options,
+          [&](AIERTControl &ctl) { return ctl.addInitConfig(targetOp); },
+          binaries)))
     return failure();
 
-  LLVM_DEBUG(llvm::dbgs() << "Generating aie_cdo_enable.bin");
   if (enableCores &&
       failed(generateCDOBinary(
-          (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo_enable.bin")
-              .str(),
-          [&ctl, &targetOp] { return ctl.addCoreEnable(targetOp); })))
+          targetModel, "aie_cdo_enable.bin", options,
+          [&](AIERTControl &ctl) { return ctl.addCoreEnable(targetOp); },
+          binaries)))
     return failure();
 
   return success();
 }
 
-static LogicalResult generateCDOUnified(AIERTControl &ctl,
-                                        const StringRef workDirPath,
-                                        DeviceOp &targetOp, bool aieSim,
-                                        bool enableCores) {
-  auto ps = std::filesystem::path::preferred_separator;
-
+LogicalResult generateCDOUnified(const BaseNPUTargetModel &targetModel,
+                                 StringRef workDirPath, DeviceOp targetOp,
+                                 const CDOOptions &options, bool enableCores,
+                                 std::vector<CDOBinary> &binaries) {
   return generateCDOBinary(
-      (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo.bin").str(),
-      [&ctl, &targetOp, &workDirPath, &aieSim, &enableCores] {
+      targetModel, "aie_cdo.bin", options,
+      [&](AIERTControl &ctl) {
         if (!targetOp.getOps<CoreOp>().empty() &&
-            failed(ctl.addAieElfs(targetOp, workDirPath, aieSim)))
+            failed(ctl.addAieElfs(targetOp, workDirPath, options.aieSim)))
           return failure();
         if (failed(ctl.addInitConfig(targetOp)))
           return failure();
@@ -125,47 +291,90 @@ static LogicalResult generateCDOUnified(AIERTControl &ctl,
             failed(ctl.addCoreEnable(targetOp)))
           return failure();
         return success();
-      });
+      },
+      binaries);
 }
 
-static LogicalResult
-translateToCDODirect(ModuleOp m, llvm::StringRef workDirPath,
-                     byte_ordering endianness, bool emitUnified, bool cdoDebug,
-                     bool aieSim, bool xaieDebug, bool enableCores) {
-
-  auto devOps = m.getOps<DeviceOp>();
-  assert(llvm::range_size(devOps) == 1 &&
-         "only exactly 1 device op supported.");
-  DeviceOp targetOp = *devOps.begin();
-  const BaseNPUTargetModel &targetModel =
+LogicalResult translateToCDOBuffers(DeviceOp targetOp, StringRef workDirPath,
+                                    const CDOOptions &options, bool emitUnified,
+                                    bool enableCores,
+                                    std::vector<CDOBinary> &binaries) {
+  const auto &targetModel =
       (const BaseNPUTargetModel &)targetOp.getTargetModel();
 
   // things like XAIE_MEM_TILE_ROW_START and the missing
   // shim dma on tile (0,0) are hard-coded assumptions about NPU...
-  assert(targetModel.hasProperty(AIETargetModel::IsNPU) &&
-         "Only NPU currently supported");
+  if (!targetModel.hasProperty(AIETargetModel::IsNPU))
+    return targetOp.emitOpError("CDO generation only supports NPU devices");
 
-  AIERTControl ctl(targetModel);
-  if (failed(ctl.setIOBackend(aieSim, xaieDebug)))
-    return failure();
-  initializeCDOGenerator(endianness, cdoDebug);
+  if (emitUnified)
+    return generateCDOUnified(targetModel, workDirPath, targetOp, options,
+                              enableCores, binaries);
+  return generateCDOBinariesSeparately(targetModel, workDirPath, targetOp,
+                                       options, enableCores, binaries);
+}
 
-  auto result = [&]() {
-    if (emitUnified) {
-      return generateCDOUnified(ctl, workDirPath, targetOp, aieSim,
-                                enableCores);
+} // namespace
+
+LogicalResult xilinx::AIE::AIETranslateToCDOBuffers(
+    DeviceOp device, llvm::StringRef workDirPath,
+    std::vector<CDOBinary> &binaries, bool bigEndian, bool emitUnified,
+    bool cdoDebug, bool aieSim, bool enableCores) {
+  CDOOptions options{bigEndian ? llvm::endianness::big
+                               : llvm::endianness::little,
+                     cdoDebug, aieSim, /*xaieDebug=*/false};
+  return translateToCDOBuffers(device, workDirPath, options, emitUnified,
+                               enableCores, binaries);
+}
+
+LogicalResult xilinx::AIE::writeCDOBinaries(llvm::ArrayRef<CDOBinary> binaries,
+                                            llvm::StringRef dirPath) {
+  for (const CDOBinary &binary : binaries) {
+    SmallString<128> path(dirPath);
+    llvm::sys::path::append(path, binary.name);
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::OF_None);
+    if (ec) {
+      llvm::errs() << "failed to open " << path << ": " << ec.message()
+                   << "\n";
+      return failure();
     }
-    return generateCDOBinariesSeparately(ctl, workDirPath, targetOp, aieSim,
-                                         enableCores);
-  }();
-  return result;
+    os.write(reinterpret_cast<const char *>(binary.data.data()),
+             binary.data.size());
+  }
+  return success();
 }
 
 LogicalResult xilinx::AIE::AIETranslateToCDODirect(
     ModuleOp m, llvm::StringRef workDirPath, bool bigEndian, bool emitUnified,
     bool cdoDebug, bool aieSim, bool xaieDebug, bool enableCores) {
-  byte_ordering endianness =
-      bigEndian ? byte_ordering::Big_Endian : byte_ordering::Little_Endian;
-  return translateToCDODirect(m, workDirPath, endianness, emitUnified, cdoDebug,
-                              aieSim, xaieDebug, enableCores);
+  SmallVector<DeviceOp> devices(m.getOps<DeviceOp>());
+  if (devices.empty())
+    return m.emitOpError("expected at least one aie.device");
+
+  CDOOptions options{bigEndian ? llvm::endianness::big
+                               : llvm::endianness::little,
+                     cdoDebug, aieSim, xaieDebug};
+  if (devices.size() == 1) {
+    std::vector<CDOBinary> binaries;
+    if (failed(translateToCDOBuffers(devices.front(), workDirPath, options,
+                                     emitUnified, enableCores, binaries)))
+      return failure();
+    return writeCDOBinaries(binaries, workDirPath);
+  }
+
+  // Every device gets its own subdirectory, which also holds its core ELFs.
+  // The translations share nothing, so they run on the thread pool.
+  return failableParallelForEach(m.getContext(), devices, [&](DeviceOp device) {
+    SmallString<128> deviceDir(workDirPath);
+    llvm::sys::path::append(deviceDir, device.getArtifactName());
+    if (std::error_code ec = llvm::sys::fs::create_directories(deviceDir))
+      return device.emitOpError("failed to create ")
+             << deviceDir << ": " << ec.message();
+    std::vector<CDOBinary> binaries;
+    if (failed(translateToCDOBuffers(device, deviceDir, options, emitUnified,
+                                     enableCores, binaries)))
+      return failure();
+    return writeCDOBinaries(binaries, deviceDir);
+  });
 }
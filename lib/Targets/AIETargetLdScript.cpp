@@ -63,14 +63,15 @@ static void writeLDScriptMap(raw_ostream &output, BufferOp buf, int offset) {
 
 LogicalResult xilinx::AIE::AIETranslateToLdScript(ModuleOp module,
                                                   raw_ostream &output,
-                                                  int tileCol, int tileRow) {
+                                                  int tileCol, int tileRow,
+                                                  StringRef deviceName) {
   DenseMap<TileID, Operation *> tiles;
   DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
 
-  if (module.getOps<DeviceOp>().empty()) {
-    module.emitOpError("expected AIE.device operation at toplevel");
-  }
-  DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+  FailureOr<DeviceOp> device = DeviceOp::lookup(module, deviceName);
+  if (failed(device))
+    return failure();
+  DeviceOp targetOp = *device;
 
   collectTiles(targetOp, tiles);
   collectBuffers(targetOp, buffers);
@@ -18,8 +18,8 @@
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/TypeSwitch.h"
-#include "llvm/Support/Format.h"
 
+#include <cstring>
 #include <vector>
 
 using namespace mlir;
@@ -67,7 +67,19 @@ void appendSync(std::vector<uint32_t> &instructions, NpuSyncOp op) {
   words[3] |= (op.getChannel() & 0xff) << 24;
 }
 
-void appendWrite32(std::vector<uint32_t> &instructions, NpuWrite32Op op) {
+// The address of a register of tile (`col`, `row`) if both are given, and
+// `address` otherwise.
+uint32_t getTileAddress(const AIETargetModel &tm, uint32_t address,
+                        std::optional<uint32_t> col,
+                        std::optional<uint32_t> row) {
+  if (!col || !row)
+    return address;
+  return ((*col & 0xff) << tm.getColumnShift()) |
+         ((*row & 0xff) << tm.getRowShift()) | (address & 0xFFFFF);
+}
+
+void appendWrite32(std::vector<uint32_t> &instructions,
+                   const AIETargetModel &tm, NpuWrite32Op op) {
 
   auto words = reserveAndGetTail(instructions, 3);
 
@@ -78,19 +90,12 @@ void appendWrite32(std::vector<uint32_t> &instructions, NpuWrite32Op op) {
 
   // XAIE_IO_WRITE
   words[0] = TXN_OPC_WRITE;
-  words[1] = op.getAddress();
-  auto col = op.getColumn();
-  auto row = op.getRow();
-  if (col && row) {
-    const AIETargetModel &tm = op->getParentOfType<DeviceOp>().getTargetModel();
-    words[1] = ((*col & 0xff) << tm.getColumnShift()) |
-               ((*row & 0xff) << tm.getRowShift()) | (words[1] & 0xFFFFF);
-  }
+  words[1] = getTileAddress(tm, op.getAddress(), op.getColumn(), op.getRow());
   words[2] = op.getValue(); // Value
 }
 
 void appendMaskWrite32(std::vector<uint32_t> &instructions,
-                       NpuMaskWrite32Op op) {
+                       const AIETargetModel &tm, NpuMaskWrite32Op op) {
 
   auto words = reserveAndGetTail(instructions, 4);
 
@@ -101,14 +106,7 @@ void appendMaskWrite32(std::vector<uint32_t> &instructions,
 
   // XAIE_IO_MASKWRITE
   words[0] = TXN_OPC_MASKWRITE;
-  words[1] = op.getAddress();
-  auto col = op.getColumn();
-  auto row = op.getRow();
-  if (col && row) {
-    const AIETargetModel &tm = op->getParentOfType<DeviceOp>().getTargetModel();
-    words[1] = ((*col & 0xff) << tm.getColumnShift()) |
-               ((*row & 0xff) << tm.getRowShift()) | (words[1] & 0xFFFFF);
-  }
+  words[1] = getTileAddress(tm, op.getAddress(), op.getColumn(), op.getRow());
   words[2] = op.getValue(); // Value
   words[3] = op.getMask();
 }
@@ -130,7 +128,9 @@ void appendAddressPatch(std::vector<uint32_t> &instructions,
   words[5] = 0;
 }
 
-void appendBlockWrite(std::vector<uint32_t> &instructions, NpuBlockWriteOp op) {
+void appendBlockWrite(std::vector<uint32_t> &instructions,
+                      const AIETargetModel &tm, SymbolTable &symbols,
+                      NpuBlockWriteOp op) {
 
   Value memref = op.getData();
   int64_t width = cast<MemRefType>(memref.getType()).getElementTypeBitWidth();
@@ -145,8 +145,7 @@ void appendBlockWrite(std::vector<uint32_t> &instructions, NpuBlockWriteOp op) {
     return;
   }
 
-  auto global = dyn_cast_if_present<memref::GlobalOp>(
-      op->getParentOfType<AIE::DeviceOp>().lookupSymbol(getGlobal.getName()));
+  auto global = symbols.lookup<memref::GlobalOp>(getGlobal.getName());
   if (!global) {
     op.emitError("Global symbol not found");
     return;
@@ -158,29 +157,48 @@ void appendBlockWrite(std::vector<uint32_t> &instructions, NpuBlockWriteOp op) {
     return;
   }
 
-  auto data = dyn_cast<DenseIntElementsAttr>(*initVal);
+  SmallVector<uint32_t> storage;
+  std::optional<ArrayRef<uint32_t>> data =
+      getBlockWriteWords(*initVal, storage);
   if (!data) {
     op.emitError("Global symbol initial value is not a dense int array");
     return;
   }
 
-  auto words = reserveAndGetTail(instructions, data.size() + 3);
+  auto words = reserveAndGetTail(instructions, data->size() + 3);
 
   // XAIE_IO_BLOCKWRITE
   words[0] = TXN_OPC_BLOCKWRITE;
-  words[1] = op.getAddress();
-  auto col = op.getColumn();
-  auto row = op.getRow();
-  if (col && row) {
-    const AIETargetModel &tm = op->getParentOfType<DeviceOp>().getTargetModel();
-    words[1] = ((*col & 0xff) << tm.getColumnShift()) |
-               ((*row & 0xff) << tm.getRowShift()) | (words[1] & 0xFFFFF);
-  }
+  words[1] = getTileAddress(tm, op.getAddress(), op.getColumn(), op.getRow());
   words[2] = words.size() * sizeof(uint32_t); // Operation Size
 
-  unsigned i = 3;
-  for (auto d : data)
-    words[i++] = d.getZExtValue();
+  std::memcpy(words.data() + 3, data->data(), data->size() * sizeof(uint32_t));
+}
+
+// The number of words `op` translates to, so that the output is sized once
+// rather than grown op by op.
+uint64_t getInstructionSize(Operation *op) {
+  return llvm::TypeSwitch<Operation *, uint64_t>(op)
+      .Case<NpuSyncOp, NpuMaskWrite32Op>([](auto) { return 4; })
+      .Case<NpuWrite32Op>([](auto) { return 3; })
+      .Case<NpuAddressPatchOp>([](auto) { return 6; })
+      .Case<NpuBlockWriteOp>([](NpuBlockWriteOp op) -> uint64_t {
+        auto type = cast<MemRefType>(op.getData().getType());
+        return type.hasStaticShape() ? type.getNumElements() + 3 : 3;
+      })
+      .Default([](Operation *) { return 0; });
+}
+
+// Writes every word as eight hex digits on a line of its own.
+void writeHexWords(raw_ostream &output, ArrayRef<uint32_t> words) {
+  static constexpr char digits[] = "0123456789ABCDEF";
+  char line[9];
+  line[8] = '\n';
+  for (uint32_t word : words) {
+    for (int i = 7; i >= 0; i--, word >>= 4)
+      line[i] = digits[word & 0xf];
+    output.write(line, sizeof(line));
+  }
 }
 
 } // namespace
@@ -188,11 +206,14 @@ void appendBlockWrite(std::vector<uint32_t> &instructions, NpuBlockWriteOp op) {
 LogicalResult
 xilinx::AIE::AIETranslateToNPU(ModuleOp module,
                                std::vector<uint32_t> &instructions,
-                               StringRef sequenceName) {
+                               StringRef sequenceName, StringRef deviceName) {
+  FailureOr<DeviceOp> device = DeviceOp::lookup(module, deviceName);
+  if (failed(device))
+    return failure();
+  DeviceOp deviceOp = *device;
 
   auto words = reserveAndGetTail(instructions, 4);
 
-  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
   const AIETargetModel &tm = deviceOp.getTargetModel();
 
   // setup txn header
@@ -206,12 +227,20 @@ xilinx::AIE::AIETranslateToNPU(ModuleOp module,
   words[0] = (numRows << 24) | (devGen << 16) | (minor << 8) | major;
   words[1] = (numMemTileRows << 8) | numCols;
 
-  auto sequenceOps = deviceOp.getOps<AIEX::RuntimeSequenceOp>();
-  for (auto seq : sequenceOps) {
-    if (sequenceName.size() && sequenceName != seq.getSymName())
-      continue;
-    Block &entry = seq.getBody().front();
-    for (auto &o : entry) {
+  SmallVector<Block *> entries;
+  for (auto seq : deviceOp.getOps<AIEX::RuntimeSequenceOp>())
+    if (sequenceName.empty() || sequenceName == seq.getSymName())
+      entries.push_back(&seq.getBody().front());
+
+  uint64_t size = instructions.size();
+  for (Block *entry : entries)
+    for (auto &o : *entry)
+      size += getInstructionSize(&o);
+  instructions.reserve(size);
+
+  SymbolTable symbols(deviceOp);
+  for (Block *entry : entries) {
+    for (auto &o : *entry) {
       llvm::TypeSwitch<Operation *>(&o)
           .Case<NpuSyncOp>([&](auto op) {
             count++;
@@ -219,15 +248,15 @@ xilinx::AIE::AIETranslateToNPU(ModuleOp module,
           })
           .Case<NpuWrite32Op>([&](auto op) {
             count++;
-            appendWrite32(instructions, op);
+            appendWrite32(instructions, tm, op);
           })
           .Case<NpuBlockWriteOp>([&](auto op) {
             count++;
-            appendBlockWrite(instructions, op);
+            appendBlockWrite(instructions, tm, symbols, op);
           })
           .Case<NpuMaskWrite32Op>([&](auto op) {
             count++;
-            appendMaskWrite32(instructions, op);
+            appendMaskWrite32(instructions, tm, op);
           })
           .Case<NpuAddressPatchOp>([&](auto op) {
             count++;
@@ -244,20 +273,23 @@ xilinx::AIE::AIETranslateToNPU(ModuleOp module,
 
 LogicalResult xilinx::AIE::AIETranslateToNPU(ModuleOp module,
                                              raw_ostream &output,
-                                             StringRef sequenceName) {
+                                             StringRef sequenceName,
+                                             StringRef deviceName) {
   std::vector<uint32_t> instructions;
-  auto r = AIETranslateToNPU(module, instructions, sequenceName);
+  auto r = AIETranslateToNPU(module, instructions, sequenceName, deviceName);
   if (failed(r))
     return r;
-  for (auto w : instructions)
-    output << llvm::format("%08X\n", w);
+  writeHexWords(output, instructions);
   return success();
 }
 
 LogicalResult xilinx::AIE::AIETranslateControlPacketsToUI32Vec(
     ModuleOp module, std::vector<uint32_t> &instructions,
-    StringRef sequenceName) {
-  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
+    StringRef sequenceName, StringRef deviceName) {
+  FailureOr<DeviceOp> device = DeviceOp::lookup(module, deviceName);
+  if (failed(device))
+    return failure();
+  DeviceOp deviceOp = *device;
   auto sequenceOps = deviceOp.getOps<AIEX::RuntimeSequenceOp>();
   for (auto seq : sequenceOps) {
     if (sequenceName.size() && sequenceName != seq.getSymName())
@@ -297,13 +329,13 @@ LogicalResult xilinx::AIE::AIETranslateControlPacketsToUI32Vec(
 }
 
 LogicalResult xilinx::AIE::AIETranslateControlPacketsToUI32Vec(
-    ModuleOp module, raw_ostream &output, StringRef sequenceName) {
+    ModuleOp module, raw_ostream &output, StringRef sequenceName,
+    StringRef deviceName) {
   std::vector<uint32_t> instructions;
-  auto r =
-      AIETranslateControlPacketsToUI32Vec(module, instructions, sequenceName);
+  auto r = AIETranslateControlPacketsToUI32Vec(module, instructions,
+                                               sequenceName, deviceName);
   if (failed(r))
     return r;
-  for (auto w : instructions)
-    output << llvm::format("%08X\n", w);
+  writeHexWords(output, instructions);
   return success();
 }
\ No newline at end of file
@@ -97,11 +97,14 @@ void writeBufferMap(raw_ostream &output, BufferOp buf, int offset) {
          << '\n';
 }
 
-LogicalResult AIETranslateToTargetArch(ModuleOp module, raw_ostream &output) {
+LogicalResult AIETranslateToTargetArch(ModuleOp module, raw_ostream &output,
+                                       StringRef deviceName) {
   AIEArch arch = AIEArch::AIE1;
   if (!module.getOps<DeviceOp>().empty()) {
-    DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
-    arch = targetOp.getTargetModel().getTargetArch();
+    FailureOr<DeviceOp> targetOp = DeviceOp::lookup(module, deviceName);
+    if (failed(targetOp))
+      return failure();
+    arch = targetOp->getTargetModel().getTargetArch();
   }
   if (arch == AIEArch::AIE1)
     output << "AIE\n";
@@ -164,16 +167,21 @@ void registerAIETranslations() {
       llvm::cl::desc(
           "Specify the name of the aiex.runtime_sequence to translate"));
 
+  static llvm::cl::opt<std::string> deviceName(
+      "aie-device-name", llvm::cl::init(""),
+      llvm::cl::desc("Specify the name of the aie.device to translate, for "
+                     "modules with several devices"));
+
   TranslateFromMLIRRegistration registrationMMap(
       "aie-generate-mmap", "Generate AIE memory map",
       [](ModuleOp module, raw_ostream &output) {
         DenseMap<TileID, Operation *> tiles;
         DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
 
-        if (module.getOps<DeviceOp>().empty()) {
-          module.emitOpError("expected AIE.device operation at toplevel");
-        }
-        DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+        FailureOr<DeviceOp> device = DeviceOp::lookup(module, deviceName);
+        if (failed(device))
+          return failure();
+        DeviceOp targetOp = *device;
 
         collectTiles(targetOp, tiles);
         // sort the tiles for deterministic output
@@ -248,28 +256,33 @@ void registerAIETranslations() {
   TranslateFromMLIRRegistration registrationLDScript(
       "aie-generate-ldscript", "Generate AIE loader script",
       [](ModuleOp module, raw_ostream &output) {
-        return AIETranslateToLdScript(module, output, tileCol, tileRow);
+        return AIETranslateToLdScript(module, output, tileCol, tileRow,
+                                      deviceName);
       },
       registerDialects);
 
   TranslateFromMLIRRegistration registrationBCF(
       "aie-generate-bcf", "Generate AIE bcf",
       [](ModuleOp module, raw_ostream &output) {
-        return AIETranslateToBCF(module, output, tileCol, tileRow);
+        return AIETranslateToBCF(module, output, tileCol, tileRow,
+                                 deviceName);
       },
       registerDialects);
 
   TranslateFromMLIRRegistration registrationTargetArch(
       "aie-generate-target-arch", "Get the target architecture",
-      AIETranslateToTargetArch, registerDialects);
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateToTargetArch(module, output, deviceName);
+      },
+      registerDialects);
 
   TranslateFromMLIRRegistration registrationCoreList(
       "aie-generate-corelist", "Generate python list of cores",
       [](ModuleOp module, raw_ostream &output) {
-        if (module.getOps<DeviceOp>().empty()) {
-          module.emitOpError("expected AIE.device operation at toplevel");
-        }
-        DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+        FailureOr<DeviceOp> device = DeviceOp::lookup(module, deviceName);
+        if (failed(device))
+          return failure();
+        DeviceOp targetOp = *device;
 
         output << "[";
         for (auto tileOp : targetOp.getOps<TileOp>()) {
@@ -348,14 +361,15 @@ void registerAIETranslations() {
       [](ModuleOp module, raw_ostream &output) {
         if (outputBinary == true) {
           std::vector<uint32_t> instructions;
-          auto r = AIETranslateToNPU(module, instructions, sequenceName);
+          auto r = AIETranslateToNPU(module, instructions, sequenceName,
+                                     deviceName);
           if (failed(r))
             return r;
           output.write(reinterpret_cast<const char *>(instructions.data()),
                        instructions.size() * sizeof(uint32_t));
           return success();
         }
-        return AIETranslateToNPU(module, output, sequenceName);
+        return AIETranslateToNPU(module, output, sequenceName, deviceName);
       },
       registerDialects);
   TranslateFromMLIRRegistration registrationCtrlPkt(
@@ -363,8 +377,8 @@ void registerAIETranslations() {
       [](ModuleOp module, raw_ostream &output) {
         if (outputBinary == true) {
           std::vector<uint32_t> instructions;
-          auto r = AIETranslateControlPacketsToUI32Vec(module, instructions,
-                                                       sequenceName);
+          auto r = AIETranslateControlPacketsToUI32Vec(
+              module, instructions, sequenceName, deviceName);
           if (failed(r))
             return r;
           output.write(reinterpret_cast<const char *>(instructions.data()),
@@ -372,7 +386,7 @@ void registerAIETranslations() {
           return success();
         }
         return AIETranslateControlPacketsToUI32Vec(module, output,
-                                                   sequenceName);
+                                                   sequenceName, deviceName);
       },
       registerDialects);
 }
@@ -0,0 +1,487 @@
+//===- AIETraceDecoder.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Targets/AIETraceDecoder.h"
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/Endian.h"
+
+#include <algorithm>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Trace event selection registers of each trace unit; the first register
+// selects the events of slots 0-3, the second those of slots 4-7.
+static constexpr uint32_t kCoreTraceEvent0 = 0x340E0;
+static constexpr uint32_t kCoreTraceEvent1 = 0x340E4;
+static constexpr uint32_t kMemTraceEvent0 = 0x140E0;
+static constexpr uint32_t kMemTraceEvent1 = 0x140E4;
+static constexpr uint32_t kMemTileTraceEvent0 = 0x940E0;
+static constexpr uint32_t kMemTileTraceEvent1 = 0x940E4;
+
+// Trace buffers are padded with this word.
+static constexpr uint32_t kTracePadding = 0xa5a5a5a5;
+static constexpr unsigned kTracePacketWords = 8;
+// Number of words decodeTrace hands to the decoder at once.
+static constexpr unsigned kTraceChunkWords = 1024;
+
+StringRef xilinx::AIE::getTraceEventName(TracePacketType type, uint8_t code) {
+  switch (type) {
+  case TracePacketType::Core:
+    switch (code) {
+#define AIE_CORE_EVENT(NAME, CODE)                                             \
+  case CODE:                                                                   \
+    return #NAME;
+#include "AIETraceEvents.inc"
+    }
+    break;
+  case TracePacketType::Mem:
+    switch (code) {
+#define AIE_MEM_EVENT(NAME, CODE)                                              \
+  case CODE:                                                                   \
+    return #NAME;
+#include "AIETraceEvents.inc"
+    }
+    break;
+  case TracePacketType::Shim:
+    switch (code) {
+#define AIE_PL_EVENT(NAME, CODE)                                               \
+  case CODE:                                                                   \
+    return #NAME;
+#include "AIETraceEvents.inc"
+    }
+    break;
+  case TracePacketType::MemTile:
+    switch (code) {
+#define AIE_MEM_TILE_EVENT(NAME, CODE)                                         \
+  case CODE:                                                                   \
+    return #NAME;
+#include "AIETraceEvents.inc"
+    }
+    break;
+  }
+  return "Unknown";
+}
+
+//===----------------------------------------------------------------------===//
+// TraceConfig
+//===----------------------------------------------------------------------===//
+
+void TraceConfig::setEvents(TracePacketType type, int col, int row,
+                            unsigned firstSlot, uint32_t value) {
+  auto key = std::make_tuple(type, col, row);
+  auto it = index.find(key);
+  if (it == index.end()) {
+    unitList.push_back({type, col, row});
+    // parse_trace.py numbers the units by packet type first, then in the
+    // order they are configured.
+    std::stable_sort(unitList.begin(), unitList.end(),
+                     [](const TraceUnit &a, const TraceUnit &b) {
+                       return a.type < b.type;
+                     });
+    index.clear();
+    for (unsigned pid = 0; pid < unitList.size(); pid++) {
+      TraceUnit &unit = unitList[pid];
+      unit.pid = pid;
+      index[std::make_tuple(unit.type, unit.col, unit.row)] = pid;
+    }
+    it = index.find(key);
+  }
+  TraceUnit &unit = unitList[it->second];
+  for (unsigned i = 0; i < 4; i++)
+    unit.events[firstSlot + i] = (value >> (8 * i)) & 0xFF;
+}
+
+const TraceUnit *TraceConfig::lookup(TracePacketType type, int col,
+                                     int row) const {
+  auto it = index.find(std::make_tuple(type, col, row));
+  if (it == index.end())
+    return nullptr;
+  return &unitList[it->second];
+}
+
+TraceConfig TraceConfig::fromModule(ModuleOp module, int colShift) {
+  TraceConfig config;
+  module.walk([&](AIEX::NpuWrite32Op op) {
+    if (op.getBuffer())
+      return;
+    auto device = op->getParentOfType<DeviceOp>();
+    if (!device)
+      return;
+    const AIETargetModel &tm = device.getTargetModel();
+
+    uint32_t address = op.getAddress();
+    int col, row;
+    uint32_t offset;
+    if (op.getColumn() && op.getRow()) {
+      col = *op.getColumn();
+      row = *op.getRow();
+      offset = address;
+    } else {
+      col = (address >> tm.getColumnShift()) & 0x7f;
+      row = (address >> tm.getRowShift()) & 0x1f;
+      offset = address & 0xFFFFF;
+    }
+
+    TracePacketType type;
+    unsigned firstSlot;
+    switch (offset) {
+    case kCoreTraceEvent0:
+    case kCoreTraceEvent1:
+      // Shim tiles have their trace unit at the offset of the core trace unit
+      // of the other tiles.
+      type = tm.isShimNOCorPLTile(col, row) ? TracePacketType::Shim
+                                             : TracePacketType::Core;
+      firstSlot = offset == kCoreTraceEvent0 ? 0 : 4;
+      break;
+    case kMemTraceEvent0:
+    case kMemTraceEvent1:
+      type = TracePacketType::Mem;
+      firstSlot = offset == kMemTraceEvent0 ? 0 : 4;
+      break;
+    case kMemTileTraceEvent0:
+    case kMemTileTraceEvent1:
+      type = TracePacketType::MemTile;
+      firstSlot = offset == kMemTileTraceEvent0 ? 0 : 4;
+      break;
+    default:
+      return;
+    }
+    config.setEvents(type, col + colShift, row, firstSlot, op.getValue());
+  });
+  return config;
+}
+
+//===----------------------------------------------------------------------===//
+// Trace sinks
+//===----------------------------------------------------------------------===//
+
+TraceSink::~TraceSink() = default;
+
+namespace {
+
+StringRef getTraceUnitPrefix(TracePacketType type) {
+  switch (type) {
+  case TracePacketType::Core:
+    return "core_trace";
+  case TracePacketType::Mem:
+    return "mem_trace";
+  case TracePacketType::Shim:
+    return "intfc_trace";
+  case TracePacketType::MemTile:
+    return "memtile_trace";
+  }
+  llvm_unreachable("unknown trace packet type");
+}
+
+// Writes the events in the format of parse_trace.py, so the output of either
+// can be loaded in the same tools.
+class ChromeTraceSink : public TraceSink {
+public:
+  ChromeTraceSink(raw_ostream &os) : os(os) {}
+
+  void unit(const TraceUnit &unit) override {
+    next() << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": "
+           << unit.pid << ", \"args\": {\"name\": \""
+           << getTraceUnitPrefix(unit.type) << " for tile" << unit.row << ","
+           << unit.col << "\"}}";
+    for (unsigned slot = 0; slot < kNumTraceEventSlots; slot++)
+      next() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": "
+             << unit.pid << ", \"tid\": " << slot << ", \"args\": {\"name\": \""
+             << getTraceEventName(unit.type, unit.events[slot]) << "\"}}";
+  }
+
+  void event(const TraceUnit &unit, unsigned slot, uint64_t timestamp,
+             bool begin) override {
+    next() << "{\"name\": \""
+           << getTraceEventName(unit.type, unit.events[slot])
+           << "\", \"ts\": " << timestamp << ", \"ph\": \""
+           << (begin ? "B" : "E") << "\", \"pid\": " << unit.pid
+           << ", \"tid\": " << slot << ", \"args\": {}}";
+  }
+
+  void finish() override {
+    if (first)
+      os << "[";
+    os << "]\n";
+    os.flush();
+  }
+
+private:
+  raw_ostream &next() {
+    os << (first ? "[" : ", ");
+    first = false;
+    return os;
+  }
+
+  raw_ostream &os;
+  bool first = true;
+};
+
+class BinaryTraceSink : public TraceSink {
+public:
+  enum RecordKind : uint8_t { Unit = 1, Begin = 2, End = 3 };
+
+  BinaryTraceSink(raw_ostream &os) : os(os) {
+    os << "AIETRACE";
+    write<uint32_t>(1);
+  }
+
+  void unit(const TraceUnit &unit) override {
+    write<uint8_t>(Unit);
+    write<uint16_t>(unit.pid);
+    write<uint8_t>(static_cast<uint8_t>(unit.type));
+    write<uint8_t>(unit.col);
+    write<uint8_t>(unit.row);
+    for (uint8_t code : unit.events)
+      write<uint8_t>(code);
+  }
+
+  void event(const TraceUnit &unit, unsigned slot, uint64_t timestamp,
+             bool begin) override {
+    write<uint8_t>(begin ? Begin : End);
+    write<uint16_t>(unit.pid);
+    write<uint8_t>(slot);
+    write<uint64_t>(timestamp);
+  }
+
+  void finish() override { os.flush(); }
+
+private:
+  template <typename T>
+  void write(T value) {
+    llvm::support::endian::write<T>(os, value, llvm::endianness::little);
+  }
+
+  raw_ostream &os;
+};
+
+} // namespace
+
+std::unique_ptr<TraceSink> xilinx::AIE::createChromeTraceSink(raw_ostream &os) {
+  return std::make_unique<ChromeTraceSink>(os);
+}
+
+std::unique_ptr<TraceSink> xilinx::AIE::createBinaryTraceSink(raw_ostream &os) {
+  return std::make_unique<BinaryTraceSink>(os);
+}
+
+//===----------------------------------------------------------------------===//
+// TraceDecoder
+//===----------------------------------------------------------------------===//
+
+struct TraceDecoder::UnitState {
+  const TraceUnit *unit;
+  // Cycle count of the last decoded command. Start commands are ignored, so
+  // every unit starts counting at 0.
+  uint64_t timer = 0;
+  // Slots whose event is currently active.
+  uint8_t active = 0;
+  // The bytes of the command being received.
+  std::array<uint8_t, 8> bytes;
+  unsigned numBytes = 0;
+  unsigned length = 0;
+};
+
+// Returns the length in bytes of the trace command starting with `op`, or 0
+// if `op` does not start a command.
+static unsigned getCommandLength(uint8_t op) {
+  if ((op & 0xFB) == 0xF0) // Start
+    return 8;
+  if ((op & 0x80) == 0x00) // Single0
+    return 1;
+  if ((op & 0xE0) == 0x80) // Single1
+    return 2;
+  if ((op & 0xE0) == 0xA0) // Single2
+    return 3;
+  if ((op & 0xF0) == 0xC0) // Multiple0
+    return 2;
+  if ((op & 0xF0) == 0xE0) // Repeat0
+    return 1;
+  switch (op & 0xFC) {
+  case 0xD0: // Multiple1
+    return 3;
+  case 0xD4: // Multiple2
+    return 4;
+  case 0xD8: // Repeat1
+    return 2;
+  case 0xDC: // Unused by the decoder
+    return 4;
+  }
+  if (op == 0xFE || op == 0xFF) // Filler, Event_Sync
+    return 1;
+  return 0;
+}
+
+TraceDecoder::TraceDecoder(const TraceConfig &config, TraceSink &sink)
+    : config(config), sink(sink) {
+  for (const TraceUnit &unit : config.units()) {
+    states.emplace_back().unit = &unit;
+    sink.unit(unit);
+  }
+}
+
+TraceDecoder::~TraceDecoder() = default;
+
+void TraceDecoder::addWords(ArrayRef<uint32_t> words) {
+  for (uint32_t word : words) {
+    if (wordIndex++ % kTracePacketWords == 0) {
+      // Words that do not look like a packet header are kept with the unit
+      // of the previous packet, as parse_trace.py does.
+      bool valid = llvm::popcount(word) % 2 == 1 && ((word >> 5) & 0x7F) == 0 &&
+                   ((word >> 19) & 0x1) == 0 && ((word >> 28) & 0x7) == 0;
+      if (!valid)
+        continue;
+      int col = (word >> 21) & 0x7F;
+      int row = (word >> 16) & 0x1F;
+      auto type = static_cast<TracePacketType>((word >> 12) & 0x3);
+      const TraceUnit *unit = config.lookup(type, col, row);
+      current = unit ? &states[unit->pid] : nullptr;
+      if (!unit)
+        droppedPackets++;
+      continue;
+    }
+    if (!current || word == kTracePadding)
+      continue;
+    for (int shift = 24; shift >= 0; shift -= 8)
+      addByte(*current, (word >> shift) & 0xFF);
+  }
+}
+
+void TraceDecoder::addByte(UnitState &state, uint8_t byte) {
+  if (state.numBytes == 0) {
+    state.length = getCommandLength(byte);
+    if (state.length == 0)
+      return;
+  }
+  state.bytes[state.numBytes++] = byte;
+  if (state.numBytes < state.length)
+    return;
+  decodeCommand(state);
+  state.numBytes = 0;
+}
+
+void TraceDecoder::decodeCommand(UnitState &state) {
+  const uint8_t *b = state.bytes.data();
+  uint8_t op = b[0];
+  uint8_t events;
+  uint32_t cycles;
+  if ((op & 0x80) == 0x00) { // Single0
+    events = 1 << ((op >> 4) & 0x7);
+    cycles = op & 0xF;
+  } else if ((op & 0xE0) == 0x80) { // Single1
+    events = 1 << ((op >> 2) & 0x7);
+    cycles = (op & 0x3) << 8 | b[1];
+  } else if ((op & 0xE0) == 0xA0) { // Single2
+    events = 1 << ((op >> 2) & 0x7);
+    cycles = (op & 0x3) << 16 | b[1] << 8 | b[2];
+  } else if ((op & 0xF0) == 0xC0) { // Multiple0
+    events = (op & 0xF) << 4 | b[1] >> 4;
+    cycles = b[1] & 0xF;
+  } else if ((op & 0xFC) == 0xD0) { // Multiple1
+    events = (op & 0x3) << 6 | b[1] >> 2;
+    cycles = (b[1] & 0x3) << 8 | b[2];
+  } else if ((op & 0xFC) == 0xD4) { // Multiple2
+    events = (op & 0x3) << 6 | b[1] >> 2;
+    cycles = (b[1] & 0x3) << 16 | b[2] << 8 | b[3];
+  } else if ((op & 0xF0) == 0xE0) { // Repeat0
+    state.timer += op & 0xF;
+    return;
+  } else if ((op & 0xFC) == 0xD8) { // Repeat1
+    state.timer += (op & 0x3) << 8 | b[1];
+    return;
+  } else {
+    // Start, Event_Sync and filler commands do not change the events.
+    return;
+  }
+
+  // Every command takes a cycle. Active events end at that cycle unless they
+  // are still active in the following `cycles` cycles; the events of the
+  // command (re)start after them.
+  state.timer += 1;
+  uint8_t ending = cycles > 0 ? state.active : state.active & ~events;
+  for (unsigned slot = 0; slot < kNumTraceEventSlots; slot++)
+    if (ending & (1 << slot))
+      sink.event(*state.unit, slot, state.timer, /*begin=*/false);
+  state.active &= ~ending;
+
+  state.timer += cycles;
+  uint8_t starting = events & ~state.active;
+  for (unsigned slot = 0; slot < kNumTraceEventSlots; slot++)
+    if (starting & (1 << slot))
+      sink.event(*state.unit, slot, state.timer, /*begin=*/true);
+  state.active |= starting;
+}
+
+uint64_t TraceDecoder::finish() {
+  sink.finish();
+  return droppedPackets;
+}
+
+LogicalResult xilinx::AIE::decodeTrace(StringRef trace, bool binaryInput,
+                                       const TraceConfig &config,
+                                       TraceSink &sink,
+                                       uint64_t *droppedPackets) {
+  TraceDecoder decoder(config, sink);
+  // Words are handed to the decoder in fixed-size chunks, so decoding never
+  // holds more than one chunk of the trace besides the input itself.
+  SmallVector<uint32_t, kTraceChunkWords> chunk;
+  auto flush = [&]() {
+    decoder.addWords(chunk);
+    chunk.clear();
+  };
+
+  if (binaryInput) {
+    if (trace.size() % 4) {
+      llvm::errs() << "trace size " << trace.size()
+                   << " is not a multiple of 4 bytes\n";
+      return failure();
+    }
+    for (size_t i = 0; i < trace.size(); i += 4) {
+      uint32_t word = llvm::support::endian::read32le(trace.data() + i);
+      if (word == 0)
+        continue;
+      chunk.push_back(word);
+      if (chunk.size() == kTraceChunkWords)
+        flush();
+    }
+  } else {
+    unsigned lineNo = 0;
+    while (!trace.empty()) {
+      StringRef line;
+      std::tie(line, trace) = trace.split('\n');
+      lineNo++;
+      line = line.trim();
+      if (line.empty())
+        continue;
+      line.consume_front_insensitive("0x");
+      uint32_t word;
+      if (line.getAsInteger(16, word)) {
+        llvm::errs() << "line " << lineNo << ": expected a hexadecimal word\n";
+        return failure();
+      }
+      chunk.push_back(word);
+      if (chunk.size() == kTraceChunkWords)
+        flush();
+    }
+  }
+  flush();
+
+  uint64_t dropped = decoder.finish();
+  if (droppedPackets)
+    *droppedPackets = dropped;
+  return success();
+}
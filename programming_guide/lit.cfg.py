@@ -6,10 +6,12 @@
 #
 # Copyright (C) 2022, Advanced Micro Devices, Inc.
 
+import atexit
 import os
 import re
 import shutil
 import subprocess
+import tempfile
 
 import lit.formats
 import lit.util
@@ -196,6 +198,12 @@ config.substitutions.append(("%aieHostTargetArch%", config.aieHostTarget))
 
 llvm_config.with_system_environment(["HOME", "INCLUDE", "LIB", "TMP", "TEMP"])
 
+# Every run starts from an empty aiecc compilation cache of its own, outside of
+# the user's home directory.
+aiecc_cache_dir = tempfile.mkdtemp(prefix="aiecc-cache-")
+atexit.register(shutil.rmtree, aiecc_cache_dir, ignore_errors=True)
+llvm_config.with_environment("AIECC_CACHE_DIR", aiecc_cache_dir)
+
 llvm_config.use_default_substitutions()
 
 # excludes: A list of directories to exclude from the testsuite. The 'Inputs'
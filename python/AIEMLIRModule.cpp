@@ -5,6 +5,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "aie-c/Compiler.h"
 #include "aie-c/Dialects.h"
 #include "aie-c/Registration.h"
 #include "aie-c/TargetModel.h"
@@ -31,6 +32,25 @@ using namespace mlir::python::adaptors;
 namespace py = pybind11;
 using namespace py::literals;
 
+namespace {
+// Owns an in-process compilation for the Python bindings.
+class PyAieCompilation {
+public:
+  explicit PyAieCompilation(AieCompilation compilation)
+      : compilation(compilation) {}
+  PyAieCompilation(const PyAieCompilation &) = delete;
+  PyAieCompilation &operator=(const PyAieCompilation &) = delete;
+  ~PyAieCompilation() { aieCompilationDestroy(compilation); }
+
+  AieCompilation get() { return compilation; }
+
+private:
+  AieCompilation compilation;
+};
+
+py::str toPyStr(MlirStringRef s) { return py::str(s.data, s.length); }
+} // namespace
+
 PYBIND11_MODULE(_aie, m) {
 
   aieRegisterAllPasses();
@@ -117,6 +137,24 @@ PYBIND11_MODULE(_aie, m) {
       },
       "ctx"_a, "binary"_a);
 
+  m.def(
+      "decode_trace",
+      [&stealCStr](MlirOperation op, py::bytes trace, bool binaryInput,
+                   bool binaryOutput, int colShift) -> py::object {
+        std::string s = trace;
+        MlirStringRef decoded = aieDecodeTrace(
+            op, {s.data(), s.size()}, binaryInput, binaryOutput, colShift);
+        if (!binaryOutput)
+          return stealCStr(decoded);
+        if (!decoded.data)
+          throw std::runtime_error("couldn't decode trace");
+        py::bytes bytes(decoded.data, decoded.length);
+        free((void *)decoded.data);
+        return bytes;
+      },
+      "module"_a, "trace"_a, "binary_input"_a = false,
+      "binary_output"_a = false, "colshift"_a = 0);
+
   m.def(
       "npu_instgen",
       [&stealCStr](MlirOperation op) {
@@ -321,4 +359,177 @@ PYBIND11_MODULE(_aie, m) {
       .def("get_row_shift", [](PyAieTargetModel &self) {
         return aieTargetModelGetRowShift(self.get());
       });
+
+  // In-process compilation. The modules stay in memory between the stages,
+  // and the cores are lowered in parallel.
+  py::class_<PyAieCompilation>(m, "Compilation", py::module_local())
+      .def(py::init([](MlirOperation op, const std::string &deviceName,
+                       const std::string &allocScheme, bool dynamicObjFifos,
+                       bool ctrlPktOverlay) {
+             mlir::python::CollectDiagnosticsToStringScope scope(
+                 mlirOperationGetContext(op));
+             AieCompilation compilation = aieCompilationCreate(
+                 op, {deviceName.data(), deviceName.size()},
+                 {allocScheme.data(), allocScheme.size()}, dynamicObjFifos,
+                 ctrlPktOverlay);
+             if (aieCompilationIsNull(compilation))
+               throw py::value_error("Failed to compile because: " +
+                                     scope.takeMessage());
+             return std::make_unique<PyAieCompilation>(compilation);
+           }),
+           "module"_a, "device_name"_a = "", "alloc_scheme"_a = "bank-aware",
+           "dynamic_objfifos"_a = false, "ctrl_pkt_overlay"_a = false)
+      .def_static(
+          "device_names",
+          [](MlirOperation op) {
+            py::list names;
+            aieCompilationGetDeviceNames(
+                op,
+                [](MlirStringRef name, void *userData) {
+                  static_cast<py::list *>(userData)->append(toPyStr(name));
+                },
+                &names);
+            return names;
+          },
+          "module"_a,
+          "The names of the devices of the module, to select them with "
+          "device_name.")
+      .def_property_readonly(
+          "device_name",
+          [](PyAieCompilation &self) {
+            return toPyStr(aieCompilationGetDeviceName(self.get()));
+          })
+      .def_property_readonly(
+          "target_arch",
+          [](PyAieCompilation &self) {
+            return toPyStr(aieCompilationGetTargetArch(self.get()));
+          })
+      .def(
+          "module_with_addresses",
+          [](PyAieCompilation &self) {
+            return mlirOperationClone(
+                aieCompilationGetModuleWithAddresses(self.get()));
+          },
+          "Get a copy of the design with buffer addresses.")
+      .def(
+          "physical_module",
+          [](PyAieCompilation &self) {
+            return mlirOperationClone(
+                aieCompilationGetPhysicalModule(self.get()));
+          },
+          "Get a copy of the routed design.")
+      .def_property_readonly(
+          "cores",
+          [](PyAieCompilation &self) {
+            py::list cores;
+            for (intptr_t i = 0; i < aieCompilationGetNumCores(self.get());
+                 ++i) {
+              int col, row;
+              aieCompilationGetCoreTile(self.get(), i, &col, &row);
+              MlirStringRef elfFile =
+                  aieCompilationGetCoreElfFile(self.get(), i);
+              py::object elf =
+                  elfFile.data ? py::object(toPyStr(elfFile)) : py::none();
+              cores.append(py::make_tuple(col, row, elf));
+            }
+            return cores;
+          },
+          "The (col, row, elf_file) of every core.")
+      .def(
+          "lower_cores",
+          [](PyAieCompilation &self) {
+            MlirOperation op = aieCompilationGetModuleWithAddresses(self.get());
+            mlir::python::CollectDiagnosticsToStringScope scope(
+                mlirOperationGetContext(op));
+            if (mlirLogicalResultIsFailure(
+                    aieCompilationLowerCores(self.get())))
+              throw py::value_error("Failed to lower cores because: " +
+                                    scope.takeMessage());
+            py::list cores;
+            for (intptr_t i = 0; i < aieCompilationGetNumCores(self.get());
+                 ++i) {
+              int col, row;
+              aieCompilationGetCoreTile(self.get(), i, &col, &row);
+              py::dict core;
+              core["col"] = col;
+              core["row"] = row;
+              core["llvm_ir"] =
+                  toPyStr(aieCompilationGetCoreLLVMIR(self.get(), i));
+              core["ld_script"] =
+                  toPyStr(aieCompilationGetCoreLdScript(self.get(), i));
+              core["bcf"] = toPyStr(aieCompilationGetCoreBCF(self.get(), i));
+              cores.append(core);
+            }
+            return cores;
+          },
+          "Lower every core to LLVM IR and generate its linker scripts.")
+      .def(
+          "lower_cores_unified",
+          [](PyAieCompilation &self) {
+            MlirOperation op = aieCompilationGetModuleWithAddresses(self.get());
+            mlir::python::CollectDiagnosticsToStringScope scope(
+                mlirOperationGetContext(op));
+            MlirStringRef llvmIR = aieCompilationLowerCoresUnified(self.get());
+            if (!llvmIR.data)
+              throw py::value_error("Failed to lower cores because: " +
+                                    scope.takeMessage());
+            py::str result = toPyStr(llvmIR);
+            free((void *)llvmIR.data);
+            return result;
+          },
+          "Lower all cores to a single LLVM IR module.")
+      .def(
+          "npu_instructions",
+          [](PyAieCompilation &self) {
+            MlirOperation op = aieCompilationGetModuleWithAddresses(self.get());
+            mlir::python::CollectDiagnosticsToStringScope scope(
+                mlirOperationGetContext(op));
+            uint32_t *words;
+            size_t numWords;
+            if (mlirLogicalResultIsFailure(
+                    aieCompilationGenerateNPUInstructions(self.get(), &words,
+                                                          &numWords)))
+              throw py::value_error(
+                  "Failed to generate NPU instructions because: " +
+                  scope.takeMessage());
+            std::vector<uint32_t> instructions(words, words + numWords);
+            free(words);
+            return instructions;
+          },
+          "Generate the NPU instruction stream of the runtime sequence.")
+      .def(
+          "generate_cdo",
+          [](PyAieCompilation &self, const std::string &elfDir) {
+            MlirOperation op = aieCompilationGetPhysicalModule(self.get());
+            mlir::python::CollectDiagnosticsToStringScope scope(
+                mlirOperationGetContext(op));
+            if (mlirLogicalResultIsFailure(aieCompilationGenerateCDO(
+                    self.get(), {elfDir.data(), elfDir.size()})))
+              throw py::value_error("Failed to generate cdo because: " +
+                                    scope.takeMessage());
+            py::dict binaries;
+            for (intptr_t i = 0;
+                 i < aieCompilationGetNumCDOBinaries(self.get()); ++i) {
+              MlirStringRef name, data;
+              aieCompilationGetCDOBinary(self.get(), i, &name, &data);
+              binaries[toPyStr(name)] = py::bytes(data.data, data.length);
+            }
+            return binaries;
+          },
+          "elf_dir"_a, "Generate the CDO binaries, keyed by file name.")
+      .def(
+          "generate_transactions",
+          [](PyAieCompilation &self, const std::string &elfDir) {
+            MlirOperation op = aieCompilationGetPhysicalModule(self.get());
+            mlir::python::CollectDiagnosticsToStringScope scope(
+                mlirOperationGetContext(op));
+            MlirOperation transactions = aieCompilationGenerateTransactions(
+                self.get(), {elfDir.data(), elfDir.size()});
+            if (mlirOperationIsNull(transactions))
+              throw py::value_error(
+                  "Failed to generate transactions because: " +
+                  scope.takeMessage());
+            return transactions;
+          },
+          "elf_dir"_a, "Generate the configuration as transactions.");
 }
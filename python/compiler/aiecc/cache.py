@@ -0,0 +1,274 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# Content-addressed cache for the artifacts built by aiecc.
+#
+# An entry is keyed by a hash of everything that determines its contents: the
+# command with its file paths replaced by placeholders, the contents of the
+# input files and the identity of the tools. Entries live in
+# <root>/<key[:2]>/<key>/ and hold the output files under their base names.
+# Entries are published with a rename, so concurrent builds sharing a cache
+# directory never see partially written entries.
+#
+# The cache is bounded in size: after a build, the least recently used entries
+# are removed until it fits again. This includes the routings that
+# aie-create-pathfinder-flows keeps in <root>/routes/, which count as used when
+# they were written.
+
+import asyncio
+import hashlib
+import os
+import shutil
+import tempfile
+
+import aie.compiler.aiecc.configure
+
+# Bump when the layout of the cache or the meaning of its keys changes.
+CACHE_VERSION = "1"
+
+DEFAULT_MAX_SIZE = "2G"
+
+_SIZE_SUFFIXES = {"": 1, "K": 1 << 10, "M": 1 << 20, "G": 1 << 30, "T": 1 << 40}
+
+
+def parse_size(text):
+    """Bytes in a size such as 512, 100M or 2G."""
+    text = text.strip().upper()
+    if text.endswith("B"):
+        text = text[:-1]
+    suffix = text[-1:] if text[-1:] in _SIZE_SUFFIXES else ""
+    try:
+        size = int(text[: len(text) - len(suffix)])
+    except ValueError:
+        raise ValueError(f"invalid size '{text}'")
+    if size < 0:
+        raise ValueError(f"invalid size '{text}'")
+    return size * _SIZE_SUFFIXES[suffix]
+
+
+def default_cache_max_size():
+    return os.getenv("AIECC_CACHE_MAX_SIZE") or DEFAULT_MAX_SIZE
+
+
+def default_cache_dir():
+    cache_dir = os.getenv("AIECC_CACHE_DIR")
+    if cache_dir:
+        return cache_dir
+    xdg_cache_home = os.getenv("XDG_CACHE_HOME") or os.path.join(
+        os.path.expanduser("~"), ".cache"
+    )
+    return os.path.join(xdg_cache_home, "mlir-aie", "aiecc")
+
+
+_file_digests = {}
+
+
+def file_digest(path):
+    """sha256 of the contents of path. Digests are remembered for as long as
+    the size and modification time of the file do not change."""
+    st = os.stat(path)
+    stamp = (st.st_size, st.st_mtime_ns)
+    cached = _file_digests.get(path)
+    if cached and cached[0] == stamp:
+        return cached[1]
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(1 << 20), b""):
+            h.update(chunk)
+    digest = h.hexdigest()
+    _file_digests[path] = (stamp, digest)
+    return digest
+
+
+def tool_fingerprint(tool):
+    """Identifies the tool that a command runs. Hashing the binaries of large
+    toolchains on every build would cost more than many of the commands, so a
+    tool is identified by its resolved path, size and modification time."""
+    path = shutil.which(tool) or tool
+    try:
+        path = os.path.realpath(path)
+        st = os.stat(path)
+        return f"{path}:{st.st_size}:{st.st_mtime_ns}"
+    except OSError:
+        return tool
+
+
+class CompilationCache:
+    def __init__(self, root, enabled=True, verbose=False):
+        self.root = os.path.abspath(root)
+        self.enabled = enabled
+        self.verbose = verbose
+        self.hits = 0
+        self.misses = 0
+        # Builds of the same key that are in flight in this process.
+        self.in_flight = {}
+
+    def key(self, *parts):
+        h = hashlib.sha256()
+        for part in (
+            CACHE_VERSION,
+            aie.compiler.aiecc.configure.git_commit,
+        ) + parts:
+            if isinstance(part, (list, tuple)):
+                part = "\x1f".join(str(p) for p in part)
+            if not isinstance(part, bytes):
+                part = str(part).encode()
+            h.update(len(part).to_bytes(8, "little"))
+            h.update(part)
+        return h.hexdigest()
+
+    def entry_dir(self, key):
+        return os.path.join(self.root, key[:2], key)
+
+    def entry_files(self, key):
+        """Names of the files of an entry, or None if there is no entry."""
+        try:
+            return sorted(os.listdir(self.entry_dir(key)))
+        except OSError:
+            return None
+
+    def fetch(self, key, outputs, optional=None):
+        """Copies the files of an entry to the paths in outputs, which maps the
+        names of the files of the entry to their destinations. Returns False if
+        the entry does not have all of them. The files in optional are copied
+        if the entry has them."""
+        if not self.enabled:
+            return False
+        entry = self.entry_dir(key)
+        names = self.entry_files(key)
+        if names is None or not set(outputs) <= set(names):
+            self.misses += 1
+            return False
+        files = list(outputs.items()) + list((optional or {}).items())
+        try:
+            for name, dest in files:
+                if name in names:
+                    _copy_atomic(os.path.join(entry, name), dest)
+        except FileNotFoundError:
+            # Another build evicted the entry while it was being copied.
+            self.misses += 1
+            return False
+        try:
+            # Entries are evicted in the order they were last used.
+            os.utime(entry)
+        except OSError:
+            pass
+        self.hits += 1
+        if self.verbose:
+            print(f"Cache hit {key[:16]}: {' '.join(outputs.values())}")
+        return True
+
+    def store(self, key, outputs):
+        """Adds an entry holding the files in outputs, which maps the names of
+        the files of the entry to the files that were built."""
+        if not self.enabled:
+            return
+        entry = self.entry_dir(key)
+        if os.path.isdir(entry):
+            return
+        parent = os.path.dirname(entry)
+        try:
+            os.makedirs(parent, exist_ok=True)
+            staging = tempfile.mkdtemp(prefix=".tmp-", dir=parent)
+            for name, src in outputs.items():
+                shutil.copyfile(src, os.path.join(staging, name))
+            try:
+                os.rename(staging, entry)
+            except OSError:
+                # Another build published the same entry first.
+                shutil.rmtree(staging, ignore_errors=True)
+        except OSError as e:
+            # The cache is an optimization; failing to fill it is not an error.
+            if self.verbose:
+                print(f"Could not write cache entry {key[:16]}: {e}")
+
+    async def single_flight(self, key, build):
+        """Awaits build() unless a build of the same key is already running in
+        this process, in which case waits for that one instead. Returns True
+        if this call ran build()."""
+        if key in self.in_flight:
+            await self.in_flight[key]
+            return False
+        done = asyncio.get_running_loop().create_future()
+        self.in_flight[key] = done
+        try:
+            await build()
+        finally:
+            done.set_result(None)
+            del self.in_flight[key]
+        return True
+
+    def entries(self):
+        """The (path, size, last use) of every entry, including the routings."""
+        found = []
+        try:
+            shards = list(os.scandir(self.root))
+        except OSError:
+            return found
+        for shard in shards:
+            if not shard.is_dir() or shard.name.startswith(".tmp-"):
+                continue
+            for entry in os.scandir(shard.path):
+                if entry.name.startswith(".tmp-"):
+                    continue
+                try:
+                    if entry.is_dir():
+                        size = sum(f.stat().st_size for f in os.scandir(entry.path))
+                    else:
+                        size = entry.stat().st_size
+                    found.append((entry.path, size, entry.stat().st_mtime))
+                except OSError:
+                    # Removed by a concurrent build.
+                    pass
+        return found
+
+    def trim(self, max_size):
+        """Removes the least recently used entries until the cache holds at most
+        max_size bytes. Returns the number of entries removed."""
+        entries = self.entries()
+        total = sum(size for _, size, _ in entries)
+        removed = 0
+        for path, size, _ in sorted(entries, key=lambda e: e[2]):
+            if total <= max_size:
+                break
+            try:
+                if os.path.isdir(path):
+                    # Unpublish the entry first, so that no build finds it
+                    # half removed.
+                    doomed = tempfile.mkdtemp(
+                        prefix=".tmp-", dir=os.path.dirname(path)
+                    )
+                    os.rename(path, os.path.join(doomed, "entry"))
+                    shutil.rmtree(doomed, ignore_errors=True)
+                else:
+                    os.remove(path)
+            except OSError:
+                continue
+            total -= size
+            removed += 1
+        if self.verbose and removed:
+            print(f"Evicted {removed} entries from the cache {self.root}")
+        return removed
+
+    def clear(self):
+        """Removes every entry."""
+        shutil.rmtree(self.root, ignore_errors=True)
+
+    def summary(self):
+        return f"Compilation cache {self.root}: {self.hits} hits, {self.misses} misses"
+
+
+def _copy_atomic(src, dest):
+    dest_dir = os.path.dirname(os.path.abspath(dest))
+    fd, tmp = tempfile.mkstemp(prefix=".tmp-", dir=dest_dir)
+    os.close(fd)
+    try:
+        shutil.copyfile(src, tmp)
+        os.replace(tmp, dest)
+    except BaseException:
+        os.unlink(tmp)
+        raise
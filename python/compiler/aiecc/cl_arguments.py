@@ -8,6 +8,11 @@
 import argparse
 import sys
 
+from aie.compiler.aiecc.cache import (
+    default_cache_dir,
+    default_cache_max_size,
+    parse_size,
+)
 from aie.compiler.aiecc.configure import *
 
 
@@ -150,6 +155,20 @@ def parse_args(args=None):
         default="bank-aware",
         help="Allocation scheme for AIE buffers: basic-sequential, bank-aware (default).",
     )
+    parser.add_argument(
+        "--router",
+        dest="router",
+        default="pathfinder",
+        choices=["pathfinder", "exact"],
+        help="Router for aie.flow and aie.packetflow: pathfinder (default), or exact to minimize the highest link utilization",
+    )
+    parser.add_argument(
+        "--router-timeout",
+        dest="router_timeout",
+        default=1000,
+        type=int,
+        help="Time budget of the exact router in milliseconds (default 1000)",
+    )
     parser.add_argument(
         "--generate-ctrl-pkt-overlay",
         dest="ctrl_pkt_overlay",
@@ -206,6 +225,54 @@ def parse_args(args=None):
         action="store_false",
         help="Compile cores independently in separate processes",
     )
+    parser.add_argument(
+        "--cache",
+        dest="cache",
+        default=True,
+        action="store_true",
+        help="Reuse compiled cores, CDOs and transactions from earlier builds with the same inputs, tools and flags (default)",
+    )
+    parser.add_argument(
+        "--no-cache",
+        dest="cache",
+        default=False,
+        action="store_false",
+        help="Rebuild every artifact from scratch",
+    )
+    parser.add_argument(
+        "--cache-dir",
+        dest="cache_dir",
+        default=default_cache_dir(),
+        help="Directory of the compilation cache (default is $AIECC_CACHE_DIR or ~/.cache/mlir-aie/aiecc)",
+    )
+    parser.add_argument(
+        "--cache-max-size",
+        dest="cache_max_size",
+        type=parse_size,
+        default=default_cache_max_size(),
+        help="Size the compilation cache is trimmed to after a build, least recently used entries first, e.g. 500M (default is $AIECC_CACHE_MAX_SIZE or 2G, 0 for no limit)",
+    )
+    parser.add_argument(
+        "--clear-cache",
+        dest="clear_cache",
+        default=False,
+        action="store_true",
+        help="Remove every entry of the compilation cache before compiling. Without an input file, aiecc exits after clearing the cache",
+    )
+    parser.add_argument(
+        "--bytecode",
+        dest="bytecode",
+        default=True,
+        action="store_true",
+        help="Pass MLIR between compilation stages as bytecode (default)",
+    )
+    parser.add_argument(
+        "--no-bytecode",
+        dest="bytecode",
+        default=False,
+        action="store_false",
+        help="Pass MLIR between compilation stages as text, for inspection",
+    )
     parser.add_argument(
         "-n",
         dest="execute",
@@ -9,7 +9,10 @@ aiecc - AIE compiler driver for MLIR tools
 """
 
 import asyncio
+import contextlib
+import copy
 import glob
+import io
 import json
 import os
 import random
@@ -28,6 +31,7 @@ from aie.extras.util import find_ops
 import aiofiles
 import rich.progress as progress
 
+from aie.compiler.aiecc.cache import CompilationCache, file_digest, tool_fingerprint
 import aie.compiler.aiecc.cl_arguments
 import aie.compiler.aiecc.configure
 from aie.dialects import aie as aiedialect
@@ -104,12 +108,13 @@ DMA_TO_NPU = Pipeline().Nested(
     .add_pass("aie-substitute-shim-dma-allocations")
     .add_pass("aie-assign-runtime-sequence-bd-ids")
     .add_pass("aie-dma-tasks-to-npu")
-    .add_pass("aie-dma-to-npu"),
+    .add_pass("aie-dma-to-npu")
+    .add_pass("aie-coalesce-npu-syncs"),
 )
 
 
-async def read_file_async(file_path: str) -> str:
-    async with aiofiles.open(file_path, mode="r") as f:
+async def read_file_async(file_path: str, binary=False):
+    async with aiofiles.open(file_path, mode="rb" if binary else "r") as f:
         contents = await f.read()
     return contents
 
@@ -319,6 +324,12 @@ async def extract_input_files(file_core_bcf):
     return " ".join(re.findall(r"^_include _file (.*)", core_bcf, re.MULTILINE))
 
 
+# Extract the object files that the given GNU linker script pulls into the link.
+async def extract_ldscript_input_files(file_core_ldscript):
+    core_ldscript = await read_file_async(file_core_ldscript)
+    return re.findall(r"^INPUT\((.*)\)", core_ldscript, re.MULTILINE)
+
+
 def do_run(command, verbose=False):
     if verbose:
         print(" ".join(command))
@@ -327,7 +338,23 @@ def do_run(command, verbose=False):
     return ret
 
 
-def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
+def serialize_module(module, bytecode):
+    """Returns `module` as MLIR bytecode, or as text if `bytecode` is false.
+    Modules that are already serialized are returned unchanged."""
+    if isinstance(module, (str, bytes)):
+        return module
+    if not bytecode:
+        return str(module)
+    buffer = io.BytesIO()
+    module.operation.write_bytecode(buffer)
+    return buffer.getvalue()
+
+
+def run_passes(
+    pass_pipeline, mlir_module_str, outputfile=None, verbose=False, bytecode=False
+):
+    """Runs `pass_pipeline` on a module given as text or bytecode. The result is
+    written to `outputfile` if there is one, and returned otherwise."""
     if verbose:
         print("Running:", pass_pipeline)
     with Context() as ctx, Location.unknown():
@@ -338,11 +365,16 @@ def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
         except Exception as e:
             print("Error running pass pipeline: ", pass_pipeline, e)
             raise e
-        mlir_module_str = str(module)
-        if outputfile:
+        if not outputfile:
+            return serialize_module(module, bytecode)
+        # Printing a large module as text takes longer than the passes, and
+        # parsing it back takes longer still.
+        if bytecode:
+            with open(outputfile, "wb") as g:
+                module.operation.write_bytecode(g)
+        else:
             with open(outputfile, "w") as g:
-                g.write(mlir_module_str)
-    return mlir_module_str
+                g.write(str(module))
 
 
 def corefile(dirname, core, ext):
@@ -384,10 +416,12 @@ def downgrade_ir_for_chess(llvmir_chesslinked):
 
 
 class FlowRunner:
-    def __init__(self, mlir_module_str, opts, tmpdirname):
+    def __init__(self, mlir_module_str, opts, tmpdirname, elf_dir="."):
         self.mlir_module_str = mlir_module_str
         self.opts = opts
         self.tmpdirname = tmpdirname
+        # Where the core ELFs without an elf_file attribute are linked to.
+        self.elf_dir = elf_dir
         self.runtimes = dict()
         self.progress_bar = None
         self.maxtasks = 5
@@ -395,10 +429,17 @@ class FlowRunner:
         self.peano_clang_path = os.path.join(opts.peano_install_dir, "bin", "clang")
         self.peano_opt_path = os.path.join(opts.peano_install_dir, "bin", "opt")
         self.peano_llc_path = os.path.join(opts.peano_install_dir, "bin", "llc")
+        self.cache = CompilationCache(
+            opts.cache_dir, enabled=opts.cache, verbose=opts.verbose
+        )
 
     def prepend_tmp(self, x):
         return os.path.join(self.tmpdirname, x)
 
+    def emit_flags(self):
+        # aie-opt and aie-translate read either form of their input.
+        return ["--emit-bytecode"] if self.opts.bytecode else []
+
     async def do_call(self, task, command, force=False):
         if self.stopall:
             return
@@ -430,6 +471,56 @@ class FlowRunner:
             print("Error encountered while running: " + commandstr, file=sys.stderr)
             sys.exit(ret)
 
+    # Like do_call, but reuses the outputs of an earlier run of the same command
+    # on inputs with the same contents from the compilation cache. Commands that
+    # only differ in the paths of their inputs and outputs share cache entries,
+    # and runs of the same command that are in flight at the same time run once.
+    # side_outputs are files that the command may or may not write.
+    async def do_cached_call(
+        self, task, command, inputs, outputs, side_outputs=()
+    ):
+        if self.stopall or not self.opts.execute or not self.cache.enabled:
+            return await self.do_call(task, command)
+
+        placeholders = {self.tmpdirname: "<tmpdir>"}
+        for i, path in enumerate(inputs):
+            placeholders[path] = f"<input{i}>"
+        for i, path in enumerate(outputs):
+            placeholders[path] = f"<output{i}>"
+
+        def normalize(arg):
+            for path in sorted(placeholders, key=len, reverse=True):
+                arg = arg.replace(path, placeholders[path])
+            return arg
+
+        digests = [
+            file_digest(path) if os.path.exists(path) else "missing:" + path
+            for path in inputs
+        ]
+        key = self.cache.key(
+            tool_fingerprint(command[0]),
+            self.opts.aietools_path,
+            [normalize(arg) for arg in command],
+            digests,
+        )
+        entry = {f"output{i}": path for i, path in enumerate(outputs)}
+        side_entry = {f"side{i}": path for i, path in enumerate(side_outputs)}
+
+        async def build():
+            if self.cache.fetch(key, entry, side_entry):
+                if task:
+                    self.progress_bar.update(task, advance=1, command="")
+                return
+            await self.do_call(task, command)
+            if not self.stopall:
+                built = {n: p for n, p in side_entry.items() if os.path.exists(p)}
+                self.cache.store(key, {**entry, **built})
+
+        if not await self.cache.single_flight(key, build):
+            # The same command ran for other inputs with the same contents.
+            if not self.cache.fetch(key, entry, side_entry):
+                await self.do_call(task, command)
+
     # In order to run xchesscc on modern ll code, we need a bunch of hacks.
     async def chesshack(self, task, llvmir, aie_target):
         llvmir_chesshack = llvmir + "chesshack.ll"
@@ -454,7 +545,7 @@ class FlowRunner:
         else:
             target = "target"
         assert os.path.exists(llvmir_chesshack)
-        await self.do_call(
+        await self.do_cached_call(
             task,
             [
                 # The path below is cheating a bit since it refers directly to the AIE1
@@ -470,6 +561,8 @@ class FlowRunner:
                 "-o",
                 llvmir_chesslinked_path,
             ],
+            [llvmir_chesshack, chess_intrinsic_wrapper_ll_path],
+            [llvmir_chesslinked_path],
         )
 
         return llvmir_chesslinked_path
@@ -508,9 +601,9 @@ class FlowRunner:
             corecol, corerow, elf_file = core
             if not opts.unified:
                 file_core = corefile(self.tmpdirname, core, "mlir")
-                await self.do_call(task, ["aie-opt", "--aie-localize-locks", "--aie-normalize-address-spaces", "--aie-standard-lowering=tilecol=%d tilerow=%d" % core[0:2], "--aiex-standard-lowering", file_with_addresses, "-o", file_core])
+                await self.do_call(task, ["aie-opt", *self.emit_flags(), "--aie-localize-locks", "--aie-normalize-address-spaces", "--aie-standard-lowering=tilecol=%d tilerow=%d" % core[0:2], "--aiex-standard-lowering", file_with_addresses, "-o", file_core])
                 file_opt_core = corefile(self.tmpdirname, core, "opt.mlir")
-                await self.do_call(task, ["aie-opt", f"--pass-pipeline={LOWER_TO_LLVM_PIPELINE}", file_core, "-o", file_opt_core])
+                await self.do_call(task, ["aie-opt", *self.emit_flags(), f"--pass-pipeline={LOWER_TO_LLVM_PIPELINE}", file_core, "-o", file_opt_core])
             if self.opts.xbridge:
                 file_core_bcf = corefile(self.tmpdirname, core, "bcf")
                 await self.do_call(task, ["aie-translate", file_with_addresses, "--aie-generate-bcf", "--tilecol=%d" % corecol, "--tilerow=%d" % corerow, "-o", file_core_bcf])
@@ -522,40 +615,43 @@ class FlowRunner:
                 await self.do_call(task, ["aie-translate", "--mlir-to-llvmir", file_opt_core, "-o", file_core_llvmir])
                 file_core_obj = corefile(self.tmpdirname, core, "o")
 
-            file_core_elf = elf_file if elf_file else corefile(".", core, "elf")
+            file_core_elf = elf_file if elf_file else corefile(self.elf_dir, core, "elf")
 
             if opts.compile and opts.xchesscc:
                 if not opts.unified:
                     file_core_llvmir_chesslinked = await self.chesshack(task, file_core_llvmir, aie_target)
                     if self.opts.link and self.opts.xbridge:
                         link_with_obj = await extract_input_files(file_core_bcf)
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                        await self.do_cached_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf], [file_core_llvmir_chesslinked, file_core_bcf, *link_with_obj.split()], [file_core_elf], [file_core_elf + ".map"])
                     elif self.opts.link:
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, "-o", file_core_obj])
-                        await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
+                        await self.do_cached_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, "-o", file_core_obj], [file_core_llvmir_chesslinked], [file_core_obj])
+                        link_with_obj = await extract_ldscript_input_files(file_core_ldscript)
+                        await self.do_cached_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf], [file_core_obj, file_core_ldscript, *link_with_obj], [file_core_elf])
                 else:
                     file_core_obj = self.unified_file_core_obj
                     if opts.link and opts.xbridge:
                         link_with_obj = await extract_input_files(file_core_bcf)
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                        await self.do_cached_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf], [file_core_obj, file_core_bcf, *link_with_obj.split()], [file_core_elf], [file_core_elf + ".map"])
                     elif opts.link:
-                        await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
+                        link_with_obj = await extract_ldscript_input_files(file_core_ldscript)
+                        await self.do_cached_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf], [file_core_obj, file_core_ldscript, *link_with_obj], [file_core_elf])
 
             elif opts.compile:
                 if not opts.unified:
                     file_core_llvmir_stripped = corefile(self.tmpdirname, core, "stripped.ll")
-                    await self.do_call(task, [self.peano_opt_path, "--passes=default<O2>,strip", "-S", file_core_llvmir, "-o", file_core_llvmir_stripped])
-                    await self.do_call(task, [self.peano_llc_path, file_core_llvmir_stripped, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", file_core_obj])
+                    await self.do_cached_call(task, [self.peano_opt_path, "--passes=default<O2>,strip", "-S", file_core_llvmir, "-o", file_core_llvmir_stripped], [file_core_llvmir], [file_core_llvmir_stripped])
+                    await self.do_cached_call(task, [self.peano_llc_path, file_core_llvmir_stripped, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", file_core_obj], [file_core_llvmir_stripped], [file_core_obj])
                 else:
                     file_core_obj = self.unified_file_core_obj
 
                 if opts.link and opts.xbridge:
                     link_with_obj = await extract_input_files(file_core_bcf)
-                    await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                    await self.do_cached_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf], [file_core_obj, file_core_bcf, *link_with_obj.split()], [file_core_elf], [file_core_elf + ".map"])
                 elif opts.link:
-                    await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
+                    link_with_obj = await extract_ldscript_input_files(file_core_ldscript)
+                    await self.do_cached_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf], [file_core_obj, file_core_ldscript, *link_with_obj], [file_core_elf])
 
-            self.progress_bar.update(self.progress_bar.task_completed, advance=1)
+            self.progress_bar.update(self.task_completed, advance=1)
             if task:
                 self.progress_bar.update(task, advance=0, visible=False)
             # fmt: on
@@ -564,61 +660,97 @@ class FlowRunner:
         from aie.dialects.aie import generate_cdo
 
         with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
+            for elf in glob.glob(os.path.join(self.elf_dir, "*.elf")):
                 try:
                     shutil.copy(elf, self.tmpdirname)
                 except shutil.SameFileError:
                     pass
-            for elf_map in glob.glob("*.elf.map"):
+            for elf_map in glob.glob(os.path.join(self.elf_dir, "*.elf.map")):
                 try:
                     shutil.copy(elf_map, self.tmpdirname)
                 except shutil.SameFileError:
                     pass
+            # The CDOs depend on the physical design and on the ELFs they load.
+            for cdo in glob.glob(self.prepend_tmp("aie_cdo*.bin")):
+                os.remove(cdo)
+            key = self.cache.key(
+                "cdo",
+                file_digest(self.prepend_tmp("input_physical.mlir")),
+                self.elf_digests(),
+            )
+            names = self.cache.entry_files(key) or []
+            cdos = {name: self.prepend_tmp(name) for name in names}
+            if names and self.cache.fetch(key, cdos):
+                return
             input_physical = Module.parse(
-                await read_file_async(self.prepend_tmp("input_physical.mlir"))
+                await read_file_async(
+                    self.prepend_tmp("input_physical.mlir"), binary=True
+                )
             )
             generate_cdo(input_physical.operation, self.tmpdirname)
+            cdos = glob.glob(self.prepend_tmp("aie_cdo*.bin"))
+            self.cache.store(key, {os.path.basename(cdo): cdo for cdo in cdos})
+
+    def elf_digests(self):
+        elfs = sorted(glob.glob(self.prepend_tmp("*.elf")))
+        return [f"{os.path.basename(elf)}:{file_digest(elf)}" for elf in elfs]
 
     async def process_txn(self):
 
         with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
+            for elf in glob.glob(os.path.join(self.elf_dir, "*.elf")):
                 try:
                     shutil.copy(elf, self.tmpdirname)
                 except shutil.SameFileError:
                     pass
-            for elf_map in glob.glob("*.elf.map"):
+            for elf_map in glob.glob(os.path.join(self.elf_dir, "*.elf.map")):
                 try:
                     shutil.copy(elf_map, self.tmpdirname)
                 except shutil.SameFileError:
                     pass
+            pass_pipeline = (
+                "builtin.module(aie.device(convert-aie-to-transaction{elf-dir="
+                + self.tmpdirname
+                + "}))"
+            )
+            # txn.mlir is written as bytecode or as text, so the form is part
+            # of the key.
+            key = self.cache.key(
+                pass_pipeline.replace(self.tmpdirname, "<tmpdir>"),
+                "bytecode" if self.opts.bytecode else "text",
+                file_digest(self.prepend_tmp("input_physical.mlir")),
+                self.elf_digests(),
+            )
+            txn = {"txn.mlir": self.prepend_tmp("txn.mlir")}
+            if self.cache.fetch(key, txn):
+                return
             input_physical = await read_file_async(
-                self.prepend_tmp("input_physical.mlir")
+                self.prepend_tmp("input_physical.mlir"), binary=True
             )
             run_passes(
-                "builtin.module(aie.device(convert-aie-to-transaction{elf-dir="
-                + self.tmpdirname
-                + "}))",
+                pass_pipeline,
                 input_physical,
                 self.prepend_tmp("txn.mlir"),
                 self.opts.verbose,
+                self.opts.bytecode,
             )
+            self.cache.store(key, txn)
 
     async def process_ctrlpkt(self):
 
         with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
+            for elf in glob.glob(os.path.join(self.elf_dir, "*.elf")):
                 try:
                     shutil.copy(elf, self.tmpdirname)
                 except shutil.SameFileError:
                     pass
-            for elf_map in glob.glob("*.elf.map"):
+            for elf_map in glob.glob(os.path.join(self.elf_dir, "*.elf.map")):
                 try:
                     shutil.copy(elf_map, self.tmpdirname)
                 except shutil.SameFileError:
                     pass
             input_physical = await read_file_async(
-                self.prepend_tmp("input_physical.mlir")
+                self.prepend_tmp("input_physical.mlir"), binary=True
             )
             run_passes(
                 "builtin.module(aie.device(convert-aie-to-control-packets{elf-dir="
@@ -627,6 +759,7 @@ class FlowRunner:
                 input_physical,
                 self.prepend_tmp("ctrlpkt.mlir"),
                 self.opts.verbose,
+                self.opts.bytecode,
             )
 
     async def process_xclbin_gen(self):
@@ -686,7 +819,7 @@ class FlowRunner:
         await self.do_call(task, ["xclbinutil"] + flag +
                                  ["--add-kernel", self.prepend_tmp("kernels.json"),
                                   "--add-replace-section", "AIE_PARTITION:JSON:" + self.prepend_tmp("aie_partition.json"),
-                                  "--force", "--quiet", "--output", opts.xclbin_name])
+                                  "--force", "--quiet", "--output", self.opts.xclbin_name])
         # fmt: on
 
     async def process_host_cgen(self, aie_target, file_with_addresses):
@@ -703,11 +836,16 @@ class FlowRunner:
 
             # Generate the included host interface
             file_physical = self.prepend_tmp("input_physical.mlir")
+            route_options = f"router={opts.router} router-timeout={opts.router_timeout}"
+            if opts.cache:
+                route_cache_dir = os.path.join(opts.cache_dir, "routes")
+                route_options += f" cache-dir={route_cache_dir}"
             await self.do_call(
                 task,
                 [
                     "aie-opt",
-                    "--aie-create-pathfinder-flows",
+                    *self.emit_flags(),
+                    f"--aie-create-pathfinder-flows={route_options}",
                     file_with_addresses,
                     "-o",
                     file_physical,
@@ -847,7 +985,7 @@ class FlowRunner:
             if len(opts.host_args) > 0:
                 await self.do_call(task, cmd + opts.host_args)
 
-            self.progress_bar.update(self.progress_bar.task_completed, advance=1)
+            self.progress_bar.update(self.task_completed, advance=1)
             if task:
                 self.progress_bar.update(task, advance=0, visible=False)
 
@@ -1044,22 +1182,18 @@ class FlowRunner:
         print("Simulation generated...")
         print("To run simulation: " + sim_script)
 
-    async def run_flow(self):
-        nworkers = int(opts.nthreads)
-        if nworkers == 0:
-            nworkers = os.cpu_count()
-
-        self.limit = asyncio.Semaphore(nworkers)
-        with progress.Progress(
-            *progress.Progress.get_default_columns(),
-            progress.TimeElapsedColumn(),
-            progress.MofNCompleteColumn(),
-            progress.TextColumn("{task.fields[command]}"),
-            redirect_stdout=False,
-            redirect_stderr=False,
-        ) as progress_bar:
+    async def run_flow(self, progress_bar=None, limit=None):
+        """Runs the flow. Runners that run at the same time share the progress
+        display `progress_bar` and the limit on concurrent tools `limit`."""
+        nworkers = worker_count()
+        self.limit = limit or asyncio.Semaphore(nworkers)
+        if progress_bar is None:
+            progress_context = make_progress_bar()
+        else:
+            progress_context = contextlib.nullcontext(progress_bar)
+        with progress_context as progress_bar:
             self.progress_bar = progress_bar
-            progress_bar.task = progress_bar.add_task(
+            self.task = progress_bar.add_task(
                 "[green] MLIR compilation:", total=1, command="1 Worker"
             )
 
@@ -1074,9 +1208,12 @@ class FlowRunner:
                 self.mlir_module_str,
                 file_with_addresses,
                 self.opts.verbose,
+                self.opts.bytecode,
             )
 
-            cores = generate_cores_list(await read_file_async(file_with_addresses))
+            cores = generate_cores_list(
+                await read_file_async(file_with_addresses, binary=True)
+            )
             t = do_run(
                 [
                     "aie-translate",
@@ -1098,9 +1235,10 @@ class FlowRunner:
             if opts.npu or opts.only_npu:
                 generated_insts_mlir = self.prepend_tmp("generated_npu_insts.mlir")
                 await self.do_call(
-                    progress_bar.task,
+                    self.task,
                     [
                         "aie-opt",
+                        *self.emit_flags(),
                         f"--pass-pipeline={DMA_TO_NPU}",
                         file_with_addresses,
                         "-o",
@@ -1108,13 +1246,13 @@ class FlowRunner:
                     ],
                 )
                 await self.do_call(
-                    progress_bar.task,
+                    self.task,
                     [
                         "aie-translate",
                         "--aie-npu-instgen",
                         generated_insts_mlir,
                         "-o",
-                        opts.insts_name,
+                        self.opts.insts_name,
                     ],
                 )
                 if opts.only_npu:
@@ -1123,23 +1261,23 @@ class FlowRunner:
             # fmt: off
             if opts.unified:
                 file_opt_with_addresses = self.prepend_tmp("input_opt_with_addresses.mlir")
-                await self.do_call(progress_bar.task, ["aie-opt", f"--pass-pipeline={AIE_LOWER_TO_LLVM()}", file_with_addresses, "-o", file_opt_with_addresses])
+                await self.do_call(self.task, ["aie-opt", *self.emit_flags(), f"--pass-pipeline={AIE_LOWER_TO_LLVM()}", file_with_addresses, "-o", file_opt_with_addresses])
 
                 file_llvmir = self.prepend_tmp("input.ll")
-                await self.do_call(progress_bar.task, ["aie-translate", "--mlir-to-llvmir", file_opt_with_addresses, "-o", file_llvmir])
+                await self.do_call(self.task, ["aie-translate", "--mlir-to-llvmir", file_opt_with_addresses, "-o", file_llvmir])
 
                 self.unified_file_core_obj = self.prepend_tmp("input.o")
                 if opts.compile and opts.xchesscc:
-                    file_llvmir_hacked = await self.chesshack(progress_bar.task, file_llvmir, aie_target)
-                    await self.do_call(progress_bar.task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_llvmir_hacked, "-o", self.unified_file_core_obj])
+                    file_llvmir_hacked = await self.chesshack(self.task, file_llvmir, aie_target)
+                    await self.do_cached_call(self.task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_llvmir_hacked, "-o", self.unified_file_core_obj], [file_llvmir_hacked], [self.unified_file_core_obj])
                 elif opts.compile:
                     file_llvmir_opt = self.prepend_tmp("input.opt.ll")
-                    await self.do_call(progress_bar.task, [self.peano_opt_path, "--passes=default<O2>", "-inline-threshold=10", "-S", file_llvmir, "-o", file_llvmir_opt])
-                    await self.do_call(progress_bar.task, [self.peano_llc_path, file_llvmir_opt, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", self.unified_file_core_obj])
+                    await self.do_cached_call(self.task, [self.peano_opt_path, "--passes=default<O2>", "-inline-threshold=10", "-S", file_llvmir, "-o", file_llvmir_opt], [file_llvmir], [file_llvmir_opt])
+                    await self.do_cached_call(self.task, [self.peano_llc_path, file_llvmir_opt, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", self.unified_file_core_obj], [file_llvmir_opt], [self.unified_file_core_obj])
             # fmt: on
 
-            progress_bar.update(progress_bar.task, advance=0, visible=False)
-            progress_bar.task_completed = progress_bar.add_task(
+            progress_bar.update(self.task, advance=0, visible=False)
+            self.task_completed = progress_bar.add_task(
                 "[green] AIE Compilation:",
                 total=len(cores) + 1,
                 command="%d Workers" % nworkers,
@@ -1151,7 +1289,7 @@ class FlowRunner:
             )  # ensure that process_host_cgen finishes before running gen_sim
             processes = []
             if opts.aiesim:
-                processes.append(self.gen_sim(progress_bar.task, aie_target))
+                processes.append(self.gen_sim(self.task, aie_target))
             for core in cores:
                 processes.append(
                     self.process_core(
@@ -1250,11 +1388,106 @@ def run(mlir_module, args=None):
     if opts.verbose:
         print("created temporary directory", tmpdirname)
 
-    runner = FlowRunner(str(mlir_module), opts, tmpdirname)
-    asyncio.run(runner.run_flow())
+    if opts.clear_cache:
+        CompilationCache(opts.cache_dir).clear()
+
+    runners = []
+    for name, module_str in split_devices(
+        serialize_module(mlir_module, opts.bytecode), opts.bytecode
+    ):
+        if name is None:
+            runner = FlowRunner(module_str, opts, tmpdirname)
+        else:
+            # Every device gets its own project directory, which also holds
+            # its ELFs, and its own output files, prefixed with its name.
+            device_tmpdirname = os.path.join(tmpdirname, name)
+            os.makedirs(device_tmpdirname, exist_ok=True)
+            device_opts = copy.copy(opts)
+            device_opts.insts_name = prefix_basename(name, opts.insts_name)
+            device_opts.xclbin_name = prefix_basename(name, opts.xclbin_name)
+            runner = FlowRunner(
+                module_str, device_opts, device_tmpdirname, device_tmpdirname
+            )
+        runners.append(runner)
+
+    async def run_flows():
+        # The devices are compiled at the same time, sharing the workers.
+        limit = asyncio.Semaphore(worker_count())
+        with make_progress_bar() as progress_bar:
+            await asyncio.gather(
+                *(runner.run_flow(progress_bar, limit) for runner in runners)
+            )
+
+    asyncio.run(run_flows())
+
+    for runner in runners:
+        if opts.profiling:
+            runner.dumpprofile()
+        if opts.verbose and runner.cache.enabled:
+            print(runner.cache.summary())
+
+    if opts.cache and opts.cache_max_size:
+        CompilationCache(opts.cache_dir, verbose=opts.verbose).trim(
+            opts.cache_max_size
+        )
+
+
+def worker_count():
+    nworkers = int(opts.nthreads)
+    return nworkers if nworkers != 0 else os.cpu_count()
+
+
+def make_progress_bar():
+    return progress.Progress(
+        *progress.Progress.get_default_columns(),
+        progress.TimeElapsedColumn(),
+        progress.MofNCompleteColumn(),
+        progress.TextColumn("{task.fields[command]}"),
+        redirect_stdout=False,
+        redirect_stderr=False,
+    )
+
+
+def prefix_basename(prefix, path):
+    dirname, basename = os.path.split(path)
+    return os.path.join(dirname, f"{prefix}_{basename}")
 
-    if opts.profiling:
-        runner.dumpprofile()
+
+def split_devices(mlir_module_str, bytecode=False):
+    """Splits a module with several aie.device ops into one module per device,
+    named like DeviceOp::getArtifactName. A module with a single device is
+    returned unchanged, without a name."""
+
+    def devices_of(module):
+        return find_ops(
+            module.operation,
+            lambda o: isinstance(o.operation.opview, aiedialect.DeviceOp),
+        )
+
+    with Context(), Location.unknown():
+        devices = devices_of(Module.parse(mlir_module_str))
+        if len(devices) <= 1:
+            return [(None, mlir_module_str)]
+        taken = {d.sym_name.value for d in devices if d.sym_name is not None}
+        names = []
+        for i, d in enumerate(devices):
+            if d.sym_name is not None:
+                names.append(d.sym_name.value)
+                continue
+            name = f"device{i}"
+            while name in taken:
+                name += "_"
+            names.append(name)
+
+    modules = []
+    for index, name in enumerate(names):
+        with Context(), Location.unknown():
+            module = Module.parse(mlir_module_str)
+            for i, device in enumerate(devices_of(module)):
+                if i != index:
+                    device.operation.erase()
+            modules.append((name, serialize_module(module, bytecode)))
+    return modules
 
 
 def main():
@@ -1266,14 +1499,17 @@ def main():
         sys.exit(0)
 
     if opts.filename is None:
+        if opts.clear_cache:
+            CompilationCache(opts.cache_dir).clear()
+            sys.exit(0)
         print("error: the 'file' positional argument is required.")
         sys.exit(1)
 
     try:
         with Context() as ctx, Location.unknown():
-            with open(opts.filename, "r") as f:
+            with open(opts.filename, "rb") as f:
                 module = Module.parse(f.read())
-            module_str = str(module)
+            module_str = serialize_module(module, opts.bytecode)
     except Exception as e:
         print(e)
         sys.exit(1)
@@ -25,10 +25,12 @@ from array import array
 
 # noinspection PyUnresolvedReferences
 from .._mlir_libs._aie import (
+    Compilation,
     ObjectFifoSubviewType,
     ObjectFifoType,
     get_target_model,
     aie_llvm_link,
+    decode_trace,
     generate_bcf,
     generate_cdo,
     generate_xaie,
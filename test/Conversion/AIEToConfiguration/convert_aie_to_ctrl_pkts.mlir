@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt -convert-aie-to-control-packets="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/" %s | FileCheck %s
+// RUN: aie-opt -convert-aie-to-control-packets="elf-dir=%S/convert_aie_to_ctrl_pkts_elfs/ batch=true" %s | FileCheck %s --check-prefix=BATCH
 
 // CHECK-label: aiex.runtime_sequence @configure
 // CHECK-COUNT-5: aiex.control_packet {address = {{.*}} : ui32, data = array<i32: {{.*}}>
@@ -16,6 +17,11 @@
 // CHECK: aiex.control_packet {address = {{.*}} : ui32, data = array<i32: {{.*}}>
 // CHECK-COUNT-36: aiex.control_packet {address = {{.*}} : ui32, data = array<i32: {{.*}}, {{.*}}, {{.*}}, {{.*}}>
 // CHECK-COUNT-22: aiex.control_packet {address = {{.*}} : ui32, data = array<i32: {{.*}}>
+
+// BATCH-LABEL: aiex.runtime_sequence @configure
+// BATCH: aiex.control_packet {address = {{.*}} : ui32, data = array<i32: {{.*}}, {{.*}}, {{.*}}, {{.*}}>
+// BATCH: aiex.control_packet {address = 2301952 : ui32, data = array<i32: {{.*}}>
+
 aie.device(npu1_1col) {
   %12 = aie.tile(0, 2)
   %buf = aie.buffer(%12) : memref<256xi32>
@@ -0,0 +1,37 @@
+//===- convert_aie_to_ctrl_pkts_batch.mlir ---------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -convert-aie-to-control-packets %s | FileCheck %s
+// RUN: aie-opt -convert-aie-to-control-packets="batch=true" %s | FileCheck %s --check-prefix=BATCH
+
+// The buffer initializers of tile (0, 2) are written to consecutive
+// addresses. Batching packs the tail of @a and all of @b into one packet and
+// puts the packet of tile (0, 3) between the two packets of tile (0, 2).
+
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK:      aiex.control_packet {address = 2098176 : ui32, data = array<i32: 1, 2, 3, 4>
+// CHECK-NEXT: aiex.control_packet {address = 2098192 : ui32, data = array<i32: 5, 6>
+// CHECK-NEXT: aiex.control_packet {address = 2098200 : ui32, data = array<i32: 7, 8>
+// CHECK-NEXT: aiex.control_packet {address = 3146752 : ui32, data = array<i32: 9, 10, 11>
+// CHECK-NOT:  aiex.control_packet
+
+// BATCH-LABEL: aiex.runtime_sequence @configure
+// BATCH:      aiex.control_packet {address = 2098176 : ui32, data = array<i32: 1, 2, 3, 4>
+// BATCH-NEXT: aiex.control_packet {address = 3146752 : ui32, data = array<i32: 9, 10, 11>
+// BATCH-NEXT: aiex.control_packet {address = 2098192 : ui32, data = array<i32: 5, 6, 7, 8>
+// BATCH-NOT:  aiex.control_packet
+
+aie.device(npu1_1col) {
+  %02 = aie.tile(0, 2)
+  %03 = aie.tile(0, 3)
+  %a = aie.buffer(%02) {address = 1024 : i32, sym_name = "a"} : memref<6xi32> = dense<[1, 2, 3, 4, 5, 6]>
+  %b = aie.buffer(%02) {address = 1048 : i32, sym_name = "b"} : memref<2xi32> = dense<[7, 8]>
+  %c = aie.buffer(%03) {address = 1024 : i32, sym_name = "c"} : memref<3xi32> = dense<[9, 10, 11]>
+}
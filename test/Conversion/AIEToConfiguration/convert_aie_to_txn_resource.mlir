@@ -0,0 +1,39 @@
+//===- convert_aie_to_txn_resource.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -convert-aie-to-transaction %s | FileCheck %s --check-prefix=TXN
+// RUN: aie-opt -convert-aie-to-control-packets %s | FileCheck %s --check-prefix=CTRL
+
+// The 1024-word initializer of @big is written with a blockwrite whose payload
+// is a dense resource blob, while the payload of @small stays a dense array.
+
+// TXN:      memref.global "private" constant @blockwrite_data : memref<1024xi32> = dense_resource<blockwrite_data>
+// TXN:      memref.global "private" constant @blockwrite_data_0 : memref<2xi32> = dense<[8, 9]>
+// TXN:      aiex.runtime_sequence @configure
+// TXN:        %[[BIG:.*]] = memref.get_global @blockwrite_data : memref<1024xi32>
+// TXN-NEXT:   aiex.npu.blockwrite(%[[BIG]]) {address = 2098176 : ui32} : memref<1024xi32>
+// TXN:        %[[SMALL:.*]] = memref.get_global @blockwrite_data_0 : memref<2xi32>
+// TXN-NEXT:   aiex.npu.blockwrite(%[[SMALL]]) {address = 2102272 : ui32} : memref<2xi32>
+// TXN:      dialect_resources
+// TXN:        blockwrite_data: "0x04000000{{(07000000)+}}"
+
+// The control packets read the blob back in 4-word packets.
+
+// CTRL:          memref.global "private" constant @blockwrite_data : memref<1024xi32> = dense_resource<blockwrite_data>
+// CTRL:          aiex.runtime_sequence @configure
+// CTRL-NEXT:       aiex.control_packet {address = 2098176 : ui32, data = array<i32: 7, 7, 7, 7>
+// CTRL-COUNT-255:  aiex.control_packet {address = {{[0-9]+}} : ui32, data = array<i32: 7, 7, 7, 7>
+// CTRL-NEXT:       aiex.control_packet {address = 2102272 : ui32, data = array<i32: 8, 9>
+
+aie.device(npu1_1col) {
+  %02 = aie.tile(0, 2)
+  %big = aie.buffer(%02) {address = 1024 : i32, sym_name = "big"} : memref<1024xi32> = dense<7>
+  %small = aie.buffer(%02) {address = 5120 : i32, sym_name = "small"} : memref<2xi32> = dense<[8, 9]>
+}
@@ -0,0 +1,30 @@
+// RUN: aie-opt %s -convert-vector-to-aievec="aie-target=aie2p target-backend=llvmir" \
+// RUN:   -convert-aievec-to-llvm="aie-target=aie2p" -convert-vector-to-llvm \
+// RUN:   -convert-arith-to-llvm -convert-func-to-llvm \
+// RUN:   -reconcile-unrealized-casts | aie-translate -mlir-to-llvmir \
+// RUN:   | FileCheck %s
+
+// Elementwise code lowers all the way to LLVM IR for AIE2P, through the
+// generic LLVM vector operations rather than AIE2 intrinsics.
+
+// CHECK-LABEL: define { <16 x bfloat>, <16 x i32> } @elementwise(
+// CHECK-NOT:    llvm.aie2.
+// CHECK:        fpext <16 x bfloat> %{{.*}} to <16 x float>
+// CHECK:        fmul <16 x float>
+// CHECK:        fadd <16 x float>
+// CHECK:        call <16 x float> @llvm.maximum.v16f32(
+// CHECK:        fptrunc <16 x float> %{{.*}} to <16 x bfloat>
+// CHECK:        add <16 x i32>
+// CHECK-NOT:    llvm.aie2.
+// CHECK:        ret
+func.func @elementwise(%a : vector<16xbf16>, %b : vector<16xf32>,
+                       %c : vector<16xi32>)
+    -> (vector<16xbf16>, vector<16xi32>) {
+  %0 = arith.extf %a : vector<16xbf16> to vector<16xf32>
+  %1 = arith.mulf %0, %b : vector<16xf32>
+  %2 = arith.addf %1, %b : vector<16xf32>
+  %3 = arith.maximumf %2, %b : vector<16xf32>
+  %4 = arith.truncf %3 : vector<16xf32> to vector<16xbf16>
+  %5 = arith.addi %c, %c : vector<16xi32>
+  return %4, %5 : vector<16xbf16>, vector<16xi32>
+}
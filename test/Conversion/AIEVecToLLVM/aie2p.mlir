@@ -0,0 +1,109 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm="aie-target=aie2p" | FileCheck %s
+
+func.func @matmul(%A : vector<8x8xbf16>, %B : vector<8x8xbf16>,
+                  %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  %0 = aievec.matmul_aie2p %A, %B, %C : vector<8x8xbf16>, vector<8x8xbf16>
+                                        into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
+
+// CHECK-LABEL: @matmul
+// CHECK-SAME: %[[A:.*]]: vector<8x8xbf16>
+// CHECK-SAME: %[[B:.*]]: vector<8x8xbf16>
+// CHECK-SAME: %[[C:.*]]: vector<8x8xf32>
+// CHECK:      %[[FA:.*]] = vector.shape_cast %[[A]] :
+// CHECK-SAME:                      vector<8x8xbf16> to vector<64xbf16>
+// CHECK:      %[[FB:.*]] = vector.shape_cast %[[B]] :
+// CHECK-SAME:                      vector<8x8xbf16> to vector<64xbf16>
+// CHECK:      %[[FC:.*]] = vector.shape_cast %[[C]] :
+// CHECK-SAME:                      vector<8x8xf32> to vector<64xf32>
+// CHECK:      %[[CONF:.*]] = llvm.mlir.constant(28 : i32) : i32
+// CHECK:      %[[BCACC:.*]] = llvm.bitcast %[[FC]] : vector<64xf32> to vector<32xi64>
+// CHECK:      %[[RACC:.*]] = "xllvm.intr.aie2p.I1024.I1024.ACC2048.bf.mac.conf"(
+// CHECK-SAME:         %[[FA]], %[[FB]], %[[BCACC]], %[[CONF]]) :
+// CHECK-SAME:         (vector<64xbf16>, vector<64xbf16>, vector<32xi64>, i32)
+// CHECK-SAME:         -> vector<32xi64>
+// CHECK:      %[[BCR:.*]] = llvm.bitcast %[[RACC]] : vector<32xi64> to vector<64xf32>
+// CHECK:      %[[R:.*]] = vector.shape_cast %[[BCR]] :
+// CHECK-SAME:                      vector<64xf32> to vector<8x8xf32>
+// CHECK:      return %[[R]] : vector<8x8xf32>
+
+// -----
+
+func.func @matmul(%A : vector<8x8xi8>, %B : vector<8x8xi8>,
+                  %C : vector<8x8xi32>) -> vector<8x8xi32> {
+  %0 = aievec.matmul_aie2p %A, %B, %C : vector<8x8xi8>, vector<8x8xi8>
+                                        into vector<8x8xi32>
+  return %0 : vector<8x8xi32>
+}
+
+// CHECK-LABEL: @matmul
+// CHECK-SAME: %[[A:.*]]: vector<8x8xi8>
+// CHECK-SAME: %[[B:.*]]: vector<8x8xi8>
+// CHECK-SAME: %[[C:.*]]: vector<8x8xi32>
+// CHECK:      %[[FA:.*]] = vector.shape_cast %[[A]] :
+// CHECK-SAME:                      vector<8x8xi8> to vector<64xi8>
+// CHECK:      %[[FB:.*]] = vector.shape_cast %[[B]] :
+// CHECK-SAME:                      vector<8x8xi8> to vector<64xi8>
+// CHECK:      %[[FC:.*]] = vector.shape_cast %[[C]] :
+// CHECK-SAME:                      vector<8x8xi32> to vector<64xi32>
+// CHECK:      %[[CONF:.*]] = llvm.mlir.constant(776 : i32) : i32
+// CHECK:      %[[BCB:.*]] = llvm.bitcast %[[FB]] : vector<64xi8> to vector<16xi32>
+// CHECK:      %[[BCC:.*]] = llvm.bitcast %[[FC]] : vector<64xi32> to vector<32xi64>
+// CHECK:      %[[RACC:.*]] =
+// CHECK-SAME:         "xllvm.intr.aie2p.I512.I512.ACC2048.acc32.mac.conf"(
+// CHECK-SAME:           %[[FA]], %[[BCB]], %[[BCC]], %[[CONF]]) :
+// CHECK-SAME:           (vector<64xi8>, vector<16xi32>, vector<32xi64>, i32)
+// CHECK-SAME:           -> vector<32xi64>
+// CHECK:      %[[BCR:.*]] = llvm.bitcast %[[RACC]] : vector<32xi64> to vector<64xi32>
+// CHECK:      %[[R:.*]] = vector.shape_cast %[[BCR]] :
+// CHECK-SAME:                      vector<64xi32> to vector<8x8xi32>
+// CHECK:      return %[[R]] : vector<8x8xi32>
+
+// -----
+
+func.func @matmul(%A : vector<8x16xf8E5M2>, %B : vector<16x8xf8E5M2>,
+                  %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  %0 = aievec.matmul_aie2p %A, %B, %C : vector<8x16xf8E5M2>,
+                                        vector<16x8xf8E5M2>
+                                        into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
+
+// CHECK-LABEL: @matmul
+// CHECK:      %[[CONF:.*]] = llvm.mlir.constant(36 : i32) : i32
+// CHECK:      "xllvm.intr.aie2p.I1024.I1024.ACC2048.fp8.mac.conf"(
+// CHECK-SAME:           (vector<128xi8>, vector<128xi8>, vector<32xi64>, i32)
+// CHECK-SAME:           -> vector<32xi64>
+
+// -----
+
+// CHECK-LABEL: @shuffle
+// CHECK-SAME: %[[LHS:.*]]: vector<16xi32>
+func.func @shuffle(%lhs : vector<16xi32>) -> vector<16xi32> {
+  // CHECK: %[[RHS:.*]] = "xllvm.intr.aie2p.v16int32"() : () -> vector<16xi32>
+  // CHECK: %[[M:.*]] = llvm.mlir.constant(48 : i32) : i32
+  // CHECK: %[[R:.*]] = "xllvm.intr.aie2p.vshuffle"(%[[LHS]], %[[RHS]], %[[M]]) :
+  // CHECK-SAME:         (vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+  %0 = aievec.shuffle %lhs [t32_2x8] : vector<16xi32>
+  // CHECK: return %[[R]] : vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// -----
+
+// CHECK-LABEL: @ups_srs_bf16
+// CHECK-SAME: %[[V:.*]]: vector<64xbf16>
+func.func @ups_srs_bf16(%v : vector<64xbf16>) -> vector<64xbf16> {
+  %c0 = arith.constant 0 : i32
+  // CHECK: %[[A:.*]] = "xllvm.intr.aie2p.v64bf16.to.v64accfloat"(%[[V]]) :
+  // CHECK-SAME:         (vector<64xbf16>) -> vector<32xi64>
+  // CHECK: %[[F:.*]] = llvm.bitcast %[[A]] : vector<32xi64> to vector<64xf32>
+  %0 = aievec.ups %v {shift = 0 : i8} : vector<64xbf16>, vector<64xf32>
+  // CHECK: %[[B:.*]] = llvm.bitcast %[[F]] : vector<64xf32> to vector<32xi64>
+  // CHECK: %[[R:.*]] = "xllvm.intr.aie2p.v64accfloat.to.v64bf16"(%[[B]]) :
+  // CHECK-SAME:         (vector<32xi64>) -> vector<64xbf16>
+  %1 = aievec.srs %0, %c0 : vector<64xf32>, i32, vector<64xbf16>
+  // CHECK: return %[[R]] : vector<64xbf16>
+  return %1 : vector<64xbf16>
+}
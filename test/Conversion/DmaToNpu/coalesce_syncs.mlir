@@ -0,0 +1,199 @@
+//===- coalesce_syncs.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file -aie-dma-to-npu -aie-coalesce-npu-syncs %s | FileCheck %s
+
+// Waits on the same channel of neighbouring columns become one sync.
+
+// CHECK-LABEL: aiex.runtime_sequence @adjacent_columns
+// CHECK: aiex.npu.sync
+// CHECK-SAME: column = 0 : i32
+// CHECK-SAME: column_num = 3 : i32
+// CHECK-NOT: aiex.npu.sync
+module  {
+  aie.device(npu1_4col) {
+    memref.global "public" @out0 : memref<16xi32>
+    memref.global "public" @out1 : memref<16xi32>
+    memref.global "public" @out2 : memref<16xi32>
+    aiex.runtime_sequence @adjacent_columns(%arg0: memref<16xi32>, %arg1: memref<16xi32>, %arg2: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out1, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg2[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out2, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out2}
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_wait {symbol = @out1}
+    }
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+    aie.shim_dma_allocation @out1 (S2MM, 0, 1)
+    aie.shim_dma_allocation @out2 (S2MM, 0, 2)
+  }
+}
+
+// -----
+
+// Different channels and non-adjacent columns are kept apart.
+
+// CHECK-LABEL: aiex.runtime_sequence @not_adjacent
+// CHECK: aiex.npu.sync
+// CHECK-SAME: channel = 0 : i32
+// CHECK-SAME: column = 0 : i32
+// CHECK-SAME: column_num = 1 : i32
+// CHECK: aiex.npu.sync
+// CHECK-SAME: channel = 1 : i32
+// CHECK-SAME: column = 1 : i32
+// CHECK-SAME: column_num = 1 : i32
+// CHECK: aiex.npu.sync
+// CHECK-SAME: channel = 0 : i32
+// CHECK-SAME: column = 2 : i32
+// CHECK-SAME: column_num = 1 : i32
+module  {
+  aie.device(npu1_4col) {
+    memref.global "public" @out0 : memref<16xi32>
+    memref.global "public" @out1 : memref<16xi32>
+    memref.global "public" @out2 : memref<16xi32>
+    aiex.runtime_sequence @not_adjacent(%arg0: memref<16xi32>, %arg1: memref<16xi32>, %arg2: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out1, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg2[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out2, id = 0 : i64 } : memref<16xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_wait {symbol = @out1}
+      aiex.npu.dma_wait {symbol = @out2}
+    }
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+    aie.shim_dma_allocation @out1 (S2MM, 1, 1)
+    aie.shim_dma_allocation @out2 (S2MM, 0, 2)
+  }
+}
+
+// -----
+
+// The first wait is implied by the second one: its sync is removed and the
+// first task no longer issues a token (bit 31 of the queue write).
+
+// CHECK-LABEL: aiex.runtime_sequence @redundant
+// CHECK: aiex.npu.write32
+// CHECK-SAME: address = 119300 : ui32
+// CHECK-SAME: value = 0 : ui32
+// CHECK-NOT: aiex.npu.sync
+// CHECK: aiex.npu.write32
+// CHECK-SAME: address = 119300 : ui32
+// CHECK-SAME: value = 2147483649 : ui32
+// CHECK: aiex.npu.sync
+// CHECK-NOT: aiex.npu.sync
+module  {
+  aie.device(npu1_4col) {
+    memref.global "public" @out0 : memref<16xi32>
+    aiex.runtime_sequence @redundant(%arg0: memref<32xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 16][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 1 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+    }
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+  }
+}
+
+// -----
+
+// Reusing the buffer descriptor of the task that is waited for keeps the wait.
+
+// CHECK-LABEL: aiex.runtime_sequence @bd_reuse
+// CHECK: aiex.npu.sync
+// CHECK: aiex.npu.sync
+module  {
+  aie.device(npu1_4col) {
+    memref.global "public" @out0 : memref<16xi32>
+    aiex.runtime_sequence @bd_reuse(%arg0: memref<32xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 16][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+    }
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+  }
+}
+
+// -----
+
+// Writes to other tiles between the waits keep both waits.
+
+// CHECK-LABEL: aiex.runtime_sequence @rtp_between
+// CHECK: aiex.npu.sync
+// CHECK: aiex.npu.write32
+// CHECK: aiex.npu.sync
+module  {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %rtp = aie.buffer(%tile_0_2) {address = 1536 : i32, sym_name = "rtp"} : memref<16xi32>
+    memref.global "public" @out0 : memref<16xi32>
+    aiex.runtime_sequence @rtp_between(%arg0: memref<32xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.rtp_write(@rtp, 0, 1)
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 16][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 1 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+    }
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+  }
+}
+
+// -----
+
+// The MM2S task between the waits reads the buffer the first S2MM task writes.
+// It runs in another queue, so the first wait keeps it from reading the buffer
+// before the write lands.
+
+// CHECK-LABEL: aiex.runtime_sequence @read_after_write
+// CHECK: aiex.npu.sync
+// CHECK: aiex.npu.write32
+// CHECK-SAME: address = 119316 : ui32
+// CHECK: aiex.npu.sync
+module  {
+  aie.device(npu1_4col) {
+    memref.global "public" @in0 : memref<16xi32>
+    memref.global "public" @out0 : memref<16xi32>
+    aiex.runtime_sequence @read_after_write(%arg0: memref<32xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in0, id = 1 : i64 } : memref<32xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 16][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 2 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+    }
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+  }
+}
+
+// -----
+
+// A task in another queue that uses another runtime sequence argument does
+// not keep the first wait.
+
+// CHECK-LABEL: aiex.runtime_sequence @other_argument
+// CHECK-NOT: aiex.npu.sync
+// CHECK: aiex.npu.write32
+// CHECK-SAME: address = 119316 : ui32
+// CHECK: aiex.npu.sync
+// CHECK-NOT: aiex.npu.sync
+module  {
+  aie.device(npu1_4col) {
+    memref.global "public" @in0 : memref<16xi32>
+    memref.global "public" @out0 : memref<16xi32>
+    aiex.runtime_sequence @other_argument(%arg0: memref<16xi32>, %arg1: memref<32xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 0 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @in0, id = 1 : i64 } : memref<16xi32>
+      aiex.npu.dma_memcpy_nd (0, 0, %arg1[0, 0, 0, 16][1, 1, 1, 16][0, 0, 0, 1]) { metadata = @out0, id = 2 : i64 } : memref<32xi32>
+      aiex.npu.dma_wait {symbol = @out0}
+    }
+    aie.shim_dma_allocation @in0 (MM2S, 0, 0)
+    aie.shim_dma_allocation @out0 (S2MM, 0, 0)
+  }
+}
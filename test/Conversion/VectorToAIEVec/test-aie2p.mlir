@@ -0,0 +1,119 @@
+// RUN: aie-opt %s -split-input-file -convert-vector-to-aievec="aie-target=aie2p target-backend=llvmir" | FileCheck %s
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func.func @contractbf16bf16f32(
+// CHECK-SAME: %[[A:[a-zA-Z0-9]+]]: vector<8x8xbf16>,
+// CHECK-SAME: %[[B:[a-zA-Z0-9]+]]: vector<8x8xbf16>,
+// CHECK-SAME: %[[C:[a-zA-Z0-9]+]]: vector<8x8xf32>) -> vector<8x8xf32> {
+// CHECK:        %[[MM:.*]] = aievec.matmul_aie2p %[[A]], %[[B]], %[[C]] :
+// CHECK-SAME:   vector<8x8xbf16>, vector<8x8xbf16> into vector<8x8xf32>
+// CHECK:        return %[[MM]] : vector<8x8xf32>
+func.func @contractbf16bf16f32(%A : vector<8x8xbf16>,
+                               %B : vector<8x8xbf16>,
+                               %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  %0 = vector.contract {indexing_maps = [#map1, #map2, #map3],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %B, %C :
+                        vector<8x8xbf16>, vector<8x8xbf16> into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
+
+// -----
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func.func @contracti8i8i32(
+// CHECK-SAME: %[[A:[a-zA-Z0-9]+]]: vector<8x8xi8>,
+// CHECK-SAME: %[[B:[a-zA-Z0-9]+]]: vector<8x8xi8>,
+// CHECK-SAME: %[[C:[a-zA-Z0-9]+]]: vector<8x8xi32>) -> vector<8x8xi32> {
+// CHECK:        %[[MM:.*]] = aievec.matmul_aie2p %[[A]], %[[B]], %[[C]] :
+// CHECK-SAME:   vector<8x8xi8>, vector<8x8xi8> into vector<8x8xi32>
+// CHECK:        return %[[MM]] : vector<8x8xi32>
+func.func @contracti8i8i32(%A : vector<8x8xi8>,
+                           %B : vector<8x8xi8>,
+                           %C : vector<8x8xi32>) -> vector<8x8xi32> {
+  %0 = arith.extsi %A : vector<8x8xi8> to vector<8x8xi32>
+  %1 = arith.extsi %B : vector<8x8xi8> to vector<8x8xi32>
+  %2 = vector.contract {indexing_maps = [#map1, #map2, #map3],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %C :
+                        vector<8x8xi32>, vector<8x8xi32> into vector<8x8xi32>
+  return %2 : vector<8x8xi32>
+}
+
+// -----
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func.func @contractf8f8f32(
+// CHECK:        aievec.matmul_aie2p %{{.*}}, %{{.*}}, %{{.*}} :
+// CHECK-SAME:   vector<8x16xf8E4M3FN>, vector<16x8xf8E4M3FN> into vector<8x8xf32>
+func.func @contractf8f8f32(%A : vector<8x16xf8E4M3FN>,
+                           %B : vector<16x8xf8E4M3FN>,
+                           %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  %0 = vector.contract {indexing_maps = [#map1, #map2, #map3],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %B, %C :
+                        vector<8x16xf8E4M3FN>, vector<16x8xf8E4M3FN>
+                        into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @transpose_aie2p_modes(
+// CHECK-SAME: %[[V0:.*]]: vector<8x2xi32>,
+// CHECK-SAME: %[[V1:.*]]: vector<2x8xi32>,
+// CHECK-SAME: %[[V2:.*]]: vector<4x2xi64>
+func.func @transpose_aie2p_modes(%v0 : vector<8x2xi32>,
+                                 %v1 : vector<2x8xi32>,
+                                 %v2 : vector<4x2xi64>)
+    -> (vector<2x8xi32>, vector<8x2xi32>, vector<2x4xi64>) {
+  // CHECK: %[[FV0:.*]] = vector.shape_cast %[[V0]] : vector<8x2xi32> to vector<16xi32>
+  // CHECK: %[[FR0:.*]] = aievec.shuffle %[[FV0]] [t32_8x2] : vector<16xi32>
+  // CHECK: vector.shape_cast %[[FR0]] : vector<16xi32> to vector<2x8xi32>
+  %v0t = vector.transpose %v0, [1, 0] : vector<8x2xi32> to vector<2x8xi32>
+  // CHECK: %[[FV1:.*]] = vector.shape_cast %[[V1]] : vector<2x8xi32> to vector<16xi32>
+  // CHECK: %[[FR1:.*]] = aievec.shuffle %[[FV1]] [t32_2x8] : vector<16xi32>
+  // CHECK: vector.shape_cast %[[FR1]] : vector<16xi32> to vector<8x2xi32>
+  %v1t = vector.transpose %v1, [1, 0] : vector<2x8xi32> to vector<8x2xi32>
+  // CHECK: %[[FV2:.*]] = vector.shape_cast %[[V2]] : vector<4x2xi64> to vector<8xi64>
+  // CHECK: %[[FR2:.*]] = aievec.shuffle %[[FV2]] [t64_4x2] : vector<8xi64>
+  // CHECK: vector.shape_cast %[[FR2]] : vector<8xi64> to vector<2x4xi64>
+  %v2t = vector.transpose %v2, [1, 0] : vector<4x2xi64> to vector<2x4xi64>
+  return %v0t, %v1t, %v2t : vector<2x8xi32>, vector<8x2xi32>, vector<2x4xi64>
+}
+
+// -----
+
+// The elementwise aievec ops of AIE2 have no AIE2P lowering, so elementwise
+// operations stay in the vector and arith dialects.
+
+// CHECK-LABEL: func.func @elementwise(
+// CHECK-NOT:    aievec.
+// CHECK:        arith.extf %{{.*}} : vector<16xbf16> to vector<16xf32>
+// CHECK:        arith.mulf %{{.*}}, %{{.*}} : vector<16xf32>
+// CHECK:        arith.addf %{{.*}}, %{{.*}} : vector<16xf32>
+// CHECK:        arith.maximumf %{{.*}}, %{{.*}} : vector<16xf32>
+// CHECK:        arith.truncf %{{.*}} : vector<16xf32> to vector<16xbf16>
+// CHECK:        arith.addi %{{.*}}, %{{.*}} : vector<16xi32>
+// CHECK-NOT:    aievec.
+// CHECK:        return
+func.func @elementwise(%a : vector<16xbf16>, %b : vector<16xf32>,
+                       %c : vector<16xi32>)
+    -> (vector<16xbf16>, vector<16xi32>) {
+  %0 = arith.extf %a : vector<16xbf16> to vector<16xf32>
+  %1 = arith.mulf %0, %b : vector<16xf32>
+  %2 = arith.addf %1, %b : vector<16xf32>
+  %3 = arith.maximumf %2, %b : vector<16xf32>
+  %4 = arith.truncf %3 : vector<16xf32> to vector<16xbf16>
+  %5 = arith.addi %c, %c : vector<16xi32>
+  return %4, %5 : vector<16xbf16>, vector<16xi32>
+}
@@ -0,0 +1,121 @@
+//===- cdo_buffers.cpp ------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Targets/AIETargets.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Parser/Parser.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+using namespace xilinx;
+
+static const char *design = R"mlir(
+module {
+  aie.device(npu1_2col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_1_0 = aie.tile(1, 0)
+    %buf = aie.buffer(%tile_0_1) {address = 0 : i32, mem_bank = 0 : i32, sym_name = "buf"} : memref<8xi32> = dense<[234, 1, 2, 3, 4, 5, 6, 7]>
+    aie.flow(%tile_0_0, DMA : 0, %tile_1_0, DMA : 0)
+  }
+}
+)mlir";
+
+static uint32_t readWord(const std::vector<uint8_t> &data, size_t idx) {
+  uint32_t word;
+  std::memcpy(&word, data.data() + 4 * idx, 4);
+  return word;
+}
+
+void test() {
+  mlir::MLIRContext context;
+  context.loadDialect<AIE::AIEDialect, AIEX::AIEXDialect,
+                      mlir::memref::MemRefDialect>();
+  auto module = mlir::parseSourceString<mlir::ModuleOp>(design, &context);
+  if (!module)
+    throw std::runtime_error("Failed to parse design");
+  auto device = *module->getOps<AIE::DeviceOp>().begin();
+
+  std::vector<AIE::CDOBinary> reference;
+  if (mlir::failed(AIE::AIETranslateToCDOBuffers(device, "", reference)))
+    throw std::runtime_error("Failed to generate CDO buffers");
+  if (reference.size() != 3 || reference[1].name != "aie_cdo_init.bin")
+    throw std::runtime_error("Unexpected CDO binaries");
+
+  // Header: number of words, "CDO" identifier, version, length, checksum.
+  for (const auto &binary : reference) {
+    if (binary.data.size() < 24 || binary.data.size() % 4)
+      throw std::runtime_error("Truncated CDO binary " + binary.name);
+    uint32_t length = binary.data.size() / 4 - 5;
+    if (readWord(binary.data, 0) != 4 ||
+        readWord(binary.data, 1) != 0x004f4443 ||
+        readWord(binary.data, 3) != length ||
+        readWord(binary.data, 4) != ~(4 + 0x004f4443 + 0x200 + length))
+      throw std::runtime_error("Bad CDO header in " + binary.name);
+  }
+
+  // The commands start with the one-word NOP that bootgen's
+  // insertNoOpCommand(4) wrote, and DMA write payloads start on a 128-bit
+  // boundary of the file, padded with NOPs as the driver did.
+  bool foundDmaWrite = false;
+  for (const auto &binary : reference) {
+    size_t numWords = binary.data.size() / 4;
+    if (numWords < 6 || readWord(binary.data, 5) != 0x111)
+      throw std::runtime_error("Missing leading NOP in " + binary.name);
+    for (size_t idx = 6; idx < numWords;) {
+      uint32_t header = readWord(binary.data, idx);
+      uint32_t length = header >> 16;
+      size_t payload = idx + 1;
+      if (length == 255)
+        length = readWord(binary.data, payload++);
+      if ((header & 0xFFFF) == 0x105) {
+        foundDmaWrite = true;
+        // The payload follows the two address words.
+        if ((payload + 2) % 4)
+          throw std::runtime_error("Misaligned DMA write in " + binary.name);
+      }
+      idx = payload + length;
+    }
+  }
+  if (!foundDmaWrite)
+    throw std::runtime_error("The buffer was not written with a DMA write");
+
+  // Generating the same design from several threads at once gives the same
+  // binaries as generating it alone.
+  constexpr int numThreads = 8;
+  std::vector<std::vector<AIE::CDOBinary>> results(numThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; i++)
+    threads.emplace_back([&, i] {
+      (void)AIE::AIETranslateToCDOBuffers(device, "", results[i]);
+    });
+  for (auto &thread : threads)
+    thread.join();
+  for (const auto &result : results) {
+    if (result.size() != reference.size())
+      throw std::runtime_error("Concurrent generation failed");
+    for (size_t i = 0; i < result.size(); i++)
+      if (result[i].name != reference[i].name ||
+          result[i].data != reference[i].data)
+        throw std::runtime_error("Concurrent generation differs for " +
+                                 reference[i].name);
+  }
+}
+
+int main() {
+  test();
+  return 0;
+}
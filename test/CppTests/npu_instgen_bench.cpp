@@ -0,0 +1,109 @@
+//===- npu_instgen_bench.cpp ------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Times NPU instruction generation for runtime sequences of many ops, and
+// checks the size of what it generates. Takes the numbers of ops to time,
+// e.g. `npu_instgen_bench 100000 1000000`.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Targets/AIETargets.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Parser/Parser.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using namespace xilinx;
+
+// Every group of four ops translates to this many words.
+constexpr size_t payloadWords = 64;
+constexpr size_t groupWords = 3 + 4 + 4 + 3 + payloadWords;
+
+static std::string makeDesign(size_t numGroups) {
+  std::string design;
+  llvm::raw_string_ostream os(design);
+  os << "module {\n  aie.device(npu1_4col) {\n";
+  os << "    memref.global \"private\" constant @payload : memref<"
+     << payloadWords << "xi32> = dense<[";
+  for (size_t i = 0; i < payloadWords; i++)
+    os << (i ? ", " : "") << i;
+  os << "]>\n";
+  os << "    aiex.runtime_sequence(%arg0: memref<16xi32>) {\n";
+  for (size_t i = 0; i < numGroups; i++) {
+    int col = i % 4;
+    os << "      aiex.npu.write32 {address = " << 0x1d000 + 4 * (i % 16)
+       << " : ui32, column = " << col << " : i32, row = 2 : i32, value = "
+       << i << " : ui32}\n";
+    os << "      aiex.npu.maskwrite32 {address = 0x1d200 : ui32, column = "
+       << col << " : i32, mask = 255 : ui32, row = 2 : i32, value = 1 : "
+       << "ui32}\n";
+    os << "      aiex.npu.sync {channel = 0 : i32, column = " << col
+       << " : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : "
+       << "i32, row_num = 1 : i32}\n";
+    os << "      %" << i << " = memref.get_global @payload : memref<"
+       << payloadWords << "xi32>\n";
+    os << "      aiex.npu.blockwrite(%" << i << ") {address = 0x1d000 : ui32,"
+       << " column = " << col << " : i32, row = 2 : i32} : memref<"
+       << payloadWords << "xi32>\n";
+  }
+  os << "    }\n  }\n}\n";
+  return os.str();
+}
+
+static void bench(size_t numOps) {
+  size_t numGroups = numOps / 4;
+  mlir::MLIRContext context;
+  context.loadDialect<AIE::AIEDialect, AIEX::AIEXDialect,
+                      mlir::memref::MemRefDialect>();
+  auto module =
+      mlir::parseSourceString<mlir::ModuleOp>(makeDesign(numGroups), &context);
+  if (!module)
+    throw std::runtime_error("Failed to parse design");
+
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+  std::vector<uint32_t> instructions;
+  if (mlir::failed(AIE::AIETranslateToNPU(*module, instructions)))
+    throw std::runtime_error("Failed to generate instructions");
+  auto generated = Clock::now();
+  llvm::raw_null_ostream null;
+  if (mlir::failed(AIE::AIETranslateToNPU(*module, null)))
+    throw std::runtime_error("Failed to print instructions");
+  auto printed = Clock::now();
+
+  // The header is four words, and counts the ops.
+  if (instructions.size() != 4 + numGroups * groupWords ||
+      instructions[2] != 4 * numGroups)
+    throw std::runtime_error("Unexpected instruction stream size");
+
+  auto ms = [](auto duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+  llvm::outs() << 4 * numGroups << " ops, " << instructions.size()
+               << " words: generated in " << ms(generated - start)
+               << " ms, generated and printed in " << ms(printed - generated)
+               << " ms\n";
+}
+
+int main(int argc, char **argv) {
+  if (argc == 1) {
+    bench(100000);
+    return 0;
+  }
+  for (int i = 1; i < argc; i++)
+    bench(std::stoul(argv[i]));
+  return 0;
+}
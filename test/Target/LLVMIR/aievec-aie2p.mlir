@@ -0,0 +1,73 @@
+// RUN: aie-translate %s -mlir-to-llvmir -split-input-file | FileCheck %s
+
+// -- MAC --
+
+// CHECK-LABEL: define <32 x i64> @mac_conf_acc32
+llvm.func @mac_conf_acc32(%A : vector<64xi8>,
+                          %B : vector<16xi32>,
+                          %C : vector<32xi64>,
+                          %cfg : i32)
+                          -> vector<32xi64> {
+    // CHECK: call <32 x i64> @llvm.aie2p.I512.I512.ACC2048.acc32.mac.conf(
+    // CHECK-SAME: <64 x i8> %{{[0-9]+}}, <16 x i32> %{{[0-9]+}},
+    // CHECK-SAME: <32 x i64> %{{[0-9]+}}, i32 %{{[0-9]+}})
+    %0 = "xllvm.intr.aie2p.I512.I512.ACC2048.acc32.mac.conf"(%A, %B, %C, %cfg) :
+        (vector<64xi8>, vector<16xi32>, vector<32xi64>, i32) -> vector<32xi64>
+    llvm.return %0 : vector<32xi64>
+}
+
+// CHECK-LABEL: define <32 x i64> @mac_conf_bf16
+llvm.func @mac_conf_bf16(%A : vector<64xbf16>,
+                         %B : vector<64xbf16>,
+                         %C : vector<32xi64>,
+                         %cfg : i32)
+                         -> vector<32xi64> {
+    // CHECK: call <32 x i64> @llvm.aie2p.I1024.I1024.ACC2048.bf.mac.conf(
+    // CHECK-SAME: <64 x bfloat> %{{[0-9]+}}, <64 x bfloat> %{{[0-9]+}},
+    // CHECK-SAME: <32 x i64> %{{[0-9]+}}, i32 %{{[0-9]+}})
+    %0 = "xllvm.intr.aie2p.I1024.I1024.ACC2048.bf.mac.conf"(%A, %B, %C, %cfg) :
+        (vector<64xbf16>, vector<64xbf16>, vector<32xi64>, i32) -> vector<32xi64>
+    llvm.return %0 : vector<32xi64>
+}
+
+// CHECK-LABEL: define <32 x i64> @mac_conf_fp8
+llvm.func @mac_conf_fp8(%A : vector<128xi8>,
+                        %B : vector<128xi8>,
+                        %C : vector<32xi64>,
+                        %cfg : i32)
+                        -> vector<32xi64> {
+    // CHECK: call <32 x i64> @llvm.aie2p.I1024.I1024.ACC2048.fp8.mac.conf(
+    // CHECK-SAME: <128 x i8> %{{[0-9]+}}, <128 x i8> %{{[0-9]+}},
+    // CHECK-SAME: <32 x i64> %{{[0-9]+}}, i32 %{{[0-9]+}})
+    %0 = "xllvm.intr.aie2p.I1024.I1024.ACC2048.fp8.mac.conf"(%A, %B, %C, %cfg) :
+        (vector<128xi8>, vector<128xi8>, vector<32xi64>, i32) -> vector<32xi64>
+    llvm.return %0 : vector<32xi64>
+}
+
+// -- SRS / UPS --
+
+// CHECK-LABEL: define <64 x bfloat> @srs_ups_bf16
+llvm.func @srs_ups_bf16(%v : vector<64xbf16>) -> vector<64xbf16> {
+    // CHECK: call <32 x i64> @llvm.aie2p.v64bf16.to.v64accfloat(
+    // CHECK-SAME: <64 x bfloat> %{{[0-9]+}})
+    %0 = "xllvm.intr.aie2p.v64bf16.to.v64accfloat"(%v) :
+        (vector<64xbf16>) -> vector<32xi64>
+    // CHECK: call <64 x bfloat> @llvm.aie2p.v64accfloat.to.v64bf16(
+    // CHECK-SAME: <32 x i64> %{{[0-9]+}})
+    %1 = "xllvm.intr.aie2p.v64accfloat.to.v64bf16"(%0) :
+        (vector<32xi64>) -> vector<64xbf16>
+    llvm.return %1 : vector<64xbf16>
+}
+
+// -- SHUFFLE --
+
+// CHECK-LABEL: define <16 x i32> @shuffle_i512
+llvm.func @shuffle_i512(%a : vector<16xi32>, %mode : i32) -> vector<16xi32> {
+    // CHECK: call <16 x i32> @llvm.aie2p.v16int32()
+    %b = "xllvm.intr.aie2p.v16int32"() : () -> vector<16xi32>
+    // CHECK: call <16 x i32> @llvm.aie2p.vshuffle(
+    // CHECK-SAME: <16 x i32> %{{[0-9]+}}, <16 x i32> %{{[0-9]+}}, i32 %{{[0-9]+}})
+    %0 = "xllvm.intr.aie2p.vshuffle"(%a, %b, %mode) :
+                                        (vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+    llvm.return %0 : vector<16xi32>
+}
@@ -0,0 +1,28 @@
+//===- multi_device.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-target-arch --aie-device-name=first %s | FileCheck --match-full-lines --check-prefix=FIRST %s
+// RUN: aie-translate --aie-generate-target-arch --aie-device-name=second %s | FileCheck --match-full-lines --check-prefix=SECOND %s
+// RUN: not aie-translate --aie-generate-target-arch %s 2>&1 | FileCheck --check-prefix=AMBIGUOUS %s
+// RUN: not aie-translate --aie-generate-target-arch --aie-device-name=third %s 2>&1 | FileCheck --check-prefix=MISSING %s
+
+// FIRST: AIE
+// SECOND: AIE2
+// AMBIGUOUS: error{{.*}}contains several aie.device operations
+// MISSING: error{{.*}}does not contain a device named third
+
+module {
+  aie.device(xcvc1902) @first {
+    %t = aie.tile(1, 3)
+  }
+  aie.device(npu1_1col) @second {
+    %t = aie.tile(0, 2)
+  }
+}
@@ -0,0 +1,27 @@
+//===- multi_device_unnamed.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-target-arch --aie-device-name=device0 %s | FileCheck --match-full-lines --check-prefix=NAMED %s
+// RUN: aie-translate --aie-generate-target-arch --aie-device-name=device0_ %s | FileCheck --match-full-lines --check-prefix=UNNAMED %s
+
+// The unnamed first device would be called device0, which the second device
+// is named, so its artifacts are called device0_ instead.
+
+// NAMED: AIE2
+// UNNAMED: AIE
+
+module {
+  aie.device(xcvc1902) {
+    %t = aie.tile(1, 3)
+  }
+  aie.device(npu1_1col) @device0 {
+    %t = aie.tile(0, 2)
+  }
+}
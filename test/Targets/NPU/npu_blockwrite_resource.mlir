@@ -0,0 +1,51 @@
+//===- npu_blockwrite_resource.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-npu-instgen %s | FileCheck %s
+// RUN: aie-opt --emit-bytecode %s | aie-translate --aie-npu-instgen | FileCheck %s
+
+// Blockwrite payloads may be dense resource blobs and splats as well as dense
+// arrays.
+
+// CHECK: 06030001
+// CHECK-NEXT: 00000104
+// CHECK-NEXT: 00000002
+// CHECK-NEXT: 00000040
+// CHECK-NEXT: 00000001
+// CHECK-NEXT: 00001000
+// CHECK-NEXT: 00000018
+// CHECK-NEXT: DEADBEEF
+// CHECK-NEXT: 00000001
+// CHECK-NEXT: 00000002
+// CHECK-NEXT: 00000001
+// CHECK-NEXT: 00002000
+// CHECK-NEXT: 00000014
+// CHECK-NEXT: 00000007
+// CHECK-NEXT: 00000007
+module {
+  aie.device(npu1_4col) {
+    memref.global "private" constant @blob : memref<3xi32> = dense_resource<blockwrite_data>
+    memref.global "private" constant @splat : memref<2xi32> = dense<7>
+    aiex.runtime_sequence() {
+      %0 = memref.get_global @blob : memref<3xi32>
+      aiex.npu.blockwrite(%0) {address = 4096 : ui32} : memref<3xi32>
+      %1 = memref.get_global @splat : memref<2xi32>
+      aiex.npu.blockwrite(%1) {address = 8192 : ui32} : memref<2xi32>
+    }
+  }
+}
+
+{-#
+  dialect_resources: {
+    builtin: {
+      blockwrite_data: "0x04000000EFBEADDE0100000002000000"
+    }
+  }
+#-}
@@ -0,0 +1,55 @@
+//===- decode_text.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// One packet from the core trace unit of tile (0, 2), one from the shim trace
+// unit of tile (0, 0) and one from tile (1, 2), which is not traced.
+// RUN: printf '%%s\n' 00020000 f0000000 00000000 03c03020 e225fefe a5a5a5a5 a5a5a5a5 a5a5a5a5 \
+// RUN:   00002000 10fefefe a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 \
+// RUN:   00220001 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 a5a5a5a5 > %t.txt
+// RUN: aie-trace-decode --mlir %s %t.txt -o %t.json 2>&1 | FileCheck %s --check-prefix=WARN
+// RUN: FileCheck %s < %t.json
+// RUN: aie-trace-decode --mlir %s %t.txt --output-format=binary -o %t.bin
+// RUN: wc -c < %t.bin | FileCheck %s --check-prefix=BINARY
+
+// WARN: warning: dropped 1 packets from trace units not configured by the design
+
+// CHECK: [{"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "core_trace for tile2,0"}}
+// CHECK-SAME: {"name": "thread_name", "ph": "M", "pid": 0, "tid": 0, "args": {"name": "TRUE"}}
+// CHECK-SAME: {"name": "thread_name", "ph": "M", "pid": 0, "tid": 1, "args": {"name": "INSTR_EVENT_0"}}
+// CHECK-SAME: {"name": "thread_name", "ph": "M", "pid": 0, "tid": 2, "args": {"name": "INSTR_EVENT_1"}}
+// CHECK-SAME: {"name": "thread_name", "ph": "M", "pid": 0, "tid": 3, "args": {"name": "PORT_RUNNING_0"}}
+// CHECK-SAME: {"name": "thread_name", "ph": "M", "pid": 0, "tid": 7, "args": {"name": "NONE"}}
+// CHECK-SAME: {"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "intfc_trace for tile0,0"}}
+// CHECK-SAME: {"name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": {"name": "DMA_S2MM_1_STALLED_LOCK"}}
+// CHECK-SAME: {"name": "TRUE", "ts": 4, "ph": "B", "pid": 0, "tid": 0, "args": {}}
+// CHECK-SAME: {"name": "INSTR_EVENT_0", "ts": 5, "ph": "B", "pid": 0, "tid": 1, "args": {}}
+// CHECK-SAME: {"name": "TRUE", "ts": 6, "ph": "E", "pid": 0, "tid": 0, "args": {}}
+// CHECK-SAME: {"name": "INSTR_EVENT_0", "ts": 6, "ph": "E", "pid": 0, "tid": 1, "args": {}}
+// CHECK-SAME: {"name": "INSTR_EVENT_1", "ts": 6, "ph": "B", "pid": 0, "tid": 2, "args": {}}
+// CHECK-SAME: {"name": "INSTR_EVENT_1", "ts": 9, "ph": "E", "pid": 0, "tid": 2, "args": {}}
+// CHECK-SAME: {"name": "INSTR_EVENT_1", "ts": 14, "ph": "B", "pid": 0, "tid": 2, "args": {}}
+// CHECK-SAME: {"name": "DMA_S2MM_1_STALLED_LOCK", "ts": 1, "ph": "B", "pid": 1, "tid": 1, "args": {}}]
+
+// 12 bytes of header, 2 unit records of 15 bytes and 8 event records of 13.
+// BINARY: 146
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_2 = aie.tile(0, 2)
+    aiex.runtime_sequence() {
+      // Core events: 0x4B PORT_RUNNING_0, 0x22 INSTR_EVENT_1, 0x21 INSTR_EVENT_0, 0x01 TRUE
+      aiex.npu.write32 {address = 213216 : ui32, column = 0 : i32, row = 2 : i32, value = 1260527873 : ui32}
+      aiex.npu.write32 {address = 213220 : ui32, column = 0 : i32, row = 2 : i32, value = 0 : ui32}
+      // Shim events: 0x1B DMA_S2MM_1_STALLED_LOCK, 0x1A DMA_S2MM_0_STALLED_LOCK
+      aiex.npu.write32 {address = 213216 : ui32, column = 0 : i32, row = 0 : i32, value = 6938 : ui32}
+    }
+  }
+}
@@ -0,0 +1,34 @@
+//===- heat_map.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="metrics-file=%t.json" %s -o %t.mlir
+// RUN: aie-visualize --heat-map=%t.json %t.mlir | FileCheck %s
+// RUN: echo '{}' > %t.empty.json
+// RUN: not aie-visualize --heat-map=%t.empty.json %t.mlir 2>&1 | FileCheck %s --check-prefix=BAD
+
+// The switchboxes the flow passes through show their utilization as a digit
+// instead of the kind of their tile.
+
+// CHECK:      1 Columns and 6 Rows
+// CHECK-NEXT: {{^}}5 {{.*}}mC
+// CHECK-NEXT: {{^}}4 {{.*}}m{{[0-9]}}
+// CHECK-NEXT: {{^}}3 {{.*}}m{{[0-9]}}
+// CHECK-NEXT: {{^}}2 {{.*}}m{{[0-9]}}
+// CHECK-NEXT: {{^}}1 {{.*}}mM
+// CHECK-NEXT: {{^}}0 {{.*}}m{{[A-Z]}}
+// CHECK:      Switchbox utilization in tenths
+
+// BAD: empty.json has no heat map
+
+aie.device(npu1_1col) {
+  %t02 = aie.tile(0, 2)
+  %t04 = aie.tile(0, 4)
+  aie.flow(%t02, DMA : 0, %t04, DMA : 0)
+}
@@ -0,0 +1,84 @@
+//===- deadlock_free.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-analyze-locks="max-cycles=100000" %s | FileCheck %s
+
+// The input and output buffers are handed back and forth between the core and
+// the DMAs, one object every 167 cycles.
+
+// CHECK-LABEL: lock analysis of npu1_1col:
+// CHECK-NEXT:    deadlock free for 4 iterations of every core loop and BD chain, {{[0-9]+}} states explored
+// CHECK-NEXT:    lock cycle in_prod, in_cons ({{.*}}): initiation interval 167.0 cycles
+// CHECK-NEXT:    lock cycle out_prod, out_cons ({{.*}}): initiation interval 167.0 cycles
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %in_buf = aie.buffer(%tile_0_2) {sym_name = "in_buf"} : memref<64xi32>
+    %out_buf = aie.buffer(%tile_0_2) {sym_name = "out_buf"} : memref<64xi32>
+    %in_prod = aie.lock(%tile_0_2, 0) {init = 1 : i32, sym_name = "in_prod"}
+    %in_cons = aie.lock(%tile_0_2, 1) {init = 0 : i32, sym_name = "in_cons"}
+    %out_prod = aie.lock(%tile_0_2, 2) {init = 1 : i32, sym_name = "out_prod"}
+    %out_cons = aie.lock(%tile_0_2, 3) {init = 0 : i32, sym_name = "out_cons"}
+
+    %switchbox_0_0 = aie.switchbox(%tile_0_0) {
+      aie.connect<South : 3, North : 0>
+      aie.connect<North : 0, South : 2>
+    }
+    %shim_mux_0_0 = aie.shim_mux(%tile_0_0) {
+      aie.connect<DMA : 0, North : 3>
+      aie.connect<North : 2, DMA : 0>
+    }
+    %switchbox_0_1 = aie.switchbox(%tile_0_1) {
+      aie.connect<South : 0, North : 0>
+      aie.connect<North : 0, South : 0>
+    }
+    %switchbox_0_2 = aie.switchbox(%tile_0_2) {
+      aie.connect<South : 0, DMA : 0>
+      aie.connect<DMA : 0, South : 0>
+    }
+
+    func.func private @scale(memref<64xi32>, memref<64xi32>) attributes {aie.kernel_cycles = 100 : i64}
+
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %cmax = arith.constant 0xFFFFFFFF : index
+      scf.for %i = %c0 to %cmax step %c1 {
+        aie.use_lock(%in_cons, AcquireGreaterEqual, 1)
+        aie.use_lock(%out_prod, AcquireGreaterEqual, 1)
+        func.call @scale(%in_buf, %out_buf) : (memref<64xi32>, memref<64xi32>) -> ()
+        aie.use_lock(%in_prod, Release, 1)
+        aie.use_lock(%out_cons, Release, 1)
+      }
+      aie.end
+    }
+
+    %mem_0_2 = aie.mem(%tile_0_2) {
+      %0 = aie.dma_start(S2MM, 0, ^bb1, ^bb2)
+    ^bb1:
+      aie.use_lock(%in_prod, AcquireGreaterEqual, 1)
+      aie.dma_bd(%in_buf : memref<64xi32>, 0, 64)
+      aie.use_lock(%in_cons, Release, 1)
+      aie.next_bd ^bb1
+    ^bb2:
+      %1 = aie.dma_start(MM2S, 0, ^bb3, ^bb4)
+    ^bb3:
+      aie.use_lock(%out_cons, AcquireGreaterEqual, 1)
+      aie.dma_bd(%out_buf : memref<64xi32>, 0, 64)
+      aie.use_lock(%out_prod, Release, 1)
+      aie.next_bd ^bb3
+    ^bb4:
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,150 @@
+//===- bad_cascade_reduction.mlir ------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --verify-diagnostics --aie-cascade-reduction %s
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_2_2 = aie.tile(2, 2)
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %i0 = arith.constant 0 : i32
+      %sum = scf.for %k = %c0 to %c8 step %c1 iter_args(%acc = %i0) -> (i32) {
+        %s = arith.addi %acc, %i0 : i32
+        scf.yield %s : i32
+      } {aie.cascade_reduction = "gap"}
+      aie.end
+    }
+    %core_2_2 = aie.core(%tile_2_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %i0 = arith.constant 0 : i32
+      // expected-error@+1 {{cascade reduction group 'gap' must span adjacent cores of one row or column}}
+      %sum = scf.for %k = %c0 to %c8 step %c1 iter_args(%acc = %i0) -> (i32) {
+        %s = arith.addi %acc, %i0 : i32
+        scf.yield %s : i32
+      } {aie.cascade_reduction = "gap"}
+      aie.end
+    }
+  }
+}
+
+// -----
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_1_2 = aie.tile(1, 2)
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c7 = arith.constant 7 : index
+      %i0 = arith.constant 0 : i32
+      // expected-error@+1 {{trip count 7 does not divide into 2 cascaded cores}}
+      %sum = scf.for %k = %c0 to %c7 step %c1 iter_args(%acc = %i0) -> (i32) {
+        %s = arith.addi %acc, %i0 : i32
+        scf.yield %s : i32
+      } {aie.cascade_reduction = "odd"}
+      aie.end
+    }
+    %core_1_2 = aie.core(%tile_1_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c7 = arith.constant 7 : index
+      %i0 = arith.constant 0 : i32
+      %sum = scf.for %k = %c0 to %c7 step %c1 iter_args(%acc = %i0) -> (i32) {
+        %s = arith.addi %acc, %i0 : i32
+        scf.yield %s : i32
+      } {aie.cascade_reduction = "odd"}
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// The first core only computes half of the sum.
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_1_2 = aie.tile(1, 2)
+    %c_0_2 = aie.buffer(%tile_0_2) : memref<i32>
+    %c_1_2 = aie.buffer(%tile_1_2) : memref<i32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %i0 = arith.constant 0 : i32
+      // expected-error@+1 {{cascade reduction to partition must not use its result outside the last core of group 'partial'}}
+      %sum = scf.for %k = %c0 to %c8 step %c1 iter_args(%acc = %i0) -> (i32) {
+        %s = arith.addi %acc, %i0 : i32
+        scf.yield %s : i32
+      } {aie.cascade_reduction = "partial"}
+      memref.store %sum, %c_0_2[] : memref<i32>
+      aie.end
+    }
+    %core_1_2 = aie.core(%tile_1_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %i0 = arith.constant 0 : i32
+      %sum = scf.for %k = %c0 to %c8 step %c1 iter_args(%acc = %i0) -> (i32) {
+        %s = arith.addi %acc, %i0 : i32
+        scf.yield %s : i32
+      } {aie.cascade_reduction = "partial"}
+      memref.store %sum, %c_1_2[] : memref<i32>
+      aie.end
+    }
+  }
+}
+
+// -----
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %i0 = arith.constant 0 : i16
+      // expected-error@+1 {{cascade reduction must carry a single integer or float accumulator of a multiple of 32 bits}}
+      %sum = scf.for %k = %c0 to %c8 step %c1 iter_args(%acc = %i0) -> (i16) {
+        scf.yield %acc : i16
+      } {aie.cascade_reduction = "narrow"}
+      aie.end
+    }
+  }
+}
+
+// -----
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %i1 = arith.constant 1 : i32
+      // expected-error@+1 {{cascade reduction must yield an arith.addf or arith.addi of its accumulator}}
+      %prod = scf.for %k = %c0 to %c8 step %c1 iter_args(%acc = %i1) -> (i32) {
+        %p = arith.muli %acc, %i1 : i32
+        scf.yield %p : i32
+      } {aie.cascade_reduction = "product"}
+      aie.end
+    }
+  }
+}
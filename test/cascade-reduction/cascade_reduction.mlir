@@ -0,0 +1,165 @@
+//===- cascade_reduction.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --aie-cascade-reduction %s | FileCheck %s
+// RUN: aie-opt --split-input-file --aie-cascade-reduction="partition-k=false" %s | FileCheck --check-prefix=NOPART %s
+
+// A dot product over K = 96 split across a row of three cores. Only the last
+// core stores the result.
+
+// CHECK-LABEL: @row
+// CHECK:       %[[T02:.*]] = aie.tile(0, 2)
+// CHECK:       %[[T12:.*]] = aie.tile(1, 2)
+// CHECK:       %[[T22:.*]] = aie.tile(2, 2)
+// CHECK:       aie.core(%[[T02]])
+// CHECK:         %[[UB0:.*]] = arith.constant 32 : index
+// CHECK:         %[[P0:.*]] = scf.for %{{.*}} = %{{.*}} to %[[UB0]] step %{{.*}} iter_args(%{{.*}} = %{{.*}}) -> (f32) {
+// CHECK:         }
+// CHECK-NOT:     aie.cascade_reduction
+// CHECK:         %[[V0:.*]] = vector.broadcast %[[P0]] : f32 to vector<1xf32>
+// CHECK:         %[[W0:.*]] = vector.bitcast %[[V0]] : vector<1xf32> to vector<1xi32>
+// CHECK:         %[[Z0:.*]] = arith.constant dense<0> : vector<16xi32>
+// CHECK:         %[[C0:.*]] = vector.insert_strided_slice %[[W0]], %[[Z0]] {offsets = [0], strides = [1]} : vector<1xi32> into vector<16xi32>
+// CHECK:         aie.put_cascade(%[[C0]] : vector<16xi32>)
+// CHECK-NOT:     memref.store
+// CHECK:       aie.core(%[[T12]])
+// CHECK:         %[[LB1:.*]] = arith.constant 32 : index
+// CHECK:         %[[UB1:.*]] = arith.constant 64 : index
+// CHECK:         %[[ZERO1:.*]] = arith.constant 0.000000e+00 : f32
+// CHECK:         %[[P1:.*]] = scf.for %{{.*}} = %[[LB1]] to %[[UB1]] step %{{.*}} iter_args(%{{.*}} = %[[ZERO1]]) -> (f32) {
+// CHECK:         %[[G1:.*]] = aie.get_cascade() : vector<16xi32>
+// CHECK:         %[[E1:.*]] = vector.extract_strided_slice %[[G1]] {offsets = [0], sizes = [1], strides = [1]} : vector<16xi32> to vector<1xi32>
+// CHECK:         %[[F1:.*]] = vector.bitcast %[[E1]] : vector<1xi32> to vector<1xf32>
+// CHECK:         %[[X1:.*]] = vector.extract %[[F1]][0] : f32 from vector<1xf32>
+// CHECK:         %[[S1:.*]] = arith.addf %[[P1]], %[[X1]] : f32
+// CHECK:         vector.broadcast %[[S1]] : f32 to vector<1xf32>
+// CHECK:         aie.put_cascade
+// CHECK-NOT:     memref.store
+// CHECK:       aie.core(%[[T22]])
+// CHECK:         %[[P2:.*]] = scf.for
+// CHECK:         aie.get_cascade() : vector<16xi32>
+// CHECK:         %[[S2:.*]] = arith.addf %[[P2]], %{{.*}} : f32
+// CHECK-NOT:     aie.put_cascade
+// CHECK:         memref.store %[[S2]]
+// CHECK:       aie.cascade_flow(%[[T02]], %[[T12]])
+// CHECK:       aie.cascade_flow(%[[T12]], %[[T22]])
+
+// NOPART-LABEL: @row
+// NOPART-COUNT-3: scf.for %{{.*}} = %c0{{.*}} to %c96{{.*}} step %c1{{.*}} iter_args(%{{.*}} = %cst{{.*}})
+
+module @row {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_1_2 = aie.tile(1, 2)
+    %tile_2_2 = aie.tile(2, 2)
+    %a_0_2 = aie.buffer(%tile_0_2) : memref<96xf32>
+    %a_1_2 = aie.buffer(%tile_1_2) : memref<96xf32>
+    %a_2_2 = aie.buffer(%tile_2_2) : memref<96xf32>
+    %c_2_2 = aie.buffer(%tile_2_2) : memref<f32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c96 = arith.constant 96 : index
+      %cst = arith.constant 0.0 : f32
+      %sum = scf.for %k = %c0 to %c96 step %c1 iter_args(%acc = %cst) -> (f32) {
+        %a = memref.load %a_0_2[%k] : memref<96xf32>
+        %p = arith.mulf %a, %a : f32
+        %s = arith.addf %acc, %p : f32
+        scf.yield %s : f32
+      } {aie.cascade_reduction = "dot"}
+      aie.end
+    }
+    %core_1_2 = aie.core(%tile_1_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c96 = arith.constant 96 : index
+      %cst = arith.constant 0.0 : f32
+      %sum = scf.for %k = %c0 to %c96 step %c1 iter_args(%acc = %cst) -> (f32) {
+        %a = memref.load %a_1_2[%k] : memref<96xf32>
+        %p = arith.mulf %a, %a : f32
+        %s = arith.addf %acc, %p : f32
+        scf.yield %s : f32
+      } {aie.cascade_reduction = "dot"}
+      aie.end
+    }
+    %core_2_2 = aie.core(%tile_2_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c96 = arith.constant 96 : index
+      %cst = arith.constant 0.0 : f32
+      %sum = scf.for %k = %c0 to %c96 step %c1 iter_args(%acc = %cst) -> (f32) {
+        %a = memref.load %a_2_2[%k] : memref<96xf32>
+        %p = arith.mulf %a, %a : f32
+        %s = arith.addf %acc, %p : f32
+        scf.yield %s : f32
+      } {aie.cascade_reduction = "dot"}
+      memref.store %sum, %c_2_2[] : memref<f32>
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// An accumulator of two cascade words, reduced down a column.
+
+// CHECK-LABEL: @column
+// CHECK:       %[[T03:.*]] = aie.tile(0, 3)
+// CHECK:       %[[T02:.*]] = aie.tile(0, 2)
+// CHECK:       aie.core(%[[T02]])
+// CHECK:         %[[P:.*]] = scf.for
+// CHECK:         %[[G0:.*]] = aie.get_cascade() : vector<16xi32>
+// CHECK:         %[[Z:.*]] = arith.constant dense<0> : vector<32xi32>
+// CHECK:         %[[W0:.*]] = vector.insert_strided_slice %[[G0]], %[[Z]] {offsets = [0], strides = [1]}
+// CHECK:         %[[G1:.*]] = aie.get_cascade() : vector<16xi32>
+// CHECK:         %[[W1:.*]] = vector.insert_strided_slice %[[G1]], %[[W0]] {offsets = [16], strides = [1]}
+// CHECK:         arith.addi %[[P]], %[[W1]] : vector<32xi32>
+// CHECK:       aie.core(%[[T03]])
+// CHECK:         %[[Q:.*]] = scf.for
+// CHECK:         %[[H0:.*]] = vector.extract_strided_slice %[[Q]] {offsets = [0], sizes = [16], strides = [1]}
+// CHECK:         aie.put_cascade(%[[H0]] : vector<16xi32>)
+// CHECK:         %[[H1:.*]] = vector.extract_strided_slice %[[Q]] {offsets = [16], sizes = [16], strides = [1]}
+// CHECK:         aie.put_cascade(%[[H1]] : vector<16xi32>)
+// CHECK:       aie.cascade_flow(%[[T03]], %[[T02]])
+
+module @column {
+  aie.device(npu1_1col) {
+    %tile_0_3 = aie.tile(0, 3)
+    %tile_0_2 = aie.tile(0, 2)
+    %a_0_2 = aie.buffer(%tile_0_2) : memref<64x32xi32>
+    %a_0_3 = aie.buffer(%tile_0_3) : memref<64x32xi32>
+    %c_0_2 = aie.buffer(%tile_0_2) : memref<32xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c64 = arith.constant 64 : index
+      %zero = arith.constant dense<0> : vector<32xi32>
+      %sum = scf.for %k = %c0 to %c64 step %c1 iter_args(%acc = %zero) -> (vector<32xi32>) {
+        %a = vector.load %a_0_2[%k, %c0] : memref<64x32xi32>, vector<32xi32>
+        %s = arith.addi %acc, %a : vector<32xi32>
+        scf.yield %s : vector<32xi32>
+      } {aie.cascade_reduction = "rows"}
+      vector.store %sum, %c_0_2[%c0] : memref<32xi32>, vector<32xi32>
+      aie.end
+    }
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c64 = arith.constant 64 : index
+      %zero = arith.constant dense<0> : vector<32xi32>
+      %sum = scf.for %k = %c0 to %c64 step %c1 iter_args(%acc = %zero) -> (vector<32xi32>) {
+        %a = vector.load %a_0_3[%k, %c0] : memref<64x32xi32>, vector<32xi32>
+        %s = arith.addi %acc, %a : vector<32xi32>
+        scf.yield %s : vector<32xi32>
+      } {aie.cascade_reduction = "rows"}
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,75 @@
+//===- balance_latency.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="balance-latency=true" --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="balance-latency=true metrics-file=-" %s -o /dev/null | FileCheck %s --check-prefix=BALANCED
+// RUN: aie-opt --aie-create-pathfinder-flows="metrics-file=-" %s -o /dev/null | FileCheck %s --check-prefix=UNBALANCED
+
+// With balancing, both branches of the fanout from (5, 2) pass through as
+// many switchboxes, and so do both inputs of the join into (7, 3). Without
+// it, the near branch and the near input take the shortest path.
+// BALANCED:        "flows": [
+// BALANCED:          "latency": [[FANOUT:[0-9]+]],
+// BALANCED-NEXT:     "min_latency": [[FANOUT]],
+// BALANCED-NEXT:     "packet": false,
+// BALANCED-NEXT:     "port": "DMA:0",
+// BALANCED-NEXT:     "source": {
+// BALANCED-NEXT:       "col": 5,
+// BALANCED-NEXT:       "row": 2
+// BALANCED:          "latency": [[JOIN:[0-9]+]],
+// BALANCED-NEXT:     "min_latency": [[JOIN]],
+// BALANCED-NEXT:     "packet": false,
+// BALANCED-NEXT:     "port": "DMA:0",
+// BALANCED-NEXT:     "source": {
+// BALANCED-NEXT:       "col": 7,
+// BALANCED-NEXT:       "row": 2
+// BALANCED:          "latency": [[JOIN]],
+// BALANCED-NEXT:     "min_latency": [[JOIN]],
+// BALANCED-NEXT:     "packet": false,
+// BALANCED-NEXT:     "port": "DMA:0",
+// BALANCED-NEXT:     "source": {
+// BALANCED-NEXT:       "col": 7,
+// BALANCED-NEXT:       "row": 6
+
+// UNBALANCED:        "flows": [
+// UNBALANCED:          "latency": 4,
+// UNBALANCED-NEXT:     "min_latency": 2,
+// UNBALANCED:          "latency": 2,
+// UNBALANCED-NEXT:     "min_latency": 2,
+// UNBALANCED:          "latency": 4,
+// UNBALANCED-NEXT:     "min_latency": 4,
+
+// The near branch of the fanout and the near input of the join take detours,
+// which must not break the flows.
+// CHECK: %[[T52:.*]] = aie.tile(5, 2)
+// CHECK: %[[T53:.*]] = aie.tile(5, 3)
+// CHECK: %[[T55:.*]] = aie.tile(5, 5)
+// CHECK: %[[T72:.*]] = aie.tile(7, 2)
+// CHECK: %[[T73:.*]] = aie.tile(7, 3)
+// CHECK: %[[T76:.*]] = aie.tile(7, 6)
+// CHECK-DAG: aie.flow(%[[T52]], DMA : 0, %[[T53]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T52]], DMA : 0, %[[T55]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T72]], DMA : 0, %[[T73]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T76]], DMA : 0, %[[T73]], DMA : 1)
+
+module {
+  aie.device(xcvc1902) {
+    %t52 = aie.tile(5, 2)
+    %t53 = aie.tile(5, 3)
+    %t55 = aie.tile(5, 5)
+    %t72 = aie.tile(7, 2)
+    %t73 = aie.tile(7, 3)
+    %t76 = aie.tile(7, 6)
+    aie.flow(%t52, DMA : 0, %t53, DMA : 0)
+    aie.flow(%t52, DMA : 0, %t55, DMA : 0)
+    aie.flow(%t72, DMA : 0, %t73, DMA : 0) {aie.balance_group = "join"}
+    aie.flow(%t76, DMA : 0, %t73, DMA : 1) {aie.balance_group = "join"}
+  }
+}
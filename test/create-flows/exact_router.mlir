@@ -0,0 +1,45 @@
+//===- exact_router.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="router=exact" --aie-find-flows %s -o %t.opt
+// RUN: FileCheck %s --check-prefix=CHECK1 < %t.opt
+// RUN: aie-translate --aie-flows-to-json %t.opt | FileCheck %s --check-prefix=CHECK2
+// RUN: not aie-opt --aie-create-pathfinder-flows="router=greedy" %s 2>&1 | FileCheck %s --check-prefix=ERROR
+
+// CHECK1: %[[T23:.*]] = aie.tile(2, 3)
+// CHECK1: %[[T22:.*]] = aie.tile(2, 2)
+// CHECK1: %[[T52:.*]] = aie.tile(5, 2)
+// CHECK1: %[[T54:.*]] = aie.tile(5, 4)
+// CHECK1: %[[T55:.*]] = aie.tile(5, 5)
+// CHECK1: aie.flow(%[[T23]], Core : 0, %[[T22]], Core : 1)
+// CHECK1: aie.flow(%[[T22]], Core : 0, %[[T22]], Core : 0)
+// CHECK1: aie.flow(%[[T22]], Core : 1, %[[T23]], Core : 1)
+// CHECK1-DAG: aie.flow(%[[T52]], DMA : 0, %[[T54]], DMA : 0)
+// CHECK1-DAG: aie.flow(%[[T52]], DMA : 0, %[[T55]], DMA : 0)
+
+// Every flow takes its shortest path, and the fanout shares its channels.
+// CHECK2: "total_path_length": 5
+
+// ERROR: error: unknown router 'greedy'
+
+module {
+  aie.device(xcvc1902) {
+    %t23 = aie.tile(2, 3)
+    %t22 = aie.tile(2, 2)
+    %t52 = aie.tile(5, 2)
+    %t54 = aie.tile(5, 4)
+    %t55 = aie.tile(5, 5)
+    aie.flow(%t23, Core : 0, %t22, Core : 1)
+    aie.flow(%t22, Core : 0, %t22, Core : 0)
+    aie.flow(%t22, Core : 1, %t23, Core : 1)
+    aie.flow(%t52, DMA : 0, %t54, DMA : 0)
+    aie.flow(%t52, DMA : 0, %t55, DMA : 0)
+  }
+}
@@ -0,0 +1,67 @@
+//===- routing_cache.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.cache
+// RUN: aie-opt --split-input-file --aie-create-pathfinder-flows="cache-dir=%t.cache" %s | FileCheck %s
+// RUN: ls %t.cache | FileCheck %s --check-prefix=FILES
+// RUN: cat %t.cache/*.json | FileCheck %s --check-prefix=CACHE
+
+// The exact router runs out of time at once and falls back to Pathfinder.
+// That routing depends on the time budget, so it is not cached.
+// RUN: rm -rf %t.exact && mkdir %t.exact
+// RUN: aie-opt --split-input-file --aie-create-pathfinder-flows="router=exact router-timeout=0 cache-dir=%t.exact" %s | FileCheck %s
+// RUN: ls %t.exact | FileCheck %s --allow-empty --check-prefix=NOFILES
+
+// The second design is the first one shifted by four columns, into columns
+// of the same kind, so it reuses the cached routing of the first one.
+
+// CHECK-LABEL: aie.device(xcvc1902)
+// CHECK:       %[[T23:.*]] = aie.tile(2, 3)
+// CHECK:       %[[T33:.*]] = aie.tile(3, 3)
+// CHECK:       aie.switchbox(%[[T23]]) {
+// CHECK-NEXT:    aie.connect<DMA : 0, East : [[CH:[0-9]+]]>
+// CHECK:       aie.switchbox(%[[T33]]) {
+// CHECK-NEXT:    aie.connect<West : [[CH]], DMA : 0>
+
+// CHECK-LABEL: aie.device(xcvc1902)
+// CHECK:       %[[T63:.*]] = aie.tile(6, 3)
+// CHECK:       %[[T73:.*]] = aie.tile(7, 3)
+// CHECK:       aie.switchbox(%[[T63]]) {
+// CHECK-NEXT:    aie.connect<DMA : 0, East : [[CH]]>
+// CHECK:       aie.switchbox(%[[T73]]) {
+// CHECK-NEXT:    aie.connect<West : [[CH]], DMA : 0>
+
+// FILES-COUNT-1: .json
+// FILES-NOT:     .json
+
+// NOFILES-NOT: .json
+
+// CACHE:      "columns": {
+// CACHE-DAG:    "0": "NCCC"
+// CACHE-DAG:    "1": "NCCC"
+// CACHE:      "key": "device xcvc1902\noption router=pathfinder\ncolumn 0 NCCC\ncolumn 1 NCCC\nflow (0, 3) DMA : 0 -> (1, 3) DMA : 0\n"
+
+module {
+  aie.device(xcvc1902) {
+    %t23 = aie.tile(2, 3)
+    %t33 = aie.tile(3, 3)
+    aie.flow(%t23, DMA : 0, %t33, DMA : 0)
+  }
+}
+
+// -----
+
+module {
+  aie.device(xcvc1902) {
+    %t63 = aie.tile(6, 3)
+    %t73 = aie.tile(7, 3)
+    aie.flow(%t63, DMA : 0, %t73, DMA : 0)
+  }
+}
@@ -0,0 +1,71 @@
+//===- routing_metrics.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="metrics-file=-" %s -o /dev/null | FileCheck %s
+
+// CHECK:       "contended_switchboxes": [
+// CHECK:         "used_ports": 1,
+// CHECK:       "device": "xcvc1902",
+// CHECK:       "flows": [
+// CHECK:           "destinations": 1,
+// CHECK-NEXT:      "hops": 1,
+// CHECK-NEXT:      "latency": 2,
+// CHECK-NEXT:      "min_latency": 2,
+// CHECK-NEXT:      "packet": true,
+// CHECK-NEXT:      "port": "DMA:1",
+// CHECK-NEXT:      "source": {
+// CHECK-NEXT:        "col": 2,
+// CHECK-NEXT:        "row": 2
+// CHECK:           "destinations": 1,
+// CHECK-NEXT:      "hops": 1,
+// CHECK-NEXT:      "latency": 2,
+// CHECK-NEXT:      "min_latency": 2,
+// CHECK-NEXT:      "packet": false,
+// CHECK-NEXT:      "port": "DMA:0",
+// CHECK-NEXT:      "source": {
+// CHECK-NEXT:        "col": 2,
+// CHECK-NEXT:        "row": 3
+// CHECK:       "heat_map": {
+// CHECK-NEXT:    "columns": 50,
+// CHECK-NEXT:    "rows": 9,
+// CHECK-NEXT:    "utilization": [
+// CHECK:       "links": [
+// CHECK:           "capacity": 4,
+// CHECK-NEXT:      "circuit_channels": 0,
+// CHECK-NEXT:      "direction": "East",
+// CHECK-NEXT:      "packet_channels": 1,
+// CHECK-NEXT:      "packet_flows": 1,
+// CHECK:           "capacity": 4,
+// CHECK-NEXT:      "circuit_channels": 1,
+// CHECK-NEXT:      "direction": "East",
+// CHECK-NEXT:      "packet_channels": 0,
+// CHECK-NEXT:      "packet_flows": 0,
+// CHECK:       "name": "device0",
+// CHECK-NEXT:  "summary": {
+// CHECK-NEXT:    "flows": 2,
+// CHECK-NEXT:    "max_latency": 2,
+// CHECK-NEXT:    "max_link_utilization": 0.25,
+// CHECK-NEXT:    "total_hops": 2,
+// CHECK-NEXT:    "unused_channels": {{[0-9]+}},
+// CHECK-NEXT:    "used_channels": 2
+
+module {
+  aie.device(xcvc1902) {
+    %t22 = aie.tile(2, 2)
+    %t23 = aie.tile(2, 3)
+    %t32 = aie.tile(3, 2)
+    %t33 = aie.tile(3, 3)
+    aie.flow(%t23, DMA : 0, %t33, DMA : 0)
+    aie.packet_flow(0x1) {
+      aie.packet_source<%t22, DMA : 1>
+      aie.packet_dest<%t32, DMA : 1>
+    }
+  }
+}
@@ -0,0 +1,38 @@
+//===- routing_metrics_devices.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Each device of the module writes its metrics to a file of its own.
+
+// RUN: rm -f %t.json %t.first.json %t.second.json
+// RUN: aie-opt --aie-create-pathfinder-flows="metrics-file=%t.json" %s -o /dev/null
+// RUN: FileCheck %s --check-prefix=FIRST < %t.first.json
+// RUN: FileCheck %s --check-prefix=SECOND < %t.second.json
+
+// FIRST:       "device": "xcvc1902",
+// FIRST:       "name": "first",
+// FIRST:       "total_hops": 1,
+
+// SECOND:      "device": "npu1_1col",
+// SECOND:      "name": "second",
+// SECOND:      "total_hops": 2,
+
+module {
+  aie.device(xcvc1902) @first {
+    %t23 = aie.tile(2, 3)
+    %t33 = aie.tile(3, 3)
+    aie.flow(%t23, DMA : 0, %t33, DMA : 0)
+  }
+  aie.device(npu1_1col) @second {
+    %t02 = aie.tile(0, 2)
+    %t03 = aie.tile(0, 3)
+    %t04 = aie.tile(0, 4)
+    aie.flow(%t02, DMA : 0, %t04, DMA : 0)
+  }
+}
@@ -9,23 +9,25 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt --aie-create-pathfinder-flows %s 2>&1 | FileCheck %s
+
+// The rule of the design on tile (0, 3) also matches the routed packet id 28.
+
 // CHECK: error{{.*}} 'aie.rule' op can lead to false packet id match for id 28, which is not supposed to pass through this port
 // CHECK: remark: Please consider changing all uses of packet id 28 to avoid deadlock.
 
 aie.device(npu1_1col) {
+  %04 = aie.tile(0, 4)
   %03 = aie.tile(0, 3)
   %02 = aie.tile(0, 2)
-  %00 = aie.tile(0, 0)
-  aie.packet_flow(28) {
-    aie.packet_source<%00, DMA : 0>
-    aie.packet_dest<%02, Ctrl : 0>
+  aie.switchbox(%03) {
+    %94 = aie.amsel<0> (0)
+    %95 = aie.masterset(South : 0, %94)
+    aie.packet_rules(DMA : 0) {
+      aie.rule(24, 24, %94)
+    }
   }
-  aie.packet_flow(29) {
-    aie.packet_source<%00, DMA : 0>
-    aie.packet_dest<%03, Ctrl : 0>
-  }
-  aie.packet_flow(26) {
-    aie.packet_source<%00, DMA : 0>
-    aie.packet_dest<%03, DMA : 0>
+  aie.packet_flow(28) {
+    aie.packet_source<%03, DMA : 0>
+    aie.packet_dest<%04, DMA : 0>
   }
 }
@@ -0,0 +1,43 @@
+//===- badpacket_rule_slots.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: not aie-opt --aie-create-pathfinder-flows %s 2>&1 | FileCheck %s
+
+// Five flows leave DMA : 0 of tile (0, 2) for different destinations, so
+// its slave port needs a rule per flow, one more than it can hold.
+
+// CHECK: error{{.*}} 'aie.tile' op needs 5 packet rules on slave port DMA : 0, but only 4 of 4 rule slots are free
+
+aie.device(npu1_1col) {
+  %05 = aie.tile(0, 5)
+  %04 = aie.tile(0, 4)
+  %03 = aie.tile(0, 3)
+  %02 = aie.tile(0, 2)
+  aie.packet_flow(1) {
+    aie.packet_source<%02, DMA : 0>
+    aie.packet_dest<%03, DMA : 0>
+  }
+  aie.packet_flow(2) {
+    aie.packet_source<%02, DMA : 0>
+    aie.packet_dest<%03, DMA : 1>
+  }
+  aie.packet_flow(3) {
+    aie.packet_source<%02, DMA : 0>
+    aie.packet_dest<%04, DMA : 0>
+  }
+  aie.packet_flow(4) {
+    aie.packet_source<%02, DMA : 0>
+    aie.packet_dest<%04, DMA : 1>
+  }
+  aie.packet_flow(5) {
+    aie.packet_source<%02, DMA : 0>
+    aie.packet_dest<%05, DMA : 0>
+  }
+}
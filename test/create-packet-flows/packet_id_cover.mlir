@@ -0,0 +1,38 @@
+//===- packet_id_cover.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows %s 2>&1 | FileCheck --implicit-check-not=error %s
+
+// No single rule can match 29 and 26 without also matching 28, which leaves
+// tile (0, 2) through another port, so the two IDs get a rule each.
+
+// CHECK:       aie.tile(0, 2)
+// CHECK:       aie.switchbox
+// CHECK-DAG:     aie.rule(31, 28, %{{.*}})
+// CHECK-DAG:     aie.rule(31, 29, %{{.*}})
+// CHECK-DAG:     aie.rule(31, 26, %{{.*}})
+
+aie.device(npu1_1col) {
+  %03 = aie.tile(0, 3)
+  %02 = aie.tile(0, 2)
+  %00 = aie.tile(0, 0)
+  aie.packet_flow(28) {
+    aie.packet_source<%00, DMA : 0>
+    aie.packet_dest<%02, Ctrl : 0>
+  }
+  aie.packet_flow(29) {
+    aie.packet_source<%00, DMA : 0>
+    aie.packet_dest<%03, Ctrl : 0>
+  }
+  aie.packet_flow(26) {
+    aie.packet_source<%00, DMA : 0>
+    aie.packet_dest<%03, DMA : 0>
+  }
+}
@@ -0,0 +1,19 @@
+//===- baddevice_name.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: not aie-opt %s 2>&1 | FileCheck %s
+// CHECK: error: redefinition of symbol named 'dev'
+
+module {
+  aie.device(npu1_1col) @dev {
+  }
+  aie.device(npu1_1col) @dev {
+  }
+}
@@ -0,0 +1,27 @@
+//===- badpacket_rules.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: not aie-opt %s 2>&1 | FileCheck %s
+// CHECK: error{{.*}} 'aie.packet_rules' op cannot hold more than 4 rules
+
+aie.device(npu1_1col) {
+  %02 = aie.tile(0, 2)
+  aie.switchbox(%02) {
+    %94 = aie.amsel<0> (0)
+    %95 = aie.masterset(North : 0, %94)
+    aie.packet_rules(DMA : 0) {
+      aie.rule(31, 1, %94)
+      aie.rule(31, 2, %94)
+      aie.rule(31, 3, %94)
+      aie.rule(31, 4, %94)
+      aie.rule(31, 5, %94)
+    }
+  }
+}
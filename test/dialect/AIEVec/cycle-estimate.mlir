@@ -0,0 +1,118 @@
+// RUN: aie-opt %s -split-input-file -aievec-cycle-estimate | FileCheck %s
+// RUN: aie-opt %s -split-input-file -aievec-cycle-estimate="print=false annotate=true" | FileCheck %s --check-prefix=ATTR
+
+// The operands of one 4x8x8 i8 matmul take 768 bits of loads, which the two
+// 256-bit load ports need two cycles for.
+
+// CHECK-LABEL: loop 0 in @matmul_i8
+// CHECK-NEXT:    ops/iter: vector=1 load=2 store=0 move=0 scalar=0
+// CHECK-NEXT:    cycles/iter: 2 (load bound)
+// CHECK-NEXT:    trip count: 16, total cycles: 32
+// CHECK-NEXT:    registers: vector=2/12 acc=1/9 spills=0
+// CHECK-NEXT:    bank conflicts: 0
+// CHECK-NEXT:    MACs/iter: 256, peak 256/cycle, utilisation 50.0%
+
+// ATTR-LABEL: func.func @matmul_i8
+// ATTR: scf.for
+// ATTR: } {aievec.cycles_per_iter = 2 : i64, aievec.mac_utilisation = 5.000000e-01 : f64}
+func.func @matmul_i8(%A : memref<16x32xi8>, %B : memref<16x64xi8>,
+                     %C : vector<4x8xi32>) -> vector<4x8xi32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  %0 = scf.for %i = %c0 to %c16 step %c1 iter_args(%acc = %C)
+      -> (vector<4x8xi32>) {
+    %a = aievec.upd %A[%i, %c0] {index = 0 : i8, offset = 0 : i32}
+        : memref<16x32xi8>, vector<32xi8>
+    %b = aievec.upd %B[%i, %c0] {index = 0 : i8, offset = 0 : i32}
+        : memref<16x64xi8>, vector<64xi8>
+    %a2 = vector.shape_cast %a : vector<32xi8> to vector<4x8xi8>
+    %b2 = vector.shape_cast %b : vector<64xi8> to vector<8x8xi8>
+    %r = aievec.matmul %a2, %b2, %acc : vector<4x8xi8>, vector<8x8xi8>
+                                        into vector<4x8xi32>
+    scf.yield %r : vector<4x8xi32>
+  }
+  return %0 : vector<4x8xi32>
+}
+
+// -----
+
+// Both operands come from the same buffer, so the loads share a bank and
+// serialize on one port.
+
+// CHECK-LABEL: loop 0 in @same_bank
+// CHECK-NEXT:    ops/iter: vector=1 load=2 store=0 move=0 scalar=0
+// CHECK-NEXT:    cycles/iter: 3 (load bound)
+// CHECK:         bank conflicts: 1
+// CHECK-NEXT:    MACs/iter: 256, peak 256/cycle, utilisation 33.3%
+func.func @same_bank(%A : memref<16x96xi8>, %C : vector<4x8xi32>)
+    -> vector<4x8xi32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c32 = arith.constant 32 : index
+  %c16 = arith.constant 16 : index
+  %0 = scf.for %i = %c0 to %c16 step %c1 iter_args(%acc = %C)
+      -> (vector<4x8xi32>) {
+    %a = aievec.upd %A[%i, %c0] {index = 0 : i8, offset = 0 : i32}
+        : memref<16x96xi8>, vector<32xi8>
+    %b = aievec.upd %A[%i, %c32] {index = 0 : i8, offset = 0 : i32}
+        : memref<16x96xi8>, vector<64xi8>
+    %a2 = vector.shape_cast %a : vector<32xi8> to vector<4x8xi8>
+    %b2 = vector.shape_cast %b : vector<64xi8> to vector<8x8xi8>
+    %r = aievec.matmul %a2, %b2, %acc : vector<4x8xi8>, vector<8x8xi8>
+                                        into vector<4x8xi32>
+    scf.yield %r : vector<4x8xi32>
+  }
+  return %0 : vector<4x8xi32>
+}
+
+// -----
+
+// Only the innermost loop is estimated. Its bf16 elementwise MACs are
+// limited by the store port.
+
+// CHECK-LABEL: loop 0 in @nested
+// CHECK-NEXT:    ops/iter: vector=1 load=2 store=1 move=1 scalar=0
+// CHECK-NEXT:    cycles/iter: 2 (store bound)
+// CHECK-NEXT:    trip count: 8, total cycles: 16
+// CHECK:         MACs/iter: 16, peak 128/cycle, utilisation {{6\.[23]}}%
+// CHECK-NOT:   loop 1
+func.func @nested(%A : memref<8x16xbf16>, %B : memref<8x16xbf16>,
+                  %C : memref<8x16xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  scf.for %j = %c0 to %c8 step %c1 {
+    scf.for %i = %c0 to %c8 step %c1 {
+      %a = aievec.upd %A[%i, %c0] {index = 0 : i8, offset = 0 : i32}
+          : memref<8x16xbf16>, vector<16xbf16>
+      %b = aievec.upd %B[%i, %c0] {index = 0 : i8, offset = 0 : i32}
+          : memref<8x16xbf16>, vector<16xbf16>
+      %c = aievec.mul_elem %a, %b : vector<16xbf16>, vector<16xbf16>,
+                                    vector<16xf32>
+      %d = aievec.cast %c {isResAcc = false} : vector<16xf32>, vector<16xf32>
+      %e = vector.broadcast %d : vector<16xf32> to vector<1x16xf32>
+      vector.transfer_write %e, %C[%i, %c0] {in_bounds = [true, true]}
+          : vector<1x16xf32>, memref<8x16xf32>
+    }
+  }
+  return
+}
+
+// -----
+
+// Loop-carried values that yield each other take the register class of
+// neither, rather than recursing through the pair forever.
+
+// CHECK-LABEL: loop 0 in @swap
+// CHECK:         registers: vector=2/12 acc=0/9 spills=0
+func.func @swap(%x : vector<16xi32>, %y : vector<16xi32>) -> vector<16xi32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %0:2 = scf.for %i = %c0 to %c8 step %c1 iter_args(%a = %x, %b = %y)
+      -> (vector<16xi32>, vector<16xi32>) {
+    scf.yield %b, %a : vector<16xi32>, vector<16xi32>
+  }
+  return %0#0 : vector<16xi32>
+}
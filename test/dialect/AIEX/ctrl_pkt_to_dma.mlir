@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt %s -aie-ctrl-packet-to-dma --split-input-file | FileCheck %s
+// RUN: aie-opt %s -aie-ctrl-packet-to-dma="parallel-channels=true" --split-input-file | FileCheck %s --check-prefix=PARALLEL
 
 // transforms control packet ops to dma memcpy ops and sync ops.
 
@@ -42,3 +43,65 @@ aie.device(npu1_1col) {
   aie.shim_dma_allocation @ctrlpkt_col0_mm2s_chan0(MM2S, 0, 0)
   memref.global "public" @ctrlpkt_col0_mm2s_chan0 : memref<2048xi32>
 }
+
+// -----
+
+// Rows 2 and 4 are served by different shim channels, so their packets are
+// sent together. The third packet waits for the first.
+
+// PARALLEL-LABEL: aie.device(npu1_1col) {
+// PARALLEL: aiex.runtime_sequence(%[[ARG0:.*]]: memref<?xi32>) {
+// PARALLEL: aiex.npu.dma_memcpy_nd(0, 0, %[[ARG0]][0, 0, 0, 0][1, 1, 1, 2][0, 0, 0, 1], packet = <pkt_type = 0, pkt_id = 27>) {id = 0 : i64, issue_token = true, metadata = @ctrlpkt_col0_mm2s_chan0} : memref<?xi32>
+// PARALLEL: aiex.npu.dma_memcpy_nd(0, 0, %[[ARG0]][0, 0, 0, 2][1, 1, 1, 3][0, 0, 0, 1], packet = <pkt_type = 0, pkt_id = 29>) {id = 1 : i64, issue_token = true, metadata = @ctrlpkt_col0_mm2s_chan1} : memref<?xi32>
+// PARALLEL: aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// PARALLEL: aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// PARALLEL: aiex.npu.dma_memcpy_nd(0, 0, %[[ARG0]][0, 0, 0, 5][1, 1, 1, 2][0, 0, 0, 1], packet = <pkt_type = 0, pkt_id = 27>) {id = 0 : i64, issue_token = true, metadata = @ctrlpkt_col0_mm2s_chan0} : memref<?xi32>
+// PARALLEL: aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+
+aie.device(npu1_1col) {
+  %tile_0_0 = aie.tile(0, 0)
+  %tile_0_2 = aie.tile(0, 2) {controller_id = #aie.packet_info<pkt_type = 0, pkt_id = 27>}
+  %tile_0_4 = aie.tile(0, 4) {controller_id = #aie.packet_info<pkt_type = 0, pkt_id = 29>}
+  aiex.runtime_sequence() {
+    aiex.control_packet {address = 2215936 : ui32, data = array<i32: 0>, opcode = 0 : i32, stream_id = 0 : i32}
+    aiex.control_packet {address = 4313088 : ui32, data = array<i32: 1, 2>, opcode = 0 : i32, stream_id = 0 : i32}
+    aiex.control_packet {address = 2215940 : ui32, data = array<i32: 3>, opcode = 0 : i32, stream_id = 0 : i32}
+  }
+  aie.shim_dma_allocation @ctrlpkt_col0_mm2s_chan0(MM2S, 0, 0)
+  memref.global "public" @ctrlpkt_col0_mm2s_chan0 : memref<2048xi32>
+  aie.shim_dma_allocation @ctrlpkt_col0_mm2s_chan1(MM2S, 1, 0)
+  memref.global "public" @ctrlpkt_col0_mm2s_chan1 : memref<2048xi32>
+}
+
+// -----
+
+// The core control write to tile (1, 2) would share a round with the writes
+// to column 0. It is sent after they have arrived, on its own.
+
+// PARALLEL-LABEL: aie.device(npu1_2col) {
+// PARALLEL: aiex.runtime_sequence(%[[ARG0:.*]]: memref<?xi32>) {
+// PARALLEL: aiex.npu.dma_memcpy_nd(0, 0, %[[ARG0]][0, 0, 0, 0][1, 1, 1, 2][0, 0, 0, 1], packet = <pkt_type = 0, pkt_id = 27>) {id = 0 : i64, issue_token = true, metadata = @ctrlpkt_col0_mm2s_chan0} : memref<?xi32>
+// PARALLEL: aiex.npu.dma_memcpy_nd(0, 0, %[[ARG0]][0, 0, 0, 2][1, 1, 1, 2][0, 0, 0, 1], packet = <pkt_type = 0, pkt_id = 29>) {id = 1 : i64, issue_token = true, metadata = @ctrlpkt_col0_mm2s_chan1} : memref<?xi32>
+// PARALLEL: aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// PARALLEL: aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// PARALLEL: aiex.npu.dma_memcpy_nd(0, 0, %[[ARG0]][0, 0, 0, 4][1, 1, 1, 2][0, 0, 0, 1], packet = <pkt_type = 0, pkt_id = 27>) {id = 0 : i64, issue_token = true, metadata = @ctrlpkt_col1_mm2s_chan0} : memref<?xi32>
+// PARALLEL: aiex.npu.sync {channel = 0 : i32, column = 1 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+
+aie.device(npu1_2col) {
+  %tile_0_0 = aie.tile(0, 0)
+  %tile_1_0 = aie.tile(1, 0)
+  %tile_0_2 = aie.tile(0, 2) {controller_id = #aie.packet_info<pkt_type = 0, pkt_id = 27>}
+  %tile_0_4 = aie.tile(0, 4) {controller_id = #aie.packet_info<pkt_type = 0, pkt_id = 29>}
+  %tile_1_2 = aie.tile(1, 2) {controller_id = #aie.packet_info<pkt_type = 0, pkt_id = 27>}
+  aiex.runtime_sequence() {
+    aiex.control_packet {address = 2215936 : ui32, data = array<i32: 0>, opcode = 0 : i32, stream_id = 0 : i32}
+    aiex.control_packet {address = 4313088 : ui32, data = array<i32: 1>, opcode = 0 : i32, stream_id = 0 : i32}
+    aiex.control_packet {address = 35856384 : ui32, data = array<i32: 1>, opcode = 0 : i32, stream_id = 0 : i32}
+  }
+  aie.shim_dma_allocation @ctrlpkt_col0_mm2s_chan0(MM2S, 0, 0)
+  memref.global "public" @ctrlpkt_col0_mm2s_chan0 : memref<2048xi32>
+  aie.shim_dma_allocation @ctrlpkt_col0_mm2s_chan1(MM2S, 1, 0)
+  memref.global "public" @ctrlpkt_col0_mm2s_chan1 : memref<2048xi32>
+  aie.shim_dma_allocation @ctrlpkt_col1_mm2s_chan0(MM2S, 0, 1)
+  memref.global "public" @ctrlpkt_col1_mm2s_chan0 : memref<2048xi32>
+}
@@ -0,0 +1,70 @@
+//===- lower_vector_stream.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --aie-standard-lowering %s | FileCheck %s
+
+// AIE1 streams vectors 128 bits at a time, and any remaining words one by one.
+
+// CHECK-LABEL: func.func @core_1_1()
+// CHECK:         %[[WORDS:.*]] = vector.bitcast %{{.*}} : vector<5xf32> to vector<5xi32>
+// CHECK:         %[[CHUNK:.*]] = vector.extract_strided_slice %[[WORDS]] {offsets = [0], sizes = [4], strides = [1]}
+// CHECK:         %[[WIDE:.*]] = vector.bitcast %[[CHUNK]] : vector<4xi32> to vector<1xi128>
+// CHECK:         %[[WIDE0:.*]] = vector.extract %[[WIDE]][0] : i128 from vector<1xi128>
+// CHECK:         call @llvm.aie.put.wms(%{{.*}}, %[[WIDE0]]) : (i32, i128) -> ()
+// CHECK:         %[[LAST:.*]] = vector.extract %[[WORDS]][4] : i32 from vector<5xi32>
+// CHECK:         call @llvm.aie.put.ms(%{{.*}}, %[[LAST]]) : (i32, i32) -> ()
+// CHECK:         %[[GET:.*]] = call @llvm.aie.get.wss(%{{.*}}) : (i32) -> i128
+// CHECK:         vector.broadcast %[[GET]] : i128 to vector<1xi128>
+// CHECK:         vector.insert_strided_slice %{{.*}}, %{{.*}} {offsets = [0], strides = [1]} : vector<4xi32> into vector<4xi32>
+// CHECK:         vector.bitcast %{{.*}} : vector<4xi32> to vector<8xi16>
+// CHECK-NOT:     llvm.aie.get.ss
+
+module @aie1 {
+  aie.device(xcvc1902) {
+    %tile11 = aie.tile(1, 1)
+    %core11 = aie.core(%tile11) {
+      %c0 = arith.constant 0 : i32
+      %v = arith.constant dense<1.0> : vector<5xf32>
+      aie.put_stream(%c0 : i32, %v : vector<5xf32>)
+      %w = aie.get_stream(%c0 : i32) : vector<8xi16>
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// AIE2 cores only have 32-bit stream accesses.
+
+// CHECK-LABEL: func.func @core_0_2()
+// CHECK:         %[[WORDS:.*]] = vector.bitcast %{{.*}} : vector<4xi16> to vector<2xi32>
+// CHECK:         %[[W0:.*]] = vector.extract %[[WORDS]][0] : i32 from vector<2xi32>
+// CHECK:         call @llvm.aie2.put.ms(%[[W0]], %{{.*}}) : (i32, i32) -> ()
+// CHECK:         %[[W1:.*]] = vector.extract %[[WORDS]][1] : i32 from vector<2xi32>
+// CHECK:         call @llvm.aie2.put.ms(%[[W1]], %{{.*}}) : (i32, i32) -> ()
+// CHECK:         %[[ZERO:.*]] = arith.constant dense<0> : vector<2xi32>
+// CHECK:         %[[G0:.*]]:2 = call @llvm.aie2.get.ss() : () -> (i32, i32)
+// CHECK:         %[[V0:.*]] = vector.insert %[[G0]]#0, %[[ZERO]] [0] : i32 into vector<2xi32>
+// CHECK:         %[[G1:.*]]:2 = call @llvm.aie2.get.ss() : () -> (i32, i32)
+// CHECK:         %[[V1:.*]] = vector.insert %[[G1]]#0, %[[V0]] [1] : i32 into vector<2xi32>
+// CHECK:         vector.bitcast %[[V1]] : vector<2xi32> to vector<2xf32>
+
+module @aie2 {
+  aie.device(npu1_1col) {
+    %tile02 = aie.tile(0, 2)
+    %core02 = aie.core(%tile02) {
+      %c0 = arith.constant 0 : i32
+      %v = arith.constant dense<1> : vector<4xi16>
+      aie.put_stream(%c0 : i32, %v : vector<4xi16>)
+      %w = aie.get_stream(%c0 : i32) : vector<2xf32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,97 @@
+//===- depth_sizing.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-depth-sizing="print" %s | FileCheck %s
+// RUN: aie-opt --aie-objectFifo-depth-sizing="report-only" %s | FileCheck %s --check-prefix=REPORT
+
+// A core between two DMAs needs double buffers on both sides to overlap its
+// kernel with the transfers.
+// CHECK-LABEL: objectFifo depth sizing for npu1_1col:
+// CHECK-NEXT:    @of_in consumer buffers in (0, 2): depth 1 -> 2 (256 bytes/object)
+// CHECK-NEXT:    @of_out producer buffers in (0, 2): depth 1 -> 2 (256 bytes/object)
+// CHECK-NEXT:    core (0, 2): 100.0 cycles/iteration (unbounded 100.0), busy 99.3%
+// CHECK-NEXT:    dma @of_in: 100.0 cycles/iteration (unbounded 100.0), busy 65.1%
+// CHECK-NEXT:    dma @of_out: 100.0 cycles/iteration (unbounded 100.0), busy 62.0%
+// CHECK-NEXT:    bottleneck: core (0, 2)
+
+// The consumer takes two objects at a time, so the producer needs room for two
+// more to keep running while the consumer holds them.
+// CHECK-LABEL: objectFifo depth sizing for npu1_1col:
+// CHECK-NEXT:    @of_shared producer buffers in (0, 2): depth 2 -> 4 (64 bytes/object)
+// CHECK-NEXT:    core (0, 2): 50.0 cycles/iteration (unbounded 50.0), busy 81.4%
+// CHECK-NEXT:    core (0, 3): 100.0 cycles/iteration (unbounded 100.0), busy 100.0%
+// CHECK-NEXT:    bottleneck: core (0, 3)
+
+// CHECK:         aie.objectfifo @of_in(%{{.*}}tile_0_0, {%{{.*}}tile_0_2}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+// CHECK:         aie.objectfifo @of_out(%{{.*}}tile_0_2, {%{{.*}}tile_0_0}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+// CHECK:         aie.objectfifo @of_shared(%{{.*}}tile_0_2, {%{{.*}}tile_0_3}, 4 : i32) : !aie.objectfifo<memref<16xi32>>
+
+// REPORT-NOT:    objectFifo depth sizing
+// REPORT:        aie.objectfifo @of_in(%{{.*}}tile_0_0, {%{{.*}}tile_0_2}, 1 : i32)
+// REPORT:        aie.objectfifo @of_out(%{{.*}}tile_0_2, {%{{.*}}tile_0_0}, 1 : i32)
+// REPORT:        aie.objectfifo @of_shared(%{{.*}}tile_0_2, {%{{.*}}tile_0_3}, 2 : i32)
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_2 = aie.tile(0, 2)
+    aie.objectfifo @of_in(%tile_0_0, {%tile_0_2}, 1 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @of_out(%tile_0_2, {%tile_0_0}, 1 : i32) : !aie.objectfifo<memref<64xi32>>
+    func.func private @scale(memref<64xi32>, memref<64xi32>) attributes {aie.kernel_cycles = 100 : i64}
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %cmax = arith.constant 0xFFFFFFFF : index
+      scf.for %i = %c0 to %cmax step %c1 {
+        %in = aie.objectfifo.acquire @of_in(Consume, 1) : !aie.objectfifosubview<memref<64xi32>>
+        %elem_in = aie.objectfifo.subview.access %in[0] : !aie.objectfifosubview<memref<64xi32>> -> memref<64xi32>
+        %out = aie.objectfifo.acquire @of_out(Produce, 1) : !aie.objectfifosubview<memref<64xi32>>
+        %elem_out = aie.objectfifo.subview.access %out[0] : !aie.objectfifosubview<memref<64xi32>> -> memref<64xi32>
+        func.call @scale(%elem_in, %elem_out) : (memref<64xi32>, memref<64xi32>) -> ()
+        aie.objectfifo.release @of_in(Consume, 1)
+        aie.objectfifo.release @of_out(Produce, 1)
+      }
+      aie.end
+    }
+  }
+
+  aie.device(npu1_1col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    aie.objectfifo @of_shared(%tile_0_2, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    func.func private @fill(memref<16xi32>)
+    func.func private @reduce(memref<16xi32>, memref<16xi32>) attributes {aie.kernel_cycles = 100 : i64}
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %cmax = arith.constant 0xFFFFFFFF : index
+      scf.for %i = %c0 to %cmax step %c1 {
+        %out = aie.objectfifo.acquire @of_shared(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %elem = aie.objectfifo.subview.access %out[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @fill(%elem) {aie.kernel_cycles = 40 : i64} : (memref<16xi32>) -> ()
+        aie.objectfifo.release @of_shared(Produce, 1)
+      }
+      aie.end
+    }
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %cmax = arith.constant 0xFFFFFFFF : index
+      scf.for %i = %c0 to %cmax step %c1 {
+        %in = aie.objectfifo.acquire @of_shared(Consume, 2) : !aie.objectfifosubview<memref<16xi32>>
+        %elem0 = aie.objectfifo.subview.access %in[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %elem1 = aie.objectfifo.subview.access %in[1] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @reduce(%elem0, %elem1) : (memref<16xi32>, memref<16xi32>) -> ()
+        aie.objectfifo.release @of_shared(Consume, 2)
+      }
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,64 @@
+//===- distribute.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-depth-sizing="print" %s | FileCheck %s
+
+// The MemTile distributes each object of @of_in over two cores. Its buffers
+// are shared by @of_in and the producer side of @of_a and @of_b, and one
+// DMA actor moves both halves. Each core needs a second object to overlap its
+// kernel with the distribute, while the MemTile needs a single object, as the
+// shim DMA refills it faster than the cores consume it.
+// CHECK-LABEL: objectFifo depth sizing for npu1_1col:
+// CHECK-NEXT:    @of_in consumer buffers in (0, 1): depth 2 -> 1 (512 bytes/object)
+// CHECK-NEXT:    @of_a consumer buffers in (0, 2): depth 1 -> 2 (256 bytes/object)
+// CHECK-NEXT:    @of_b consumer buffers in (0, 3): depth 1 -> 2 (256 bytes/object)
+// CHECK-NEXT:    core (0, 2): 200.0 cycles/iteration (unbounded 200.0), busy {{.*}}%
+// CHECK-NEXT:    core (0, 3): 200.0 cycles/iteration (unbounded 200.0), busy {{.*}}%
+// CHECK-NEXT:    dma @of_in: {{.*}} cycles/iteration (unbounded 200.0), busy {{.*}}%
+// CHECK-NEXT:    dma @of_a, @of_b: {{.*}} cycles/iteration (unbounded 200.0), busy {{.*}}%
+// CHECK-NEXT:    bottleneck: core (0, 2)
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    aie.objectfifo @of_in(%tile_0_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<128xi32>>
+    aie.objectfifo @of_a(%tile_0_1, {%tile_0_2}, 1 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @of_b(%tile_0_1, {%tile_0_3}, 1 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo.link [@of_in] -> [@of_a, @of_b] ([] [0, 64])
+    func.func private @consume(memref<64xi32>) attributes {aie.kernel_cycles = 200 : i64}
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %cmax = arith.constant 0xFFFFFFFF : index
+      scf.for %i = %c0 to %cmax step %c1 {
+        %in = aie.objectfifo.acquire @of_a(Consume, 1) : !aie.objectfifosubview<memref<64xi32>>
+        %elem = aie.objectfifo.subview.access %in[0] : !aie.objectfifosubview<memref<64xi32>> -> memref<64xi32>
+        func.call @consume(%elem) : (memref<64xi32>) -> ()
+        aie.objectfifo.release @of_a(Consume, 1)
+      }
+      aie.end
+    }
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %cmax = arith.constant 0xFFFFFFFF : index
+      scf.for %i = %c0 to %cmax step %c1 {
+        %in = aie.objectfifo.acquire @of_b(Consume, 1) : !aie.objectfifosubview<memref<64xi32>>
+        %elem = aie.objectfifo.subview.access %in[0] : !aie.objectfifosubview<memref<64xi32>> -> memref<64xi32>
+        func.call @consume(%elem) : (memref<64xi32>) -> ()
+        aie.objectfifo.release @of_b(Consume, 1)
+      }
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,76 @@
+//===- loop_test.mlir ------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-software-pipeline %s | FileCheck %s
+
+// CHECK-LABEL: aie.device(xcve2302) {
+// CHECK:         %core_1_2 = aie.core(%tile_1_2) {
+// CHECK:           %[[C0:.*]] = arith.constant 0 : index
+// CHECK:           %[[C1:.*]] = arith.constant 1 : index
+// CHECK:           %[[C4:.*]] = arith.constant 4 : index
+// CHECK:           aie.objectfifo.acquire @of_in(Consume, 1)
+// CHECK:           aie.objectfifo.acquire @of_out(Produce, 1)
+// CHECK:           %[[C3:.*]] = arith.constant 3 : index
+// CHECK:           scf.for %[[I:.*]] = %[[C0]] to %[[C3]] step %[[C1]] {
+// CHECK:             %[[IN:.*]] = aie.objectfifo.acquire @of_in(Consume, 2)
+// CHECK:             %[[OUT:.*]] = aie.objectfifo.acquire @of_out(Produce, 2)
+// CHECK:             %[[ELEM_IN:.*]] = aie.objectfifo.subview.access %[[IN]][0]
+// CHECK:             %[[ELEM_OUT:.*]] = aie.objectfifo.subview.access %[[OUT]][0]
+// CHECK:             func.call @some_work(%[[ELEM_IN]], %[[ELEM_OUT]], %[[I]])
+// CHECK:             aie.objectfifo.release @of_in(Consume, 1)
+// CHECK:             aie.objectfifo.release @of_out(Produce, 1)
+// CHECK:           }
+// CHECK:           %[[LAST_IN:.*]] = aie.objectfifo.acquire @of_in(Consume, 1)
+// CHECK:           %[[LAST_OUT:.*]] = aie.objectfifo.acquire @of_out(Produce, 1)
+// CHECK:           %[[LAST_ELEM_IN:.*]] = aie.objectfifo.subview.access %[[LAST_IN]][0]
+// CHECK:           %[[LAST_ELEM_OUT:.*]] = aie.objectfifo.subview.access %[[LAST_OUT]][0]
+// CHECK:           func.call @some_work(%[[LAST_ELEM_IN]], %[[LAST_ELEM_OUT]], %[[C3]])
+// CHECK:           aie.objectfifo.release @of_in(Consume, 1)
+// CHECK:           aie.objectfifo.release @of_out(Produce, 1)
+// CHECK:           scf.for %{{.*}} = %[[C0]] to %[[C4]] step %[[C1]] {
+// CHECK:             aie.objectfifo.acquire @of_small(Consume, 1)
+// CHECK:             aie.objectfifo.release @of_small(Consume, 1)
+// CHECK:           }
+// CHECK:           aie.end
+
+module {
+  aie.device(xcve2302) {
+    %tile12 = aie.tile(1, 2)
+    %tile13 = aie.tile(1, 3)
+    aie.objectfifo @of_in (%tile13, {%tile12}, 4 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @of_out (%tile12, {%tile13}, 3 : i32) : !aie.objectfifo<memref<16xi32>>
+    // Too shallow to hold the objects of two iterations.
+    aie.objectfifo @of_small (%tile13, {%tile12}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    func.func @some_work(%line_in:memref<16xi32>, %line_out:memref<16xi32>, %index:index) -> () {
+      return
+    }
+    %core12 = aie.core(%tile12) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c4 = arith.constant 4 : index
+      scf.for %i = %c0 to %c4 step %c1 {
+        %subviewIn = aie.objectfifo.acquire @of_in (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %subviewOut = aie.objectfifo.acquire @of_out (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %elemIn = aie.objectfifo.subview.access %subviewIn[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %elemOut = aie.objectfifo.subview.access %subviewOut[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @some_work(%elemIn, %elemOut, %i) : (memref<16xi32>, memref<16xi32>, index) -> ()
+        aie.objectfifo.release @of_in (Consume, 1)
+        aie.objectfifo.release @of_out (Produce, 1)
+      }
+      scf.for %j = %c0 to %c4 step %c1 {
+        %subview = aie.objectfifo.acquire @of_small (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %elem = aie.objectfifo.subview.access %subview[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @some_work(%elem, %elem, %j) : (memref<16xi32>, memref<16xi32>, index) -> ()
+        aie.objectfifo.release @of_small (Consume, 1)
+      }
+      aie.end
+    }
+  }
+}
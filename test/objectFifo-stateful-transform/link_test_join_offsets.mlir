@@ -45,10 +45,10 @@
 // CHECK:     %link1_buff_1 = aie.buffer(%tile_2_2) {sym_name = "link1_buff_1"} : memref<4x4xi32> 
 // CHECK:     %link1_prod_lock = aie.lock(%tile_2_2, 0) {init = 2 : i32, sym_name = "link1_prod_lock"}
 // CHECK:     %link1_cons_lock = aie.lock(%tile_2_2, 1) {init = 0 : i32, sym_name = "link1_cons_lock"}
-// CHECK:     aie.flow(%tile_2_2, DMA : 0, %tile_2_1, DMA : 0)
-// CHECK:     aie.flow(%tile_2_3, DMA : 0, %tile_2_1, DMA : 1)
-// CHECK:     aie.flow(%tile_3_3, DMA : 0, %tile_2_1, DMA : 2)
-// CHECK:     aie.flow(%tile_2_1, DMA : 0, %tile_2_0, DMA : 0)
+// CHECK:     aie.flow(%tile_2_2, DMA : 0, %tile_2_1, DMA : 0) {aie.balance_group = "link4"}
+// CHECK:     aie.flow(%tile_2_3, DMA : 0, %tile_2_1, DMA : 1) {aie.balance_group = "link4"}
+// CHECK:     aie.flow(%tile_3_3, DMA : 0, %tile_2_1, DMA : 2) {aie.balance_group = "link4"}
+// CHECK:     aie.flow(%tile_2_1, DMA : 0, %tile_2_0, DMA : 0){{$}}
 // CHECK:     %mem_2_2 = aie.mem(%tile_2_2) {
 // CHECK:       %0 = aie.dma_start(MM2S, 0, ^bb1, ^bb3)
 // CHECK:     ^bb1:  // 2 preds: ^bb0, ^bb2
@@ -0,0 +1,102 @@
+//===- loop_cost_model_test.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --aie-objectFifo-stateful-transform="loop-cost-model program-memory-size=800" %s | FileCheck %s
+
+// Fully unrolling the loops over objectFifos with depths 2, 3, 5 (30 copies)
+// or 2, 3, 7 (42 copies) does not fit in the program memory size. The first
+// one keeps its loop rolled and rotates the buffers through loop-carried
+// values; rotating seven buffers does not fit for the second one, which is
+// unrolled by 2 and accesses the other objectFifos through a runtime index.
+
+// CHECK-LABEL: %core_0_2 = aie.core(%tile_0_2) {
+// CHECK:         scf.for
+// CHECK:           func.call @work1
+// CHECK:           func.call @work1
+// CHECK:         scf.index_switch
+// CHECK:         scf.for %{{[^ ]+}} = %{{[^ ]+}} to %{{[^ ]+}} step %{{[^ ]+}} iter_args(%[[A0:[^ ]+]] = %{{[^ ]+}}, %[[A1:[^ ]+]] = %{{[^ ]+}}, %[[B0:[^ ]+]] = %{{[^ ]+}}, %[[B1:[^ ]+]] = %{{[^ ]+}}, %[[B2:[^ ]+]] = %{{[^ ]+}}, %[[C0:[^ ]+]] = %{{[^ ]+}}, %[[C1:[^ ]+]] = %{{[^ ]+}}, %[[C2:[^ ]+]] = %{{[^ ]+}}, %[[C3:[^ ]+]] = %{{[^ ]+}}, %[[C4:[^ ]+]] = %{{[^ ]+}})
+// CHECK:           func.call @work3(%[[A0]], %[[B0]], %[[C0]])
+// CHECK:           scf.yield %[[A1]], %[[A0]], %[[B1]], %[[B2]], %[[B0]], %[[C1]], %[[C2]], %[[C3]], %[[C4]], %[[C0]] :
+// CHECK:         aie.end
+// CHECK-LABEL: %core_0_4 = aie.core(%tile_0_4) {
+// CHECK:         scf.for
+// CHECK:           scf.index_switch
+// CHECK:           func.call @work3
+// CHECK:           scf.index_switch
+// CHECK:           func.call @work3
+// CHECK:         aie.end
+
+module @loop_cost_model {
+  aie.device(npu1_1col) {
+    %tile02 = aie.tile(0, 2)
+    %tile03 = aie.tile(0, 3)
+    %tile04 = aie.tile(0, 4)
+    %tile05 = aie.tile(0, 5)
+
+    aie.objectfifo @s2 (%tile02, {%tile03}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @a2 (%tile02, {%tile03}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @a3 (%tile02, {%tile03}, 3 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @a5 (%tile02, {%tile03}, 5 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @b2 (%tile04, {%tile05}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @b3 (%tile04, {%tile05}, 3 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @b7 (%tile04, {%tile05}, 7 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    func.func private @work1(memref<16xi32>) -> ()
+    func.func private @work3(memref<16xi32>, memref<16xi32>, memref<16xi32>) -> ()
+
+    %core02 = aie.core(%tile02) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c4 = arith.constant 4 : index
+      %c30 = arith.constant 30 : index
+      // expected-remark@+1 {{objectFifo loop lowering: unroll by 2 (estimated +24 bytes of program memory, +0 cycles)}}
+      scf.for %i = %c0 to %c4 step %c1 {
+        %sv = aie.objectfifo.acquire @s2 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %s = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @work1(%s) : (memref<16xi32>) -> ()
+        aie.objectfifo.release @s2 (Produce, 1)
+      }
+      // expected-remark@+1 {{objectFifo loop lowering: rotating buffer table for @a2, @a3, @a5 (estimated +600 bytes of program memory, +330 cycles)}}
+      scf.for %i = %c0 to %c30 step %c1 {
+        %av = aie.objectfifo.acquire @a2 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %bv = aie.objectfifo.acquire @a3 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %cv = aie.objectfifo.acquire @a5 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %a = aie.objectfifo.subview.access %av[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %b = aie.objectfifo.subview.access %bv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %c = aie.objectfifo.subview.access %cv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @work3(%a, %b, %c) : (memref<16xi32>, memref<16xi32>, memref<16xi32>) -> ()
+        aie.objectfifo.release @a2 (Produce, 1)
+        aie.objectfifo.release @a3 (Produce, 1)
+        aie.objectfifo.release @a5 (Produce, 1)
+      }
+      aie.end
+    }
+
+    %core04 = aie.core(%tile04) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c42 = arith.constant 42 : index
+      // expected-remark@+1 {{objectFifo loop lowering: partial unroll by 2 with runtime index for @b3, @b7 (estimated +504 bytes of program memory, +840 cycles)}}
+      scf.for %i = %c0 to %c42 step %c1 {
+        %av = aie.objectfifo.acquire @b2 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %bv = aie.objectfifo.acquire @b3 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %cv = aie.objectfifo.acquire @b7 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+        %a = aie.objectfifo.subview.access %av[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %b = aie.objectfifo.subview.access %bv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        %c = aie.objectfifo.subview.access %cv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+        func.call @work3(%a, %b, %c) : (memref<16xi32>, memref<16xi32>, memref<16xi32>) -> ()
+        aie.objectfifo.release @b2 (Produce, 1)
+        aie.objectfifo.release @b3 (Produce, 1)
+        aie.objectfifo.release @b7 (Produce, 1)
+      }
+      aie.end
+    }
+  }
+}
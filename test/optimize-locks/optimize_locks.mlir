@@ -0,0 +1,98 @@
+//===- optimize_locks.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-optimize-locks %s | FileCheck %s
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:         %[[PROD:.*]] = aie.lock(%{{.*}}, 0) {init = 2 : i32}
+// CHECK:         %[[CONS:.*]] = aie.lock(%{{.*}}, 1) {init = 0 : i32}
+// CHECK:         %[[PRIV:.*]] = aie.lock(%{{.*}}, 2) {init = 1 : i32}
+// CHECK:         aie.core
+// Two acquires become one.
+// CHECK-NEXT:      aie.use_lock(%[[PROD]], AcquireGreaterEqual, 2)
+// CHECK-NEXT:      arith.constant
+// CHECK-NEXT:      arith.constant
+// CHECK-NEXT:      memref.store
+// Two releases become one, at the position of the second.
+// CHECK-NEXT:      arith.constant
+// CHECK-NEXT:      aie.use_lock(%[[CONS]], Release, 2)
+// CHECK-NEXT:      memref.store
+// A release followed by an acquire of a lock only this core acquires
+// cancels out.
+// CHECK-NEXT:      aie.use_lock(%[[PRIV]], Release, 1)
+// The DMA acquires the consumer lock, so the release stays visible to it.
+// CHECK-NEXT:      aie.use_lock(%[[CONS]], Release, 1)
+// CHECK-NEXT:      aie.use_lock(%[[CONS]], AcquireGreaterEqual, 1)
+// A store between two acquires keeps them apart.
+// CHECK-NEXT:      aie.use_lock(%[[PROD]], AcquireGreaterEqual, 1)
+// CHECK-NEXT:      memref.store
+// CHECK-NEXT:      aie.use_lock(%[[PROD]], AcquireGreaterEqual, 1)
+// CHECK-NEXT:      aie.end
+
+aie.device(npu1_1col) {
+  %tile_0_2 = aie.tile(0, 2)
+  %prod = aie.lock(%tile_0_2, 0) {init = 2 : i32}
+  %cons = aie.lock(%tile_0_2, 1) {init = 0 : i32}
+  %priv = aie.lock(%tile_0_2, 2) {init = 1 : i32}
+  %buf = aie.buffer(%tile_0_2) : memref<16xi32>
+  %core = aie.core(%tile_0_2) {
+    aie.use_lock(%prod, AcquireGreaterEqual, 1)
+    aie.use_lock(%prod, AcquireGreaterEqual, 1)
+    %c0 = arith.constant 0 : index
+    %v = arith.constant 7 : i32
+    memref.store %v, %buf[%c0] : memref<16xi32>
+    aie.use_lock(%cons, Release, 1)
+    %c1 = arith.constant 1 : index
+    aie.use_lock(%cons, Release, 1)
+    memref.store %v, %buf[%c1] : memref<16xi32>
+    aie.use_lock(%priv, Release, 2)
+    aie.use_lock(%priv, AcquireGreaterEqual, 1)
+    aie.use_lock(%cons, Release, 1)
+    aie.use_lock(%cons, AcquireGreaterEqual, 1)
+    aie.use_lock(%prod, AcquireGreaterEqual, 1)
+    memref.store %v, %buf[%c0] : memref<16xi32>
+    aie.use_lock(%prod, AcquireGreaterEqual, 1)
+    aie.end
+  }
+  %mem = aie.mem(%tile_0_2) {
+    %0 = aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    aie.use_lock(%cons, AcquireGreaterEqual, 1)
+    aie.dma_bd(%buf : memref<16xi32>, 0, 16)
+    aie.use_lock(%prod, Release, 1)
+    aie.next_bd ^bd0
+  ^end:
+    aie.end
+  }
+}
+
+// Merged values that do not fit a 6-bit AIE2 lock value are left alone.
+
+// CHECK-LABEL: aie.device(npu1_2col)
+// CHECK:         %[[LOCK:.*]] = aie.lock(%{{.*}}, 0) {init = 63 : i32}
+// CHECK:         aie.core
+// CHECK-NEXT:      aie.use_lock(%[[LOCK]], AcquireGreaterEqual, 40)
+// CHECK-NEXT:      aie.use_lock(%[[LOCK]], AcquireGreaterEqual, 30)
+// CHECK-NEXT:      aie.use_lock(%[[LOCK]], Release, 63)
+// CHECK-NEXT:      aie.use_lock(%[[LOCK]], Release, 7)
+// CHECK-NEXT:      aie.end
+
+aie.device(npu1_2col) {
+  %tile_0_2 = aie.tile(0, 2)
+  %lock = aie.lock(%tile_0_2, 0) {init = 63 : i32}
+  %core = aie.core(%tile_0_2) {
+    aie.use_lock(%lock, AcquireGreaterEqual, 40)
+    aie.use_lock(%lock, AcquireGreaterEqual, 30)
+    aie.use_lock(%lock, Release, 40)
+    aie.use_lock(%lock, Release, 23)
+    aie.use_lock(%lock, Release, 7)
+    aie.end
+  }
+}
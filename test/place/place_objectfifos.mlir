@@ -0,0 +1,46 @@
+//===- place_objectfifos.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-place %s | FileCheck %s
+
+// The consumer of @in is placed next to the shim tile, and the consumer of @mid
+// is placed on a tile that shares memory with its producer, so that @mid does
+// not need a stream.
+
+// CHECK-LABEL: aie.device(npu1_1col) {
+// CHECK:         %[[SHIM:.*]] = aie.tile(0, 0)
+// CHECK:         %[[FIRST:.*]] = aie.tile(0, 2)
+// CHECK:         %[[SECOND:.*]] = aie.tile(0, 3)
+// CHECK:         aie.objectfifo @in(%[[SHIM]], {%[[FIRST]]}, 2 : i32)
+// CHECK:         aie.objectfifo @mid(%[[FIRST]], {%[[SECOND]]}, 2 : i32)
+// CHECK:         aie.core(%[[FIRST]])
+// CHECK:         aie.core(%[[SECOND]])
+
+module @place_objectfifos {
+  aie.device(npu1_1col) {
+    %shim = aie.tile(0, 0)
+    %first = aie.tile(0, 5)
+    %second = aie.tile(0, 2)
+    aie.objectfifo @in(%shim, {%first}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @mid(%first, {%second}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    %core_first = aie.core(%first) {
+      %0 = aie.objectfifo.acquire @in(Consume, 1) : !aie.objectfifosubview<memref<64xi32>>
+      %1 = aie.objectfifo.acquire @mid(Produce, 1) : !aie.objectfifosubview<memref<64xi32>>
+      aie.objectfifo.release @in(Consume, 1)
+      aie.objectfifo.release @mid(Produce, 1)
+      aie.end
+    }
+    %core_second = aie.core(%second) {
+      %0 = aie.objectfifo.acquire @mid(Consume, 1) : !aie.objectfifosubview<memref<64xi32>>
+      aie.objectfifo.release @mid(Consume, 1)
+      aie.end
+    }
+  }
+}
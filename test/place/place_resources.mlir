@@ -0,0 +1,49 @@
+//===- place_resources.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-place --verify-diagnostics --split-input-file %s | FileCheck %s
+
+// The buffer and the default stack do not fit in the local memory of any
+// compute tile.
+
+module @too_much_memory {
+  // expected-error@+2 {{aie-place: no placement satisfies the resource limits of the device}}
+  // expected-note@+1 {{tile (0, 2) requires 71024 bytes of memory, but only 65536 are available}}
+  aie.device(npu1_1col) {
+    %tile = aie.tile(0, 2)
+    %buf = aie.buffer(%tile) : memref<17500xi32>
+    %core = aie.core(%tile) {
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// Tiles sharing a buffer are kept in place.
+
+// CHECK-LABEL: module @pinned
+// CHECK:         aie.tile(0, 0)
+// CHECK:         aie.tile(0, 5)
+// CHECK:         aie.tile(0, 4)
+module @pinned {
+  aie.device(npu1_1col) {
+    %shim = aie.tile(0, 0)
+    %a = aie.tile(0, 5)
+    %b = aie.tile(0, 4)
+    %buf = aie.buffer(%b) : memref<16xi32>
+    aie.flow(%shim, DMA : 0, %a, DMA : 0)
+    %core = aie.core(%a) {
+      %c0 = arith.constant 0 : index
+      %v = memref.load %buf[%c0] : memref<16xi32>
+      aie.end
+    }
+  }
+}
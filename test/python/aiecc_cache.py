@@ -0,0 +1,104 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import asyncio
+import os
+import tempfile
+
+from aie.compiler.aiecc.cache import CompilationCache, file_digest, parse_size
+
+
+def write(path, contents):
+    with open(path, "w") as f:
+        f.write(contents)
+
+
+def read(path):
+    with open(path) as f:
+        return f.read()
+
+
+with tempfile.TemporaryDirectory() as tmp:
+    cache = CompilationCache(os.path.join(tmp, "cache"))
+    src = os.path.join(tmp, "core_0_2.ll")
+    obj = os.path.join(tmp, "core_0_2.o")
+    write(src, "define void @core() { ret void }")
+
+    key = cache.key("llc", file_digest(src))
+    # CHECK: miss: True
+    print("miss:", not cache.fetch(key, {"output0": obj}))
+
+    write(obj, "object")
+    cache.store(key, {"output0": obj})
+    os.remove(obj)
+    # CHECK: hit: True object
+    print("hit:", cache.fetch(key, {"output0": obj}), read(obj))
+
+    # A missing optional file does not turn a hit into a miss.
+    # CHECK: optional: True False
+    map_file = obj + ".map"
+    print(
+        "optional:",
+        cache.fetch(key, {"output0": obj}, {"side0": map_file}),
+        os.path.exists(map_file),
+    )
+
+    # Any change of the input contents changes the key.
+    write(src, "define void @core() { unreachable }")
+    # CHECK: changed: True
+    print("changed:", cache.key("llc", file_digest(src)) != key)
+
+    # CHECK: disabled: False
+    print("disabled:", CompilationCache(cache.root, enabled=False).fetch(key, {}))
+
+    # Identical builds in flight at the same time run once.
+    builds = []
+
+    async def build():
+        builds.append(1)
+        await asyncio.sleep(0.01)
+
+    async def twins():
+        return await asyncio.gather(
+            cache.single_flight("k", build), cache.single_flight("k", build)
+        )
+
+    # CHECK: single flight: [True, False] 1
+    print("single flight:", asyncio.run(twins()), len(builds))
+
+    # CHECK: Compilation cache {{.*}}: 2 hits, 1 misses
+    print(cache.summary())
+
+    # The cache is trimmed to a size, least recently used entries first. The
+    # routings count as used when they were written.
+    trimmed = CompilationCache(os.path.join(tmp, "trimmed"))
+    keys = []
+    for i in range(3):
+        write(obj, "x" * 100)
+        keys.append(trimmed.key("entry", i))
+        trimmed.store(keys[-1], {"output0": obj})
+        os.utime(trimmed.entry_dir(keys[-1]), (1000 + i, 1000 + i))
+    route = os.path.join(trimmed.root, "routes", "0123.json")
+    os.makedirs(os.path.dirname(route))
+    write(route, "x" * 100)
+    os.utime(route, (500, 500))
+    # A hit makes the oldest entry the most recently used one.
+    trimmed.fetch(keys[0], {"output0": obj})
+    # CHECK: trim: 2 [True, False, True] False
+    print(
+        "trim:",
+        trimmed.trim(200),
+        [trimmed.entry_files(key) is not None for key in keys],
+        os.path.exists(route),
+    )
+    # CHECK: within size: 0
+    print("within size:", trimmed.trim(200))
+
+    # CHECK: cleared: False []
+    trimmed.clear()
+    print("cleared:", os.path.exists(trimmed.root), trimmed.entries())
+
+    # CHECK: sizes: 512 1048576 2147483648
+    print("sizes:", parse_size("512"), parse_size("1M"), parse_size("2GB"))
@@ -0,0 +1,62 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %PYTHON %s | FileCheck %s
+
+from aie.dialects.aie import Compilation
+from aie.ir import Context, Location, Module
+
+module = """
+module {
+  aie.device(npu1_1col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %buf_0_2 = aie.buffer(%tile_0_2) {sym_name = "buf_0_2"} : memref<256xi32>
+    %buf_0_3 = aie.buffer(%tile_0_3) {sym_name = "buf_0_3"} : memref<256xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c7 = arith.constant 7 : i32
+      memref.store %c7, %buf_0_2[%c0] : memref<256xi32>
+      aie.end
+    }
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c9 = arith.constant 9 : i32
+      memref.store %c9, %buf_0_3[%c0] : memref<256xi32>
+      aie.end
+    } {elf_file = "custom.elf"}
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {address = 0x1F000 : ui32, value = 42 : ui32}
+    }
+  }
+}
+"""
+
+with Context() as ctx, Location.unknown():
+    compilation = Compilation(Module.parse(module).operation)
+
+    # CHECK: AIE2
+    print(compilation.target_arch)
+    # CHECK: [(0, 2, None), (0, 3, 'custom.elf')]
+    print(compilation.cores)
+
+    # CHECK: (0, 2) define void @core_0_2() PROVIDE(main = core_0_2);
+    # CHECK: (0, 3) define void @core_0_3() PROVIDE(main = core_0_3);
+    for core in compilation.lower_cores():
+        tile = f"core_{core['col']}_{core['row']}"
+        print(
+            (core["col"], core["row"]),
+            "define void @" + tile + "()" if tile in core["llvm_ir"] else "",
+            f"PROVIDE(main = {tile});" if tile in core["ld_script"] else "",
+        )
+
+    # CHECK: unified: True True
+    unified = compilation.lower_cores_unified()
+    print("unified:", "@core_0_2" in unified, "@core_0_3" in unified)
+
+    # The write32 shows up in the instruction stream.
+    # CHECK: npu: True
+    print("npu:", 42 in compilation.npu_instructions())
+
+    # CHECK: aie.device(npu1_1col)
+    print(compilation.physical_module())
@@ -0,0 +1,79 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %PYTHON %s | FileCheck %s
+
+from aie.dialects.aie import Compilation
+from aie.ir import Context, Location, Module
+
+# Two devices, each with a core that runs the standard lowering, which erases
+# every other device of its module.
+module = """
+module {
+  aie.device(npu1_1col) @first {
+    %tile_0_2 = aie.tile(0, 2)
+    %buf_0_2 = aie.buffer(%tile_0_2) {sym_name = "buf_0_2"} : memref<256xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c7 = arith.constant 7 : i32
+      memref.store %c7, %buf_0_2[%c0] : memref<256xi32>
+      aie.end
+    }
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {address = 0x1F000 : ui32, value = 42 : ui32}
+    }
+  }
+  aie.device(npu1_1col) {
+    %tile_0_3 = aie.tile(0, 3)
+    %buf_0_3 = aie.buffer(%tile_0_3) {sym_name = "buf_0_3"} : memref<256xi32>
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c9 = arith.constant 9 : i32
+      memref.store %c9, %buf_0_3[%c0] : memref<256xi32>
+      aie.end
+    }
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {address = 0x1F000 : ui32, value = 43 : ui32}
+    }
+  }
+}
+"""
+
+with Context() as ctx, Location.unknown():
+    op = Module.parse(module).operation
+
+    # CHECK: ['first', 'device1']
+    names = Compilation.device_names(op)
+    print(names)
+
+    # CHECK: first [(0, 2, None)] True False
+    # CHECK: first (0, 2) define void @core_0_2()
+    # CHECK: device1 [(0, 3, None)] False True
+    # CHECK: device1 (0, 3) define void @core_0_3()
+    for name in names:
+        compilation = Compilation(op, device_name=name)
+        npu = compilation.npu_instructions()
+        print(compilation.device_name, compilation.cores, 42 in npu, 43 in npu)
+        for core in compilation.lower_cores():
+            tile = f"core_{core['col']}_{core['row']}"
+            print(
+                name,
+                (core["col"], core["row"]),
+                "define void @" + tile + "()" if tile in core["llvm_ir"] else "",
+            )
+
+    # The input module keeps both devices.
+    # CHECK: devices: 2
+    print("devices:", str(op).count("aie.device(npu1_1col)"))
+
+    # CHECK: select one by name
+    try:
+        Compilation(op)
+    except ValueError as e:
+        print(e)
+
+    # CHECK: does not contain a device named second
+    try:
+        Compilation(op, device_name="second")
+    except ValueError as e:
+        print(e)
@@ -0,0 +1,48 @@
+//===- zero_time.mlir ------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-simulate-performance="max-cycles=1000" %s | FileCheck %s
+
+// A loop whose lock operations never wait and a chain of empty BDs without
+// locks would take no time: every iteration and every BD takes a cycle
+// instead, so the simulation reaches max-cycles.
+
+// CHECK-LABEL: performance of npu1_1col:
+// CHECK-NEXT:    simulated 1000 cycles, steady state from cycle 500
+// CHECK-NEXT:    tile (0, 2): core busy 100.0%, DMA occupancy 100.0%
+// CHECK-NEXT:      core (0, 2): busy 100.0%, lock stall 0.0%, idle 0.0%
+// CHECK-NEXT:      MM2S 0 (0, 2): busy 100.0%, lock stall 0.0%, stream stall 0.0%, idle 0.0%
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %buf = aie.buffer(%tile_0_2) {sym_name = "buf"} : memref<64xi32>
+    %count = aie.lock(%tile_0_2, 0) {init = 0 : i32, sym_name = "count"}
+
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %cmax = arith.constant 0xFFFFFFFF : index
+      scf.for %i = %c0 to %cmax step %c1 {
+        aie.use_lock(%count, Release, 1)
+      }
+      aie.end
+    }
+
+    %mem_0_2 = aie.mem(%tile_0_2) {
+      %0 = aie.dma_start(MM2S, 0, ^bb1, ^bb2)
+    ^bb1:
+      aie.dma_bd(%buf : memref<64xi32>, 0, 0)
+      aie.next_bd ^bb1
+    ^bb2:
+      aie.end
+    }
+  }
+}
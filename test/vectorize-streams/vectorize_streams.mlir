@@ -0,0 +1,74 @@
+//===- vectorize_streams.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-vectorize-streams %s | FileCheck %s
+// RUN: aie-opt --aie-vectorize-streams="vector-bits=256" %s | FileCheck --check-prefix=WIDE %s
+
+// CHECK-LABEL: aie.core(%{{.*}}) {
+// CHECK:         %[[C4:.*]] = arith.constant 4 : index
+// CHECK:         scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %[[C4]] {
+// CHECK:           %[[V:.*]] = aie.get_stream(%{{.*}} : i32) : vector<4xi32>
+// CHECK:           vector.store %[[V]], %{{.*}}[%[[I]]] : memref<64xi32>, vector<4xi32>
+// CHECK:         }
+// CHECK:         scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+// CHECK:           %[[W:.*]] = vector.load %{{.*}}[%{{.*}}, %[[J]]] : memref<4x16xf32>, vector<4xf32>
+// CHECK:           aie.put_stream(%{{.*}} : i32, %[[W]] : vector<4xf32>)
+// CHECK:         }
+
+// The trip count of this loop is not a multiple of the vector width.
+// CHECK:         scf.for %{{.*}} = %{{.*}} to %{{.*}} step %{{.*}} {
+// CHECK:           aie.get_stream(%{{.*}} : i32) : i32
+// CHECK:           memref.store
+
+// The stored value is not the one read from the stream.
+// CHECK:         scf.for
+// CHECK:           aie.get_stream(%{{.*}} : i32) : i32
+// CHECK:           arith.addi
+// CHECK:           memref.store
+
+// WIDE:          aie.get_stream(%{{.*}} : i32) : vector<8xi32>
+// WIDE:          vector.load %{{.*}} : memref<4x16xf32>, vector<8xf32>
+// WIDE:          aie.put_stream(%{{.*}} : i32, %{{.*}} : vector<8xf32>)
+// WIDE-NOT:      vector<
+
+module {
+  aie.device(npu1_1col) {
+    %tile02 = aie.tile(0, 2)
+    %in = aie.buffer(%tile02) : memref<64xi32>
+    %out = aie.buffer(%tile02) : memref<4x16xf32>
+    %core02 = aie.core(%tile02) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c2 = arith.constant 2 : index
+      %c6 = arith.constant 6 : index
+      %c16 = arith.constant 16 : index
+      %c64 = arith.constant 64 : index
+      %ch = arith.constant 0 : i32
+      scf.for %i = %c0 to %c64 step %c1 {
+        %v = aie.get_stream(%ch : i32) : i32
+        memref.store %v, %in[%i] : memref<64xi32>
+      }
+      scf.for %j = %c0 to %c16 step %c1 {
+        %w = memref.load %out[%c2, %j] : memref<4x16xf32>
+        aie.put_stream(%ch : i32, %w : f32)
+      }
+      scf.for %k = %c0 to %c6 step %c1 {
+        %v = aie.get_stream(%ch : i32) : i32
+        memref.store %v, %in[%k] : memref<64xi32>
+      }
+      scf.for %l = %c0 to %c16 step %c1 {
+        %v = aie.get_stream(%ch : i32) : i32
+        %s = arith.addi %v, %ch : i32
+        memref.store %s, %in[%l] : memref<64xi32>
+      }
+      aie.end
+    }
+  }
+}
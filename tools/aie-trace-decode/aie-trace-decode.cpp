@@ -0,0 +1,118 @@
+//===- aie-trace-decode.cpp -------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This tool decodes the trace buffer written by the trace units of a design
+// into a Chrome/Perfetto trace, naming the events after the trace event
+// configuration found in the design. It replaces
+// programming_examples/utils/parse_trace.py for large traces.
+
+#include "aie/InitialAllDialect.h"
+#include "aie/Targets/AIETraceDecoder.h"
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/OwningOpRef.h"
+#include "mlir/InitAllDialects.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Support/FileUtilities.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+using namespace llvm;
+using namespace mlir;
+using namespace xilinx;
+
+enum class TraceFormat { Text, Binary };
+enum class OutputFormat { JSON, Binary };
+
+static cl::opt<std::string> traceFileName(cl::Positional,
+                                          cl::desc("<input trace>"),
+                                          cl::init("-"));
+
+static cl::opt<std::string>
+    mlirFileName("mlir", cl::desc("MLIR design that configured the trace"),
+                 cl::value_desc("filename"), cl::Required);
+
+static cl::opt<std::string> outputFileName("o", cl::desc("Output filename"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"));
+
+static cl::opt<TraceFormat> inputFormat(
+    "input-format", cl::desc("Format of the input trace"),
+    cl::init(TraceFormat::Text),
+    cl::values(clEnumValN(TraceFormat::Text, "text",
+                          "One hexadecimal word per line"),
+               clEnumValN(TraceFormat::Binary, "binary",
+                          "Raw little-endian trace buffer")));
+
+static cl::opt<OutputFormat> outputFormat(
+    "output-format", cl::desc("Format of the decoded trace"),
+    cl::init(OutputFormat::JSON),
+    cl::values(clEnumValN(OutputFormat::JSON, "json",
+                          "Chrome trace event JSON"),
+               clEnumValN(OutputFormat::Binary, "binary",
+                          "Compact binary event records")));
+
+static cl::opt<int> colShift("colshift",
+                             cl::desc("Column shift adjustment to the design"),
+                             cl::init(0));
+
+int main(int argc, char *argv[]) {
+  InitLLVM y(argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "AIE trace decoder\n");
+
+  MLIRContext ctx;
+  DialectRegistry registry;
+  mlir::registerAllDialects(registry);
+  xilinx::registerAllDialects(registry);
+  ctx.appendDialectRegistry(registry);
+
+  SourceMgr srcMgr;
+  ParserConfig pcfg(&ctx);
+  OwningOpRef<ModuleOp> module =
+      parseSourceFile<ModuleOp>(mlirFileName, srcMgr, pcfg);
+  if (!module)
+    return 1;
+  AIE::TraceConfig config = AIE::TraceConfig::fromModule(*module, colShift);
+
+  std::string errorMessage;
+  std::unique_ptr<MemoryBuffer> trace =
+      openInputFile(traceFileName, &errorMessage);
+  if (!trace) {
+    errs() << errorMessage << "\n";
+    return 1;
+  }
+  std::unique_ptr<ToolOutputFile> output =
+      openOutputFile(outputFileName, &errorMessage);
+  if (!output) {
+    errs() << errorMessage << "\n";
+    return 1;
+  }
+
+  std::unique_ptr<AIE::TraceSink> sink =
+      outputFormat == OutputFormat::JSON
+          ? AIE::createChromeTraceSink(output->os())
+          : AIE::createBinaryTraceSink(output->os());
+  uint64_t droppedPackets = 0;
+  if (failed(AIE::decodeTrace(trace->getBuffer(),
+                              inputFormat == TraceFormat::Binary, config,
+                              *sink, &droppedPackets)))
+    return 1;
+  if (droppedPackets)
+    errs() << "warning: dropped " << droppedPackets
+           << " packets from trace units not configured by the design\n";
+
+  output->keep();
+  return 0;
+}
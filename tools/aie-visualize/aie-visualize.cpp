@@ -10,6 +10,8 @@
 
 // This tool generates a simple visualization of a design, showing the
 // device layout and highlighting which device tiles are being used.
+// Given the routing metrics of aie-create-pathfinder-flows, it shades every
+// used switchbox by its utilization instead.
 
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 #include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
@@ -35,6 +37,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SourceMgr.h"
@@ -50,6 +53,11 @@ using namespace xilinx;
 
 cl::opt<std::string> FileName(cl::Positional, cl::desc("<input mlir>"),
                               cl::Required);
+cl::opt<std::string>
+    HeatMapFileName("heat-map",
+                    cl::desc("Routing metrics JSON written by "
+                             "aie-create-pathfinder-flows=metrics-file"),
+                    cl::value_desc("filename"));
 
 const std::string bold("\033[0;1m");
 const std::string dim("\033[0;2m");
@@ -109,6 +117,37 @@ int main(int argc, char *argv[]) {
     used[tile.getCol() + model.columns() * tile.getRow()] = true;
   }
 
+  // Switchbox utilization by row and column, from 0 to 1.
+  std::vector<double> utilization(model.columns() * model.rows(), 0.0);
+  if (!HeatMapFileName.empty()) {
+    auto buffer = MemoryBuffer::getFile(HeatMapFileName);
+    if (!buffer) {
+      std::cerr << "cannot read " << HeatMapFileName << "\n";
+      return 3;
+    }
+    Expected<json::Value> metrics = json::parse((*buffer)->getBuffer());
+    if (!metrics) {
+      std::cerr << toString(metrics.takeError()) << "\n";
+      return 3;
+    }
+    const json::Object *heatMap = nullptr;
+    if (const json::Object *object = metrics->getAsObject())
+      heatMap = object->getObject("heat_map");
+    const json::Array *rows =
+        heatMap ? heatMap->getArray("utilization") : nullptr;
+    if (!rows) {
+      std::cerr << HeatMapFileName << " has no heat map\n";
+      return 3;
+    }
+    for (int row = 0; row < model.rows() && row < (int)rows->size(); row++) {
+      const json::Array *cols = (*rows)[row].getAsArray();
+      for (int col = 0;
+           cols && col < model.columns() && col < (int)cols->size(); col++)
+        utilization[col + model.columns() * row] =
+            (*cols)[col].getAsNumber().value_or(0.0);
+    }
+  }
+
   std::cout << model.columns() << " Columns and " << model.rows() << " Rows\n";
   for (int row = model.rows() - 1; row >= 0; row--) {
     std::cout << reset << row % 10 << " ";
@@ -126,6 +165,12 @@ int main(int argc, char *argv[]) {
         v = blue + 'D';
       else if (model.isShimPLTile(col, row))
         v = magenta + 'P';
+      // Used switchboxes show their utilization in tenths.
+      double u = utilization[col + model.columns() * row];
+      if (u > 0.0) {
+        const std::string &color = u < 0.25 ? green : u < 0.5 ? yellow : red;
+        v = color + std::to_string(std::min(9, (int)(u * 10)));
+      }
       std::cout << v << reset;
     }
     std::cout << "\n";
@@ -146,5 +191,9 @@ int main(int argc, char *argv[]) {
   }
   std::cout << "\n";
 
+  if (!HeatMapFileName.empty())
+    std::cout << "Switchbox utilization in tenths: " << green << "<25% "
+              << yellow << "<50% " << red << ">=50%" << reset << "\n";
+
   return 0;
 }
@@ -7,6 +7,9 @@ importable Python file containing an enum of all events.
 The generated enum is included in python/utils/trace_events_enum.py and 
 used by the trace utilities in python/utils/trace.py and in
 programming_examples/utils/parse_trace.py
+
+With --cpp, the same events are written as a C++ include file instead, which
+is lib/Targets/AIETraceEvents.inc used by the native trace decoder.
 """
 
 import sys, re, argparse, collections
@@ -33,6 +36,36 @@ class MemTileEvent(Enum):
 {mem_tile_items}
 """
 
+cpp_template = """// Enumeration of AIE2 trace events
+// Automatically generated from utils/generate_events_enum.py
+
+#ifndef AIE_CORE_EVENT
+#define AIE_CORE_EVENT(NAME, CODE)
+#endif
+#ifndef AIE_MEM_EVENT
+#define AIE_MEM_EVENT(NAME, CODE)
+#endif
+#ifndef AIE_PL_EVENT
+#define AIE_PL_EVENT(NAME, CODE)
+#endif
+#ifndef AIE_MEM_TILE_EVENT
+#define AIE_MEM_TILE_EVENT(NAME, CODE)
+#endif
+
+{core_items}
+
+{mem_items}
+
+{pl_items}
+
+{mem_tile_items}
+
+#undef AIE_CORE_EVENT
+#undef AIE_MEM_EVENT
+#undef AIE_PL_EVENT
+#undef AIE_MEM_TILE_EVENT
+"""
+
 core_regex = r"^\s*#define\s+XAIEML_EVENTS_CORE_([a-zA-Z0-9_]+)\s+(\d+)U\s*$"
 mem_regex = r"^\s*#define\s+XAIEML_EVENTS_MEM_(?!TILE)([a-zA-Z0-9_]+)\s+(\d+)U\s*$"
 pl_regex = r"^\s*#define\s+XAIEML_EVENTS_PL_([a-zA-Z0-9_]+)\s+(\d+)U\s*$"
@@ -54,10 +87,19 @@ def write_enum_items(dict):
     return "\n".join("    {} = {}".format(name, num) for num, name in dict.items())
 
 
+def write_cpp_items(macro, dict):
+    return "\n".join(
+        "{}({}, {})".format(macro, name, num) for num, name in dict.items()
+    )
+
+
 def main():
     argparser = argparse.ArgumentParser()
     argparser.add_argument("-i", type=argparse.FileType("r"), default=sys.stdin)
     argparser.add_argument("-o", type=argparse.FileType("w"), default=sys.stdout)
+    argparser.add_argument(
+        "--cpp", action="store_true", help="Generate a C++ include file"
+    )
     args = argparser.parse_args()
 
     lines = args.i.readlines()
@@ -71,6 +113,17 @@ def main():
         parse_event_declaration(pl_regex, pl_events, line)
         parse_event_declaration(mem_tile_regex, mem_tile_events, line)
 
+    if args.cpp:
+        args.o.write(
+            cpp_template.format(
+                core_items=write_cpp_items("AIE_CORE_EVENT", core_events),
+                mem_items=write_cpp_items("AIE_MEM_EVENT", mem_events),
+                pl_items=write_cpp_items("AIE_PL_EVENT", pl_events),
+                mem_tile_items=write_cpp_items("AIE_MEM_TILE_EVENT", mem_tile_events),
+            )
+        )
+        return
+
     core_str = write_enum_items(core_events)
     mem_str = write_enum_items(mem_events)
     pl_str = write_enum_items(pl_events)